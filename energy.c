@@ -0,0 +1,139 @@
+/**@file		energy.c
+ * @brief		Implementation of the energy meter
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "energy.h"
+#include "telemetry.h"
+
+static void EnergyAdd(EnergyTotal* total, uint16_t milliwattHours);
+
+// INITIALIZATION FUNCTIONS----------------------------------------------------
+
+/**
+ * Clears all totals of an <b>EnergyMeter</b>
+ * @param meter Pointer to the <b>EnergyMeter</b> to be initialized
+ */
+void EnergyInitialize(EnergyMeter* meter)
+{
+	memset(meter, 0, sizeof(EnergyMeter));
+}
+
+// INTEGRATION FUNCTIONS-------------------------------------------------------
+
+/**
+ * Adds the energy of one sample window to the totals.
+ * The energy (load times duration) is converted to whole milliwatt-hours,
+ * and the remainder is carried over to the next window, so nothing is lost to rounding.
+ * @param meter			Pointer to the target <b>EnergyMeter</b>
+ * @param load			Load during the window (tenths of a watt)
+ * @param duration		Length of the window (periods of <code>ENERGY_TIME_BASE</code>)
+ * @param isRelayClosed	Relay state during the window
+ */
+void EnergyAddWindow(EnergyMeter* meter, uint16_t load, uint32_t duration, bool isRelayClosed)
+{
+	// The product fits in 32 bits for windows of up to 65536 clock periods
+	uint32_t energy = (uint32_t) load * duration;
+	uint16_t milliwattHours = (uint16_t) (energy / ENERGY_UNITS_PER_MWH);
+	meter->residue += energy % ENERGY_UNITS_PER_MWH;
+	if(meter->residue >= ENERGY_UNITS_PER_MWH)
+	{
+		meter->residue -= ENERGY_UNITS_PER_MWH;
+		milliwattHours++;
+	}
+	meter->windows++;
+
+	if(milliwattHours == 0)
+		return;
+	EnergyAdd(&meter->totals[ENERGY_TOTAL], milliwattHours);
+	EnergyAdd(&meter->totals[ENERGY_TODAY], milliwattHours);
+	EnergyAdd(&meter->totals[isRelayClosed ? ENERGY_RELAY_CLOSED : ENERGY_RELAY_OPEN], milliwattHours);
+}
+
+/**
+ * Starts a new day if the RTCC day has changed: today's total becomes yesterday's, and today's total is cleared.
+ * Nothing is rolled over when the day was unknown (after the meter has been cleared).
+ * @param meter	Pointer to the target <b>EnergyMeter</b>
+ * @param day	RTCC day (BCD)
+ * @return		true if a new day was started, false if not
+ */
+bool EnergySetDay(EnergyMeter* meter, uint8_t day)
+{
+	if(day == meter->day)
+		return false;
+
+	bool isRollover = meter->day != 0;
+	if(isRollover)
+	{
+		meter->totals[ENERGY_YESTERDAY] = meter->totals[ENERGY_TODAY];
+		meter->totals[ENERGY_TODAY].wattHours = 0;
+		meter->totals[ENERGY_TODAY].milliwattHours = 0;
+	}
+	meter->day = day;
+	return isRollover;
+}
+
+/**
+ * Converts a total to milliwatt-hours
+ * @param total	Pointer to the total
+ * @return		The total in milliwatt-hours (limited to 0xFFFFFFFF, about 4.3MWh)
+ */
+uint32_t EnergyMilliwattHours(const EnergyTotal* total)
+{
+	if(total->wattHours >= 4294967UL)
+		return 0xFFFFFFFF;
+	return total->wattHours * 1000 + total->milliwattHours;
+}
+
+// CHECKPOINT FUNCTIONS--------------------------------------------------------
+
+/**
+ * Creates a checkpoint image of a meter
+ * @param meter			Pointer to the <b>EnergyMeter</b>
+ * @param sequence		Checkpoint sequence number
+ * @param checkpoint	Destination
+ */
+void EnergySeal(const EnergyMeter* meter, uint16_t sequence, EnergyCheckpoint* checkpoint)
+{
+	// Clear any padding, so that the CRC only depends on the contents of the meter
+	memset(checkpoint, 0, sizeof(EnergyCheckpoint));
+	checkpoint->magic = ENERGY_MAGIC;
+	checkpoint->sequence = sequence;
+	checkpoint->meter = *meter;
+	checkpoint->crc = TelemetryCrc16(0xFFFF, (const uint8_t*) checkpoint, offsetof(EnergyCheckpoint, crc));
+}
+
+/**
+ * Checks whether a checkpoint image is intact (for example, after it has been read back from SRAM following a reset)
+ * @param checkpoint	Pointer to the checkpoint
+ * @return				true if the checkpoint is valid, false if not
+ */
+bool EnergyIsValid(const EnergyCheckpoint* checkpoint)
+{
+	return checkpoint->magic == ENERGY_MAGIC
+			&& checkpoint->crc == TelemetryCrc16(0xFFFF, (const uint8_t*) checkpoint, offsetof(EnergyCheckpoint, crc));
+}
+
+// INTERNAL FUNCTIONS----------------------------------------------------------
+
+/**
+ * Adds milliwatt-hours to a total
+ * @param total				Pointer to the total
+ * @param milliwattHours	Energy to be added (milliwatt-hours)
+ */
+static void EnergyAdd(EnergyTotal* total, uint16_t milliwattHours)
+{
+	total->milliwattHours += milliwattHours;
+	if(total->milliwattHours >= 1000)
+	{
+		total->wattHours += total->milliwattHours / 1000;
+		total->milliwattHours %= 1000;
+	}
+}
@@ -0,0 +1,71 @@
+/**@file		energy.h
+ * @brief		Header file defining the energy meter, which integrates the load of each sample window
+ *				into watt-hour totals (overall, per relay state, and per day) without floating point math.
+ *				This module has no hardware dependencies, so it can be built and checked on a host.
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINITIONS-----------------------------------------------------------------
+#define ENERGY_TIME_BASE		150000UL	/**< Clock (Hz) in which window durations are given (a window may last up to 65535 periods) */
+#define ENERGY_UNITS_PER_MWH	(36UL * ENERGY_TIME_BASE)	/**< Integration units (tenths of a watt times clock periods) per milliwatt-hour */
+#define ENERGY_MAGIC			0x454D		/**< Identifies a checkpoint ("EM") */
+// Totals (see EnergyMeter)
+#define ENERGY_TOTAL			0			/**< Since the meter was last cleared */
+#define ENERGY_TODAY			1			/**< Since midnight (RTCC) */
+#define ENERGY_YESTERDAY		2			/**< The previous day */
+#define ENERGY_RELAY_OPEN		3			/**< While the relay was open (leakage or measurement offset) */
+#define ENERGY_RELAY_CLOSED		4			/**< While the relay was closed */
+#define ENERGY_TOTAL_COUNT		5
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct EnergyTotal
+ * An energy total, held as whole watt-hours and the milliwatt-hours above them
+ * (together a 42-bit count of milliwatt-hours, without 64-bit arithmetic)
+ */
+typedef struct EnergyTotal
+{
+	uint32_t wattHours;			/**< Whole watt-hours */
+	uint16_t milliwattHours;	/**< Milliwatt-hours (0 - 999) */
+} EnergyTotal;
+
+/**@struct EnergyMeter
+ * Energy totals and the integration state
+ */
+typedef struct EnergyMeter
+{
+	EnergyTotal totals[ENERGY_TOTAL_COUNT];	/**< Totals (ENERGY_TOTAL, ENERGY_TODAY, ...) */
+	uint32_t residue;						/**< Integrated energy not yet counted (less than one milliwatt-hour, in integration units) */
+	uint32_t windows;						/**< Number of windows integrated */
+	uint8_t day;							/**< RTCC day (BCD) to which ENERGY_TODAY belongs (0 = unknown) */
+} EnergyMeter;
+
+/**@struct EnergyCheckpoint
+ * Image of an <b>EnergyMeter</b> as it is stored in external SRAM
+ */
+typedef struct EnergyCheckpoint
+{
+	uint16_t magic;				/**< ENERGY_MAGIC */
+	uint16_t sequence;			/**< Incremented with every checkpoint, so that the most recent of several can be found */
+	EnergyMeter meter;			/**< Meter contents */
+	uint16_t crc;				/**< CRC-16/CCITT-FALSE of all preceding bytes */
+} EnergyCheckpoint;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+void EnergyInitialize(EnergyMeter* meter);
+void EnergyAddWindow(EnergyMeter* meter, uint16_t load, uint32_t duration, bool isRelayClosed);
+bool EnergySetDay(EnergyMeter* meter, uint8_t day);
+uint32_t EnergyMilliwattHours(const EnergyTotal* total);
+void EnergySeal(const EnergyMeter* meter, uint16_t sequence, EnergyCheckpoint* checkpoint);
+bool EnergyIsValid(const EnergyCheckpoint* checkpoint);
+
+#endif
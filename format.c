@@ -0,0 +1,376 @@
+/**@file		format.c
+ * @brief		Implementation of integer and fixed-point number formatting without floating point math
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "format.h"
+#include "serial_comm.h"
+#include "utility.h"
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct FormatCursor
+ * Write position within a destination which is filled from its last character towards its first.
+ * The destination may be a ring (the position wraps from index 0 to <code>capacity - 1</code>).
+ */
+typedef struct FormatCursor
+{
+	char* data;					/**< Destination characters */
+	unsigned int capacity;		/**< Size of the destination (characters) */
+	unsigned int index;			/**< Index at which the next character will be written */
+	unsigned char remaining;	/**< Number of characters left to write */
+} FormatCursor;
+
+// CONSTANTS-------------------------------------------------------------------
+static const char _digitPairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+static const char _hexDigits[] = "0123456789ABCDEF";
+static const unsigned long int _powersOf10[] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// FUNCTION PROTOTYPES (INTERNAL)----------------------------------------------
+static unsigned char FormatDecimalLength(unsigned long int magnitude, unsigned char decimals,
+										 bool isNegative, unsigned char width);
+static unsigned char FormatHexLength(unsigned long int value, unsigned char width);
+static void FormatSetCursor(FormatCursor* cursor, char* data, unsigned int capacity,
+							unsigned int start, unsigned char length);
+static void FormatEmit(FormatCursor* cursor, char ch);
+static void FormatRenderDecimal(FormatCursor* cursor, unsigned long int magnitude, unsigned char decimals,
+								bool isNegative, char pad);
+static void FormatRenderHex(FormatCursor* cursor, unsigned long int value);
+
+// CHARACTER ARRAY FUNCTIONS---------------------------------------------------
+
+/**
+ * Formats an unsigned integer
+ * @param dest	Destination character array
+ * @param value	Value to be formatted
+ * @param width	Minimum number of characters (the result is right-aligned)
+ * @param pad	Padding character (<b>'0'</b> or <b>' '</b>)
+ * @return		Number of characters written (not including the null terminator)
+ */
+unsigned char FormatUnsigned(char* dest, unsigned long int value, unsigned char width, char pad)
+{
+	unsigned char length = FormatDecimalLength(value, 0, false, width);
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, dest, length, 0, length);
+	FormatRenderDecimal(&cursor, value, 0, false, pad);
+	dest[length] = ASCII_NUL;
+	return length;
+}
+
+/**
+ * Formats a signed integer
+ * @param dest	Destination character array
+ * @param value	Value to be formatted
+ * @param width	Minimum number of characters (the result is right-aligned)
+ * @param pad	Padding character (<b>'0'</b> or <b>' '</b>)
+ * @return		Number of characters written (not including the null terminator)
+ */
+unsigned char FormatSigned(char* dest, long int value, unsigned char width, char pad)
+{
+	return FormatFixed(dest, value, 0, width, pad);
+}
+
+/**
+ * Formats a signed fixed-point number.
+ * For example, the value 1234 with 1 decimal is formatted as "123.4".
+ * @param dest		Destination character array
+ * @param value		Value to be formatted (scaled by 10^decimals)
+ * @param decimals	Number of digits after the decimal point (0 to <code>FORMAT_MAX_DECIMALS</code>)
+ * @param width		Minimum number of characters (the result is right-aligned)
+ * @param pad		Padding character (<b>'0'</b> or <b>' '</b>)
+ * @return			Number of characters written (not including the null terminator)
+ */
+unsigned char FormatFixed(char* dest, long int value, unsigned char decimals, unsigned char width, char pad)
+{
+	bool isNegative = value < 0;
+	unsigned long int magnitude = isNegative ? 0UL - (unsigned long int) value : (unsigned long int) value;
+	if(decimals > FORMAT_MAX_DECIMALS)
+		decimals = FORMAT_MAX_DECIMALS;
+
+	unsigned char length = FormatDecimalLength(magnitude, decimals, isNegative, width);
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, dest, length, 0, length);
+	FormatRenderDecimal(&cursor, magnitude, decimals, isNegative, pad);
+	dest[length] = ASCII_NUL;
+	return length;
+}
+
+/**
+ * Formats an unsigned integer in hexadecimal (upper case, without a prefix)
+ * @param dest	Destination character array
+ * @param value	Value to be formatted
+ * @param width	Minimum number of digits (the result is padded with zeros)
+ * @return		Number of characters written (not including the null terminator)
+ */
+unsigned char FormatHex(char* dest, unsigned long int value, unsigned char width)
+{
+	unsigned char length = FormatHexLength(value, width);
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, dest, length, 0, length);
+	FormatRenderHex(&cursor, value);
+	dest[length] = ASCII_NUL;
+	return length;
+}
+
+// COMMPORT FUNCTIONS----------------------------------------------------------
+
+/**
+ * Formats an unsigned integer directly into the TX buffer of a <b>CommPort</b>.
+ * Like every FormatPut function, the number is either written completely or dropped if it does not fit.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param value	Value to be formatted
+ * @param width	Minimum number of characters (the result is right-aligned)
+ * @param pad	Padding character (<b>'0'</b> or <b>' '</b>)
+ */
+void FormatPutUnsigned(CommPort* comm, unsigned long int value, unsigned char width, char pad)
+{
+	unsigned char length = FormatDecimalLength(value, 0, false, width);
+	volatile RingBuffer* tx = &comm->buffers.tx;
+	if(tx->capacity - tx->length < length)
+	{
+		comm->txCounters.dropped += length;
+		return;
+	}
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, (char*) tx->data, tx->capacity, tx->head, length);
+	FormatRenderDecimal(&cursor, value, 0, false, pad);
+	CommCommit(comm, length);
+}
+
+/**
+ * Formats a signed integer directly into the TX buffer of a <b>CommPort</b>
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param value	Value to be formatted
+ * @param width	Minimum number of characters (the result is right-aligned)
+ * @param pad	Padding character (<b>'0'</b> or <b>' '</b>)
+ */
+void FormatPutSigned(CommPort* comm, long int value, unsigned char width, char pad)
+{
+	FormatPutFixed(comm, value, 0, width, pad);
+}
+
+/**
+ * Formats a signed fixed-point number directly into the TX buffer of a <b>CommPort</b>
+ * @param comm		Pointer to the target <b>CommPort</b>
+ * @param value		Value to be formatted (scaled by 10^decimals)
+ * @param decimals	Number of digits after the decimal point (0 to <code>FORMAT_MAX_DECIMALS</code>)
+ * @param width		Minimum number of characters (the result is right-aligned)
+ * @param pad		Padding character (<b>'0'</b> or <b>' '</b>)
+ */
+void FormatPutFixed(CommPort* comm, long int value, unsigned char decimals, unsigned char width, char pad)
+{
+	bool isNegative = value < 0;
+	unsigned long int magnitude = isNegative ? 0UL - (unsigned long int) value : (unsigned long int) value;
+	if(decimals > FORMAT_MAX_DECIMALS)
+		decimals = FORMAT_MAX_DECIMALS;
+
+	unsigned char length = FormatDecimalLength(magnitude, decimals, isNegative, width);
+	volatile RingBuffer* tx = &comm->buffers.tx;
+	if(tx->capacity - tx->length < length)
+	{
+		comm->txCounters.dropped += length;
+		return;
+	}
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, (char*) tx->data, tx->capacity, tx->head, length);
+	FormatRenderDecimal(&cursor, magnitude, decimals, isNegative, pad);
+	CommCommit(comm, length);
+}
+
+/**
+ * Formats an unsigned integer in hexadecimal directly into the TX buffer of a <b>CommPort</b>
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param value	Value to be formatted
+ * @param width	Minimum number of digits (the result is padded with zeros)
+ */
+void FormatPutHex(CommPort* comm, unsigned long int value, unsigned char width)
+{
+	unsigned char length = FormatHexLength(value, width);
+	volatile RingBuffer* tx = &comm->buffers.tx;
+	if(tx->capacity - tx->length < length)
+	{
+		comm->txCounters.dropped += length;
+		return;
+	}
+	FormatCursor cursor;
+	FormatSetCursor(&cursor, (char*) tx->data, tx->capacity, tx->head, length);
+	FormatRenderHex(&cursor, value);
+	CommCommit(comm, length);
+}
+
+// INTERNAL FUNCTIONS----------------------------------------------------------
+
+/**
+ * Calculates the number of characters needed to format a decimal number
+ * @param magnitude		Absolute value of the number
+ * @param decimals		Number of digits after the decimal point
+ * @param isNegative	Indicates that a minus sign is needed
+ * @param width			Minimum number of characters
+ * @return				Number of characters (at most <code>FORMAT_MAX_LENGTH</code> when padded)
+ */
+static unsigned char FormatDecimalLength(unsigned long int magnitude, unsigned char decimals,
+										 bool isNegative, unsigned char width)
+{
+	unsigned char length = 1;
+	while(length < 10 && magnitude >= _powersOf10[length])
+		length++;
+	if(decimals)
+	{
+		if(length <= decimals)
+			length = decimals + 1;
+		length++;	// Decimal point
+	}
+	if(isNegative)
+		length++;
+
+	if(width > FORMAT_MAX_LENGTH)
+		width = FORMAT_MAX_LENGTH;
+	return length > width ? length : width;
+}
+
+/**
+ * Calculates the number of characters needed to format a hexadecimal number
+ * @param value	Value to be formatted
+ * @param width	Minimum number of digits
+ * @return		Number of characters (at most <code>FORMAT_MAX_LENGTH</code> when padded)
+ */
+static unsigned char FormatHexLength(unsigned long int value, unsigned char width)
+{
+	unsigned char length = 1;
+	while(length < 8 && (value >> (length << 2)))
+		length++;
+
+	if(width > FORMAT_MAX_LENGTH)
+		width = FORMAT_MAX_LENGTH;
+	return length > width ? length : width;
+}
+
+/**
+ * Positions a cursor at the last character of a result
+ * @param cursor	Pointer to the cursor to be positioned
+ * @param data		Destination characters
+ * @param capacity	Size of the destination (characters)
+ * @param start		Index of the first character of the result
+ * @param length	Number of characters in the result
+ */
+static void FormatSetCursor(FormatCursor* cursor, char* data, unsigned int capacity,
+							unsigned int start, unsigned char length)
+{
+	cursor->data = data;
+	cursor->capacity = capacity;
+	cursor->index = start + length - 1;
+	if(cursor->index >= capacity)
+		cursor->index -= capacity;
+	cursor->remaining = length;
+}
+
+/**
+ * Writes one character and moves the cursor towards the start of the destination
+ * @param cursor	Pointer to the write position
+ * @param ch		Character to be written
+ */
+static void FormatEmit(FormatCursor* cursor, char ch)
+{
+	cursor->data[cursor->index] = ch;
+	cursor->index = cursor->index ? cursor->index - 1 : cursor->capacity - 1;
+	cursor->remaining--;
+}
+
+/**
+ * Renders a decimal number from its least significant digit to its sign and padding.
+ * Digits are produced two at a time from a lookup table (one division by 100 per pair),
+ * using 16-bit division once the remaining value fits.
+ * @param cursor		Pointer to the write position (at the last character of the result)
+ * @param magnitude		Absolute value of the number
+ * @param decimals		Number of digits after the decimal point
+ * @param isNegative	Indicates that a minus sign is written
+ * @param pad			Padding character (<b>'0'</b> pads between the sign and the digits)
+ */
+static void FormatRenderDecimal(FormatCursor* cursor, unsigned long int magnitude, unsigned char decimals,
+								bool isNegative, char pad)
+{
+	unsigned char count = 0;
+	uint8_t pair;
+	char high = '0';
+	bool hasHigh = false;
+
+	// Digits (and decimal point)
+	while(true)
+	{
+		if(hasHigh)
+		{
+			FormatEmit(cursor, high);
+			hasHigh = false;
+		}
+		else
+		{
+			if(magnitude > 0xFFFF)
+			{
+				pair = (uint8_t) (magnitude % 100);
+				magnitude /= 100;
+			}
+			else
+			{
+				uint16_t value = (uint16_t) magnitude;
+				pair = (uint8_t) (value % 100);
+				magnitude = value / 100;
+			}
+			pair <<= 1;
+			FormatEmit(cursor, _digitPairs[pair + 1]);
+			high = _digitPairs[pair];
+			hasHigh = true;
+		}
+
+		count++;
+		if(count == decimals)
+			FormatEmit(cursor, '.');
+		if(magnitude == 0 && count > decimals && !(hasHigh && high != '0'))
+			break;
+	}
+
+	// Sign and padding
+	if(pad != '0')
+	{
+		if(isNegative)
+			FormatEmit(cursor, '-');
+		while(cursor->remaining)
+			FormatEmit(cursor, ' ');
+	}
+	else
+	{
+		while(cursor->remaining > (isNegative ? 1 : 0))
+			FormatEmit(cursor, '0');
+		if(isNegative)
+			FormatEmit(cursor, '-');
+	}
+}
+
+/**
+ * Renders a hexadecimal number from its least significant digit, then pads it with zeros
+ * @param cursor	Pointer to the write position (at the last character of the result)
+ * @param value		Value to be formatted
+ */
+static void FormatRenderHex(FormatCursor* cursor, unsigned long int value)
+{
+	do
+	{
+		FormatEmit(cursor, _hexDigits[value & 0xF]);
+		value >>= 4;
+	} while(value);
+
+	while(cursor->remaining)
+		FormatEmit(cursor, '0');
+}
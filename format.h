@@ -0,0 +1,32 @@
+/**@file		format.h
+ * @brief		Header file defining integer and fixed-point number formatting without floating point math.
+ *				Numbers are rendered least significant digit first (two digits at a time),
+ *				either into a character array or directly into the TX buffer of a <b>CommPort</b>.
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include "serial_comm.h"
+
+// DEFINITIONS-----------------------------------------------------------------
+#define FORMAT_MAX_LENGTH	16	/**< The maximum length (characters) of a formatted number, including sign, point, and padding */
+#define FORMAT_MAX_DECIMALS	4	/**< The maximum number of digits after the decimal point of a fixed-point number */
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+// Character array destination (the result is null-terminated, the destination must hold FORMAT_MAX_LENGTH + 1 characters)
+unsigned char FormatUnsigned(char* dest, unsigned long int value, unsigned char width, char pad);
+unsigned char FormatSigned(char* dest, long int value, unsigned char width, char pad);
+unsigned char FormatFixed(char* dest, long int value, unsigned char decimals, unsigned char width, char pad);
+unsigned char FormatHex(char* dest, unsigned long int value, unsigned char width);
+// CommPort destination (the result is written directly into the TX buffer, or dropped if it does not fit)
+void FormatPutUnsigned(CommPort* comm, unsigned long int value, unsigned char width, char pad);
+void FormatPutSigned(CommPort* comm, long int value, unsigned char width, char pad);
+void FormatPutFixed(CommPort* comm, long int value, unsigned char decimals, unsigned char width, char pad);
+void FormatPutHex(CommPort* comm, unsigned long int value, unsigned char width);
+
+#endif
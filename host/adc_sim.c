@@ -0,0 +1,909 @@
+/**@file		adc_sim.c
+ * @brief		Host simulation of the current sensor measurement: the ADC interrupt and CalculateCurrentRMS
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Synthetic load currents are converted as the current sensor and the ADC would (40 mV per amp around a 2.474 V bias,
+ * 3.3 V reference, 12 bits, with +/-1 step of noise) and fed sample by sample to isrHighPriority,
+ * at the default sample rate. Every window it hands over is processed by CalculateCurrentRMS (and TaskCalculateHarmonics),
+ * and the harness compares the result against the same samples run through the floating point RMS calculation
+ * it replaced, and against the RMS of the analog current over the same time. Some cases change the sample rate
+ * and the window length with ConfigureSampling, before the first sample or in the middle of a window.
+ */
+
+#include <xc.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "interrupt.h"
+#include "host.h"
+
+#define SIM_LINE_FREQUENCY	60.0	// Mains frequency (Hz)
+#define SIM_BIAS			2.474	// Zero-current output of the current sensor (V)
+#define SIM_WINDOWS			200		// Windows measured per case (after SIM_SETTLE_WINDOWS)
+#define SIM_SETTLE_WINDOWS	2		// Windows left out at the start of each case (the first starts at a random sample)
+#define SIM_MAX_SAMPLES		256		// Largest window the harness records
+#define SIM_DRIFT_WINDOWS	300		// Windows measured per drift case (60 s at 60 Hz)
+#define SIM_STEPS			32		// Integration steps per sample interval for the analog RMS
+
+/**
+ * Load current over one mains cycle, with an RMS of 1
+ */
+typedef struct SimWaveform
+{
+	const char* name;
+	double (*current)(double phase);	// Current at a phase of the mains cycle (0 - 1), before scaling
+	double scale;						// Factor which brings the RMS to 1 (calculated by the harness)
+	unsigned int maxLoad;				// Largest load (W) that does not clip at the ADC
+} SimWaveform;
+
+/**
+ * A load as seen by the ADC
+ */
+typedef struct SimSignal
+{
+	const SimWaveform* waveform;
+	double rms;							// RMS current (A)
+	double frequency;					// Mains frequency (Hz)
+	double phase;						// Phase at time 0 (cycles)
+	double bias;						// Sensor output at zero current at time 0 (V)
+	double drift;						// Change of the bias (V per second)
+} SimSignal;
+
+/**
+ * A window handed over by the ADC interrupt, with the raw samples it was accumulated from
+ */
+typedef struct SimWindow
+{
+	AdcWindow sums;						// Copy of the window before CalculateCurrentRMS
+	unsigned int samples[SIM_MAX_SAMPLES];
+	unsigned int count;
+	double start;						// Time of the first sample (s)
+	unsigned int load;					// Result of CalculateCurrentRMS (tenths of a watt)
+} SimWindow;
+
+typedef void (*SimHandler)(const SimSignal* signal, const SimWindow* window);
+
+static unsigned long _random = 12345;
+static unsigned int _failures;
+static volatile unsigned long _sink;
+static const AdcSampling* _sampling;			// Sampling configuration applied by Run (NULL for the default)
+static const AdcSampling* _change;				// Sampling configuration requested by Run in the middle of a case (NULL for none)
+static unsigned long _changeSample;				// Number of samples after which _change is requested
+static double _changeTime;						// Time at which _change was requested (s)
+static long long _goertzelPeak;				// Largest |coefficient * state| formed by the filters of MeasureHarmonics windows
+
+// Waveforms
+static double Sine(double phase)
+{
+	return sin(2 * M_PI * phase);
+}
+
+/**
+ * Switched-mode power supply: the rectifier only conducts around the peaks of the line voltage (crest factor about 3)
+ */
+static double Smps(double phase)
+{
+	double v = sin(2 * M_PI * phase);
+	double conduction = fabs(v) - 0.85;
+	return conduction > 0 ? (v > 0 ? conduction : -conduction) : 0;
+}
+
+/**
+ * Leading-edge dimmer at half brightness: each half cycle conducts from 90 degrees on
+ */
+static double Dimmer(double phase)
+{
+	double half = fmod(phase, 0.5);
+	return half >= 0.25 ? sin(2 * M_PI * phase) : 0;
+}
+
+static SimWaveform _waveforms[] = {
+	{"sine", Sine, 0, 1000},
+	{"SMPS", Smps, 0, 500},
+	{"dimmer", Dimmer, 0, 1000},
+};
+#define WAVEFORM_COUNT	(sizeof(_waveforms) / sizeof(_waveforms[0]))
+
+static const unsigned int _loads[] = {5, 20, 60, 150, 500, 1000};
+#define LOAD_COUNT		(sizeof(_loads) / sizeof(_loads[0]))
+
+static void NormalizeWaveforms(void)
+{
+	unsigned int i, n;
+	for(i = 0; i < WAVEFORM_COUNT; i++)
+	{
+		double sum = 0;
+		for(n = 0; n < 100000; n++)
+		{
+			double current = _waveforms[i].current((n + 0.5) / 100000);
+			sum += current * current;
+		}
+		_waveforms[i].scale = 1 / sqrt(sum / 100000);
+	}
+}
+
+static unsigned long Random(void)
+{
+	_random = _random * 1103515245 + 12345;
+	return (_random >> 16) & 0x7FFF;
+}
+
+static double Current(const SimSignal* signal, double time)
+{
+	double phase = signal->phase + signal->frequency * time;
+	return signal->rms * signal->waveform->scale * signal->waveform->current(phase - floor(phase));
+}
+
+/**
+ * Converts the sensor output at a point in time, as the ADC would (with +/-1 step of noise)
+ */
+static unsigned int Convert(const SimSignal* signal, double time)
+{
+	double volts = signal->bias + signal->drift * time + Current(signal, time) * (ADC_SENSITIVITY / 1000.0);
+	long steps = lround(volts * 4095 / (ADC_VREF / 1000.0)) + (long) (Random() % 3) - 1;
+	return steps < 0 ? 0 : (steps > 4095 ? 4095 : (unsigned int) steps);
+}
+
+/**
+ * RMS of the analog current over a window, as a load in tenths of a watt
+ */
+static double AnalogLoad(const SimSignal* signal, const SimWindow* window, double period)
+{
+	double sum = 0;
+	unsigned int n, count = window->count * SIM_STEPS;
+	for(n = 0; n < count; n++)
+	{
+		double current = Current(signal, window->start + (n + 0.5) * period / SIM_STEPS);
+		sum += current * current;
+	}
+	return sqrt(sum / count) * ADC_LINE_VOLTAGE * 10;
+}
+
+/**
+ * The floating point RMS calculation which CalculateCurrentRMS replaced, applied to the samples of a window
+ * (it used a fixed zero point and did not remove the DC component)
+ */
+static unsigned int FloatLoad(const SimWindow* window)
+{
+	unsigned int i;
+	double result = 0.0;
+	for(i = 0; i < window->count; i++)
+	{
+		double adjSample = ((window->samples[i] * 0.000805860806) - 2.474) / 0.04;
+		result += adjSample * adjSample;
+	}
+	result /= (double) window->count;
+	result = sqrt(result);
+	result *= 1200.0;
+	return result < 65535.0 ? (unsigned int) (result + 0.5) : 65535;
+}
+
+/**
+ * Samples a signal until a number of windows have been processed by CalculateCurrentRMS
+ * @param signal	The signal
+ * @param windows	Number of windows passed to the handler (after SIM_SETTLE_WINDOWS)
+ * @param handler	Called with every window
+ */
+static void Run(const SimSignal* signal, unsigned int windows, SimHandler handler)
+{
+	static SimWindow window;
+	unsigned int raw[SIM_MAX_SAMPLES];
+	unsigned int rawCount = 0, settle = SIM_SETTLE_WINDOWS;
+	unsigned long sample = 0;
+	double rawStart = 0, time = 0;
+	bool isChanging = false;
+
+	HostInitialize();
+	_changeTime = HUGE_VAL;
+	if(_sampling != NULL && !ConfigureSampling(_sampling))
+	{
+		printf("FAIL: ConfigureSampling rejected the configuration\n");
+		_failures++;
+		return;
+	}
+	for(; windows; sample++, time += _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0))
+	{
+		unsigned int value = Convert(signal, time);
+		ADRES = value;
+		PIR1bits.ADIF = true;
+		isrHighPriority();
+
+		// A requested change stays pending until the next window starts, and is applied to that window
+		if(isChanging)
+		{
+			volatile AdcWindow* active = &_adc.windows[_adc.active];
+			if(active->count != 1 && !_adc.isPending)
+			{
+				printf("FAIL: the sampling change was applied %u samples into a window\n", active->count);
+				_failures++;
+				isChanging = false;
+			}
+			else if(active->count == 1)
+			{
+				if(_adc.isPending || active->period != _adc.pendingPeriod || active->isSynchronized)
+				{
+					printf("FAIL: the sampling change was not applied at the start of a window\n");
+					_failures++;
+				}
+				isChanging = false;
+			}
+		}
+		if(_change != NULL && sample == _changeSample)
+		{
+			if(!ConfigureSampling(_change))
+			{
+				printf("FAIL: ConfigureSampling rejected the change\n");
+				_failures++;
+			}
+			isChanging = true;
+			_changeTime = time;
+		}
+
+		// A window count of 1 means this sample started a new window
+		if(_adc.windows[_adc.active].count == 1)
+		{
+			if(_adc.isReady && rawCount)
+			{
+				window.sums = *((const AdcWindow*) &_adc.windows[_adc.active ^ 1]);
+				memcpy(window.samples, raw, rawCount * sizeof(raw[0]));
+				window.count = rawCount;
+				window.start = rawStart;
+				window.load = CalculateCurrentRMS();
+#if ADC_HARMONIC_COUNT
+				// The window is held until its filters have run (the next window ends long after that)
+				while(_adc.isReady)
+					TaskCalculateHarmonics();
+#endif
+				if(window.count != window.sums.count)
+				{
+					printf("FAIL: the harness recorded %u samples of a window of %u\n", window.count, window.sums.count);
+					_failures++;
+				}
+				if(settle)
+					settle--;
+				else
+				{
+					handler(signal, &window);
+					windows--;
+				}
+			}
+			rawCount = 0;
+			rawStart = time;
+		}
+		if(rawCount < SIM_MAX_SAMPLES)
+			raw[rawCount++] = value;
+	}
+	if(_adc.overruns)
+	{
+		printf("FAIL: %u windows were discarded\n", _adc.overruns);
+		_failures++;
+	}
+}
+
+// RMS accuracy
+typedef struct RmsErrors
+{
+	double sumFloat, maxFloat;			// Integer vs floating point (%)
+	double sumTrue, maxTrue;			// Integer vs analog (%)
+	double sumFloatTrue, maxFloatTrue;	// Floating point vs analog (%)
+	unsigned int windows, synchronized;
+} RmsErrors;
+
+static RmsErrors _errors;
+
+static void AddError(double* sum, double* max, double value, double reference)
+{
+	double error = fabs(value - reference) * 100 / reference;
+	*sum += error;
+	if(error > *max)
+		*max = error;
+}
+
+static void MeasureRms(const SimSignal* signal, const SimWindow* window)
+{
+	double period = _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0);
+	double analog = AnalogLoad(signal, window, period);
+	unsigned int floating = FloatLoad(window);
+	AddError(&_errors.sumFloat, &_errors.maxFloat, window->load, floating);
+	AddError(&_errors.sumTrue, &_errors.maxTrue, window->load, analog);
+	AddError(&_errors.sumFloatTrue, &_errors.maxFloatTrue, floating, analog);
+	_errors.windows++;
+	if(window->sums.isSynchronized)
+		_errors.synchronized++;
+}
+
+static void TestRmsAccuracy(void)
+{
+	unsigned int w, l;
+	printf("RMS: integer (CalculateCurrentRMS) vs floating point over the same samples, and both vs the analog RMS\n");
+	printf("  %u windows per case, 60 Hz, +/-1 step of noise; errors in %% (mean / max)\n", SIM_WINDOWS);
+	printf("  waveform  load   sync    int vs float      int vs analog   float vs analog\n");
+	for(w = 0; w < WAVEFORM_COUNT; w++)
+	{
+		for(l = 0; l < LOAD_COUNT && _loads[l] <= _waveforms[w].maxLoad; l++)
+		{
+			SimSignal signal = {&_waveforms[w], _loads[l] / (double) ADC_LINE_VOLTAGE, SIM_LINE_FREQUENCY,
+								Random() / 32768.0, SIM_BIAS, 0};
+			memset(&_errors, 0, sizeof(_errors));
+			Run(&signal, SIM_WINDOWS, MeasureRms);
+			printf("  %-8s %4u W %5u   %5.2f / %5.2f    %5.2f / %5.2f    %5.2f / %5.2f\n", _waveforms[w].name,
+				   _loads[l], _errors.synchronized,
+				   _errors.sumFloat / _errors.windows, _errors.maxFloat,
+				   _errors.sumTrue / _errors.windows, _errors.maxTrue,
+				   _errors.sumFloatTrue / _errors.windows, _errors.maxFloatTrue);
+
+			// Above 5 W (about 2 steps RMS), the integer result must stay within 0.1 W or 0.25% of the floating point result
+			if(_loads[l] >= 20 && _errors.maxFloat > (_loads[l] < 60 ? 1.0 : 0.25))
+			{
+				printf("FAIL: %s at %u W, the integer RMS is %.2f%% from the floating point RMS\n",
+					   _waveforms[w].name, _loads[l], _errors.maxFloat);
+				_failures++;
+			}
+		}
+	}
+}
+
+/**
+ * A sensor whose zero-current output is off by +/-15 mV (about 19 steps): the floating point calculation used a fixed
+ * zero point, while the integer one removes the mean of each window
+ */
+static void TestRmsOffset(void)
+{
+	static const int offsets[] = {-15, 15};
+	unsigned int o, l;
+	printf("RMS with the sensor zero point off by 15 mV (sine); errors vs the analog RMS in %% (mean / max)\n");
+	printf("  offset  load    integer           floating point\n");
+	for(o = 0; o < 2; o++)
+	{
+		for(l = 1; l < 4; l++)
+		{
+			SimSignal signal = {&_waveforms[0], _loads[l] / (double) ADC_LINE_VOLTAGE, SIM_LINE_FREQUENCY,
+								Random() / 32768.0, SIM_BIAS + offsets[o] / 1000.0, 0};
+			memset(&_errors, 0, sizeof(_errors));
+			Run(&signal, SIM_WINDOWS, MeasureRms);
+			printf("  %+3d mV %4u W   %6.2f / %6.2f   %6.2f / %6.2f\n", offsets[o], _loads[l],
+				   _errors.sumTrue / _errors.windows, _errors.maxTrue,
+				   _errors.sumFloatTrue / _errors.windows, _errors.maxFloatTrue);
+			if(_errors.maxTrue > 5)
+			{
+				printf("FAIL: %+d mV at %u W, the integer RMS is %.2f%% from the analog RMS\n",
+					   offsets[o], _loads[l], _errors.maxTrue);
+				_failures++;
+			}
+		}
+	}
+}
+
+// DC tracking
+typedef struct DriftResults
+{
+	bool isTracking;					// false resets the DC tracker after every window (a fixed ADC_DC_OFFSET)
+	unsigned int windows, synchronized;
+	unsigned int minFrequency, maxFrequency;
+	double maxLag;						// Largest distance of the offset in use from the sensor bias (steps)
+	double sumError, maxError;			// Integer RMS vs analog (%)
+} DriftResults;
+
+static DriftResults _drift;
+
+static void MeasureDrift(const SimSignal* signal, const SimWindow* window)
+{
+	double period = _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0);
+	double bias = (signal->bias + signal->drift * (window->start + window->count * period / 2)) * 4095 / (ADC_VREF / 1000.0);
+	double lag = fabs(window->sums.offset - bias);
+	if(lag > _drift.maxLag)
+		_drift.maxLag = lag;
+	AddError(&_drift.sumError, &_drift.maxError, window->load, AnalogLoad(signal, window, period));
+	_drift.windows++;
+	if(window->sums.isSynchronized)
+	{
+		_drift.synchronized++;
+		if(_adc.frequency < _drift.minFrequency)
+			_drift.minFrequency = _adc.frequency;
+		if(_adc.frequency > _drift.maxFrequency)
+			_drift.maxFrequency = _adc.frequency;
+	}
+	if(!_drift.isTracking)
+	{
+		_adc.dcLevel = (long int) ADC_DC_OFFSET << 8;
+		_adc.dcOffset = ADC_DC_OFFSET;
+	}
+}
+
+/**
+ * A sensor bias which drifts 50 mV per minute (62 steps) in either direction, with the DC tracker and without it
+ */
+static void TestDcDrift(void)
+{
+	static const int drifts[] = {50, -50};
+	static const unsigned int loads[] = {30, 100};
+	unsigned int d, l, t;
+	printf("DC tracking: the sensor bias drifts 50 mV per minute (sine, 60 Hz, %u windows, about 60 s)\n", SIM_DRIFT_WINDOWS);
+	printf("  drift        load  DC offset   sync   line frequency (Hz)  offset lag   vs analog (%% mean / max)\n");
+	for(d = 0; d < 2; d++)
+	{
+		for(l = 0; l < 2; l++)
+		{
+			for(t = 0; t < 2; t++)
+			{
+				SimSignal signal = {&_waveforms[0], loads[l] / (double) ADC_LINE_VOLTAGE, SIM_LINE_FREQUENCY,
+									Random() / 32768.0, SIM_BIAS, drifts[d] / 60000.0};
+				memset(&_drift, 0, sizeof(_drift));
+				_drift.isTracking = t;
+				_drift.minFrequency = 65535;
+				Run(&signal, SIM_DRIFT_WINDOWS, MeasureDrift);
+				printf("  %+3d mV/min %4u W  %-9s %4u   ", drifts[d], loads[l], t ? "tracked" : "fixed", _drift.synchronized);
+				if(_drift.synchronized)
+					printf("%6.2f - %6.2f     ", _drift.minFrequency / 100.0, _drift.maxFrequency / 100.0);
+				else
+					printf("      -             ");
+				printf("%5.1f steps   %5.2f / %5.2f\n", _drift.maxLag, _drift.sumError / _drift.windows, _drift.maxError);
+
+				// With the tracker, every window must stay synchronized and measure the line within 0.5 Hz
+				if(t && (_drift.synchronized != _drift.windows
+				|| _drift.minFrequency < 5950 || _drift.maxFrequency > 6050))
+				{
+					printf("FAIL: %+d mV/min at %u W, %u of %u windows synchronized\n", drifts[d], loads[l],
+						   _drift.synchronized, _drift.windows);
+					_failures++;
+				}
+			}
+		}
+	}
+}
+
+// Sampling changes
+typedef struct ChangeResults
+{
+	const AdcSampling* from;
+	unsigned long fromPeriod, toPeriod;	// Sample periods before and after the change (instruction cycles)
+	unsigned int before, after;			// Windows sampled before and after the change
+	unsigned int synchronized;			// Windows after the change which cover exactly the new number of mains cycles
+	unsigned int minFrequency, maxFrequency;
+	double nextStart;					// Time at which the next window must start (s)
+	double sumError, maxError;			// Integer RMS vs analog (%)
+} ChangeResults;
+
+static ChangeResults _changeResults;
+
+/**
+ * Checks that every window was sampled with one configuration throughout: the one before the change if it started
+ * before the request, the new one otherwise, and that no samples were lost or added between the windows
+ */
+static void MeasureChange(const SimSignal* signal, const SimWindow* window)
+{
+	ChangeResults* results = &_changeResults;
+	double period = window->sums.period / (ADC_CYCLE_CLOCK / 100.0);
+
+	if(results->before + results->after && fabs(window->start - results->nextStart) > period / 100)
+	{
+		printf("FAIL: a window starts at %.6f s instead of %.6f s\n", window->start, results->nextStart);
+		_failures++;
+	}
+	results->nextStart = window->start + window->count * period;
+	AddError(&results->sumError, &results->maxError, window->load, AnalogLoad(signal, window, period));
+
+	if(window->start < _changeTime)
+	{
+		if(window->sums.period != results->fromPeriod || window->count > results->from->windowSize)
+		{
+			printf("FAIL: window %u before the change has a period of %lu and %u samples\n", results->before,
+				   (unsigned long) window->sums.period, window->count);
+			_failures++;
+		}
+		results->before++;
+		return;
+	}
+
+	// The zero crossings of the first window are not used (its first sample interval may be the old one)
+	if(window->sums.period != results->toPeriod || window->count > _change->windowSize
+	|| (results->after == 0 && window->sums.isSynchronized))
+	{
+		printf("FAIL: window %u after the change has a period of %lu, %u samples, and is %ssynchronized\n",
+			   results->after, (unsigned long) window->sums.period, window->count, window->sums.isSynchronized ? "" : "not ");
+		_failures++;
+	}
+	if(window->sums.isSynchronized && window->sums.cycles == _change->windowCycles)
+	{
+		results->synchronized++;
+		if(_adc.frequency < results->minFrequency)
+			results->minFrequency = _adc.frequency;
+		if(_adc.frequency > results->maxFrequency)
+			results->maxFrequency = _adc.frequency;
+	}
+	results->after++;
+}
+
+/**
+ * Changes the sample rate and the window length in the middle of a window (as #sample or the line tracking would),
+ * and checks that the change waits for the start of the next window
+ */
+static void TestSamplingChange(void)
+{
+	static const AdcSampling standard = {ADC_TIMER_PRESCALE, ADC_TIMER_POSTSCALE, ADC_TIMER_PERIOD, ADC_WINDOW_CYCLES,
+										 ADC_WINDOW_SIZE};
+	static const AdcSampling fastest = {16, 5, 124, 6, 160};	// 1200 Hz, 6 cycles
+	static const AdcSampling faster = {16, 5, 186, 12, 200};		// 802 Hz, 12 cycles
+	static const AdcSampling shorter = {ADC_TIMER_PRESCALE, ADC_TIMER_POSTSCALE, ADC_TIMER_PERIOD, 4, 80};
+	static const struct
+	{
+		const char* name;
+		const AdcSampling* from;
+		const AdcSampling* to;
+	} cases[] = {
+		{"default -> 1200 Hz, 6 cycles", &standard, &fastest},
+		{"1200 Hz, 6 cycles -> default", &fastest, &standard},
+		{"default -> 802 Hz, 12 cycles", &standard, &faster},
+		{"default -> 4 cycles", &standard, &shorter},
+		{"4 cycles -> default", &shorter, &standard},
+	};
+	static const double frequencies[] = {49.95, 60.05};
+	unsigned int c, f;
+
+	printf("Sampling changes: ConfigureSampling in the middle of a window (sine, 500 W, 40 windows per case);\n");
+	printf("  the change must wait for the next window, and every window must use a single configuration\n");
+	printf("  change                         line      before after  sync   line frequency (Hz)  vs analog (%% mean / max)\n");
+	for(c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+	{
+		for(f = 0; f < 2; f++)
+		{
+			ChangeResults* results = &_changeResults;
+			SimSignal signal = {&_waveforms[0], 500.0 / ADC_LINE_VOLTAGE, frequencies[f], Random() / 32768.0, SIM_BIAS, 0};
+			memset(results, 0, sizeof(*results));
+			results->from = cases[c].from;
+			results->fromPeriod = CalculateSamplePeriod(cases[c].from->prescale, cases[c].from->postscale,
+														cases[c].from->period);
+			results->toPeriod = CalculateSamplePeriod(cases[c].to->prescale, cases[c].to->postscale, cases[c].to->period);
+			results->minFrequency = 65535;
+
+			// The change is requested at a random sample of the 10th to 12th window
+			_sampling = cases[c].from;
+			_change = cases[c].to;
+			_changeSample = (unsigned long) (9 + SIM_SETTLE_WINDOWS) * cases[c].from->windowCycles
+							* CalculateSampleRate(results->fromPeriod) / (unsigned long) (frequencies[f] * 100)
+							+ Random() % (2 * cases[c].from->windowCycles * 12);
+			Run(&signal, 40, MeasureChange);
+			_sampling = NULL;
+			_change = NULL;
+
+			printf("  %-30s %5.2f Hz  %6u %5u  %4u   %6.2f - %6.2f      %5.2f / %5.2f\n", cases[c].name, frequencies[f],
+				   results->before, results->after, results->synchronized, results->minFrequency / 100.0,
+				   results->maxFrequency / 100.0, results->sumError / (results->before + results->after), results->maxError);
+
+			// Every window after the first new one must be synchronized, measure the line within 0.5 Hz,
+			// and stay within 1% of the analog RMS
+			if(results->before == 0 || results->after < 2 || results->synchronized != results->after - 1
+			|| abs((int) results->minFrequency - (int) (frequencies[f] * 100)) > 50
+			|| abs((int) results->maxFrequency - (int) (frequencies[f] * 100)) > 50 || results->maxError > 1)
+			{
+				printf("FAIL: %s at %.2f Hz\n", cases[c].name, frequencies[f]);
+				_failures++;
+			}
+		}
+	}
+}
+
+#if ADC_HARMONIC_COUNT
+// Harmonics
+static double _harmonicAmplitudes[4];	// Peak amplitude of the fundamental and the 3rd, 5th, and 7th harmonic
+static double _harmonicPhases[4];
+
+static double Harmonics(double phase)
+{
+	unsigned int i;
+	double current = 0;
+	for(i = 0; i < 4; i++)
+		current += _harmonicAmplitudes[i] * sin(2 * M_PI * (2 * i + 1) * phase + _harmonicPhases[i]);
+	return current;
+}
+
+static SimWaveform _harmonicWaveform = {"harmonics", Harmonics, 0, 1000};
+
+/**
+ * Sets the amplitudes of the harmonics relative to the fundamental, with random phases
+ */
+static void SetHarmonics(double third, double fifth, double seventh)
+{
+	unsigned int i;
+	double sum = 0;
+	_harmonicAmplitudes[0] = 1;
+	_harmonicAmplitudes[1] = third;
+	_harmonicAmplitudes[2] = fifth;
+	_harmonicAmplitudes[3] = seventh;
+	for(i = 0; i < 4; i++)
+	{
+		_harmonicPhases[i] = i ? 2 * M_PI * Random() / 32768.0 : 0;
+		sum += _harmonicAmplitudes[i] * _harmonicAmplitudes[i] / 2;
+	}
+	_harmonicWaveform.scale = 1 / sqrt(sum);
+}
+
+typedef struct HarmonicResults
+{
+	unsigned int windows, analyzed, filters;
+	unsigned char inputShift;				// Largest input shift used
+	double maxDft[ADC_HARMONIC_COUNT];		// Largest distance of the integer RMS from the DFT (% of the fundamental)
+	double maxNominal[ADC_HARMONIC_COUNT];	// Largest distance of the integer RMS from the nominal RMS (% of the fundamental)
+	double maxTone;							// Largest distance of a coefficient from the harmonic it is meant for (Hz)
+	double thdNominal;						// Nominal THD over the analyzed harmonics (%)
+	double thdMin, thdMax;					// Range of the measured THD (%)
+} HarmonicResults;
+
+static HarmonicResults _harmonicResults;
+
+/**
+ * Compares the harmonics CalculateHarmonics obtained from the integer Goertzel filters of a window
+ * with a floating point DFT of the same samples, at the frequencies the coefficients stand for
+ */
+static void MeasureHarmonics(const SimSignal* signal, const SimWindow* window)
+{
+	HarmonicResults* results = &_harmonicResults;
+	double period = _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0);
+	double stepsPerAmp = (ADC_SENSITIVITY / 1000.0) * 4095 / (ADC_VREF / 1000.0);
+	double fundamental = signal->rms * signal->waveform->scale * _harmonicAmplitudes[0] / sqrt(2) * stepsPerAmp;
+	double harmonicSquares = 0;
+	unsigned int i, n;
+
+	results->windows++;
+	if(!window->sums.isSynchronized || window->sums.harmonicCount == 0)
+		return;
+	results->analyzed++;
+	results->filters = window->sums.harmonicCount;
+	if(window->sums.inputShift > results->inputShift)
+		results->inputShift = window->sums.inputShift;
+	for(i = 0; i < window->sums.harmonicCount; i++)
+	{
+		// DFT term at the angle the coefficient (2cos(w)) stands for
+		double angle = acos(window->sums.coefficients[i] / (2.0 * (1 << ADC_GOERTZEL_SHIFT)));
+		double re = 0, im = 0;
+		for(n = 0; n < window->count; n++)
+		{
+			double sample = (double) window->samples[n] - window->sums.offset;
+			re += sample * cos(angle * n);
+			im -= sample * sin(angle * n);
+		}
+		double dft = sqrt(2 * (re * re + im * im)) / window->count;
+		double nominal = fundamental * _harmonicAmplitudes[i];
+		double measured = _adc.harmonics[i] / 16.0;
+		double tone = fabs(angle / (2 * M_PI * period) - (2 * i + 1) * signal->frequency);
+
+		// Largest product of the coefficient and a filter state, which must fit in 32 bits
+		long long s1 = 0, s2 = 0;
+		for(n = 0; n < window->count; n++)
+		{
+			long long product = llabs((long long) window->sums.coefficients[i] * s1), state;
+			if(product > _goertzelPeak)
+				_goertzelPeak = product;
+			state = (((int) window->samples[n] - window->sums.offset) >> window->sums.inputShift)
+					+ ((window->sums.coefficients[i] * s1) >> ADC_GOERTZEL_SHIFT) - s2;
+			s2 = s1;
+			s1 = state;
+		}
+
+		if(fabs(measured - dft) * 100 / fundamental > results->maxDft[i])
+			results->maxDft[i] = fabs(measured - dft) * 100 / fundamental;
+		if(fabs(measured - nominal) * 100 / fundamental > results->maxNominal[i])
+			results->maxNominal[i] = fabs(measured - nominal) * 100 / fundamental;
+		if(tone > results->maxTone)
+			results->maxTone = tone;
+		if(i)
+			harmonicSquares += _harmonicAmplitudes[i] * _harmonicAmplitudes[i];
+	}
+	results->thdNominal = sqrt(harmonicSquares) * 100;
+	if(_adc.distortion / 10.0 < results->thdMin)
+		results->thdMin = _adc.distortion / 10.0;
+	if(_adc.distortion / 10.0 > results->thdMax)
+		results->thdMax = _adc.distortion / 10.0;
+}
+
+/**
+ * Runs a harmonic signal and prints how the integer filters compare with the DFT and with the nominal content
+ */
+static void RunHarmonics(const char* name, double frequency, unsigned int load, unsigned int windows)
+{
+	HarmonicResults* results = &_harmonicResults;
+	SimSignal signal = {&_harmonicWaveform, load / (double) ADC_LINE_VOLTAGE, frequency, Random() / 32768.0, SIM_BIAS, 0};
+	unsigned int i;
+	memset(results, 0, sizeof(*results));
+	results->thdMin = 1e9;
+	_goertzelPeak = 0;
+	Run(&signal, windows, MeasureHarmonics);
+
+	printf("  %-9s %5.2f Hz %4u W %4u %u  ", name, frequency, load, results->analyzed, results->filters);
+	for(i = 0; i < ADC_HARMONIC_COUNT; i++)
+		printf(i < results->filters ? " %5.2f" : "     -", results->maxDft[i]);
+	printf("  ");
+	for(i = 0; i < ADC_HARMONIC_COUNT; i++)
+		printf(i < results->filters ? " %5.2f" : "     -", results->maxNominal[i]);
+	printf("  %5.1f %5.1f-%5.1f  %5.3f  %5u  %5.1f\n", results->thdNominal, results->thdMin, results->thdMax,
+		   results->maxTone, results->inputShift, log2((double) 0x7FFFFFFF / _goertzelPeak));
+
+	// The filters are integer versions of the DFT, so they must agree with it within 0.5% of the fundamental
+	// (the coefficients are quantized to 1/2^ADC_GOERTZEL_SHIFT), and the products must fit in 32 bits
+	for(i = 0; i < results->filters; i++)
+	{
+		if(results->maxDft[i] > 0.5)
+		{
+			printf("FAIL: %s at %.2f Hz, filter %u is %.2f%% (of the fundamental) from the DFT\n", name, frequency, i,
+				   results->maxDft[i]);
+			_failures++;
+		}
+	}
+	if(results->analyzed < windows / 2 || _goertzelPeak > 0x7FFFFFFF)
+	{
+		printf("FAIL: %s at %.2f Hz, %u of %u windows analyzed, largest product %lld\n", name, frequency,
+			   results->analyzed, windows, _goertzelPeak);
+		_failures++;
+	}
+}
+
+static void TestHarmonics(void)
+{
+	static const AdcSampling fastest = {16, 5, 124, 6, 160};	// 1200 Hz, 6 cycles (up to 144 samples at 50 Hz)
+	static const double frequencies[] = {49.95, 60.05};
+	static const unsigned int loads[] = {100, 500, 1000};
+	unsigned int f, l;
+
+	printf("Harmonics: integer Goertzel filters (TaskCalculateHarmonics, CalculateHarmonics) vs a floating point DFT\n");
+	printf("  of the same samples at the coefficient frequencies, and vs the nominal content; 3rd 30%%, 5th 15%%, 7th 8%%\n");
+	printf("  Errors are the largest over %u windows, in %% of the fundamental. Headroom: bits left above the largest\n",
+		   SIM_WINDOWS);
+	printf("  |coefficient * state| in the filters, within 32 bits\n");
+	printf("  sampling  line       load  win f  int vs DFT (h1 h3 h5)  vs nominal (h1 h3 h5)  THD   measured  tone Hz  shift  headroom\n");
+	for(f = 0; f < 2; f++)
+	{
+		for(l = 0; l < 3; l++)
+		{
+			SetHarmonics(0.30, 0.15, 0.08);
+			RunHarmonics("default", frequencies[f], loads[l], SIM_WINDOWS);
+		}
+	}
+	_sampling = &fastest;
+	for(f = 0; f < 2; f++)
+	{
+		SetHarmonics(0.30, 0.15, 0.08);
+		RunHarmonics("1200 Hz", frequencies[f], 1000, SIM_WINDOWS);
+	}
+
+	// Overload: a sine of 35 A peak, clipped at 4095 steps (+1025 from the bias) and almost down to 0 (-3070).
+	// Its fundamental is about the largest the filters can see before the input is taken as floating
+	SetHarmonics(0, 0, 0);
+	for(f = 0; f < 2; f++)
+	{
+		_sampling = NULL;
+		RunHarmonics("default", frequencies[f], 3000, SIM_WINDOWS / 4);
+		_sampling = &fastest;
+		RunHarmonics("1200 Hz", frequencies[f], 3000, SIM_WINDOWS / 4);
+	}
+	_sampling = NULL;
+}
+
+/**
+ * Host time of the ADC interrupt for a current sensor sample, and of the Goertzel filters over a window
+ * (TaskCalculateHarmonics), which the ADC interrupt ran sample by sample before
+ */
+static void TestHarmonicsCost(void)
+{
+	static unsigned int values[1200];
+	unsigned int i, run, rounds = 1000000, windows = 20000, count = 0;
+	double isr = 1e9, filters = 1e9;
+	struct timespec t0, t1;
+	SimSignal signal = {&_waveforms[0], 500.0 / ADC_LINE_VOLTAGE, SIM_LINE_FREQUENCY, 0, SIM_BIAS, 0};
+
+	HostInitialize();
+	for(i = 0; i < 1200; i++)
+		values[i] = Convert(&signal, i * _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0));
+	CalculateGoertzelCoefficients(6000);
+
+	// Best of 5 runs
+	for(run = 0; run < 5; run++)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for(i = 0; i < rounds; i++)
+		{
+			ADRES = values[i % 1200];
+			PIR1bits.ADIF = true;
+			isrHighPriority();
+			_adc.isReady = false;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		double time = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / rounds;
+		if(time < isr)
+			isr = time;
+	}
+
+	// The window the last run handed over, held for its filters over and over
+	AdcWindow window = *((const AdcWindow*) &_adc.windows[_adc.active ^ 1]);
+	for(run = 0; run < 5; run++)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for(i = 0; i < windows; i++)
+		{
+			_adc.windows[_adc.active ^ 1] = window;
+			_adc.isReady = true;
+			_adc.isHarmonicsPending = true;
+			for(count = 0; _adc.isReady; count++)
+				TaskCalculateHarmonics();
+		}
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		double time = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / windows;
+		if(time < filters)
+			filters = time;
+	}
+	printf("Harmonic analysis cost (host, best of 5)\n");
+	printf("  ADC interrupt per current sensor sample                %5.1f ns\n", isr);
+	printf("  TaskCalculateHarmonics per window of %u samples, %u filters in %u runs  %7.0f ns  (%.1f ns per sample)\n",
+		   window.count, window.harmonicCount, count, filters, filters / window.count);
+}
+#endif
+
+// Cost
+static void TestRmsCost(void)
+{
+	static SimWindow window;
+	unsigned int i, n, rounds = 200000;
+	struct timespec t0, t1, t2;
+	SimSignal signal = {&_waveforms[0], 500.0 / ADC_LINE_VOLTAGE, SIM_LINE_FREQUENCY, 0, SIM_BIAS, 0};
+
+	// One window of samples, accumulated by the ADC interrupt
+	HostInitialize();
+	for(n = 0; n < 4 * SIM_MAX_SAMPLES && !_adc.isReady; n++)
+	{
+		window.samples[window.count = n % SIM_MAX_SAMPLES] = Convert(&signal, n * _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0));
+		ADRES = window.samples[window.count];
+		PIR1bits.ADIF = true;
+		isrHighPriority();
+	}
+	AdcWindow sums = *((const AdcWindow*) &_adc.windows[_adc.active ^ 1]);
+	window.count = sums.count;
+	for(i = 0; i < window.count; i++)
+		window.samples[i] = Convert(&signal, i * _adc.samplePeriod / (ADC_CYCLE_CLOCK / 100.0));
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(i = 0; i < rounds; i++)
+	{
+		_adc.windows[_adc.active ^ 1] = sums;
+		_adc.isReady = true;
+#if ADC_HARMONIC_COUNT
+		_adc.isHarmonicsPending = false;
+#endif
+		_sink += CalculateCurrentRMS();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	for(i = 0; i < rounds; i++)
+	{
+		window.samples[i % window.count] ^= 1;
+		_sink += FloatLoad(&window);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	double integer = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / rounds;
+	double floating = ((t2.tv_sec - t1.tv_sec) * 1e9 + (t2.tv_nsec - t1.tv_nsec)) / rounds;
+	printf("Per window of %u samples (host, hardware floating point)\n", window.count);
+	printf("  floating point: %u conversions, %u multiplies, %u adds and subtracts, %u divides, 1 sqrt  %7.0f ns\n",
+		   window.count, 2 * window.count + 1, 2 * window.count, window.count + 1, floating);
+	printf("  CalculateCurrentRMS (whole window, with line frequency and DC tracker)                %7.0f ns\n", integer);
+}
+
+int main(void)
+{
+	NormalizeWaveforms();
+	TestRmsAccuracy();
+	TestRmsOffset();
+	TestDcDrift();
+#if ADC_HARMONIC_COUNT
+	TestHarmonics();
+#endif
+	TestSamplingChange();
+	TestRmsCost();
+#if ADC_HARMONIC_COUNT
+	TestHarmonicsCost();
+#endif
+	return _failures ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+/**@file		capture_test.c
+ * @brief		Host test: the uplink of a stored transient capture through SRAM timeouts and a full uplink queue
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * A capture is handed to TaskStoreCapture, which stores it in SRAM and adds TaskUplinkCapture, and UpdateShell
+ * runs both tasks as in the firmware. Before some runs of TaskUplinkCapture, one of the SramWait calls of the run
+ * times out (either of its own two, or either of the two in WifiQueueRecord), or the uplink queue is full.
+ * The queue is then emptied as the ESP8266 would send it. The test checks that each failed run is retried
+ * with the same part of the capture, and that the batches hold every part exactly once, in order, with the samples
+ * of the capture, oldest first.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "sram.h"
+#include "telemetry.h"
+#include "wifi.h"
+#include "host.h"
+
+#define PARTS			(ADC_CAPTURE_SIZE / 16)
+#define PAIRS			(ADC_CAPTURE_SIZE / 2)
+#define CAPTURE_INDEX	200		// Samples recorded (the oldest sample is at CAPTURE_INDEX & (ADC_CAPTURE_SIZE - 1))
+
+// Fault injected before a run of TaskUplinkCapture
+#define FAULT_NONE		0
+#define FAULT_SRAM		1		// SramWait call number 'passes' of the run times out
+#define FAULT_FULL		2		// The uplink queue is full for 'runs' runs
+
+typedef struct Fault
+{
+	const char* name;
+	unsigned char type;
+	unsigned char passes;
+	unsigned char runs;
+} Fault;
+
+extern Task _taskListData[];
+extern WifiInfo _wifi;
+
+static const Fault _faults[PARTS] = {
+	{"none", FAULT_NONE},
+	{"SRAM read start", FAULT_SRAM, 0, 1},
+	{"SRAM read end", FAULT_SRAM, 1, 1},
+	{"uplink queue full", FAULT_FULL, 0, 3},
+	{"queue write start", FAULT_SRAM, 2, 1},
+	{"queue write end", FAULT_SRAM, 3, 1},
+	{"two timeouts in a row", FAULT_SRAM, 0, 2},
+	{"none", FAULT_NONE}
+};
+
+static int _expected[ADC_CAPTURE_SIZE];	// The capture, oldest sample first
+static unsigned int _nextPair;
+static unsigned int _peaks;
+static unsigned int _failures;
+
+static void Check(bool condition, const char* message)
+{
+	if(!condition)
+	{
+		printf("FAIL: %s\n", message);
+		_failures++;
+	}
+}
+
+static LinkedListNode* FindTask(B_Action action)
+{
+	LinkedListNode* node;
+	for(node = _shell.task.list.first; node; node = node->next)
+	{
+		if(((Task*) node->data)->action == action)
+			return node;
+	}
+	return NULL;
+}
+
+// Runs UpdateShell until the task has had one run, and returns its remaining runs (0 once it has been removed)
+static unsigned int RunTask(B_Action action)
+{
+	LinkedListNode* node;
+	bool isCurrent;
+	do
+	{
+		node = FindTask(action);
+		if(node == NULL)
+			return 0;
+		isCurrent = (_shell.task.current ? _shell.task.current : _shell.task.list.first) == node;
+		UpdateShell();
+	}
+	while(!isCurrent);
+	return ((Task*) node->data)->runsRemaining;
+}
+
+// Checks the capture parts in a batch of the uplink queue
+static void ReadBatch(unsigned char batch)
+{
+	const uint8_t* data = &_hostSram[SRAM_ADDR_UPLINK_QUEUE + (unsigned long) batch * WIFI_UPLINK_BATCH_SIZE];
+	uint16_t offset = 0, length = _wifi.uplink.length[batch];
+	TelemetryRecord record;
+	char message[96];
+	uint8_t i;
+
+	while(offset < length)
+	{
+		int16_t result = TelemetryDecodeRecord(data + offset, length - offset, &record);
+		if(result <= 0)
+		{
+			sprintf(message, "batch %u does not decode at offset %u", batch, offset);
+			Check(false, message);
+			return;
+		}
+		offset += result;
+
+		for(i = 0; i < record.readingCount; i++)
+		{
+			uint32_t value = (uint32_t) record.readings[i].value;
+			if(record.readings[i].tag == TELEMETRY_TAG_CAPTURE)
+				_peaks++;
+			if(record.readings[i].tag != TELEMETRY_TAG_CAPTURE_DATA)
+				continue;
+
+			unsigned int pair = value >> 26;
+			int first = (int) ((value >> 13) & 0x1FFF), second = (int) (value & 0x1FFF);
+			if(first & 0x1000)
+				first -= 0x2000;
+			if(second & 0x1000)
+				second -= 0x2000;
+			sprintf(message, "pair %u was uplinked where pair %u was expected", pair, _nextPair);
+			Check(pair == _nextPair, message);
+			sprintf(message, "pair %u holds %d, %d instead of %d, %d",
+					pair, first, second, _expected[2 * pair], _expected[2 * pair + 1]);
+			Check(pair < PAIRS && first == _expected[2 * pair] && second == _expected[2 * pair + 1], message);
+			_nextPair = pair + 1;
+		}
+	}
+}
+
+// Sends the closed batches, as WifiBatchDone does after SEND OK
+static void SendBatches(void)
+{
+	while(_wifi.uplink.closed)
+	{
+		ReadBatch(_wifi.uplink.tail);
+		if(++_wifi.uplink.tail == WIFI_UPLINK_SLOTS)
+			_wifi.uplink.tail = 0;
+		_wifi.uplink.closed--;
+	}
+}
+
+// Queues records of other readings until the uplink queue is full
+static void FillQueue(void)
+{
+	TelemetryReading readings[8];
+	uint8_t i;
+	for(i = 0; i < 8; i++)
+	{
+		readings[i].tag = TELEMETRY_TAG_LOAD;
+		readings[i].value = i;
+	}
+	while(ShellQueueReadings(readings, 8, false));
+}
+
+int main(void)
+{
+	unsigned int i, runs = 0, retries = 0;
+	char message[96];
+
+	HostInitialize();
+	LinkedList_16Element_Initialize(&_shell.task.list, _taskListData, sizeof(Task));
+	_shell.task.current = NULL;
+	_shell.watchdog.critical = 0;
+	_shell.watchdog.checkIns = 0;
+	_shell.watchdog.isResetPending = false;
+	_tick = SHELL_RESET_DELAY + 1;
+
+	// A complete capture, waiting to be stored (the ring starts at the oldest sample)
+	for(i = 0; i < ADC_CAPTURE_SIZE; i++)
+	{
+		int sample = (int) ((i * 1237UL) % 8001) - 4000;
+		_adc.capture.samples[(CAPTURE_INDEX + i) & (ADC_CAPTURE_SIZE - 1)] = sample;
+		_expected[i] = sample;
+	}
+	_adc.capture.index = CAPTURE_INDEX;
+	_adc.capture.state = ADC_CAPTURE_DONE;
+
+	// TaskStoreCapture stores the capture on its first run, and adds TaskUplinkCapture
+	ShellAddTask(TaskStoreCapture, 0, 100, 0, false, true, true, 0);
+	RunTask(TaskStoreCapture);
+	Check(_adc.capture.state == ADC_CAPTURE_STORED && FindTask(TaskUplinkCapture) != NULL, "the capture was not stored");
+	if(_failures)
+		return 1;
+
+	for(i = 0; i < PARTS; i++)
+	{
+		const Fault* fault = &_faults[i];
+		unsigned int remaining = PARTS - i, j;
+
+		if(fault->type == FAULT_FULL)
+			FillQueue();
+		for(j = 0; j < fault->runs; j++)
+		{
+			if(fault->type == FAULT_SRAM)
+			{
+				_hostSramPasses = fault->passes;
+				_hostSramFailures = 1;
+			}
+			runs++;
+			sprintf(message, "part %u was not retried after a failed run (%s)", i, fault->name);
+			Check(RunTask(TaskUplinkCapture) == remaining, message);
+			retries++;
+			_hostSramPasses = 0;
+			_hostSramFailures = 0;
+		}
+		if(fault->type == FAULT_FULL)
+			SendBatches();
+
+		runs++;
+		sprintf(message, "part %u was not queued (after: %s)", i, fault->name);
+		Check(RunTask(TaskUplinkCapture) == remaining - 1, message);
+	}
+
+	// The task is removed on its next turn
+	for(i = 0; i < 4; i++)
+		UpdateShell();
+	Check(FindTask(TaskUplinkCapture) == NULL, "TaskUplinkCapture was not removed after its last part");
+
+	SendBatches();
+	ReadBatch(_wifi.uplink.head);
+	sprintf(message, "%u of %u pairs were uplinked", _nextPair, PAIRS);
+	Check(_nextPair == PAIRS, message);
+	Check(_peaks == 1, "the capture peak was not uplinked once");
+
+	if(_failures)
+		return 1;
+	printf("Capture uplink: %u parts in %u runs (%u retried), %lu records refused by the uplink queue: passed\n",
+		   PARTS, runs, retries, (unsigned long) _wifi.uplink.dropped);
+	return 0;
+}
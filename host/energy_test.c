@@ -0,0 +1,259 @@
+/**@file		energy_test.c
+ * @brief		Host test: energy integration across windows, the day rollover, and the two checkpoint slots
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * EnergyAddWindow is fed windows of pseudo-random load and duration (including the largest of both), and every
+ * total is checked against a 64-bit sum of load times duration: the meter must count exactly the whole
+ * milliwatt-hours in the sum, whichever window completes them. EnergySetDay is called with a new RTCC day at
+ * intervals, and each day's total is checked the same way. The checkpoints are written by TaskCheckpointEnergy
+ * and read back by TaskRestoreEnergy through the SRAM model, with SramWait timeouts, a torn slot, and a wrapping
+ * sequence number.
+ */
+
+#include <xc.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "sram.h"
+#include "energy.h"
+#include "host.h"
+
+#define WINDOWS			200000UL
+#define DAY_WINDOWS		30011UL		// Windows per simulated day
+#define SLOT_SIZE		sizeof(EnergyCheckpoint)
+
+extern uint16_t _energySequence;
+
+static uint32_t _random = 12345;
+static unsigned int _failures;
+
+static void Check(bool condition, const char* message)
+{
+	if(!condition)
+	{
+		printf("FAIL: %s\n", message);
+		_failures++;
+	}
+}
+
+static uint32_t Random(void)
+{
+	_random = _random * 1103515245UL + 12345UL;
+	return _random >> 8;
+}
+
+static uint64_t Milliwatts(const EnergyTotal* total)
+{
+	return (uint64_t) total->wattHours * 1000 + total->milliwattHours;
+}
+
+/**
+ * Integrates windows, with a new day every DAY_WINDOWS windows, and checks the totals against a 64-bit reference
+ */
+static void TestIntegration(void)
+{
+	EnergyMeter meter;
+	uint64_t sum = 0, closed = 0, dayStart = 0;
+	uint8_t day = 0x01;
+	unsigned long i, rollovers = 0;
+	char message[128];
+
+	EnergyInitialize(&meter);
+	Check(!EnergySetDay(&meter, day), "a day was rolled over while the day was unknown");
+	Check(!EnergySetDay(&meter, day), "a day was rolled over without a change of day");
+	for(i = 0; i < WINDOWS; i++)
+	{
+		// Every 1000th window has the largest load and duration the meter accepts at once
+		uint16_t load = i % 1000 == 999 ? 65535 : (uint16_t) (Random() % 30000);
+		uint32_t duration = i % 1000 == 999 ? 65535 : 2400 + Random() % 201;
+		bool isRelayClosed = (i / 7) & 1;
+		uint64_t before = sum / ENERGY_UNITS_PER_MWH;
+		EnergyAddWindow(&meter, load, duration, isRelayClosed);
+		sum += (uint64_t) load * duration;
+		if(isRelayClosed)
+			closed += sum / ENERGY_UNITS_PER_MWH - before;
+
+		if((i + 1) % DAY_WINDOWS == 0)
+		{
+			uint64_t today = sum / ENERGY_UNITS_PER_MWH - dayStart;
+			sprintf(message, "day %02X: today %llu mWh instead of %llu", day,
+					(unsigned long long) Milliwatts(&meter.totals[ENERGY_TODAY]), (unsigned long long) today);
+			Check(Milliwatts(&meter.totals[ENERGY_TODAY]) == today, message);
+
+			// Days can be skipped (the meter only sees the day of each checkpoint)
+			day = day == 0x09 ? 0x11 : day + 1;
+			Check(EnergySetDay(&meter, day), "a new day was not rolled over");
+			sprintf(message, "day %02X: yesterday %llu mWh instead of %llu", day,
+					(unsigned long long) Milliwatts(&meter.totals[ENERGY_YESTERDAY]), (unsigned long long) today);
+			Check(Milliwatts(&meter.totals[ENERGY_YESTERDAY]) == today && Milliwatts(&meter.totals[ENERGY_TODAY]) == 0,
+				  message);
+			dayStart = sum / ENERGY_UNITS_PER_MWH;
+			rollovers++;
+		}
+	}
+
+	sprintf(message, "total %llu mWh instead of %llu", (unsigned long long) Milliwatts(&meter.totals[ENERGY_TOTAL]),
+			(unsigned long long) (sum / ENERGY_UNITS_PER_MWH));
+	Check(Milliwatts(&meter.totals[ENERGY_TOTAL]) == sum / ENERGY_UNITS_PER_MWH, message);
+	Check(meter.residue == sum % ENERGY_UNITS_PER_MWH, "the residue is not the remainder of the sum");
+	Check(Milliwatts(&meter.totals[ENERGY_RELAY_CLOSED]) == closed
+		  && Milliwatts(&meter.totals[ENERGY_RELAY_OPEN]) == sum / ENERGY_UNITS_PER_MWH - closed,
+		  "the relay totals do not add up to the total");
+	Check(Milliwatts(&meter.totals[ENERGY_TODAY]) == sum / ENERGY_UNITS_PER_MWH - dayStart,
+		  "today's total is not the energy since the last rollover");
+	Check(meter.windows == WINDOWS && rollovers == WINDOWS / DAY_WINDOWS, "windows or days were not counted");
+	if(_failures == 0)
+		printf("Integration: %lu windows, %lu days, %llu mWh counted exactly (residue %lu of %lu): passed\n",
+			   WINDOWS, rollovers, (unsigned long long) (sum / ENERGY_UNITS_PER_MWH), (unsigned long) meter.residue,
+			   (unsigned long) ENERGY_UNITS_PER_MWH);
+}
+
+/**
+ * Checks that every single-bit error in a sealed checkpoint is rejected
+ */
+static unsigned int TestSeal(void)
+{
+	EnergyCheckpoint checkpoint;
+	EnergyMeter meter;
+	unsigned int bit, rejected = 0;
+	EnergyInitialize(&meter);
+	EnergyAddWindow(&meter, 12345, 2500, true);
+	meter.day = 0x19;
+
+	EnergySeal(&meter, 0x1234, &checkpoint);
+	Check(EnergyIsValid(&checkpoint), "a sealed checkpoint is not valid");
+	for(bit = 0; bit < 8 * offsetof(EnergyCheckpoint, crc) + 16; bit++)
+	{
+		((uint8_t*) &checkpoint)[bit / 8] ^= 1 << (bit % 8);
+		if(!EnergyIsValid(&checkpoint))
+			rejected++;
+		((uint8_t*) &checkpoint)[bit / 8] ^= 1 << (bit % 8);
+	}
+	Check(rejected == bit, "a single-bit error in a checkpoint was not rejected");
+	return rejected;
+}
+
+/**
+ * Reads both checkpoint slots back as TaskRestoreEnergy does after a reset, into a cleared meter
+ * @return The sequence number of the restored checkpoint
+ */
+static uint16_t Restore(void)
+{
+	EnergyInitialize(&_energy);
+	_energySequence = 0;
+	TaskRestoreEnergy();
+	return _energySequence;
+}
+
+static bool IsRestored(const EnergyMeter* meter)
+{
+	unsigned char i;
+	for(i = 0; i < ENERGY_TOTAL_COUNT; i++)
+	{
+		if(Milliwatts(&_energy.totals[i]) != Milliwatts(&meter->totals[i]))
+			return false;
+	}
+	return _energy.residue == meter->residue && _energy.windows == meter->windows && _energy.day == meter->day;
+}
+
+static const EnergyCheckpoint* Slot(unsigned char slot)
+{
+	return (const EnergyCheckpoint*) &_hostSram[SRAM_ADDR_ENERGY + slot * SLOT_SIZE];
+}
+
+/**
+ * Writes checkpoints with TaskCheckpointEnergy, and restores them with TaskRestoreEnergy
+ */
+static void TestSlots(void)
+{
+	EnergyMeter saved;
+	uint8_t copy[2 * SLOT_SIZE];
+	unsigned int wait, checkpoints = 0, retries = 0;
+	char message[96];
+
+	HostInitialize();
+	memset(&_hostSram[SRAM_ADDR_ENERGY], 0xFF, 2 * SLOT_SIZE);
+	RTCVALL = 0x19;
+	EnergyInitialize(&_energy);
+	_energySequence = 0;
+
+	// Blank slots: nothing is restored
+	EnergyAddWindow(&_energy, 20000, 50000, true);
+	saved = _energy;
+	Check(Restore() == 0 && _energy.windows == 0, "a blank slot was restored");
+
+	// Checkpoints alternate between the slots, and the newer one is restored
+	_energy = saved;
+	_energySequence = 0;
+	Check(TaskCheckpointEnergy() && _energySequence == 1 && EnergyIsValid(Slot(1)) && Slot(1)->sequence == 1,
+		  "the first checkpoint was not written to slot 1");
+	EnergyAddWindow(&_energy, 20000, 50000, false);
+	Check(TaskCheckpointEnergy() && _energySequence == 2 && EnergyIsValid(Slot(0)) && Slot(0)->sequence == 2,
+		  "the second checkpoint was not written to slot 0");
+	checkpoints += 2;
+	saved = _energy;
+	Check(Restore() == 2 && IsRestored(&saved), "the newer checkpoint was not restored");
+
+	// A timeout of either SramWait call leaves the sequence number and the other slot as they were
+	for(wait = 0; wait < 2; wait++)
+	{
+		_energy = saved;
+		_energySequence = 2;
+		EnergyAddWindow(&_energy, 20000, 50000, true);
+		memcpy(copy, &_hostSram[SRAM_ADDR_ENERGY], sizeof(copy));
+		_hostSramPasses = wait;
+		_hostSramFailures = 1;
+		_shell.result.lastError = 0;
+		sprintf(message, "a timeout of SramWait %u was not reported, or advanced the sequence number", wait + 1);
+		Check(!TaskCheckpointEnergy() && _energySequence == 2 && _shell.result.lastError == SHELL_ERROR_SRAM_BUSY,
+			  message);
+		Check(memcmp(copy, &_hostSram[SRAM_ADDR_ENERGY], SLOT_SIZE) == 0, "slot 0 was changed by a failed write");
+		retries++;
+		_hostSramPasses = 0;
+		_hostSramFailures = 0;
+
+		// The write was cut short (the model completes it, so it is torn here): the previous checkpoint is restored
+		_hostSram[SRAM_ADDR_ENERGY + SLOT_SIZE + SLOT_SIZE / 2] ^= 0x5A;
+		Check(Restore() == 2 && IsRestored(&saved),
+			  "the previous checkpoint was not restored after a torn write");
+	}
+
+	// The retry writes the same slot
+	_energy = saved;
+	_energySequence = 2;
+	EnergyAddWindow(&_energy, 20000, 50000, true);
+	Check(TaskCheckpointEnergy() && _energySequence == 3 && EnergyIsValid(Slot(1)) && Slot(1)->sequence == 3,
+		  "the retried checkpoint was not written to slot 1");
+	checkpoints++;
+	saved = _energy;
+	Check(Restore() == 3 && IsRestored(&saved), "the retried checkpoint was not restored");
+
+	// The sequence number wraps: 0 is newer than 0xFFFF
+	_energy = saved;
+	_energySequence = 0xFFFE;
+	Check(TaskCheckpointEnergy() && Slot(1)->sequence == 0xFFFF, "checkpoint 0xFFFF was not written to slot 1");
+	EnergyAddWindow(&_energy, 20000, 50000, true);
+	Check(TaskCheckpointEnergy() && Slot(0)->sequence == 0, "checkpoint 0 was not written to slot 0");
+	checkpoints += 2;
+	saved = _energy;
+	Check(Restore() == 0 && IsRestored(&saved),
+		  "the checkpoint after the sequence number wrapped was not restored");
+
+	if(_failures == 0)
+		printf("Checkpoints: %u written, %u SramWait timeouts retried in the same slot, torn slot and wrap restored: "
+			   "passed\n", checkpoints, retries);
+}
+
+int main(void)
+{
+	TestIntegration();
+	unsigned int bits = TestSeal();
+	if(_failures == 0)
+		printf("Seal: every single-bit error of %u bits rejected: passed\n", bits);
+	TestSlots();
+	return _failures ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+/**@file		host.c
+ * @brief		Start-up and terminal capture shared by the host harnesses
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "main.h"
+#include "system.h"
+#include "sram.h"
+#include "wifi.h"
+#include "host.h"
+
+extern WifiInfo _wifi;
+
+// Buffers (ConfigureOS allocates these on its stack, which the XC8 compiled stack keeps in place)
+static char _txData1[TX_BUFFER_SIZE], _txData2[TX_BUFFER_SIZE];
+static char _rxData1[RX_BUFFER_SIZE], _rxData2[RX_BUFFER_SIZE];
+static char _lineData1[LINE_BUFFER_SIZE], _lineData2[LINE_BUFFER_SIZE];
+static char _swapData[LINE_BUFFER_SIZE];
+
+/**
+ * Initializes the firmware as ConfigureOS does, without touching the peripherals
+ */
+void HostInitialize(void)
+{
+	CommPortInitialize(&_comm1,
+					TX_BUFFER_SIZE, RX_BUFFER_SIZE, LINE_BUFFER_SIZE,
+					_txData1, _rxData1, _lineData1,
+					&SRAM_ADDR_COMM1_LINE_QUEUE, COMM1_LINE_QUEUE_SIZE,
+					NEWLINE_CRLF, NEWLINE_CRLF,
+					&_comm1Regs,
+					false, false,
+					COORD_VALUE_COMM1A.y, COORD_VALUE_COMM1A.x);
+	CommPayloadQueueInitialize(&_comm1, &_comm1Payloads,
+							SRAM_ADDR_COMM1_PAYLOAD_QUEUE, COMM1_PAYLOAD_QUEUE_SIZE);
+	CommPortInitialize(&_comm2,
+					TX_BUFFER_SIZE, RX_BUFFER_SIZE, LINE_BUFFER_SIZE,
+					_txData2, _rxData2, _lineData2,
+					&SRAM_ADDR_COMM2_LINE_QUEUE, COMM2_LINE_QUEUE_SIZE,
+					NEWLINE_CRLF, NEWLINE_CR,
+					&_comm2Regs,
+					true, false,
+					COORD_VALUE_COMM2A.y, COORD_VALUE_COMM2A.x);
+	_comm1.modeBits.echoRx = false;
+	_comm2.modeBits.echoRx = true;
+	SramStatusInitialize();
+	ShellInitialize(&_comm1, &_comm2, LINE_BUFFER_SIZE, _swapData);
+	InitializeLoadMeasurement();
+	_wifi.link.limit = WIFI_LINK_RATES - 1;
+	WifiUplinkInitialize();
+}
+
+/**
+ * Sends everything waiting in the TX lanes of a port, as the TX interrupt would
+ * @param comm	Pointer to the <b>CommPort</b>
+ * @param dest	Destination for the sent characters (may be NULL)
+ * @param size	Size of the destination
+ * @return		Number of characters sent
+ */
+unsigned int HostDrainTx(CommPort* comm, char* dest, unsigned int size)
+{
+	unsigned int count = 0;
+	while(comm->urgent.length || (comm->buffers.tx.length && !comm->statusBits.isTxPaused))
+	{
+		_CommTransmit(comm);
+		if(dest != NULL && count < size)
+			dest[count] = (char) *comm->registers->pTxReg;
+		count++;
+	}
+	return count;
+}
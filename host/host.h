@@ -0,0 +1,25 @@
+/**@file		host.h
+ * @brief		Header file for the pieces shared by the host harnesses: the SRAM model and a captured terminal
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include "serial_comm.h"
+
+// GLOBAL VARIABLES------------------------------------------------------------
+extern uint8_t _hostSram[];
+extern unsigned int _hostSramFailures;
+extern unsigned int _hostSramPasses;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+int FirmwareMain(void);
+void HostInitialize(void);
+unsigned int HostDrainTx(CommPort* comm, char* dest, unsigned int size);
+
+#endif
@@ -0,0 +1,149 @@
+/**@file		layout_bench.c
+ * @brief		Host benchmark: run-time formatted vs pre-rendered layout sequences
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Emits the cursor sequence of every fixed layout point, and the five pane clears sent after each command line,
+ * once with CommPutSequence (the code before the sequence table) and once with CommPutStoredSequence.
+ * Checks that both produce the same bytes, then reports host time per refresh and the size of the table.
+ * The times are host times (x86, gcc -O2): only their ratio carries over to the PIC18.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "sram.h"
+#include "system.h"
+#include "host.h"
+
+#define REFRESHES		20000
+#define BENCH_TX_SIZE	1024	// Large enough for a whole refresh, so that no sequence is dropped or waits
+
+typedef struct LayoutPoint
+{
+	const Point* coord;
+	const StoredSequence* cpos;
+	const StoredSequence* clear;
+} LayoutPoint;
+
+#define LAYOUT_BENCH_ENTRY(name, x, y)	{&COORD_##name, &CPOS_##name, &CLEAR_##name},
+static const LayoutPoint _points[] = { LAYOUT_POINTS(LAYOUT_BENCH_ENTRY) };
+#define POINT_COUNT		(sizeof(_points) / sizeof(_points[0]))
+
+// The pane clears sent after every command line (ShellCommandProcessor)
+#define LAYOUT_BENCH_POINT(name)	{&COORD_##name, &CPOS_##name, &CLEAR_##name}
+static const LayoutPoint _clears[] = {
+	LAYOUT_BENCH_POINT(VALUE_ERROR),
+	LAYOUT_BENCH_POINT(VALUE_COMM2A),
+	LAYOUT_BENCH_POINT(VALUE_COMM2B),
+	LAYOUT_BENCH_POINT(VALUE_COMM2C),
+	LAYOUT_BENCH_POINT(VALUE_COMM2D)
+};
+#define CLEAR_COUNT		(sizeof(_clears) / sizeof(_clears[0]))
+
+static CommPort _bench;
+static char _benchTx[BENCH_TX_SIZE], _benchRx[RX_BUFFER_SIZE], _benchLine[LINE_BUFFER_SIZE];
+
+static void ResetTx(void)
+{
+	_bench.buffers.tx.length = 0;
+	_bench.buffers.tx.head = 0;
+	_bench.buffers.tx.tail = 0;
+}
+
+static void RefreshFormatted(void)
+{
+	unsigned int i;
+	for(i = 0; i < POINT_COUNT; i++)
+		CommPutSequence(&_bench, ANSI_CPOS, 2, _points[i].coord->y, _points[i].coord->x);
+	for(i = 0; i < CLEAR_COUNT; i++)
+	{
+		CommPutSequence(&_bench, ANSI_CPOS, 2, _clears[i].coord->y, _clears[i].coord->x);
+		CommPutSequence(&_bench, ANSI_ELINE, 0);
+	}
+}
+
+static void RefreshStored(void)
+{
+	unsigned int i;
+	for(i = 0; i < POINT_COUNT; i++)
+		CommPutStoredSequence(&_bench, _points[i].cpos);
+	for(i = 0; i < CLEAR_COUNT; i++)
+		CommPutStoredSequence(&_bench, _clears[i].clear);
+}
+
+static double TimeRefresh(void (*refresh)(void))
+{
+	struct timespec start, end;
+	unsigned int i;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i = 0; i < REFRESHES; i++)
+	{
+		refresh();
+		ResetTx();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / REFRESHES;
+}
+
+static unsigned int Capture(void (*refresh)(void), char* dest)
+{
+	unsigned int length;
+	ResetTx();
+	refresh();
+	length = _bench.buffers.tx.length;
+	memcpy(dest, _benchTx, length);
+	ResetTx();
+	return length;
+}
+
+int main(void)
+{
+	static char formatted[BENCH_TX_SIZE], stored[BENCH_TX_SIZE];
+	unsigned int formattedLength, storedLength, stringBytes = 0, i;
+	double formattedTime, storedTime;
+
+	HostInitialize();
+	CommPortInitialize(&_bench,
+					BENCH_TX_SIZE, RX_BUFFER_SIZE, LINE_BUFFER_SIZE,
+					_benchTx, _benchRx, _benchLine,
+					&SRAM_ADDR_COMM1_LINE_QUEUE, COMM1_LINE_QUEUE_SIZE,
+					NEWLINE_CRLF, NEWLINE_CRLF,
+					&_comm1Regs,
+					false, false,
+					0, 0);
+
+	formattedLength = Capture(RefreshFormatted, formatted);
+	storedLength = Capture(RefreshStored, stored);
+	if(formattedLength != storedLength || memcmp(formatted, stored, storedLength) != 0)
+	{
+		printf("FAIL: stored sequences differ from the formatted ones\n");
+		return 1;
+	}
+	if(_bench.txCounters.dropped)
+	{
+		printf("FAIL: %u characters dropped\n", (unsigned int) _bench.txCounters.dropped);
+		return 1;
+	}
+
+	// Warm up, then measure
+	TimeRefresh(RefreshFormatted);
+	formattedTime = TimeRefresh(RefreshFormatted);
+	storedTime = TimeRefresh(RefreshStored);
+
+	for(i = 0; i < POINT_COUNT; i++)
+		stringBytes += _points[i].cpos->length + 1 + _points[i].clear->length + 1;
+
+	printf("Refresh: %u cursor positions + %u pane clears, %u bytes (identical output)\n",
+		   (unsigned int) POINT_COUNT, (unsigned int) CLEAR_COUNT, storedLength);
+	printf("  CommPutSequence        %8.0f ns/refresh\n", formattedTime);
+	printf("  CommPutStoredSequence  %8.0f ns/refresh  (%.1fx faster)\n", storedTime, formattedTime / storedTime);
+	printf("Table: %u points, %u sequences, %u string bytes (including terminators)\n",
+		   (unsigned int) POINT_COUNT, (unsigned int) (2 * POINT_COUNT), stringBytes);
+	printf("  descriptors with 24-bit program memory pointers: %u bytes\n", (unsigned int) (2 * POINT_COUNT * 4));
+	return 0;
+}
@@ -0,0 +1,10 @@
+/**@file		registers.c
+ * @brief		Storage for the special function registers declared by the host xc.h
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+// Built with HOST_DEFINE_REGISTERS (see the Makefile), which turns the declarations in xc.h into definitions
+#include <xc.h>
@@ -0,0 +1,458 @@
+/**@file		rx_bench.c
+ * @brief		Host benchmark: received characters per UpdateCommPort call, before and after the table-driven parser
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Feeds ESP8266 responses (no echo, CR LF) and typed terminal input (echo, CR, with arrow keys and backspaces)
+ * through _CommReceive, then UpdateCommPort, once with the parser that handled one character per call
+ * (reproduced below as UpdateCommPortOneChar) and once with the current one.
+ * Checks that both produce the same lines, control sequences, and echo, then reports characters per call,
+ * host throughput (fastest of 5 runs), and the characters lost to RX overruns when the main loop runs every 5 ms
+ * at 115200 baud.
+ * Also checks that a line is dropped, and the line buffer emptied, when the line queue write times out in SramWait.
+ * The times are host times (x86, gcc -O2): only their ratio carries over to the PIC18.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "sram.h"
+#include "system.h"
+#include "host.h"
+
+#define STREAM_SIZE		200000
+#define PACED_CHARS		58		// Characters received at 115200 baud during a 5 ms main loop pass (11.52 per ms)
+#define MAX_PASSES		(4 * STREAM_SIZE)
+#define RUNS			5
+
+typedef void (*UpdateFunction)(CommPort*);
+
+typedef struct Traffic
+{
+	const char* name;
+	const char* const* samples;
+	unsigned int sampleCount;
+	NewlineFlags rxNewline;
+	bool echo;
+} Traffic;
+
+typedef struct RunResult
+{
+	unsigned long passes;
+	unsigned long received;
+	unsigned long lines;
+	unsigned long sequences;
+	unsigned long overrun;
+	unsigned long hash;		// Lines and control sequences
+	unsigned long echoHash;
+	double ms;
+} RunResult;
+
+static const char* const _espSamples[] = {
+	"AT+CIPSTATUS\r\r\n",
+	"STATUS:3\r\n",
+	"+CIPSTATUS:0,\"TCP\",\"192.168.1.10\",5000,41236,0\r\n",
+	"OK\r\n",
+	"+CWLAP:(3,\"HomeNetwork\",-67,\"aa:bb:cc:dd:ee:ff\",6,7,0)\r\n",
+	"+CWLAP:(4,\"Neighbour-5G\",-81,\"12:34:56:78:9a:bc\",11,-3,0)\r\n",
+	"WIFI CONNECTED\r\n",
+	"WIFI GOT IP\r\n",
+	"\r\n",
+	"busy p...\r\n",
+	"SEND OK\r\n",
+	"+CIFSR:STAIP,\"192.168.1.42\"\r\n",
+	"+CIFSR:STAMAC,\"5c:cf:7f:01:02:03\"\r\n"
+};
+
+static const char* const _terminalSamples[] = {
+	"#stats\r",
+	"#energy\r",
+	"ls -la /var/log\r",
+	"\x1b[A\r",
+	"echo hello wrold\b\b\b\borld\r",
+	"\x1b[D\x1b[D\x1b[C",
+	"#uplink 3\r",
+	"\x1b[12;40H",
+	"set interval=250\r"
+};
+
+static const Traffic _traffic[] = {
+	{"ESP8266 responses, no echo", _espSamples, sizeof(_espSamples) / sizeof(_espSamples[0]), NEWLINE_CRLF, false},
+	{"terminal input, echo", _terminalSamples, sizeof(_terminalSamples) / sizeof(_terminalSamples[0]), NEWLINE_CR, true}
+};
+#define TRAFFIC_COUNT	(sizeof(_traffic) / sizeof(_traffic[0]))
+
+static CommPort _bench;
+static char _benchTx[TX_BUFFER_SIZE], _benchRx[RX_BUFFER_SIZE], _benchLine[LINE_BUFFER_SIZE];
+static char _swapData[LINE_BUFFER_SIZE], _echo[TX_BUFFER_SIZE];
+static Buffer _swap;
+static char _stream[STREAM_SIZE];
+
+/**
+ * The parser before the table-driven rewrite: one character per call, taken with RingBufferDequeue.
+ * Only the names of the parser state (csiCharCount) and of the line hand-off have been updated.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+static void UpdateCommPortOneChar(CommPort* comm)
+{
+	// Only continue if all events have been handled
+	if(comm->statusBits.hasSequence
+	|| comm->buffers.external.length == comm->buffers.external.capacity
+	|| (!comm->modeBits.useExternalBuffer && comm->statusBits.hasLine))
+		return;
+
+	// Only continue if the RX buffer is not empty
+	if(comm->buffers.rx.length == 0)
+		return;
+
+	// Only continue if the echo of the next character can be sent without waiting
+	if((comm->modeBits.echoRx || comm->modeBits.echoNewline || comm->modeBits.echoSequence)
+	&& !CommReserve(comm, ECHO_RESERVE))
+		return;
+
+	// Retrieve the next character from the RX buffer
+	char ch;
+	RingBufferDequeue(&comm->buffers.rx, &ch);
+
+	// If an escape sequence has been initiated,
+	// retrieve parameters until terminating character is received
+	if(comm->sequence.statusBits.state == 1)
+	{
+		if(ch == '[')
+			comm->sequence.statusBits.state++;
+		else
+			CommResetSequence(comm);
+	}
+	else if(comm->sequence.statusBits.state == 2)
+	{
+		if((ch >= 0x41 && ch <= 0x5A) || (ch >= 0x61 && ch <= 0x7A))
+		{
+			comm->sequence.terminator = ch;
+			comm->sequence.statusBits.sequenceId = ch;
+			comm->statusBits.hasSequence = true;
+
+			// If enabled, echo the sequence
+			if(comm->modeBits.echoSequence)
+			{
+				CommPutChar(comm, ASCII_ESC);
+				CommPutChar(comm, '[');
+				uint8_t i;
+				for(i = 0; i < comm->sequence.paramCount; i++)
+				{
+					CommPutChar(comm, comm->sequence.params[i]);
+				}
+				CommPutChar(comm, comm->sequence.terminator);
+			}
+		}
+		else if(comm->sequence.paramCount < SEQ_MAX_PARAMS
+				&& (ch >= 0x30 && ch <= 0x3F)
+				&& !comm->sequence.terminator)
+		{
+			comm->sequence.params[comm->sequence.paramCount] = ch;
+			comm->sequence.paramCount++;
+		}
+		else
+		{
+			CommResetSequence(comm);
+		}
+	}
+
+	// If a control character was received, process it, otherwise add character to the line
+	if(ch < 0x20 && !comm->modeBits.isBinaryMode && !comm->sequence.status)
+	{
+		switch(ch)
+		{
+			case ASCII_BS:
+			{
+				if(comm->buffers.line.length)
+					comm->buffers.line.length--;
+				break;
+			}
+			case ASCII_LF:
+			{
+				comm->newline.inProgress |= NEWLINE_LF;
+				break;
+			}
+			case ASCII_CR:
+			{
+				comm->newline.inProgress |= NEWLINE_CR;
+				break;
+			}
+			case ASCII_ESC:
+			{
+				comm->sequence.statusBits.state++;
+				break;
+			}
+		}
+	}
+	else if(!comm->sequence.status)
+	{
+		// Since a printable character was received, invalidate a partial newline
+		comm->newline.inProgress = 0;
+
+		// Add character to the line
+		((char*) comm->buffers.line.data)[comm->buffers.line.length] = ch;
+		comm->buffers.line.length++;
+
+		// Echo received character (if enabled)
+		if(comm->modeBits.echoRx)
+		{
+			CommPutSequence(comm, ANSI_SCPOS, 0);
+			CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x + comm->buffers.line.length - 1);
+			CommPutChar(comm, ch);
+			CommPutSequence(comm, ANSI_RCPOS, 0);
+		}
+	}
+
+	// If the line buffer is full, flush the line to external RAM
+	if(comm->buffers.line.length == comm->buffers.line.capacity)
+	{
+		if(!comm->modeBits.isBinaryMode)
+		{
+			((char*) comm->buffers.line.data)[comm->buffers.line.capacity - 1] = ASCII_NUL;
+
+			if(comm->modeBits.echoNewline)
+			{
+				comm->cursor.y++;
+				CommPutSequence(comm, ANSI_SCPOS, 0);
+				CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x);
+				CommPutNewline(comm);
+				CommPutSequence(comm, ANSI_RCPOS, 0);
+			}
+		}
+		CommFlushLineBuffer(comm);
+	}
+
+	// If a newline has been received, flush the line to external RAM
+	if(comm->newline.inProgress == comm->newline.rx)
+	{
+		((char*) comm->buffers.line.data)[comm->buffers.line.length] = ASCII_NUL;
+		comm->buffers.line.length++;
+		comm->newline.inProgress = 0;
+		CommFlushLineBuffer(comm);
+
+		// If enabled, echo the newline sequence
+		if(comm->modeBits.echoNewline)
+		{
+			comm->cursor.y++;
+			CommPutSequence(comm, ANSI_SCPOS, 0);
+			CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x);
+			CommPutNewline(comm);
+			CommPutSequence(comm, ANSI_RCPOS, 0);
+		}
+	}
+}
+
+static unsigned long Hash(unsigned long hash, const char* data, unsigned int length)
+{
+	unsigned int i;
+	for(i = 0; i < length; i++)
+		hash = (hash ^ (unsigned char) data[i]) * 16777619ul;
+	return hash & 0xFFFFFFFFul;
+}
+
+static unsigned int BuildStream(const Traffic* traffic)
+{
+	unsigned int length = 0, i = 0;
+	for(;;)
+	{
+		const char* sample = traffic->samples[i++ % traffic->sampleCount];
+		unsigned int sampleLength = strlen(sample);
+		if(length + sampleLength > STREAM_SIZE)
+			return length;
+		memcpy(_stream + length, sample, sampleLength);
+		length += sampleLength;
+	}
+}
+
+static void OpenPort(const Traffic* traffic)
+{
+	CommPortInitialize(&_bench,
+					TX_BUFFER_SIZE, RX_BUFFER_SIZE, LINE_BUFFER_SIZE,
+					_benchTx, _benchRx, _benchLine,
+					&SRAM_ADDR_COMM1_LINE_QUEUE, COMM1_LINE_QUEUE_SIZE,
+					NEWLINE_CRLF, traffic->rxNewline,
+					&_comm1Regs,
+					false, traffic->echo,
+					COORD_VALUE_COMM2A.y, COORD_VALUE_COMM2A.x);
+}
+
+/**
+ * Runs the main loop until the whole stream has been received and handled.
+ * Each pass delivers up to <code>perPass</code> characters through the RX interrupt, calls the update function,
+ * then takes every queued line and control sequence and drains the TX buffer.
+ * The lines and control sequences are hashed separately from the echo, whose position between them depends on
+ * how many characters each call processes.
+ * @param traffic	Traffic being received
+ * @param length	Length of the stream
+ * @param update	Update function being measured
+ * @param perPass	Characters received per pass
+ * @param holdBack	If true, characters are only delivered while the RX buffer has room (no overruns)
+ */
+static RunResult Run(const Traffic* traffic, unsigned int length, UpdateFunction update,
+					 unsigned int perPass, bool holdBack)
+{
+	RunResult result = {0};
+	struct timespec start, end;
+	unsigned int position = 0;
+	result.hash = 2166136261ul;
+	result.echoHash = 2166136261ul;
+
+	OpenPort(traffic);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while(result.passes < MAX_PASSES)
+	{
+		unsigned int n = perPass, drained;
+		if(holdBack && n > _bench.buffers.rx.capacity - _bench.buffers.rx.length)
+			n = _bench.buffers.rx.capacity - _bench.buffers.rx.length;
+		if(n > length - position)
+			n = length - position;
+		for(; n; n--)
+			_CommReceive(&_bench, _stream[position++]);
+
+		update(&_bench);
+		result.passes++;
+
+		while(_bench.buffers.external.length)
+		{
+			RingBufferDequeueSRAM(&_bench.buffers.external, &_swap);
+			result.hash = Hash(result.hash, _swapData, strlen(_swapData) + 1);
+			result.lines++;
+		}
+		if(_bench.statusBits.hasSequence)
+		{
+			result.hash = Hash(result.hash, (const char*) _bench.sequence.params, _bench.sequence.paramCount);
+			result.hash = Hash(result.hash, (const char*) &_bench.sequence.terminator, 1);
+			result.sequences++;
+			CommResetSequence(&_bench);
+		}
+		drained = HostDrainTx(&_bench, _echo, sizeof(_echo));
+		result.echoHash = Hash(result.echoHash, _echo, drained);
+
+		if(position == length && _bench.buffers.rx.length == 0)
+			break;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	result.received = position;
+	result.overrun = _bench.rxLines.overrun;
+	result.ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+	return result;
+}
+
+static RunResult Best(const Traffic* traffic, unsigned int length, UpdateFunction update)
+{
+	RunResult best = Run(traffic, length, update, RX_BUDGET, true);
+	unsigned int i;
+	for(i = 1; i < RUNS; i++)
+	{
+		RunResult result = Run(traffic, length, update, RX_BUDGET, true);
+		if(result.ms < best.ms)
+			best = result;
+	}
+	return best;
+}
+
+/**
+ * Receives a line which fills the line buffer while SramWait times out, then a short line.
+ * The full line must be dropped and the line buffer emptied (the characters which follow must not be written
+ * past its end), and the short line must be queued intact.
+ * @return true if passed
+ */
+static bool CheckSramTimeout(void)
+{
+	const char* next = "OK\r";
+	unsigned int i;
+	bool passed;
+
+	// Typed input is processed as it arrives (with echo), so the line fills the line buffer without a newline
+	OpenPort(&_traffic[1]);
+	_hostSramFailures = 1;
+	for(i = 0; i < LINE_BUFFER_SIZE + strlen(next); i++)
+	{
+		_CommReceive(&_bench, i < LINE_BUFFER_SIZE ? 'x' : next[i - LINE_BUFFER_SIZE]);
+		while(_bench.buffers.rx.length)
+		{
+			UpdateCommPort(&_bench);
+			HostDrainTx(&_bench, NULL, 0);
+		}
+	}
+	_hostSramFailures = 0;
+
+	passed = _bench.rxCounters.dropped == 1 && _bench.buffers.external.length == 1 && _bench.buffers.line.length == 0;
+	if(passed)
+	{
+		RingBufferDequeueSRAM(&_bench.buffers.external, &_swap);
+		passed = strcmp(_swapData, "OK") == 0;
+	}
+	printf("SRAM timeout while a full line is queued: %lu line dropped, the next line queued intact: %s\n",
+		   (unsigned long) _bench.rxCounters.dropped, passed ? "passed" : "FAIL");
+	return passed;
+}
+
+static bool Compare(const char* name, const RunResult* before, const RunResult* after)
+{
+	if(before->hash != after->hash || before->echoHash != after->echoHash || before->lines != after->lines || before->sequences != after->sequences)
+	{
+		printf("FAIL: %s: output differs (lines %lu vs %lu, sequences %lu vs %lu)\n",
+			   name, before->lines, after->lines, before->sequences, after->sequences);
+		return false;
+	}
+	return true;
+}
+
+int main(void)
+{
+	unsigned int t;
+	bool passed = true;
+
+	HostInitialize();
+	InitializeBuffer(&_swap, LINE_BUFFER_SIZE, 1, _swapData);
+
+	printf("Up to %u characters received between calls, held back while the RX buffer is full\n", RX_BUDGET);
+	for(t = 0; t < TRAFFIC_COUNT; t++)
+	{
+		const Traffic* traffic = &_traffic[t];
+		unsigned int length = BuildStream(traffic);
+		RunResult before, after, pacedBefore, pacedAfter;
+
+		// Warm up, then keep the fastest of several runs
+		Run(traffic, length, UpdateCommPort, RX_BUDGET, true);
+		before = Best(traffic, length, UpdateCommPortOneChar);
+		after = Best(traffic, length, UpdateCommPort);
+		passed &= Compare(traffic->name, &before, &after);
+		if(before.received != length || after.received != length)
+		{
+			printf("FAIL: %s: the stream was not received\n", traffic->name);
+			passed = false;
+		}
+
+		printf("  %s: %u characters, %lu lines, %lu control sequences (identical output)\n",
+			   traffic->name, length, after.lines, after.sequences);
+		printf("    one character per call  %6.2f chars/call  %8.0f chars/ms\n",
+			   (double) length / before.passes, length / before.ms);
+		printf("    table-driven parser     %6.2f chars/call  %8.0f chars/ms  (%.2fx)\n",
+			   (double) length / after.passes, length / after.ms, before.ms / after.ms);
+
+		// 115200 baud with a 5 ms main loop: the RX interrupt does not wait for the parser
+		// (typed input never arrives at that rate, so only traffic without echo is paced)
+		if(!traffic->echo)
+		{
+			pacedBefore = Run(traffic, length, UpdateCommPortOneChar, PACED_CHARS, false);
+			pacedAfter = Run(traffic, length, UpdateCommPort, PACED_CHARS, false);
+			printf("    5 ms passes at 115200 baud: %lu characters lost to RX overruns before, %lu after\n",
+				   pacedBefore.overrun, pacedAfter.overrun);
+			passed &= Compare(traffic->name, &after, &pacedAfter);
+			if(pacedAfter.overrun)
+			{
+				printf("FAIL: %s: %lu characters lost to RX overruns\n", traffic->name, pacedAfter.overrun);
+				passed = false;
+			}
+		}
+	}
+	passed &= CheckSramTimeout();
+	return passed ? 0 : 1;
+}
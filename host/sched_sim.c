@@ -0,0 +1,398 @@
+/**@file		sched_sim.c
+ * @brief		Host simulation of the task scheduler in virtual time
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Runs UpdateShell in a loop in which every pass and every task step costs a fixed amount of virtual time,
+ * and _tick follows that time as the timer interrupt would. The task list holds up to SHELL_MAX_TASKS tasks:
+ * periodic tasks, two long-running tasks which take many steps per run, a critical supervised task,
+ * and bursts of one-shot tasks. The harness computes the start-time jitter of every start on its own
+ * and checks it against the scheduler statistics. It also checks:
+ * - that nothing runs, and the watchdog is always cleared, during SHELL_RESET_DELAY;
+ * - that no periodic task waits longer than one pass over a full task list;
+ * - that the #stats printout (TaskPrintTaskStatistics) drops nothing through a 115200 baud terminal;
+ * - that a critical task which hangs is restarted SHELL_TASK_MAX_RESTARTS times, then stops the watchdog.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "host.h"
+
+#define SIM_DURATION		60000	// Length of the simulation (ms)
+#define SIM_BURST_END		45000	// Bursts of one-shot tasks are added until this time (ms)
+#define SIM_STATS_TIME		47000	// Time at which #stats is run (ms)
+#define SIM_HANG_TIME		50000	// Time at which the critical task stops checking in (ms)
+#define SIM_PASS_COST		20		// Cost of one pass of the main loop, without the task (us)
+#define SIM_UART_RATE		11520	// Terminal characters per second (115200 baud)
+#define SIM_WDT_PERIOD		2048	// Watchdog timeout (ms, see config.c)
+#define SIM_ONE_SHOTS		8		// Size of the one-shot pool
+
+#define TERMINAL_ROWS		40
+#define TERMINAL_COLUMNS	100
+
+typedef struct SimTask
+{
+	const char* name;
+	unsigned long interval;			// Run interval (ms, 0 for a one-shot)
+	unsigned int cost;				// Cost of one step (us)
+	unsigned char steps;			// Steps per run (a long-running task returns false until its last step)
+	unsigned long timeout;			// Heartbeat budget (ms)
+	bool isCritical;
+	// Observed by the harness
+	LinkedListNode* node;
+	unsigned long queuedAt;
+	unsigned long lastStart;
+	unsigned char step;
+	bool isHung;
+	bool isActive;
+	unsigned int runs;
+	unsigned long maxJitter;		// Largest jitter, without the first start and without starts after SIM_HANG_TIME
+	unsigned int histogram[SHELL_JITTER_BUCKETS];
+} SimTask;
+
+extern Task _taskListData[];
+extern TaskStatistics _taskStatistics[];
+
+static SimTask _tasks[] = {
+	{"periodic 10ms", 10, 100, 1},
+	{"periodic 20ms", 20, 150, 1},
+	{"periodic 50ms", 50, 800, 1},
+	{"periodic 125ms", 125, 300, 1},
+	{"periodic 250ms", 250, 500, 1},
+	{"periodic 500ms", 500, 1000, 1},
+	{"periodic 1s A", 1000, 1500, 1},
+	{"periodic 1s B", 1000, 600, 1},
+	{"periodic 2s", 2000, 200, 1},
+	{"periodic 10s", 10000, 300, 1},
+	{"long 250ms x10", 250, 1500, 10, 50},
+	{"long 1s x20", 1000, 2000, 20, 50},
+	{"critical 100ms", 100, 100, 1, 100, true}
+};
+#define TASK_COUNT		(sizeof(_tasks) / sizeof(_tasks[0]))
+#define CRITICAL_TASK	(&_tasks[TASK_COUNT - 1])
+
+static SimTask _oneShots[SIM_ONE_SHOTS];
+static unsigned int _oneShotHistogram[SHELL_JITTER_BUCKETS];	// Computed by the harness
+static unsigned int _oneShotStatistics[SHELL_JITTER_BUCKETS];	// Recorded by the scheduler
+static unsigned int _oneShotRuns, _oneShotsSkipped;
+static unsigned long _oneShotMaxJitter;
+
+static unsigned long _micros;
+static unsigned long _random = 1;
+static char _terminal[TERMINAL_ROWS][TERMINAL_COLUMNS + 1];
+static char _printout[TERMINAL_ROWS][TERMINAL_COLUMNS + 1];	// The terminal before the critical task hangs
+static int _failures;
+
+static void Check(bool condition, const char* message)
+{
+	if(!condition)
+	{
+		printf("FAIL: %s\n", message);
+		_failures++;
+	}
+}
+
+static unsigned long Random(unsigned long range)
+{
+	_random = _random * 1103515245 + 12345;
+	return (_random >> 16) % range;
+}
+
+static void Advance(unsigned long micros)
+{
+	_micros += micros;
+	_tick = _micros / 1000;
+}
+
+static unsigned char Bucket(unsigned long jitter)
+{
+	unsigned char bucket = 0;
+	while(jitter && bucket < SHELL_JITTER_BUCKETS - 1)
+	{
+		jitter >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+static bool HistogramEquals(const uint16_t* statistics, const unsigned int* histogram)
+{
+	unsigned char i;
+	for(i = 0; i < SHELL_JITTER_BUCKETS; i++)
+		if(statistics[i] != histogram[i])
+			return false;
+	return true;
+}
+
+/**
+ * The action of every simulated task (the SimTask is the first task parameter)
+ */
+static bool SimAction(void)
+{
+	SimTask* task = (SimTask*) CURRENT_TASK->params[0];
+
+	// A task which is not busy starts a new run: the jitter is measured from the time it was due
+	if(!CURRENT_TASK->statusBits.busy)
+	{
+		unsigned long due = task->runs ? task->lastStart + task->interval : task->queuedAt;
+		unsigned long jitter = _tick > due ? _tick - due : 0;
+		task->histogram[Bucket(jitter)]++;
+		if(task->runs && _tick < SIM_HANG_TIME && jitter > task->maxJitter)
+			task->maxJitter = jitter;
+		if(task->interval == 0)
+		{
+			_oneShotHistogram[Bucket(jitter)]++;
+			if(jitter > _oneShotMaxJitter)
+				_oneShotMaxJitter = jitter;
+		}
+		task->lastStart = _tick;
+		task->runs++;
+		task->step = 0;
+	}
+
+	Advance(task->cost);
+	if(task->isHung)
+		return false;
+	if(++task->step < task->steps)
+	{
+		ShellTaskCheckIn();
+		return false;
+	}
+
+	// A one-shot is done: its statistics entry is reused by the next task added to its list entry
+	if(task->interval == 0)
+	{
+		unsigned char i;
+		for(i = 0; i < SHELL_JITTER_BUCKETS; i++)
+			_oneShotStatistics[i] += _taskStatistics[_shell.task.current->memoryIndex].histogram[i];
+		_oneShotRuns++;
+		task->isActive = false;
+	}
+	return true;
+}
+
+static unsigned char TaskListLength(void)
+{
+	unsigned char length = 0;
+	LinkedListNode* node;
+	for(node = _shell.task.list.first; node; node = node->next)
+		length++;
+	return length;
+}
+
+static void AddBurst(void)
+{
+	unsigned int count = 1 + Random(6);
+	unsigned int i;
+	for(i = 0; i < SIM_ONE_SHOTS && count; i++)
+	{
+		if(_oneShots[i].isActive)
+			continue;
+		if(TaskListLength() >= SHELL_MAX_TASKS)
+			break;
+		memset(&_oneShots[i], 0, sizeof(SimTask));
+		_oneShots[i].name = "one-shot";
+		_oneShots[i].cost = 100 + Random(2900);
+		_oneShots[i].steps = 1;
+		_oneShots[i].isActive = true;
+		_oneShots[i].queuedAt = _tick;
+		ShellAddTask(SimAction, 1, 0, 0, false, false, false, 1, &_oneShots[i]);
+		count--;
+	}
+	_oneShotsSkipped += count;
+}
+
+/**
+ * Sends terminal characters at the baud rate, and applies them to a character grid
+ * (only cursor positioning and erase line are interpreted)
+ */
+static void SendTerminal(unsigned long micros)
+{
+	static unsigned long credit;
+	static char sequence[16];
+	static unsigned char sequenceLength;
+	static unsigned int row, col;
+
+	credit += micros * SIM_UART_RATE;
+	while(credit >= 1000000 && (_comm2.urgent.length || _comm2.buffers.tx.length))
+	{
+		char c;
+		credit -= 1000000;
+		_CommTransmit(&_comm2);
+		c = (char) *_comm2.registers->pTxReg;
+		if(sequenceLength || c == '\033')
+		{
+			sequence[sequenceLength++] = c;
+			if(sequenceLength > 2 && c >= 0x40)
+			{
+				sequence[sequenceLength] = '\0';
+				if(c == 'H' && sscanf(sequence, "\033[%u;%uH", &row, &col) != 2)
+					row = col = 0;
+				if(c == 'K' && row < TERMINAL_ROWS && col > 0 && col <= TERMINAL_COLUMNS)
+					memset(&_terminal[row][col - 1], ' ', TERMINAL_COLUMNS - col + 1);
+				sequenceLength = 0;
+			}
+			else if(sequenceLength == sizeof(sequence) - 1)
+				sequenceLength = 0;
+		}
+		else if(row < TERMINAL_ROWS && col > 0 && col <= TERMINAL_COLUMNS)
+			_terminal[row][col++ - 1] = c;
+	}
+	if(_comm2.urgent.length == 0 && _comm2.buffers.tx.length == 0)
+		credit = 0;
+}
+
+static void PrintHistogram(const char* name, unsigned int runs, unsigned long maxJitter, const unsigned int* histogram)
+{
+	unsigned char i;
+	printf("  %-16s %6u %5lu |", name, runs, maxJitter);
+	for(i = 0; i < SHELL_JITTER_BUCKETS; i++)
+		printf(" %6u", histogram[i]);
+	printf("\n");
+}
+
+int main(void)
+{
+	unsigned long lastClear = 0, maxClearGap = 0, nextBurst = SHELL_RESET_DELAY;
+	unsigned long firstStart = 0, resetAt = 0, clearsBeforeStart = 0, passesBeforeStart = 0;
+	unsigned long previousMicros, bound;
+	unsigned int restarts = 0, maxLength = 0, maxCost = 0, i, j;
+	bool isOtherTimeout = false, isStatsAdded = false;
+	char message[128];
+
+	HostInitialize();
+	LinkedList_16Element_Initialize(&_shell.task.list, _taskListData, sizeof(Task));
+	_shell.task.current = NULL;
+	_shell.watchdog.critical = 0;
+	_shell.watchdog.checkIns = 0;
+	_shell.watchdog.isResetPending = false;
+	memset(_terminal, ' ', sizeof(_terminal));
+	for(i = 0; i < TERMINAL_ROWS; i++)
+		_terminal[i][TERMINAL_COLUMNS] = '\0';
+
+	// Tasks are added at startup, as ShellInitialize does: their first run waits for SHELL_RESET_DELAY
+	for(i = 0; i < TASK_COUNT; i++)
+	{
+		SimTask* task = &_tasks[i];
+		if(task->steps == 0)
+			task->steps = 1;
+		task->node = ShellAddTask(SimAction, 0, task->interval, task->timeout, false, true, true, 1, task);
+		if(task->timeout)
+			ShellSuperviseTask(task->node, TASK_POLICY_RESTART, task->isCritical);
+		if(task->cost > maxCost)
+			maxCost = task->cost;
+	}
+
+	while(_tick < SIM_DURATION)
+	{
+		unsigned long clears = _hostWatchdogClears;
+		previousMicros = _micros;
+
+		if(_tick >= nextBurst && _tick < SIM_BURST_END)
+		{
+			AddBurst();
+			nextBurst = _tick + Random(400);
+		}
+		if(_tick >= SIM_STATS_TIME && !isStatsAdded)
+		{
+			ShellAddTask(TaskPrintTaskStatistics, 2 * SHELL_MAX_TASKS, 0, 0, false, false, false, 0);
+			isStatsAdded = true;
+		}
+		if(_tick >= SIM_HANG_TIME && !CRITICAL_TASK->isHung)
+		{
+			memcpy(_printout, _terminal, sizeof(_terminal));
+			CRITICAL_TASK->isHung = true;
+		}
+		if(TaskListLength() > maxLength)
+			maxLength = TaskListLength();
+
+		UpdateShell();
+		Advance(SIM_PASS_COST);
+		SendTerminal(_micros - previousMicros);
+
+		// An overrunning task is restarted (counted in its task list entry) until it is given up
+		for(i = 0; i < TASK_COUNT; i++)
+		{
+			unsigned char count = ((Task*) _tasks[i].node->data)->restarts;
+			if(count && !_tasks[i].isHung)
+				isOtherTimeout = true;
+			else if(_tasks[i].isHung && count > restarts)
+				restarts = count;
+		}
+		if(_shell.watchdog.isResetPending && resetAt == 0)
+			resetAt = _tick;
+
+		if(_tick <= SHELL_RESET_DELAY)
+		{
+			passesBeforeStart++;
+			clearsBeforeStart += _hostWatchdogClears - clears;
+		}
+		for(i = 0; i < TASK_COUNT && !firstStart; i++)
+			if(_tasks[i].runs)
+				firstStart = _tick;
+
+		if(_hostWatchdogClears != clears)
+		{
+			if(_tick < SIM_HANG_TIME && _tick - lastClear > maxClearGap)
+				maxClearGap = _tick - lastClear;
+			lastClear = _tick;
+		}
+	}
+
+	// Nothing runs, and the watchdog is cleared on every pass, until the scheduler starts
+	Check(firstStart > SHELL_RESET_DELAY, "a task ran during SHELL_RESET_DELAY");
+	Check(clearsBeforeStart == passesBeforeStart, "the watchdog was not cleared on every pass during SHELL_RESET_DELAY");
+
+	// The scheduler statistics match the harness, and no periodic task waits longer than one pass over a full list
+	bound = (SHELL_MAX_TASKS * (SIM_PASS_COST + maxCost) + 999) / 1000 + 1;
+	for(i = 0; i < TASK_COUNT; i++)
+	{
+		const TaskStatistics* stats = &_taskStatistics[_tasks[i].node->memoryIndex];
+		snprintf(message, sizeof(message), "%s: scheduler statistics differ from the harness", _tasks[i].name);
+		Check(stats->runs == _tasks[i].runs && HistogramEquals(stats->histogram, _tasks[i].histogram), message);
+		snprintf(message, sizeof(message), "%s: jitter %lu ms exceeds %lu ms", _tasks[i].name, _tasks[i].maxJitter, bound);
+		Check(_tasks[i].maxJitter <= bound, message);
+	}
+	Check(memcmp(_oneShotStatistics, _oneShotHistogram, sizeof(_oneShotHistogram)) == 0,
+		  "one-shots: scheduler statistics differ from the harness");
+	Check(maxLength == SHELL_MAX_TASKS, "the task list was never full");
+
+	// The printout went through the terminal without drops: one line per task, in two parts
+	for(i = 0, j = 0; i < TERMINAL_ROWS; i++)
+		if(strstr(_printout[i], " n=") && strchr(_printout[i], '|'))
+			j++;
+	snprintf(message, sizeof(message), "#stats printed %u complete lines, expected %u", j, (unsigned int) TASK_COUNT + 1);
+	Check(j == TASK_COUNT + 1, message);
+	Check(_comm2.txCounters.dropped == 0, "terminal characters were dropped");
+
+	// The hung critical task is restarted, then the watchdog is no longer cleared
+	Check(!isOtherTimeout, "a task timed out before the critical task hung");
+	Check(restarts == SHELL_TASK_MAX_RESTARTS, "the hung critical task was not restarted SHELL_TASK_MAX_RESTARTS times");
+	Check(resetAt > SIM_HANG_TIME && _shell.watchdog.isResetPending, "the hung critical task did not stop the watchdog");
+	Check(maxClearGap < SIM_WDT_PERIOD, "the watchdog would have expired before the critical task hung");
+	Check(SIM_DURATION - lastClear > SIM_WDT_PERIOD, "the watchdog was still being cleared after the critical task hung");
+
+	printf("Virtual time %u ms, %u tasks at most in the list, %u one-shots run (%u skipped, the list was full)\n",
+		   SIM_DURATION, maxLength, _oneShotRuns, _oneShotsSkipped);
+	printf("Start-time jitter (first starts wait for SHELL_RESET_DELAY = %u ms), bound %lu ms\n", SHELL_RESET_DELAY, bound);
+	printf("  %-16s %6s %5s | %6s %6s %6s %6s %6s %6s %6s %6s\n", "task", "starts", "max",
+		   "0", "1", "2-3", "4-7", "8-15", "16-31", "32-63", "64+");
+	for(i = 0; i < TASK_COUNT; i++)
+		PrintHistogram(_tasks[i].name, _tasks[i].runs, _tasks[i].maxJitter, _tasks[i].histogram);
+	PrintHistogram("one-shots", _oneShotRuns, _oneShotMaxJitter, _oneShotHistogram);
+	printf("Watchdog: longest time between clears %lu ms; the critical task hung at %u ms, was restarted %u times,\n"
+		   "          then given up at %lu ms; the watchdog was last cleared at %lu ms\n",
+		   maxClearGap, SIM_HANG_TIME, restarts, resetAt, lastClear);
+	printf("#stats (%lu characters deferred):\n", (unsigned long) _comm2.txCounters.deferred);
+	for(i = 22; i < 22 + TASK_COUNT + 1; i++)
+	{
+		for(j = TERMINAL_COLUMNS; j > 0 && _printout[i][j - 1] == ' '; j--)
+			continue;
+		printf("  %.*s\n", j, _printout[i]);
+	}
+	return _failures ? 1 : 0;
+}
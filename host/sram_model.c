@@ -0,0 +1,80 @@
+/**@file		sram_model.c
+ * @brief		Host stand-in for sram.c: the external SRAM is an array, and every operation completes immediately.
+ *				A harness can set <code>_hostSramFailures</code> to make the next SramWait calls time out
+ *				(after <code>_hostSramPasses</code> calls which still succeed).
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sram.h"
+#include "main.h"
+#include "host.h"
+
+uint8_t _hostSram[SRAM_CAPACITY];	/**< Contents of the external SRAM */
+unsigned int _hostSramFailures;		/**< Number of SramWait calls that still fail with SHELL_ERROR_SRAM_BUSY */
+unsigned int _hostSramPasses;		/**< Number of SramWait calls that succeed before _hostSramFailures apply */
+
+void SramStatusInitialize(void)
+{
+	_sram.status = 0;
+}
+
+void SramSetMode(SramMode mode)
+{
+	(void) mode;
+}
+
+void SramRead(uint24_t address, uint24_t length, Buffer* destination)
+{
+	if(_sram.statusBits.busy || destination == NULL || length == 0 || address >= SRAM_CAPACITY)
+		return;
+	if(length > destination->capacity)
+		length = destination->capacity;
+	if(address + (length * destination->elementSize) > SRAM_CAPACITY)
+		length = (SRAM_CAPACITY - address) / destination->elementSize;
+	memcpy(destination->data, &_hostSram[address], length * destination->elementSize);
+	destination->length = length;
+}
+
+void SramWrite(uint24_t address, Buffer* source)
+{
+	if(_sram.statusBits.busy || source == NULL || source->length == 0
+	|| address + (source->length * source->elementSize) > SRAM_CAPACITY)
+		return;
+	memcpy(&_hostSram[address], source->data, source->length * source->elementSize);
+}
+
+void SramFill(uint24_t address, uint24_t length, unsigned char value)
+{
+	if(_sram.statusBits.busy || length == 0 || address + length > SRAM_CAPACITY)
+		return;
+	memset(&_hostSram[address], value, length);
+}
+
+bool SramWait(void)
+{
+	if(_hostSramPasses)
+	{
+		_hostSramPasses--;
+		return true;
+	}
+	if(_hostSramFailures)
+	{
+		_hostSramFailures--;
+		_shell.result.lastError = SHELL_ERROR_SRAM_BUSY;
+		return false;
+	}
+	return true;
+}
+
+// The SPI interrupt (interrupt.c) is never raised on the host
+void _SramOperationStart(void) { }
+void _SramReadBytes(void) { }
+void _SramWriteBytes(void) { }
+void _SramFill(void) { }
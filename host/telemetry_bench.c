@@ -0,0 +1,366 @@
+/**@file		telemetry_bench.c
+ * @brief		Host test and benchmark: COBS framing, CRC-16, and the uplink record encoder and decoder
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Checks the CRC against its standard check value, COBS against known encodings and random round trips
+ * (zero runs and 254-byte blocks), and the records: round trips with 0 - 8 readings of every value width,
+ * unknown tags, truncation, every single-bit error, and resynchronization after garbage.
+ * Then reports the bytes per reading of the records and of the text format they replaced,
+ * and host encode/decode speed. The times are host times (x86, gcc -O2): only their ratio carries over to the PIC18.
+ */
+
+#include <xc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "format.h"
+#include "telemetry.h"
+
+#define COBS_ROUND_TRIPS	20000
+#define COBS_MAX_LENGTH		600
+#define RECORD_ROUND_TRIPS	20000
+#define SPEED_RECORDS		1000000
+
+static unsigned int _failures;
+
+#define CHECK(condition, ...)	do { if(!(condition)) { printf("FAIL: " __VA_ARGS__); printf("\n"); _failures++; } } while(0)
+
+static const int32_t _boundaries[] = {
+	0, 1, -1, 127, -128, 128, -129, 32767, -32768, 32768, -32769, 2147483647L, -2147483647L - 1
+};
+#define BOUNDARY_COUNT	(sizeof(_boundaries) / sizeof(_boundaries[0]))
+
+static uint32_t Random(void)
+{
+	return ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+}
+
+static double Elapsed(const struct timespec* start)
+{
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void MakeRecord(TelemetryRecord* record, uint8_t readingCount)
+{
+	uint8_t i;
+	memcpy(record->id, "SM000001", TELEMETRY_ID_SIZE);
+	record->sequence = (uint16_t) Random();
+	for(i = 0; i < TELEMETRY_TIME_SIZE; i++)
+		record->time[i] = (uint8_t) Random();
+	record->uptime = Random();
+	record->readingCount = readingCount;
+	for(i = 0; i < readingCount; i++)
+	{
+		record->readings[i].tag = (uint8_t) (TELEMETRY_TAG_LOAD + Random() % 13);
+		record->readings[i].value = Random() & 1 ? _boundaries[Random() % BOUNDARY_COUNT] : (int32_t) Random();
+	}
+}
+
+static bool RecordEquals(const TelemetryRecord* a, const TelemetryRecord* b)
+{
+	uint8_t i;
+	if(memcmp(a->id, b->id, TELEMETRY_ID_SIZE) != 0
+	|| a->sequence != b->sequence
+	|| memcmp(a->time, b->time, TELEMETRY_TIME_SIZE) != 0
+	|| a->uptime != b->uptime
+	|| a->readingCount != b->readingCount)
+		return false;
+	for(i = 0; i < a->readingCount; i++)
+	{
+		if(a->readings[i].tag != b->readings[i].tag || a->readings[i].value != b->readings[i].value)
+			return false;
+	}
+	return true;
+}
+
+static void TestCrc(void)
+{
+	uint16_t crc = TelemetryCrc16(0xFFFF, (const uint8_t*) "123456789", 9);
+	CHECK(crc == 0x29B1, "CRC-16/CCITT-FALSE check value is 0x%04X, expected 0x29B1", crc);
+}
+
+static void TestCobsVector(const char* name, const uint8_t* data, uint16_t length,
+						   const uint8_t* expected, uint16_t expectedLength)
+{
+	uint8_t encoded[COBS_MAX_LENGTH], decoded[COBS_MAX_LENGTH];
+	uint16_t encodedLength = TelemetryCobsEncode(data, length, encoded);
+	CHECK(encodedLength == expectedLength && memcmp(encoded, expected, expectedLength) == 0, "COBS encoding of %s", name);
+	int16_t decodedLength = TelemetryCobsDecode(expected, expectedLength, decoded);
+	CHECK(decodedLength == length && memcmp(decoded, data, length) == 0, "COBS decoding of %s", name);
+}
+
+static void TestCobs(void)
+{
+	static const uint8_t zero[] = {0x00}, zeroEncoded[] = {0x01, 0x01};
+	static const uint8_t zeros[] = {0x00, 0x00}, zerosEncoded[] = {0x01, 0x01, 0x01};
+	static const uint8_t mixed[] = {0x11, 0x22, 0x00, 0x33}, mixedEncoded[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+	static const uint8_t trailing[] = {0x11, 0x00, 0x00, 0x00}, trailingEncoded[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+	uint8_t block[255], blockEncoded[257];
+	uint8_t data[COBS_MAX_LENGTH], encoded[COBS_MAX_LENGTH + 4], decoded[COBS_MAX_LENGTH + 4];
+	unsigned int i, n;
+
+	TestCobsVector("{}", zero, 0, zeroEncoded, 1);
+	TestCobsVector("{00}", zero, 1, zeroEncoded, 2);
+	TestCobsVector("{00 00}", zeros, 2, zerosEncoded, 3);
+	TestCobsVector("{11 22 00 33}", mixed, 4, mixedEncoded, 5);
+	TestCobsVector("{11 00 00 00}", trailing, 4, trailingEncoded, 5);
+
+	// 254 non-zero bytes fill a block, and a 255th starts the next one
+	for(i = 0; i < 255; i++)
+		block[i] = (uint8_t) (i + 1);
+	blockEncoded[0] = 0xFF;
+	memcpy(blockEncoded + 1, block, 254);
+	blockEncoded[255] = 0x01;
+	TestCobsVector("{01 .. FE}", block, 254, blockEncoded, 256);
+	blockEncoded[255] = 0x02;
+	blockEncoded[256] = 0xFF;
+	TestCobsVector("{01 .. FF}", block, 255, blockEncoded, 257);
+
+	// Random data with every density of zero bytes, up to several blocks long
+	for(n = 0; n < COBS_ROUND_TRIPS; n++)
+	{
+		uint16_t length = (uint16_t) (Random() % (COBS_MAX_LENGTH + 1));
+		unsigned int zeroPercent = Random() % 101;
+		for(i = 0; i < length; i++)
+			data[i] = Random() % 100 < zeroPercent ? 0 : (uint8_t) (1 + Random() % 255);
+
+		uint16_t encodedLength = TelemetryCobsEncode(data, length, encoded);
+		bool hasZero = memchr(encoded, 0, encodedLength) != NULL;
+		int16_t decodedLength = TelemetryCobsDecode(encoded, encodedLength, decoded);
+		if(hasZero || encodedLength > length + 1 + length / 254
+		|| decodedLength != length || memcmp(decoded, data, length) != 0)
+		{
+			CHECK(false, "COBS round trip %u (%u bytes, %u%% zeros)", n, length, zeroPercent);
+			return;
+		}
+	}
+
+	// A zero byte, or a code that runs past the end, is not a valid encoding
+	CHECK(TelemetryCobsDecode(mixedEncoded, 2, decoded) < 0, "truncated COBS data was accepted");
+	encoded[0] = 0x02;
+	encoded[1] = 0x00;
+	CHECK(TelemetryCobsDecode(encoded, 2, decoded) < 0, "COBS data containing a zero was accepted");
+}
+
+static void TestRecords(void)
+{
+	TelemetryRecord record, decoded;
+	uint8_t frame[TELEMETRY_MAX_RECORD_SIZE], body[TELEMETRY_MAX_RECORD_SIZE + 8];
+	uint8_t extended[TELEMETRY_MAX_RECORD_SIZE + 8];
+	unsigned int n, i, bit, length;
+
+	// Round trips, up to the largest record
+	for(n = 0; n < RECORD_ROUND_TRIPS; n++)
+	{
+		MakeRecord(&record, (uint8_t) (n % (TELEMETRY_MAX_READINGS + 1)));
+		if(n % 97 == 0)
+		{
+			for(i = 0; i < record.readingCount; i++)
+				record.readings[i].value = (int32_t) 0x80000000ul;	// Every reading 4 bytes: the largest record
+		}
+		length = TelemetryEncodeRecord(&record, frame);
+		int16_t result = TelemetryDecodeRecord(frame, (uint16_t) length, &decoded);
+		if(length > TELEMETRY_MAX_RECORD_SIZE || memchr(frame, 0, length - 1) != NULL
+		|| frame[length - 1] != TELEMETRY_DELIMITER || result != (int16_t) length || !RecordEquals(&record, &decoded))
+		{
+			CHECK(false, "record round trip %u (%u readings, %u bytes)", n, record.readingCount, length);
+			return;
+		}
+	}
+
+	// Truncated: more bytes are needed
+	MakeRecord(&record, 3);
+	length = TelemetryEncodeRecord(&record, frame);
+	CHECK(TelemetryDecodeRecord(frame, (uint16_t) (length - 1), &decoded) == 0, "a truncated record was not held back");
+
+	// A field with an unknown tag (added by a later firmware version) is skipped
+	int16_t bodyLength = TelemetryCobsDecode(frame, (uint16_t) (length - 1), body);
+	bodyLength -= TELEMETRY_CRC_SIZE;
+	memcpy(extended, body, 10);				// The device ID field
+	extended[10] = 0x05;
+	extended[11] = 3;
+	extended[12] = 0xAA;
+	extended[13] = 0x00;
+	extended[14] = 0x55;
+	memcpy(extended + 15, body + 10, bodyLength - 10);
+	bodyLength += 5;
+	uint16_t crc = TelemetryCrc16(0xFFFF, extended, (uint16_t) bodyLength);
+	extended[bodyLength++] = (uint8_t) crc;
+	extended[bodyLength++] = (uint8_t) (crc >> 8);
+	length = TelemetryCobsEncode(extended, (uint16_t) bodyLength, frame);
+	frame[length++] = TELEMETRY_DELIMITER;
+	CHECK(TelemetryDecodeRecord(frame, (uint16_t) length, &decoded) == (int16_t) length && RecordEquals(&record, &decoded),
+		  "a field with an unknown tag was not skipped");
+
+	// Every single-bit error is rejected (a bit error which creates a zero byte splits the record, and both parts are rejected)
+	for(n = 0; n <= TELEMETRY_MAX_READINGS; n += TELEMETRY_MAX_READINGS / 2)
+	{
+		MakeRecord(&record, (uint8_t) n);
+		length = TelemetryEncodeRecord(&record, frame);
+		for(bit = 0; bit < 8 * (length - 1); bit++)
+		{
+			uint8_t corrupt[TELEMETRY_MAX_RECORD_SIZE];
+			uint16_t offset = 0;
+			memcpy(corrupt, frame, length);
+			corrupt[bit / 8] ^= (uint8_t) (1 << (bit % 8));
+			while(offset < length)
+			{
+				int16_t result = TelemetryDecodeRecord(corrupt + offset, (uint16_t) (length - offset), &decoded);
+				if(result >= 0)
+				{
+					CHECK(false, "bit %u of a record with %u readings was flipped, and the record was accepted", bit, n);
+					return;
+				}
+				offset += (uint16_t) -result;
+			}
+		}
+	}
+
+	// A receiver recovers at the first delimiter after garbage, such as the end of a corrupted record
+	// (bytes which are not followed by a delimiter are taken as part of the next record, which is then lost)
+	{
+		uint8_t stream[64 + 2 * TELEMETRY_MAX_RECORD_SIZE];
+		TelemetryRecord first, second;
+		uint16_t streamLength = 0, offset = 0;
+		unsigned int recovered = 0;
+		for(i = 0; i < 64; i++)
+			stream[streamLength++] = (uint8_t) (i % 8 == 7 ? TELEMETRY_DELIMITER : Random());
+		MakeRecord(&first, 2);
+		MakeRecord(&second, 8);
+		streamLength += TelemetryEncodeRecord(&first, stream + streamLength);
+		streamLength += TelemetryEncodeRecord(&second, stream + streamLength);
+		while(offset < streamLength)
+		{
+			int16_t result = TelemetryDecodeRecord(stream + offset, (uint16_t) (streamLength - offset), &decoded);
+			if(result == 0)
+				break;
+			if(result > 0)
+			{
+				CHECK(RecordEquals(recovered == 0 ? &first : &second, &decoded), "record %u after garbage differs", recovered);
+				recovered++;
+				offset += (uint16_t) result;
+			}
+			else
+				offset += (uint16_t) -result;
+		}
+		CHECK(recovered == 2, "%u of 2 records recovered after garbage", recovered);
+	}
+}
+
+static void TestStatus(void)
+{
+	TelemetryStatus status = {123456789ul, 12345, 678, 1, 0x05, 3, 9}, decoded;
+	uint8_t frame[TELEMETRY_MAX_FRAME_SIZE];
+	uint8_t length = TelemetryEncodeStatus(&status, frame);
+	CHECK(TelemetryDecodeStatus(frame, length, &decoded) == length && memcmp(&status, &decoded, sizeof(status)) == 0,
+		  "status frame round trip");
+	CHECK(TelemetryDecodeStatus(frame, (uint16_t) (length - 1), &decoded) == 0, "a truncated status frame was not held back");
+	frame[5] ^= 0x10;
+	CHECK(TelemetryDecodeStatus(frame, length, &decoded) < 0, "a corrupted status frame was accepted");
+}
+
+/**
+ * Bytes per reading of the text format the records replaced ("<load>\r\n" after AT+CIPSEND=<length>),
+ * of the same text carrying the record's ID, sequence, time, and uptime, and of the records.
+ */
+static void ReportSize(void)
+{
+	static const int32_t loads[] = {0, 87, 415, 1203, 6024, 14968, 23000, 30000};	// Tenths of a watt
+	TelemetryRecord record;
+	uint8_t frame[TELEMETRY_MAX_RECORD_SIZE];
+	char text[64];
+	unsigned int i, textBytes = 0, fullTextBytes = 0, commandBytes = 0, oneBytes = 0;
+	const unsigned int count = sizeof(loads) / sizeof(loads[0]);
+
+	for(i = 0; i < count; i++)
+	{
+		unsigned char length = FormatFixed(text, loads[i], 1, 0, ' ');
+		textBytes += length + 2;
+		commandBytes += strlen("AT+CIPSEND=") + (length + 2 >= 10 ? 2 : 1) + 2;
+		fullTextBytes += snprintf(text, sizeof(text), "SM000001,%u,261019123456,%lu,", 1000 + i, 3600000ul + i) + length + 2;
+
+		MakeRecord(&record, 1);
+		record.readings[0].tag = TELEMETRY_TAG_LOAD;
+		record.readings[0].value = loads[i];
+		oneBytes += TelemetryEncodeRecord(&record, frame);
+	}
+
+	// Capture data: 8 readings of 4 bytes each
+	MakeRecord(&record, TELEMETRY_MAX_READINGS);
+	for(i = 0; i < TELEMETRY_MAX_READINGS; i++)
+	{
+		record.readings[i].tag = TELEMETRY_TAG_CAPTURE_DATA;
+		record.readings[i].value = (int32_t) ((i << 26) | (0x0123 << 13) | 0x1F00);
+	}
+	unsigned int eightBytes = TelemetryEncodeRecord(&record, frame);
+
+	printf("Bytes per reading (load readings of %u sizes)\n", count);
+	printf("  text \"<load>\\r\\n\", no ID or time       %5.1f  (+%.1f for its AT+CIPSEND)\n",
+		   (double) textBytes / count, (double) commandBytes / count);
+	printf("  text with ID, sequence, time, uptime   %5.1f\n", (double) fullTextBytes / count);
+	printf("  record, 1 reading                      %5.1f\n", (double) oneBytes / count);
+	printf("  record, %u readings of 4 bytes          %5.1f\n", TELEMETRY_MAX_READINGS, (double) eightBytes / TELEMETRY_MAX_READINGS);
+}
+
+static void ReportSpeed(uint8_t readingCount)
+{
+	static TelemetryRecord records[256];
+	static uint8_t frames[256][TELEMETRY_MAX_RECORD_SIZE];
+	static uint8_t lengths[256];
+	TelemetryRecord decoded;
+	struct timespec start;
+	unsigned long bytes = 0, checksum = 0;
+	unsigned int i;
+	double encodeTime, decodeTime;
+
+	for(i = 0; i < 256; i++)
+		MakeRecord(&records[i], readingCount);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i = 0; i < SPEED_RECORDS; i++)
+	{
+		lengths[i & 0xFF] = TelemetryEncodeRecord(&records[i & 0xFF], frames[i & 0xFF]);
+		bytes += lengths[i & 0xFF];
+	}
+	encodeTime = Elapsed(&start);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i = 0; i < SPEED_RECORDS; i++)
+	{
+		checksum += TelemetryDecodeRecord(frames[i & 0xFF], lengths[i & 0xFF], &decoded);
+		checksum += decoded.uptime;
+	}
+	decodeTime = Elapsed(&start);
+
+	printf("  %u reading%s  %6.1f bytes  encode %5.2f M records/s (%4.0f bytes/ms)  decode %5.2f M records/s (%4.0f bytes/ms)\n",
+		   readingCount, readingCount == 1 ? " " : "s", (double) bytes / SPEED_RECORDS,
+		   SPEED_RECORDS / encodeTime / 1e6, bytes / encodeTime / 1e3,
+		   SPEED_RECORDS / decodeTime / 1e6, bytes / decodeTime / 1e3);
+	if(checksum == 0)
+		printf("\n");	// Keeps the decode loop from being optimized out
+}
+
+int main(void)
+{
+	srand(1);
+	TestCrc();
+	TestCobs();
+	TestRecords();
+	TestStatus();
+	if(_failures)
+		return 1;
+	printf("CRC check value, %u COBS round trips, %u record round trips, every single-bit error rejected: passed\n",
+		   COBS_ROUND_TRIPS, RECORD_ROUND_TRIPS);
+
+	ReportSize();
+	printf("Host speed\n");
+	ReportSpeed(1);
+	ReportSpeed(TELEMETRY_MAX_READINGS);
+	return 0;
+}
@@ -0,0 +1,1106 @@
+/**@file		wifi_test.c
+ * @brief		Host test: the AT command engine driven by scripted ESP8266 responses, and CommPutLine
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ *
+ * Each script queues test commands, then feeds ESP8266 response streams through the RX interrupt (_CommReceive),
+ * UpdateCommPort, and the line queue into WifiHandleResponse, as UpdateShell does.
+ * Everything the engine does is logged: the commands sent, the lines routed to each command,
+ * the final responses, and the lines left for UpdateShell. Each step is checked against the expected log.
+ * The scripts cover pipelining, ERROR and FAIL, timeouts, busy, unsolicited lines (and an +IPD payload) arriving
+ * in the middle of a command, a command which cannot be written yet, a command line longer than the TX buffer,
+ * and the line of a WC: command, which is sent by a task.
+ * The batch scripts queue text records for the uplink, and answer its AT+CIPSEND with prompts, SEND OK and SEND FAIL.
+ * The passthrough scripts enter passthrough mode, stream records, and leave it with +++ when a command is queued.
+ * The link negotiation scripts boot the ESP8266 and step the link speed up with AT+UART_CUR, checking the baud rate
+ * generator and the limit after each response, ERROR, and timeout.
+ */
+
+#include <xc.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "sram.h"
+#include "system.h"
+#include "wifi.h"
+#include "host.h"
+
+#define LOG_SIZE		1024
+
+extern WifiInfo _wifi;
+extern Shell _shell;
+extern bool _isServerLinePending;
+
+static char _log[LOG_SIZE];
+static char _lineData[LINE_BUFFER_SIZE];
+static Buffer _line;
+static char _txLine[LINE_BUFFER_SIZE];
+static unsigned int _txLength;
+static unsigned int _failures;
+static const char* _script;
+
+// Test commands: each logs its intermediate lines and its final response
+static const char* ResponseName(unsigned char response)
+{
+	switch(response)
+	{
+		case WIFI_RESPONSE_OK:			return "OK";
+		case WIFI_RESPONSE_ERROR:		return "ERROR";
+		case WIFI_RESPONSE_FAIL:		return "FAIL";
+		case WIFI_RESPONSE_SEND_OK:		return "SEND OK";
+		case WIFI_RESPONSE_SEND_FAIL:	return "SEND FAIL";
+		case WIFI_RESPONSE_BUSY:		return "BUSY";
+		case WIFI_RESPONSE_TIMEOUT:		return "TIMEOUT";
+	}
+	return "?";
+}
+
+static void Log(const char* format, ...)
+{
+	va_list args;
+	unsigned int length = strlen(_log);
+	if(length)
+		_log[length++] = ' ';
+	va_start(args, format);
+	vsnprintf(_log + length, LOG_SIZE - length, format, args);
+	va_end(args);
+}
+
+static bool WriteCommand(const char* command)
+{
+	if(!CommReserve(&_comm1, strlen(command) + 2))
+		return false;
+	CommPutString(&_comm1, command);
+	CommPutNewline(&_comm1);
+	return true;
+}
+
+#define TEST_COMMAND(name, timeout, responses) \
+	static bool Write##name(void) { return WriteCommand("AT+" #name); } \
+	static void Line##name(void* line) { Log(#name ".line(%s)", (char*) ((Buffer*) line)->data); } \
+	static void Done##name(unsigned char response) { Log(#name ".done(%s)", ResponseName(response)); } \
+	static const WifiCommand _command##name = {Write##name, Line##name, Done##name, timeout, responses};
+
+TEST_COMMAND(A, 1000, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR)
+TEST_COMMAND(B, 1000, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR)
+TEST_COMMAND(C, 1000, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR)
+TEST_COMMAND(JOIN, 20000, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR | WIFI_RESPONSE_FAIL)
+
+// A command whose done handler queues the next one
+static void DoneChain(unsigned char response)
+{
+	Log("CHAIN.done(%s)", ResponseName(response));
+	WifiQueueCommand(&_commandA);
+}
+static bool WriteChain(void) { return WriteCommand("AT+CHAIN"); }
+static const WifiCommand _commandChain = {WriteChain, NULL, DoneChain, 1000, WIFI_RESPONSE_OK};
+
+// A command line longer than the TX buffer, written in parts (as AtJoinNetwork and AtConnectTcp do)
+static const char _longHost[] = "uplink-collector.eu-west.example.invalid.measurement-gateway.smartmodule.example.org";
+static const char* const _longParts[] = {"AT+CIPSTART", "=\"TCP\",\"", _longHost, "\",", "50000"};
+#define LONG_PART_COUNT	(sizeof(_longParts) / sizeof(_longParts[0]))
+static uint16_t _longProgress;
+static bool WriteLong(void) { return CommPutLine(&_comm1, _longParts, LONG_PART_COUNT, &_longProgress); }
+static void DoneLong(unsigned char response) { Log("LONG.done(%s)", ResponseName(response)); }
+static const WifiCommand _commandLong = {WriteLong, NULL, DoneLong, 1000, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR};
+
+// Script steps
+static void Begin(const char* script)
+{
+	HostInitialize();
+	_wifi.statusBits.boot = WIFI_BOOT_COMPLETE;
+	_wifi.command.head = 0;
+	_wifi.command.count = 0;
+	_wifi.command.current = NULL;
+	_tick = 100000;
+	_log[0] = ASCII_NUL;
+	_txLength = 0;
+	_longProgress = 0;
+	_script = script;
+}
+
+static void Expect(const char* expected)
+{
+	if(strcmp(_log, expected) != 0)
+	{
+		printf("FAIL: %s\n  expected: %s\n  logged:   %s\n", _script, expected, _log);
+		_failures++;
+	}
+	_log[0] = ASCII_NUL;
+}
+
+/**
+ * Sends up to <code>count</code> characters from the TX buffer, logging every complete command line
+ * (and the +++ which leaves passthrough, which has no newline)
+ */
+static void Transmit(unsigned int count)
+{
+	while(count-- && (_comm1.urgent.length || _comm1.buffers.tx.length))
+	{
+		_CommTransmit(&_comm1);
+		char c = (char) *_comm1.registers->pTxReg;
+		if(c == ASCII_LF && _txLength && _txLine[_txLength - 1] == ASCII_CR)
+		{
+			_txLine[_txLength - 1] = ASCII_NUL;
+			Log("send(%s)", _txLine);
+			_txLength = 0;
+		}
+		else if(_txLength < sizeof(_txLine) - 1)
+			_txLine[_txLength++] = c;
+		if(_txLength == 3 && strncmp(_txLine, "+++", 3) == 0)
+		{
+			Log("send(+++)");
+			_txLength = 0;
+		}
+	}
+}
+
+/**
+ * One main loop pass of the engine, after which the UART sends everything written
+ */
+static void Pass(void)
+{
+	WifiUpdateCommands();
+	Transmit(~0u);
+}
+
+/**
+ * Receives a response stream, and routes every complete line as UpdateShell does
+ * (a partial line, such as the AT+CIPSEND prompt, is left in the RX buffer)
+ */
+static void Receive(const char* stream)
+{
+	uint16_t length;
+	while(*stream)
+		_CommReceive(&_comm1, *stream++);
+	do
+	{
+		length = _comm1.buffers.rx.length;
+		UpdateCommPort(&_comm1);
+		while(_comm1.buffers.external.length)
+		{
+			RingBufferDequeueSRAM(&_comm1.buffers.external, &_line);
+			if(!WifiHandleResponse(&_line))
+				Log("left(%s)", _lineData);
+		}
+	} while(_comm1.buffers.rx.length && _comm1.buffers.rx.length != length);
+}
+
+/**
+ * Receives a response stream, after which the UART sends everything written
+ */
+static void Respond(const char* stream)
+{
+	Receive(stream);
+	Transmit(~0u);
+}
+
+static void Queue(const WifiCommand* command, bool isExpected)
+{
+	if(WifiQueueCommand(command) != isExpected)
+	{
+		printf("FAIL: %s\n  WifiQueueCommand did not return %s\n", _script, isExpected ? "true" : "false");
+		_failures++;
+	}
+}
+
+// Link negotiation steps
+static const unsigned long _linkRates[] = {WIFI_LINK_RATE0, WIFI_LINK_RATE1, WIFI_LINK_RATE2, WIFI_LINK_RATE3};
+
+/**
+ * One main loop pass of the boot and link negotiation, after which the UART sends everything written
+ */
+static void LinkPass(void)
+{
+	if(_wifi.statusBits.boot != WIFI_BOOT_COMPLETE)
+		UpdateWifi();
+	Transmit(~0u);
+}
+
+/**
+ * Receives a response stream during boot, where each line is handed over with <b>hasLine</b>,
+ * then logs the lines passed on to the line queue
+ */
+static void LinkRespond(const char* stream)
+{
+	unsigned int passes = 0;
+	while(*stream)
+		_CommReceive(&_comm1, *stream++);
+	do
+	{
+		UpdateCommPort(&_comm1);
+		LinkPass();
+	} while((_comm1.buffers.rx.length || _comm1.statusBits.hasLine) && ++passes < 100);
+	LinkPass();
+	while(_comm1.buffers.external.length)
+	{
+		RingBufferDequeueSRAM(&_comm1.buffers.external, &_line);
+		Log("left(%s)", _lineData);
+	}
+}
+
+/**
+ * Releases the ESP8266 from reset and boots it up to the ATE0 which starts link negotiation
+ */
+static void LinkBoot(void)
+{
+	_wifi.statusBits.resetMode = WIFI_RESET_RELEASE;
+	WifiReset();
+	_tick += 101;
+	LinkPass();
+	LinkPass();
+	LinkRespond("ready\r\n");
+	Expect("send(ATE0)");
+}
+
+static void ExpectLink(unsigned char boot, unsigned char rate, unsigned char limit, unsigned long baud)
+{
+	unsigned int brg = ((unsigned int) SPBRGH1 << 8) | SPBRG1;
+	if(_wifi.statusBits.boot != boot || _wifi.link.rate != rate || _wifi.link.limit != limit
+	|| brg != (unsigned int) (CALCULATE_BRG_16H(baud)))
+	{
+		printf("FAIL: %s\n  expected boot %u, rate %u, limit %u, BRG %u\n  found    boot %u, rate %u, limit %u, BRG %u\n",
+			   _script, boot, rate, limit, (unsigned int) (CALCULATE_BRG_16H(baud)),
+			   _wifi.statusBits.boot, _wifi.link.rate, _wifi.link.limit, brg);
+		_failures++;
+	}
+}
+
+/**
+ * Expects the AT+UART_CUR request for the link speed after <code>rate</code>
+ */
+static void ExpectRequest(unsigned char rate)
+{
+	char expected[48];
+	sprintf(expected, "send(AT+UART_CUR=%lu,8,1,0,0)", _linkRates[rate + 1]);
+	Expect(expected);
+}
+
+// Uplink steps
+/**
+ * One main loop pass of the AT command engine and the uplink, after which the UART sends everything written
+ */
+static void UplinkPass(void)
+{
+	WifiUpdateCommands();
+	WifiUpdateUplink();
+	Transmit(~0u);
+}
+
+/**
+ * Queues a text record (a line, so that it is logged when it is sent) of <code>length</code> bytes
+ */
+static bool QueueText(unsigned int index, unsigned char length, bool isUrgent)
+{
+	char record[256];
+	unsigned char i;
+	sprintf(record, "r%u", index);
+	for(i = strlen(record); i < length - 2; i++)
+		record[i] = '.';
+	record[length - 2] = ASCII_CR;
+	record[length - 1] = ASCII_LF;
+	return WifiQueueRecord((const unsigned char*) record, length, isUrgent);
+}
+
+/**
+ * Runs the uplink for a number of passes, and returns the number of records sent
+ */
+static unsigned int CountSent(unsigned int passes)
+{
+	unsigned int records = 0;
+	char* entry;
+	while(passes--)
+	{
+		UplinkPass();
+		for(entry = strstr(_log, "send(r"); entry; entry = strstr(entry + 1, "send(r"))
+			records++;
+		_log[0] = ASCII_NUL;
+	}
+	return records;
+}
+
+/**
+ * Runs the uplink until the oldest batch has been written, and returns the number of records sent
+ */
+static unsigned int SendBatch(void)
+{
+	unsigned int records = 0, passes = 0;
+	char* entry;
+	while(_wifi.uplink.step != WIFI_UPLINK_CONFIRM && passes++ < 1000)
+	{
+		UplinkPass();
+		for(entry = strstr(_log, "send(r"); entry; entry = strstr(entry + 1, "send(r"))
+			records++;
+		_log[0] = ASCII_NUL;
+	}
+	return records;
+}
+
+static void ExpectUplink(unsigned char step, unsigned char closed, unsigned long batches, unsigned long dropped)
+{
+	if(_wifi.uplink.step != step || _wifi.uplink.closed != closed || _wifi.uplink.batches != batches
+	|| _wifi.uplink.dropped != dropped)
+	{
+		printf("FAIL: %s\n  expected step %u, %u closed, %lu sent, %lu dropped\n"
+			   "  found    step %u, %u closed, %lu sent, %lu dropped\n", _script, step, closed, batches, dropped,
+			   _wifi.uplink.step, _wifi.uplink.closed, (unsigned long) _wifi.uplink.batches,
+			   (unsigned long) _wifi.uplink.dropped);
+		_failures++;
+	}
+}
+
+/**
+ * Enters passthrough mode: AT+CIPMODE=1, then AT+CIPSEND, whose prompt starts the stream
+ */
+static void EnterPassthrough(void)
+{
+	UplinkPass();
+	Respond("OK\r\n");
+	Expect("send(AT+CIPMODE=1) send(AT+CIPSEND)");
+	Respond("OK\r\n> ");
+	UplinkPass();
+	Expect("");
+	if(_wifi.uplink.step != WIFI_UPLINK_STREAM || !_wifi.uplink.isPassthrough)
+	{
+		printf("FAIL: %s\n  passthrough was not entered (step %u)\n", _script, _wifi.uplink.step);
+		_failures++;
+	}
+}
+
+/**
+ * Starts a script with the TCP connection up, and batches sent with AT+CIPSEND (passthrough was rejected)
+ */
+static void BeginUplink(const char* script)
+{
+	Begin(script);
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	_wifi.uplink.isPassthroughFailed = true;
+}
+
+// Scripts
+static void TestPipeline(void)
+{
+	Begin("pipeline: each command is sent as soon as the previous one completes");
+	Queue(&_commandA, true);
+	Queue(&_commandB, true);
+	Queue(&_commandC, true);
+	Pass();
+	Expect("send(AT+A)");
+	Respond("+A:1\r\nOK\r\n");
+	Expect("A.line(+A:1) left(+A:1) A.done(OK) send(AT+B)");
+	Respond("ERROR\r\n");
+	Expect("B.done(ERROR) send(AT+C)");
+
+	// FAIL is not a final response of C, so it is an intermediate line
+	Respond("FAIL\r\nOK\r\n");
+	Expect("C.line(FAIL) left(FAIL) C.done(OK)");
+	Pass();
+	Expect("");
+
+	// A done handler which queues a command starts it right away
+	Queue(&_commandChain, true);
+	Pass();
+	Respond("OK\r\n");
+	Expect("send(AT+CHAIN) CHAIN.done(OK) send(AT+A)");
+	Respond("OK\r\n");
+	Expect("A.done(OK)");
+}
+
+static void TestFail(void)
+{
+	Begin("FAIL: a command which expects FAIL completes with it");
+	Queue(&_commandJOIN, true);
+	Pass();
+	Respond("WIFI DISCONNECT\r\n+CWJAP:3\r\n\r\nFAIL\r\n");
+	Expect("send(AT+JOIN) JOIN.line(WIFI DISCONNECT) left(WIFI DISCONNECT) JOIN.line(+CWJAP:3) left(+CWJAP:3) "
+		   "JOIN.line() left() JOIN.done(FAIL)");
+}
+
+static void TestTimeout(void)
+{
+	Begin("timeout: a command without a final response times out, and a late response is left for UpdateShell");
+	Queue(&_commandA, true);
+	Queue(&_commandB, true);
+	Pass();
+	Expect("send(AT+A)");
+	_tick += 1000;
+	Pass();
+	Expect("");
+	_tick++;
+	Pass();
+	Expect("A.done(TIMEOUT)");
+
+	// B is sent on the next pass, so a late response to A, received before then, is left for UpdateShell
+	Respond("OK\r\n");
+	Expect("left(OK)");
+	Pass();
+	Expect("send(AT+B)");
+	_tick += 1001;
+	Pass();
+	Expect("B.done(TIMEOUT)");
+	Respond("OK\r\n");
+	Expect("left(OK)");
+}
+
+static void TestUnsolicited(void)
+{
+	Begin("unsolicited lines in the middle of a command are passed on, and do not complete it");
+	Queue(&_commandA, true);
+	Pass();
+	Expect("send(AT+A)");
+	Respond("WIFI CONNECTED\r\nWIFI GOT IP\r\n+IPD,0,5:hello0,CLOSED\r\n");
+	Expect("A.line(WIFI CONNECTED) left(WIFI CONNECTED) A.line(WIFI GOT IP) left(WIFI GOT IP) "
+		   "A.line(0,CLOSED) left(0,CLOSED)");
+	if(_comm1Payloads.count != 1 || CommPeekPayload(&_comm1)->length != 5)
+	{
+		printf("FAIL: %s\n  the +IPD payload was not received\n", _script);
+		_failures++;
+	}
+	Respond("OK\r\n");
+	Expect("A.done(OK)");
+
+	// With no command waiting for a response, every line is left for UpdateShell
+	Respond("OK\r\nERROR\r\n");
+	Expect("left(OK) left(ERROR)");
+}
+
+static void TestBusy(void)
+{
+	Begin("busy: the command is sent again after WIFI_COMMAND_BUSY_DELAY, up to WIFI_COMMAND_MAX_RETRIES times");
+	unsigned char i;
+	Queue(&_commandA, true);
+	Pass();
+	Expect("send(AT+A)");
+	for(i = 0; i < WIFI_COMMAND_MAX_RETRIES; i++)
+	{
+		Respond("busy p...\r\n");
+		Pass();
+		Expect("");
+		_tick += WIFI_COMMAND_BUSY_DELAY + 1;
+		Pass();
+		Expect("send(AT+A)");
+	}
+	Respond("busy p...\r\n");
+	Expect("A.done(BUSY)");
+
+	// A busy reply followed by the final response
+	Queue(&_commandB, true);
+	Pass();
+	Respond("busy p...\r\n");
+	_tick += WIFI_COMMAND_BUSY_DELAY + 1;
+	Pass();
+	Respond("OK\r\n");
+	Expect("send(AT+B) send(AT+B) B.done(OK)");
+}
+
+static void TestBlocked(void)
+{
+	Begin("blocked: a command is only timed from when it has been written, and it waits for the uplink");
+	unsigned int i;
+	for(i = 0; i < TX_BUFFER_SIZE; i++)
+		CommPutChar(&_comm1, 'x');
+	Queue(&_commandA, true);
+	WifiUpdateCommands();
+	Receive("OK\r\n");
+	Expect("left(OK)");
+	_tick += 5000;
+	WifiUpdateCommands();
+	Expect("");
+	if(_wifi.command.isSent || _wifi.command.current != &_commandA)
+	{
+		printf("FAIL: %s\n  the command was taken as sent before it was written\n", _script);
+		_failures++;
+	}
+	Transmit(~0u);
+	_txLength = 0;
+	Pass();
+	Expect("send(AT+A)");
+	Respond("OK\r\n");
+	Expect("A.done(OK)");
+
+	// No command is started while the uplink is sending
+	_wifi.uplink.step = WIFI_UPLINK_CONFIRM;
+	Queue(&_commandB, true);
+	Pass();
+	Expect("");
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+	Pass();
+	Expect("send(AT+B)");
+
+	// The queue holds WIFI_COMMAND_QUEUE_SIZE commands besides the current one, and a reset discards them
+	for(i = 0; i < WIFI_COMMAND_QUEUE_SIZE; i++)
+		Queue(&_commandC, true);
+	Queue(&_commandC, false);
+	_wifi.statusBits.resetMode = WIFI_RESET_RELEASE;
+	WifiReset();
+	_comm1.modeBits.ignoreRx = false;
+	_comm1.modeBits.useExternalBuffer = true;
+	_wifi.statusBits.boot = WIFI_BOOT_COMPLETE;
+	Respond("OK\r\n");
+	Pass();
+	Expect("left(OK)");
+}
+
+static void TestLongLine(void)
+{
+	Begin("long line: a command longer than the TX buffer is sent whole, and timed from its last character");
+	char expected[256] = "send(";
+	unsigned int i, passes = 0;
+	for(i = 0; i < LONG_PART_COUNT; i++)
+		strcat(expected, _longParts[i]);
+	strcat(expected, ")");
+
+	Queue(&_commandLong, true);
+	WifiUpdateCommands();
+	while(!_wifi.command.isSent && passes < 1000)
+	{
+		Transmit(7);
+		_tick += 100;
+		WifiUpdateCommands();
+		passes++;
+	}
+	Transmit(~0u);
+	Expect(expected);
+	if(_comm1.txCounters.dropped || _longProgress != 0 || _wifi.command.eventTime != _tick)
+	{
+		printf("FAIL: %s\n  dropped=%lu progress=%u sent at %lu (now %lu)\n", _script,
+			   (unsigned long) _comm1.txCounters.dropped, _longProgress,
+			   (unsigned long) _wifi.command.eventTime, (unsigned long) _tick);
+		_failures++;
+	}
+	Respond("OK\r\n");
+	Expect("LONG.done(OK)");
+}
+
+static void TestPutLine(void)
+{
+	Begin("CommPutLine: parts longer than the TX buffer, sent with every amount of room");
+	static const char* const parts[] = {"", _longHost, ",", _longHost, "", "!"};
+	const unsigned int partCount = sizeof(parts) / sizeof(parts[0]);
+	char expected[512] = "";
+	unsigned int i, room, completions = 0, calls = 0;
+	uint16_t progress = 0;
+	for(i = 0; i < partCount; i++)
+		strcat(expected, parts[i]);
+
+	// The UART sends between 1 and 13 characters between calls
+	for(room = 1; room <= 13; room++)
+	{
+		char sent[512] = "send(";
+		_log[0] = ASCII_NUL;
+		while(!CommPutLine(&_comm1, parts, (unsigned char) partCount, &progress))
+		{
+			Transmit(room);
+			calls++;
+		}
+		completions++;
+		Transmit(~0u);
+		strcat(sent, expected);
+		strcat(sent, ")");
+		Expect(sent);
+	}
+
+	// Room for the text, but not for the newline
+	for(i = 0; i < TX_BUFFER_SIZE - 1; i++)
+		_txLine[i] = 'y';
+	_txLine[TX_BUFFER_SIZE - 1] = ASCII_NUL;
+	{
+		const char* const text[] = {_txLine};
+		char copy[TX_BUFFER_SIZE];
+		strcpy(copy, _txLine);
+		_txLength = 0;
+		bool isFirst = CommPutLine(&_comm1, text, 1, &progress);
+		unsigned int firstProgress = progress;
+		Transmit(1);
+		bool isSecond = CommPutLine(&_comm1, text, 1, &progress);
+		Transmit(~0u);
+		if(isFirst || firstProgress != TX_BUFFER_SIZE - 1 || !isSecond || progress != 0)
+		{
+			printf("FAIL: %s\n  a line which fills the TX buffer was not completed by the next call\n", _script);
+			_failures++;
+		}
+		char sent[TX_BUFFER_SIZE + 8] = "send(";
+		strcat(sent, copy);
+		strcat(sent, ")");
+		Expect(sent);
+	}
+
+	if(completions != 13 || _comm1.txCounters.dropped)
+	{
+		printf("FAIL: %s\n  %u of 13 lines completed, %lu characters dropped\n", _script, completions,
+			   (unsigned long) _comm1.txCounters.dropped);
+		_failures++;
+	}
+	else
+		printf("CommPutLine: 13 lines of %u characters through a %u-character TX buffer in %u calls\n",
+			   (unsigned int) strlen(expected) + 2, TX_BUFFER_SIZE, calls + 13);
+}
+
+static void TestServerLine(void)
+{
+	Begin("WC: a line longer than the TX buffer is copied, and sent by TaskSendServerLine as the TX buffer makes room");
+	char data[LINE_BUFFER_SIZE];
+	char expected[LINE_BUFFER_SIZE + 8] = "send(";
+	Buffer command;
+	unsigned int runs = 1;
+	InitializeBuffer(&command, LINE_BUFFER_SIZE, 1, data);
+	strcpy(data, "WC:");
+	strcat(data, _longHost);
+	command.length = strlen(data);
+	strcat(expected, _longHost);
+	strcat(expected, ")");
+
+	// The command returns at once, and the swap buffer may be reused
+	ShellParseCommandLine(&command);
+	memset(data, 'z', sizeof(data) - 1);
+	data[sizeof(data) - 1] = ASCII_NUL;
+	Expect("");
+
+	// A second line, while the first is being sent, is dropped
+	strcpy(data, "WC:AT");
+	command.length = 5;
+	ShellParseCommandLine(&command);
+	if(_shell.result.lastWarning != SHELL_WARNING_DATA_TRUNCATED)
+	{
+		printf("FAIL: %s\n  a line which arrived while one was being sent was not reported\n", _script);
+		_failures++;
+	}
+
+	while(!TaskSendServerLine() && runs < 1000)
+	{
+		Transmit(7);
+		runs++;
+	}
+	Transmit(~0u);
+	Expect(expected);
+	if(_isServerLinePending || runs < 2 || _comm1.txCounters.dropped)
+	{
+		printf("FAIL: %s\n  pending=%u after %u runs, %lu characters dropped\n", _script, _isServerLinePending, runs,
+			   (unsigned long) _comm1.txCounters.dropped);
+		_failures++;
+	}
+
+	// Once it has been sent, the next line is taken
+	ShellParseCommandLine(&command);
+	TaskSendServerLine();
+	Transmit(~0u);
+	Expect("send(AT)");
+}
+
+static void TestBatchClose(void)
+{
+	BeginUplink("batches: a batch is closed once its oldest record is WIFI_UPLINK_MAX_AGE old, and sent with AT+CIPSEND");
+	unsigned int i;
+	QueueText(1, 8, false);
+	UplinkPass();
+	_tick += WIFI_UPLINK_MAX_AGE;
+	QueueText(2, 8, false);
+	UplinkPass();
+	Expect("");
+	_tick++;
+	UplinkPass();
+	Expect("send(AT+CIPSEND=16)");
+	ExpectUplink(WIFI_UPLINK_PROMPT, 1, 0, 0);
+
+	// The OK before the prompt is an intermediate line, and the batch is written once the prompt has arrived
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	UplinkPass();
+	UplinkPass();
+	UplinkPass();
+	Expect("send(r1....) send(r2....)");
+	ExpectUplink(WIFI_UPLINK_CONFIRM, 1, 0, 0);
+	Respond("\r\nRecv 16 bytes\r\n\r\nSEND OK\r\n");
+	Expect("left(> ) left(Recv 16 bytes) left()");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 1, 0);
+
+	// A record which does not fit closes the batch being filled, which is then sent without waiting
+	for(i = 0; i < WIFI_UPLINK_BATCH_SIZE / 128; i++)
+		QueueText(i, 128, false);
+	QueueText(i, 8, false);
+	UplinkPass();
+	Expect("send(AT+CIPSEND=2048)");
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	if(SendBatch() != WIFI_UPLINK_BATCH_SIZE / 128)
+	{
+		printf("FAIL: %s\n  the full batch was not sent whole\n", _script);
+		_failures++;
+	}
+	Respond("\r\nSEND OK\r\n");
+	Expect("left(> )");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 2, 0);
+	UplinkPass();
+	Expect("");
+
+	// An urgent record closes the batch being filled at once
+	QueueText(100, 8, true);
+	UplinkPass();
+	Expect("send(AT+CIPSEND=16)");
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	SendBatch();
+	Respond("\r\nSEND OK\r\n");
+	Expect("left(> )");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 3, 0);
+	if(_wifi.uplink.length[_wifi.uplink.head] || _wifi.uplink.isUrgent)
+	{
+		printf("FAIL: %s\n  the batch being filled was not cleared after the urgent batch\n", _script);
+		_failures++;
+	}
+}
+
+static void TestBatchResend(void)
+{
+	BeginUplink("batches: a batch is sent again after a prompt timeout or SEND FAIL, and is only removed after SEND OK");
+	QueueText(1, 8, true);
+	UplinkPass();
+	Expect("send(AT+CIPSEND=8)");
+
+	// No prompt: the uplink gives up after WIFI_UPLINK_TIMEOUT, and the command times out after twice that
+	_tick += WIFI_UPLINK_TIMEOUT;
+	UplinkPass();
+	ExpectUplink(WIFI_UPLINK_PROMPT, 1, 0, 0);
+	_tick++;
+	UplinkPass();
+	ExpectUplink(WIFI_UPLINK_IDLE, 1, 0, 0);
+	Expect("");
+	_tick += WIFI_UPLINK_TIMEOUT;
+	UplinkPass();
+	Expect("send(AT+CIPSEND=8)");
+	ExpectUplink(WIFI_UPLINK_PROMPT, 1, 0, 0);
+
+	// SEND FAIL: the same batch is sent again
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	SendBatch();
+	Respond("\r\nSEND FAIL\r\n");
+	Expect("left(> )");
+	ExpectUplink(WIFI_UPLINK_IDLE, 1, 0, 0);
+	UplinkPass();
+	Expect("send(AT+CIPSEND=8)");
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	UplinkPass();
+	UplinkPass();
+	UplinkPass();
+	Expect("send(r1....)");
+	Respond("\r\nSEND OK\r\n");
+	Expect("left(> )");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 1, 0);
+}
+
+static void TestBatchFull(void)
+{
+	BeginUplink("batches: records are dropped while every batch is waiting to be sent");
+	unsigned int i, queued = 0;
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+	for(i = 0; i < WIFI_UPLINK_SLOTS * WIFI_UPLINK_BATCH_SIZE / 128 + 3; i++)
+	{
+		if(QueueText(i, 128, false))
+			queued++;
+	}
+	ExpectUplink(WIFI_UPLINK_IDLE, WIFI_UPLINK_SLOTS - 1, 0, 3);
+	if(queued != WIFI_UPLINK_SLOTS * WIFI_UPLINK_BATCH_SIZE / 128)
+	{
+		printf("FAIL: %s\n  %u records were queued\n", _script, queued);
+		_failures++;
+	}
+
+	// Once the oldest batch has been sent, records are taken again
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	UplinkPass();
+	Expect("send(AT+CIPSEND=2048)");
+	Respond("OK\r\n> ");
+	Expect("left(OK)");
+	if(SendBatch() != WIFI_UPLINK_BATCH_SIZE / 128)
+	{
+		printf("FAIL: %s\n  the oldest batch was not sent whole\n", _script);
+		_failures++;
+	}
+	Respond("\r\nSEND OK\r\n");
+	Expect("left(> )");
+	ExpectUplink(WIFI_UPLINK_IDLE, WIFI_UPLINK_SLOTS - 2, 1, 3);
+	if(!QueueText(i, 128, false))
+	{
+		printf("FAIL: %s\n  a record was dropped after a batch had been sent\n", _script);
+		_failures++;
+	}
+	ExpectUplink(WIFI_UPLINK_IDLE, WIFI_UPLINK_SLOTS - 1, 1, 3);
+}
+
+static void TestPassthrough(void)
+{
+	Begin("passthrough: records are streamed as they are queued, and +++ is framed by WIFI_ESCAPE_GUARD");
+	unsigned int i;
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	EnterPassthrough();
+
+	// Records are sent without AT+CIPSEND, and without waiting for the batch to close
+	QueueText(1, 8, false);
+	UplinkPass();
+	UplinkPass();
+	Expect("send(r1....)");
+	ExpectUplink(WIFI_UPLINK_STREAM, 0, 0, 0);
+
+	// A queued command leaves passthrough. The guard time starts once the TX buffer is empty,
+	// and a chunk read but not yet sent is dropped, to be read again (the offset has not moved)
+	QueueText(2, 8, false);
+	WifiUpdateUplink();
+	WifiUpdateUplink();
+	QueueText(3, 8, false);
+	WifiUpdateUplink();
+	Queue(&_commandA, true);
+	WifiUpdateCommands();
+	WifiUpdateUplink();
+	_tick += 2 * WIFI_ESCAPE_GUARD;
+	UplinkPass();
+	Expect("send(r2....)");
+	ExpectUplink(WIFI_UPLINK_GUARD, 0, 0, 0);
+	if(_wifi.uplink.offset != 16 || _wifi.uplink.chunk.length)
+	{
+		printf("FAIL: %s\n  the stream was left at offset %u with a chunk of %u\n", _script, _wifi.uplink.offset,
+			   _wifi.uplink.chunk.length);
+		_failures++;
+	}
+	_tick += WIFI_ESCAPE_GUARD;
+	UplinkPass();
+	Expect("");
+	_tick++;
+	UplinkPass();
+	Expect("send(+++)");
+
+	// Nothing is sent for WIFI_ESCAPE_GUARD after +++, then the command goes out
+	_tick += WIFI_ESCAPE_GUARD;
+	UplinkPass();
+	Expect("");
+	ExpectUplink(WIFI_UPLINK_ESCAPE, 0, 0, 0);
+	_tick++;
+	UplinkPass();
+	UplinkPass();
+	Expect("send(AT+A)");
+	if(_wifi.uplink.isPassthrough)
+	{
+		printf("FAIL: %s\n  isPassthrough was not cleared after +++\n", _script);
+		_failures++;
+	}
+	// The prompt which started passthrough is completed by the newline before the response
+	Respond("\r\nOK\r\n");
+	Expect("A.line(> ) left(> ) A.done(OK)");
+
+	// Passthrough resumes at the offset where it was left
+	EnterPassthrough();
+	UplinkPass();
+	UplinkPass();
+	Expect("send(r3....)");
+	ExpectUplink(WIFI_UPLINK_STREAM, 0, 0, 0);
+
+	// A lost connection also leaves passthrough, and it is not entered again until the connection is back
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+	Respond("\r\nCLOSED\r\n");
+	Expect("left(> ) left(CLOSED)");
+	UplinkPass();
+	_tick += WIFI_ESCAPE_GUARD + 1;
+	UplinkPass();
+	_tick += WIFI_ESCAPE_GUARD + 1;
+	UplinkPass();
+	UplinkPass();
+	Expect("send(+++)");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 0, 0);
+
+	// A batch closed by a record which does not fit is streamed to its end, then the next one from its start
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	EnterPassthrough();
+	for(i = 0; i < (WIFI_UPLINK_BATCH_SIZE - 24) / 128 + 1; i++)
+		QueueText(10 + i, 128, false);
+	if(CountSent(400) != i)
+	{
+		printf("FAIL: %s\n  the records of a closed batch and the next one were not streamed\n", _script);
+		_failures++;
+	}
+	ExpectUplink(WIFI_UPLINK_STREAM, 0, 1, 0);
+	if(_wifi.uplink.offset != 128 || _wifi.uplink.tail != _wifi.uplink.head)
+	{
+		printf("FAIL: %s\n  the next batch was not streamed from its start (offset %u)\n", _script,
+			   _wifi.uplink.offset);
+		_failures++;
+	}
+}
+
+static void TestPassthroughRejected(void)
+{
+	Begin("passthrough: AT+CIPMODE=1 rejected with ERROR falls back to AT+CIPSEND per batch, until the next reset");
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	QueueText(1, 8, true);
+	UplinkPass();
+	Respond("ERROR\r\n");
+	Expect("send(AT+CIPMODE=1)");
+	UplinkPass();
+	Expect("send(AT+CIPSEND=8)");
+	if(_wifi.uplink.isPassthrough || !_wifi.uplink.isPassthroughFailed)
+	{
+		printf("FAIL: %s\n  passthrough was not given up after ERROR\n", _script);
+		_failures++;
+	}
+	_wifi.statusBits.resetMode = WIFI_RESET_RELEASE;
+	WifiReset();
+	if(_wifi.uplink.isPassthroughFailed)
+	{
+		printf("FAIL: %s\n  passthrough was not tried again after a reset\n", _script);
+		_failures++;
+	}
+
+	// AT+CIPSEND rejected: passthrough is tried again on the next pass
+	Begin("passthrough: AT+CIPSEND rejected with ERROR leaves passthrough, and it is tried again");
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+	UplinkPass();
+	Respond("OK\r\n");
+	Respond("ERROR\r\n");
+	Expect("send(AT+CIPMODE=1) send(AT+CIPSEND)");
+	ExpectUplink(WIFI_UPLINK_IDLE, 0, 0, 0);
+	if(_wifi.uplink.isPassthrough || _wifi.uplink.isPassthroughFailed)
+	{
+		printf("FAIL: %s\n  passthrough was not left for a retry\n", _script);
+		_failures++;
+	}
+	UplinkPass();
+	Expect("send(AT+CIPMODE=1)");
+}
+
+static void TestLinkStepUp(void)
+{
+	Begin("link negotiation: each speed is requested, switched to after its OK, and verified, up to the limit");
+	unsigned char rate, limit = _wifi.link.limit;
+	LinkBoot();
+	ExpectLink(WIFI_BOOT_NEGOTIATING, 0, limit, WIFI_LINK_RATE0);
+
+	LinkRespond("OK\r\n");
+	ExpectRequest(0);
+	for(rate = 0; rate < limit; rate++)
+	{
+		// The OK arrives at the current speed, after which both ends switch and settle.
+		// A line which is not a response is passed on.
+		LinkRespond(rate == 0 ? "WIFI DISCONNECT\r\nOK\r\n" : "OK\r\n");
+		Expect(rate == 0 ? "left(WIFI DISCONNECT)" : "");
+		ExpectLink(WIFI_BOOT_NEGOTIATING, rate, limit, _linkRates[rate + 1]);
+		_tick += WIFI_LINK_SETTLE - 1;
+		LinkPass();
+		Expect("");
+		_tick++;
+		LinkPass();
+		Expect("send(AT)");
+
+		// The AT round trip at the new speed verifies it, and the next speed is requested
+		_tick += WIFI_LINK_TIMEOUT;
+		LinkRespond("OK\r\n");
+		if(rate + 1 < limit)
+			ExpectRequest(rate + 1);
+	}
+	Expect("");
+	ExpectLink(WIFI_BOOT_COMPLETE, limit, limit, _linkRates[limit]);
+	if(!_comm1.modeBits.useExternalBuffer)
+	{
+		printf("FAIL: %s\n  the line queue was not enabled once negotiation completed\n", _script);
+		_failures++;
+	}
+}
+
+static void TestLinkError(void)
+{
+	Begin("link negotiation: a speed rejected with ERROR becomes the limit, and negotiation stops at the current speed");
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	ExpectRequest(0);
+	LinkRespond("ERROR\r\n");
+	Expect("");
+	ExpectLink(WIFI_BOOT_COMPLETE, 0, 0, WIFI_LINK_RATE0);
+
+	// The limit is kept across a restart, so the next boot does not request the speed again
+	WifiRestart();
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	Expect("");
+	ExpectLink(WIFI_BOOT_COMPLETE, 0, 0, WIFI_LINK_RATE0);
+}
+
+static void TestLinkTimeout(void)
+{
+	Begin("link negotiation: a speed which is not accepted or not verified in time restarts the ESP8266 with a lower limit");
+	unsigned char limit = _wifi.link.limit;
+
+	// No response to AT+UART_CUR: nothing at exactly WIFI_LINK_TIMEOUT, a restart a millisecond later
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	ExpectRequest(0);
+	_tick += WIFI_LINK_TIMEOUT;
+	LinkPass();
+	ExpectLink(WIFI_BOOT_NEGOTIATING, 0, limit, WIFI_LINK_RATE0);
+	_tick++;
+	LinkPass();
+	ExpectLink(WIFI_BOOT_POWER_ON_RESET_HOLD, 0, 0, WIFI_BAUD_BOOT);
+	Expect("");
+
+	// The power-on sequence restarts the module, which then completes at the current speed
+	_tick += 2001;
+	LinkPass();
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	Expect("");
+	ExpectLink(WIFI_BOOT_COMPLETE, 0, 0, WIFI_LINK_RATE0);
+
+	// Accepted, but the AT round trip at the new speed is never answered
+	_wifi.link.limit = limit;
+	WifiRestart();
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	ExpectRequest(0);
+	LinkRespond("OK\r\n");
+	_tick += WIFI_LINK_SETTLE;
+	LinkPass();
+	Expect("send(AT)");
+	ExpectLink(WIFI_BOOT_NEGOTIATING, 0, limit, WIFI_LINK_RATE1);
+	_tick += WIFI_LINK_TIMEOUT + 1;
+	LinkPass();
+	ExpectLink(WIFI_BOOT_POWER_ON_RESET_HOLD, 0, 0, WIFI_BAUD_BOOT);
+	_tick += 2001;
+	LinkPass();
+	LinkBoot();
+	LinkRespond("OK\r\n");
+	Expect("");
+	ExpectLink(WIFI_BOOT_COMPLETE, 0, 0, WIFI_LINK_RATE0);
+}
+
+int main(void)
+{
+	InitializeBuffer(&_line, LINE_BUFFER_SIZE, 1, _lineData);
+	TestPipeline();
+	TestFail();
+	TestTimeout();
+	TestUnsolicited();
+	TestBusy();
+	TestBlocked();
+	TestLongLine();
+	TestPutLine();
+	TestServerLine();
+	TestBatchClose();
+	TestBatchResend();
+	TestBatchFull();
+	TestPassthrough();
+	TestPassthroughRejected();
+	TestLinkStepUp();
+	TestLinkError();
+	TestLinkTimeout();
+	if(_failures)
+		return 1;
+	printf("AT command engine: pipeline, FAIL, timeout, unsolicited lines, busy, blocked, long line, WC line: passed\n");
+	printf("Batches: closed on age, size, and urgent records; resent after a prompt timeout and SEND FAIL; "
+		   "dropped while the queue is full: passed\n");
+	printf("Passthrough: CIPMODE, streaming, +++ guard times, resume at the offset, lost connection, rejection: "
+		   "passed\n");
+	printf("Link negotiation: step-up to %lu baud, ERROR, switch timeout, verify timeout: passed\n",
+		   _linkRates[WIFI_LINK_RATES - 1]);
+	return 0;
+}
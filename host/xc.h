@@ -0,0 +1,162 @@
+/**@file		xc.h
+ * @brief		Host stand-in for the XC8 device header, so that the firmware sources build with gcc on Linux.
+ *				Special function registers are plain variables (defined once in registers.c), and every SFR bit
+ *				structure is one <b>HostBits</b> with a byte per bit field. Nothing here models the peripherals:
+ *				the harnesses set and read the registers themselves.
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+// XC8 types and keywords (the 24-bit short long types are rewritten to these by xc8types.sed)
+typedef uint32_t uint24_t;
+typedef int32_t int24_t;
+#define __interrupt(priority)
+#define CLRWDT()	(_hostWatchdogClears++)
+#define ClrWdt()	(_hostWatchdogClears++)
+#define Reset()		do { } while(0)
+#define RESET()		do { } while(0)
+#define NOP()		do { } while(0)
+#define di()		do { } while(0)
+#define ei()		do { } while(0)
+
+/**@struct HostBits
+ * Every SFR bit field used by the firmware (one byte each, so a field holds any value the firmware writes)
+ */
+typedef struct HostBits
+{
+	unsigned char ACQT, TO, POR, ADCAL, ADCS, ADFM, ADIE, ADIF;
+	unsigned char ADIP, ADON, ALRMEN, BRG16, BRGH, CCP1IF, CHS, CKE;
+	unsigned char CKP, CREN, DLYCYC, DLYINTEN, DMAEN, DUPLEX0, DUPLEX1, FERR;
+	unsigned char GIEH, GIEL, GO, GO_DONE, INT1IE, INT1IF, INT1IP, INT2IE;
+	unsigned char INT2IF, INT2IP, INTEDG1, INTEDG2, INTLVL, IOLOCK, IPEN, IRCF;
+	unsigned char LATA6, LATA7, LATB0, LATB1, LATB3, LATC2, OERR, PCFG11;
+	unsigned char PSA, RA0, RA1, RA2, RA3, RBPU, RC1IE, RC1IF;
+	unsigned char RC1IP, RC2IE, RC2IF, RC2IP, REGSLP, RODIV, ROON, ROSEL;
+	unsigned char RP1, RP11, RP12, RP2, RP5, RP7, RP8, RTCEN;
+	unsigned char RTCOE, RTCPTR0, RTCPTR1, RTCSYNC, RTCWREN, RX1, RX9, RXDTP;
+	unsigned char RXINC, SCK1, SCS, SDI1, SDO1, SMP, SPEN, SPI2OD;
+	unsigned char SSCON0, SSCON1, SSP2IE, SSP2IF, SSP2IP, SSPEN, SSPM, SWDTEN;
+	unsigned char SYNC, T08BIT, T0CS, T0PS, T1OSCEN, T4CKPS, T4OUTPS, T6CKPS;
+	unsigned char T6OUTPS, TMR0IE, TMR0IF, TMR0IP, TMR0ON, TMR1IE, TMR1IF, TMR2IE;
+	unsigned char TMR2IF, TMR4IE, TMR4IF, TMR4IP, TMR4ON, TMR6IE, TMR6IF, TMR6IP;
+	unsigned char TMR6ON, TRMT, TX1, TX1IE, TX1IF, TX1IP, TX2IE, TX2IF;
+	unsigned char TX2IP, TX9, TXCKP, TXEN, TXINC, ULPEN, ULPSINK, VBGOE;
+	unsigned char VCFG;
+} HostBits;
+typedef HostBits TXSTAbits_t;
+
+// Registers (defined in registers.c)
+#ifdef HOST_DEFINE_REGISTERS
+#define HOST_REGISTER(type, name)	volatile type name
+#else
+#define HOST_REGISTER(type, name)	extern volatile type name
+#endif
+
+HOST_REGISTER(HostBits, ADCON0bits);
+HOST_REGISTER(HostBits, ADCON1bits);
+HOST_REGISTER(HostBits, ALRMCFGbits);
+HOST_REGISTER(HostBits, ANCON1bits);
+HOST_REGISTER(HostBits, BAUDCON1bits);
+HOST_REGISTER(HostBits, BAUDCON2bits);
+HOST_REGISTER(HostBits, DMACON1bits);
+HOST_REGISTER(HostBits, DMACON2bits);
+HOST_REGISTER(HostBits, INTCON2bits);
+HOST_REGISTER(HostBits, INTCON3bits);
+HOST_REGISTER(HostBits, INTCONbits);
+HOST_REGISTER(HostBits, IPR1bits);
+HOST_REGISTER(HostBits, IPR3bits);
+HOST_REGISTER(HostBits, IPR5bits);
+HOST_REGISTER(HostBits, LATAbits);
+HOST_REGISTER(HostBits, LATBbits);
+HOST_REGISTER(HostBits, LATCbits);
+HOST_REGISTER(HostBits, ODCON3bits);
+HOST_REGISTER(HostBits, OSCCONbits);
+HOST_REGISTER(HostBits, PIE1bits);
+HOST_REGISTER(HostBits, PIE3bits);
+HOST_REGISTER(HostBits, PIE5bits);
+HOST_REGISTER(HostBits, PIR1bits);
+HOST_REGISTER(HostBits, PIR3bits);
+HOST_REGISTER(HostBits, PIR5bits);
+HOST_REGISTER(HostBits, PORTAbits);
+HOST_REGISTER(HostBits, PORTBbits);
+HOST_REGISTER(HostBits, PORTCbits);
+HOST_REGISTER(HostBits, PPSCONbits);
+HOST_REGISTER(HostBits, RCONbits);
+HOST_REGISTER(HostBits, RCSTA1bits);
+HOST_REGISTER(HostBits, RCSTA2bits);
+HOST_REGISTER(HostBits, REFOCONbits);
+HOST_REGISTER(HostBits, RTCCFGbits);
+HOST_REGISTER(HostBits, SSP2CON1bits);
+HOST_REGISTER(HostBits, SSP2STATbits);
+HOST_REGISTER(HostBits, T0CONbits);
+HOST_REGISTER(HostBits, T1CONbits);
+HOST_REGISTER(HostBits, T4CONbits);
+HOST_REGISTER(HostBits, T6CONbits);
+HOST_REGISTER(HostBits, TXSTA1bits);
+HOST_REGISTER(HostBits, TXSTA2bits);
+HOST_REGISTER(HostBits, WDTCONbits);
+HOST_REGISTER(unsigned char, ADCON0);
+HOST_REGISTER(unsigned int, ADRES);
+HOST_REGISTER(unsigned char, ADRESH);
+HOST_REGISTER(unsigned char, ADRESL);
+HOST_REGISTER(unsigned char, ALCFGRPT);
+HOST_REGISTER(unsigned char, ANCON0);
+HOST_REGISTER(unsigned char, ANCON1);
+HOST_REGISTER(unsigned char, DMABCH);
+HOST_REGISTER(unsigned char, DMABCL);
+HOST_REGISTER(unsigned char, EECON2);
+HOST_REGISTER(unsigned char, LATA);
+HOST_REGISTER(unsigned char, LATB);
+HOST_REGISTER(unsigned char, LATC);
+HOST_REGISTER(unsigned char, PIE1);
+HOST_REGISTER(unsigned char, PIE3);
+HOST_REGISTER(unsigned char, PIE5);
+HOST_REGISTER(unsigned char, PORTA);
+HOST_REGISTER(unsigned char, PORTB);
+HOST_REGISTER(unsigned char, PORTC);
+HOST_REGISTER(unsigned char, PR4);
+HOST_REGISTER(unsigned char, PR6);
+HOST_REGISTER(unsigned char, RCREG1);
+HOST_REGISTER(unsigned char, RCREG2);
+HOST_REGISTER(unsigned char, RPINR1);
+HOST_REGISTER(unsigned char, RPINR16);
+HOST_REGISTER(unsigned char, RPINR2);
+HOST_REGISTER(unsigned char, RPINR21);
+HOST_REGISTER(unsigned char, RPINR22);
+HOST_REGISTER(unsigned char, RPOR11);
+HOST_REGISTER(unsigned char, RPOR7);
+HOST_REGISTER(unsigned char, RPOR8);
+HOST_REGISTER(unsigned char, RTCVALH);
+HOST_REGISTER(unsigned char, RTCVALL);
+HOST_REGISTER(unsigned char, RXADDRH);
+HOST_REGISTER(unsigned char, RXADDRL);
+HOST_REGISTER(unsigned char, SPBRG1);
+HOST_REGISTER(unsigned char, SPBRG2);
+HOST_REGISTER(unsigned char, SPBRGH1);
+HOST_REGISTER(unsigned char, SPBRGH2);
+HOST_REGISTER(unsigned char, T6CON);
+HOST_REGISTER(unsigned int, TMR0);
+HOST_REGISTER(unsigned char, TMR6);
+HOST_REGISTER(unsigned char, TRISA);
+HOST_REGISTER(unsigned char, TRISB);
+HOST_REGISTER(unsigned char, TRISC);
+HOST_REGISTER(unsigned char, TXADDRH);
+HOST_REGISTER(unsigned char, TXADDRL);
+HOST_REGISTER(unsigned char, TXREG1);
+HOST_REGISTER(unsigned char, TXREG2);
+HOST_REGISTER(unsigned char, TXSTA1);
+HOST_REGISTER(unsigned char, TXSTA2);
+
+// Number of times the firmware has cleared the watchdog timer
+HOST_REGISTER(unsigned long, _hostWatchdogClears);
+
+#endif
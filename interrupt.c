@@ -1,161 +1,310 @@
-/* Project:	SmartModule
- * File:	interrupt.c
- * Author:	Jonathan Ruisi
- * Created:	December 19, 2016, 5:26 AM
- */
-
-#include <xc.h>
-#include <stdbool.h>
-#include <stdint.h>
-#include "interrupt.h"
-#include "main.h"
-#include "system.h"
-#include "button.h"
-#include "serial_comm.h"
-#include "sram.h"
-#include "utility.h"
-
-void __interrupt(high_priority) isrHighPriority(void)
-{
-	if(PIR1bits.ADIF)
-	{
-		if(_adc.samples.length < _adc.samples.capacity)
-			RingBufferEnqueue(&_adc.samples, (unsigned int*) ADRES);
-		PIR1bits.ADIF = false;
-	}
-	else if(PIR3bits.TMR4IF)
-	{
-		_tick++;
-		PIR3bits.TMR4IF = false;
-	}
-	else if(PIR5bits.TMR6IF)
-	{
-		ADCON0bits.GO = true;
-		PIR5bits.TMR6IF = false;
-	}
-	else if(INTCON3bits.INT1IF)
-	{
-		CheckButtonState(&_button, BUTTON);
-		INTCON3bits.INT1IF = false;
-	}
-	return;
-}
-
-void __interrupt(low_priority) isrLowPriority(void)
-{
-	if(PIR3bits.SSP2IF)
-	{
-		if(_sram.bytesRemaining == 0)
-		{
-			RAM_CS = 1;
-			if(_sram.statusBits.currentOperation == SRAM_OP_READ)
-				_sram.targetBuffer->length = _sram.dataLength;
-			_sram.statusBits.busy = false;
-		}
-
-		if(_sram.statusBits.busy)
-		{
-			switch(_sram.statusBits.currentOperation)
-			{
-				case SRAM_OP_READ:
-				{
-					_SramReadBytes();
-					break;
-				}
-				case SRAM_OP_WRITE:
-				{
-					_SramWriteBytes();
-					break;
-				}
-				case SRAM_OP_FILL:
-				{
-					_SramFill();
-					break;
-				}
-			}
-		}
-		PIR3bits.SSP2IF = false;
-	}
-
-	if(PIR1bits.TX1IF)
-	{
-		if(_comm1.buffers.tx.length && !_comm1.statusBits.isTxPaused)
-			RingBufferDequeue(&_comm1.buffers.tx, &TXREG1);
-		else
-			PIE1bits.TX1IE = false;
-	}
-
-	if(PIR1bits.RC1IF)
-	{
-		char data = RCREG1;
-		if(!_comm1.modeBits.ignoreRx)
-		{
-			if(data == ASCII_XOFF && _comm1.statusBits.isTxFlowControl)
-				_comm1.statusBits.isTxPaused = true;
-			else if(data == ASCII_XON && _comm1.statusBits.isTxFlowControl)
-				_comm1.statusBits.isTxPaused = false;
-			else
-				RingBufferEnqueue(&_comm1.buffers.rx, (char*) data);
-
-			if(_comm1.statusBits.isRxFlowControl
-			&&!_comm1.statusBits.isRxPaused
-			&& _comm1.buffers.rx.length >= XOFF_THRESHOLD)
-			{
-				while(!TXSTA1bits.TRMT)
-					continue;
-				TXREG1 = ASCII_XOFF;
-				_comm1.statusBits.isRxPaused = true;
-			}
-		}
-	}
-
-	if(PIR3bits.TX2IF)
-	{
-		if(_comm2.buffers.tx.length && !_comm2.statusBits.isTxPaused)
-			RingBufferDequeue(&_comm2.buffers.tx, &TXREG2);
-		else
-			PIE3bits.TX2IE = false;
-	}
-
-	if(PIR3bits.RC2IF)
-	{
-		char data = RCREG2;
-		if(!_comm2.modeBits.ignoreRx)
-		{
-			if(data == ASCII_XOFF && _comm2.statusBits.isTxFlowControl)
-				_comm2.statusBits.isTxPaused = true;
-			else if(data == ASCII_XON && _comm2.statusBits.isTxFlowControl)
-				_comm2.statusBits.isTxPaused = false;
-			else
-				RingBufferEnqueue(&_comm2.buffers.rx, (char*) data);
-
-			if(_comm2.statusBits.isRxFlowControl
-			&&!_comm2.statusBits.isRxPaused
-			&& _comm2.buffers.rx.length >= XOFF_THRESHOLD)
-			{
-				while(!TXSTA2bits.TRMT)
-					continue;
-				TXREG2 = ASCII_XOFF;
-				_comm2.statusBits.isRxPaused = true;
-			}
-		}
-	}
-
-	if(INTCONbits.TMR0IF)
-	{
-		RELAY_RES = 0;
-		RELAY_SET = 0;
-		T0CONbits.TMR0ON = false;
-		TMR0 = TIMER0_START_VALUE;
-		INTCONbits.TMR0IF = false;
-	}
-
-	if(INTCON3bits.INT2IF && !_prox.isTripped)
-	{
-		_prox.lastTripped = _tick;
-		_prox.count++;
-		_prox.isTripped = true;
-		INTCON3bits.INT2IF = false;
-	}
-	return;
+/* Project:	SmartModule
+ * File:	interrupt.c
+ * Author:	Jonathan Ruisi
+ * Created:	December 19, 2016, 5:26 AM
+ */
+
+#include <xc.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "interrupt.h"
+#include "main.h"
+#include "system.h"
+#include "button.h"
+#include "serial_comm.h"
+#include "sram.h"
+#include "utility.h"
+
+void __interrupt(high_priority) isrHighPriority(void)
+{
+	if(PIR1bits.ADIF)
+	{
+#if ADC_SCAN_COUNT > 1
+		// Select the next input right away (it is acquired until TMR6 starts the next conversion)
+		unsigned char channel = _adc.channel;
+		if(++_adc.channel >= ADC_SCAN_COUNT)
+			_adc.channel = 0;
+		ADCON0bits.CHS = _adcChannels[_adc.channel];
+
+		// The other inputs are accumulated into the window of the current sensor sample that precedes them
+		if(channel)
+		{
+			volatile AdcChannelSums* sums = &_adc.windows[_adc.active].channels[channel - 1];
+			unsigned int result = ADRES;
+			sums->sum += result;
+			sums->sumSquares += (unsigned long int) result * result;
+		}
+		else
+#endif
+		{
+			// Accumulate the sums for the RMS calculation (see CalculateCurrentRMS)
+			volatile AdcWindow* window = &_adc.windows[_adc.active];
+			int sample = (int) ADRES - window->offset;
+#if ADC_SCAN_COUNT > 1 || ADC_HARMONIC_COUNT
+			unsigned char i;
+#endif
+
+			// Rising zero crossings (the hysteresis keeps noise around zero from producing extra crossings)
+			bool isCrossing = false;
+			if(sample < -ADC_ZC_HYSTERESIS)
+				_adc.isArmed = true;
+			else if(sample >= 0 && _adc.isArmed)
+			{
+				_adc.isArmed = false;
+				isCrossing = true;
+			}
+
+			// A window ends at the zero crossing that completes the configured number of mains cycles,
+			// or after the configured number of samples if there are not enough crossings
+			if((isCrossing && window->cycles >= _adc.sampling.windowCycles) || window->count >= _adc.sampling.windowSize)
+			{
+				int offset = window->offset;
+				if(isCrossing)
+				{
+					window->end.before = _adc.previous;
+					window->end.after = sample;
+				}
+				else
+					window->isSynchronized = false;
+
+				// Hand the complete window over and continue with the other one,
+				// unless the previous window is still waiting (this window is then discarded)
+				if(_adc.isReady)
+					_adc.overruns++;
+				else
+				{
+					_adc.active ^= 1;
+					_adc.isReady = true;
+					window = &_adc.windows[_adc.active];
+				}
+				window->sum = 0;
+				window->sumSquares = 0;
+				window->count = 0;
+				window->cycles = 0;
+				window->isSynchronized = isCrossing;
+				window->start.before = _adc.previous;
+				window->start.after = sample;
+
+				// A new DC offset (see CalculateCurrentRMS) only takes effect at the start of a window
+				window->offset = _adc.dcOffset;
+				sample += offset - window->offset;
+
+				// A new sampling configuration (see ConfigureSampling) only takes effect at the start of a window.
+				// The first sample interval of the window is still the old one, so its zero crossings are not used
+				if(_adc.isPending)
+				{
+					_adc.sampling = _adc.pending;
+					T6CONbits.T6CKPS = _adc.pending.prescale == 1 ? 0 : (_adc.pending.prescale == 4 ? 1 : 2);
+					T6CONbits.T6OUTPS = _adc.pending.postscale - 1;
+					PR6 = _adc.pending.period;
+					TMR6 = 0;
+					_adc.samplePeriod = _adc.pendingPeriod;
+					_adc.isPending = false;
+					window->isSynchronized = false;
+#if ADC_HARMONIC_COUNT
+					_adc.harmonicCount = 0;
+#endif
+#if ADC_CAPTURE_SIZE
+					// A capture in progress would mix two sample rates, so it is started over
+					if(_adc.capture.state < ADC_CAPTURE_DONE)
+					{
+						_adc.capture.state = ADC_CAPTURE_FILLING;
+						_adc.capture.remaining = ADC_CAPTURE_PRE_TRIGGER;
+					}
+#endif
+				}
+				window->period = _adc.samplePeriod;
+#if ADC_SCAN_COUNT > 1
+				for(i = 0; i < ADC_SCAN_COUNT - 1; i++)
+				{
+					window->channels[i].sum = 0;
+					window->channels[i].sumSquares = 0;
+				}
+#endif
+#if ADC_HARMONIC_COUNT
+				window->harmonicCount = _adc.harmonicCount;
+				window->inputShift = _adc.inputShift;
+				for(i = 0; i < ADC_HARMONIC_COUNT; i++)
+					window->coefficients[i] = _adc.coefficients[i];
+#endif
+			}
+
+#if ADC_HARMONIC_COUNT
+			// The Goertzel filters run over the stored samples once the window is complete (see TaskCalculateHarmonics)
+			if(window->count < ADC_HARMONIC_SAMPLES)
+				_adc.samples[_adc.active][window->count] = sample;
+#endif
+			window->sum += sample;
+			window->sumSquares += (unsigned long int) ((long int) sample * sample);
+			window->count++;
+			if(isCrossing)
+				window->cycles++;
+			_adc.previous = sample;
+#if ADC_CAPTURE_SIZE
+			// Transient recorder (see TaskStoreCapture)
+			if(_adc.capture.state < ADC_CAPTURE_DONE)
+			{
+				_adc.capture.samples[_adc.capture.index++ & (ADC_CAPTURE_SIZE - 1)] = sample;
+				if(_adc.capture.state == ADC_CAPTURE_ARMED)
+				{
+					if(sample > _adc.capture.high || sample < _adc.capture.low)
+					{
+						_adc.capture.state = ADC_CAPTURE_TRIGGERED;
+						_adc.capture.time = _tick;
+					}
+				}
+				else if(--_adc.capture.remaining == 0)
+				{
+					// The pre-trigger history is full (FILLING -> ARMED), or the capture is complete (TRIGGERED -> DONE)
+					_adc.capture.state++;
+					_adc.capture.remaining = ADC_CAPTURE_SIZE - ADC_CAPTURE_PRE_TRIGGER - 1;
+				}
+			}
+#endif
+		}
+		PIR1bits.ADIF = false;
+	}
+	else if(PIR3bits.TMR4IF)
+	{
+		_tick++;
+		PIR3bits.TMR4IF = false;
+	}
+	else if(PIR5bits.TMR6IF)
+	{
+		ADCON0bits.GO = true;
+		PIR5bits.TMR6IF = false;
+	}
+	else if(INTCON3bits.INT1IF)
+	{
+		CheckButtonState(&_button, BUTTON);
+		INTCON3bits.INT1IF = false;
+	}
+	return;
+}
+
+void __interrupt(low_priority) isrLowPriority(void)
+{
+	if(PIR3bits.SSP2IF)
+	{
+		if(_sram.bytesRemaining == 0)
+		{
+			RAM_CS = 1;
+			if(_sram.statusBits.currentOperation == SRAM_OP_READ)
+				_sram.targetBuffer->length = _sram.dataLength;
+			_sram.statusBits.busy = false;
+		}
+
+		if(_sram.statusBits.busy)
+		{
+			switch(_sram.statusBits.currentOperation)
+			{
+				case SRAM_OP_READ:
+				{
+					_SramReadBytes();
+					break;
+				}
+				case SRAM_OP_WRITE:
+				{
+					_SramWriteBytes();
+					break;
+				}
+				case SRAM_OP_FILL:
+				{
+					_SramFill();
+					break;
+				}
+			}
+		}
+		PIR3bits.SSP2IF = false;
+	}
+
+	if(PIR1bits.TX1IF && PIE1bits.TX1IE)
+		_CommTransmit(&_comm1);
+
+	if(PIR1bits.RC1IF && PIE1bits.RC1IE)
+	{
+		// The framing error flag belongs to the character at the top of the FIFO, so it is read before RCREG1
+		bool isFramingError = RCSTA1bits.FERR;
+		char data = RCREG1;
+
+		// After an overrun the receiver stops until it is reset (the characters which arrived meanwhile are lost)
+		if(RCSTA1bits.OERR)
+		{
+			RCSTA1bits.CREN = false;
+			RCSTA1bits.CREN = true;
+			_comm1.rxCounters.overrun++;
+		}
+
+		if(isFramingError)
+			_comm1.rxCounters.framing++;
+		else if(!_comm1.modeBits.ignoreRx)
+		{
+			if(data == ASCII_XOFF && _comm1.statusBits.isTxFlowControl)
+				_comm1.statusBits.isTxPaused = true;
+			else if(data == ASCII_XON && _comm1.statusBits.isTxFlowControl)
+				_comm1.statusBits.isTxPaused = false;
+			else
+				_CommReceive(&_comm1, data);
+
+			if(_comm1.statusBits.isRxFlowControl
+			&&!_comm1.statusBits.isRxPaused
+			&& _comm1.buffers.rx.length >= XOFF_THRESHOLD
+			&& _CommPutUrgent(&_comm1, ASCII_XOFF))
+				_comm1.statusBits.isRxPaused = true;
+		}
+	}
+
+	if(PIR3bits.TX2IF && PIE3bits.TX2IE)
+		_CommTransmit(&_comm2);
+
+	if(PIR3bits.RC2IF && PIE3bits.RC2IE)
+	{
+		// The framing error flag belongs to the character at the top of the FIFO, so it is read before RCREG2
+		bool isFramingError = RCSTA2bits.FERR;
+		char data = RCREG2;
+
+		// After an overrun the receiver stops until it is reset (the characters which arrived meanwhile are lost)
+		if(RCSTA2bits.OERR)
+		{
+			RCSTA2bits.CREN = false;
+			RCSTA2bits.CREN = true;
+			_comm2.rxCounters.overrun++;
+		}
+
+		if(isFramingError)
+			_comm2.rxCounters.framing++;
+		else if(!_comm2.modeBits.ignoreRx)
+		{
+			if(data == ASCII_XOFF && _comm2.statusBits.isTxFlowControl)
+				_comm2.statusBits.isTxPaused = true;
+			else if(data == ASCII_XON && _comm2.statusBits.isTxFlowControl)
+				_comm2.statusBits.isTxPaused = false;
+			else
+				_CommReceive(&_comm2, data);
+
+			if(_comm2.statusBits.isRxFlowControl
+			&&!_comm2.statusBits.isRxPaused
+			&& _comm2.buffers.rx.length >= XOFF_THRESHOLD
+			&& _CommPutUrgent(&_comm2, ASCII_XOFF))
+				_comm2.statusBits.isRxPaused = true;
+		}
+	}
+
+	if(INTCONbits.TMR0IF)
+	{
+		RELAY_RES = 0;
+		RELAY_SET = 0;
+		T0CONbits.TMR0ON = false;
+		TMR0 = TIMER0_START_VALUE;
+		INTCONbits.TMR0IF = false;
+	}
+
+	if(INTCON3bits.INT2IF && !_prox.isTripped)
+	{
+		_prox.lastTripped = _tick;
+		_prox.count++;
+		_prox.isTripped = true;
+		INTCON3bits.INT2IF = false;
+	}
+	return;
 }
\ No newline at end of file
@@ -1,995 +1,2588 @@
-/**@file		main.c
- * @brief		Implementation of the RTOS, task scheduler, and SmartModule operations
- * @author		Jonathan Ruisi
- * @version		1.0
- * @date		December 16, 2016
- * @copyright	GNU Public License
- */
-
-#include <xc.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <stdlib.h>
-#include <stdarg.h>
-#include <string.h>
-#include <math.h>
-#include "main.h"
-#include "system.h"
-#include "button.h"
-#include "serial_comm.h"
-#include "sram.h"
-#include "wifi.h"
-#include "linked_list.h"
-#include "utility.h"
-
-// GLOBAL VARIABLES------------------------------------------------------------
-volatile uint32_t _tick = 0;	/**< Global timekeeping variable (not related to RTCC)*/
-volatile ButtonInfo _button;	/**< The main SmartModule button */
-volatile Sram _sram;			/**< Main SRAM control structure */
-CommPort _comm1, _comm2;		/**< USART1 and USART2 (wifi and debug terminal) control structures */
-const CommDataRegisters _comm1Regs = {&TXREG1, (TXSTAbits_t*) & TXSTA1, &PIE1, 4};
-const CommDataRegisters _comm2Regs = {&TXREG2, (TXSTAbits_t*) & TXSTA2, &PIE3, 4};
-WifiInfo _wifi;					/**< Main WIFI control structure */
-Shell _shell;					/**< Main SHELL control structure */
-Task _taskListData[SHELL_MAX_TASKS];
-AdcRmsInfo _adc;				/**< ADC measurement control structure */
-uint16_t _adcData[ADC_WINDOW_SIZE];
-unsigned char _relayState;		/**< Current state of the relay */
-ProxDetectInfo _prox;			/**< Proximity detection information structure */
-
-// PROGRAM ENTRY & MAIN LOOP---------------------------------------------------
-
-/**
- * Program entry point and main loop
- */
-void main(void)
-{
-	// Initialize device
-	ConfigureOscillator();
-	ConfigureWDT();
-	ConfigurePorts();
-	ConfigureTimers();
-	ConfigureSPI();
-	ConfigureUSART();
-	ConfigureRTCC();
-	ConfigureADC();
-	ConfigureInterrupts();
-	ConfigureOS();
-
-	// Main program loop
-main_loop:
-	// BUTTON------------------------------------------
-	UpdateButton(&_button);
-
-	// USART-------------------------------------------
-	UpdateCommPort(&_comm1);
-	UpdateCommPort(&_comm2);
-
-	// WIFI--------------------------------------------
-	UpdateWifi();
-
-	// SHELL-------------------------------------------
-	UpdateShell();
-	goto main_loop;
-}
-
-// SHELL UPDATE FUNCTION-------------------------------------------------------
-
-/**
- * This function performs all related shell operations based on the current state of the RTOS and any received commands.
- * A call to this function must be placed in the main program loop.
- * @see main()
- */
-void UpdateShell(void)
-{
-	// Manage tasks (this is delayed by SHELL_RESET_DELAY upon a device reset)
-	if(_tick > SHELL_RESET_DELAY)
-		TaskScheduler();
-
-	if(_shell.server->buffers.external.length && !_sram.statusBits.busy)
-	{
-		RingBufferDequeueSRAM(&_shell.server->buffers.external, &_shell.swapBuffer);
-		while(_sram.statusBits.busy)
-			continue;
-
-		if((BufferContains(&_shell.swapBuffer, "OK", 2) == 0)
-		|| (BufferContains(&_shell.swapBuffer, "ERROR", 2) == 0))
-		{
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1B.y, COORD_VALUE_COMM1B.x);
-			CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1B.y, COORD_VALUE_COMM1B.x);
-			CommPutString(_shell.terminal, (char*) _shell.swapBuffer.data);
-		}
-		else
-		{
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1A.y, COORD_VALUE_COMM1A.x);
-			CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1B.y, COORD_VALUE_COMM1B.x);
-			CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1A.y, COORD_VALUE_COMM1A.x);
-			CommPutString(_shell.terminal, (char*) _shell.swapBuffer.data);
-		}
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1C.y, COORD_VALUE_COMM1C.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM1D.y, COORD_VALUE_COMM1D.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-
-		if(BufferContains(&_shell.swapBuffer, "WIFI GOT IP", 11) >= 0)
-		{
-			_wifi.statusBits.isSsidConnected = true;
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "Connected");
-			_wifi.eventTime = _tick;
-
-			// Send command to connect to TCP server
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "Connecting...");
-			ShellAddTask(TaskConnectTcp, 1, 0, 0, false, false, false, 0);
-		}
-		else if(BufferContains(&_shell.swapBuffer, "WIFI CONNECTED", 14) >= 0)
-		{
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "Connecting...");
-		}
-		else if(BufferContains(&_shell.swapBuffer, "WIFI DISCONNECT", 15) >= 0)
-		{
-			_wifi.statusBits.isSsidConnected = false;
-			_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_SSID_STATUS.y, COORD_VALUE_SSID_STATUS.x);
-			CommPutString(_shell.terminal, "Disconnected");
-			ShellAddTask(TaskConnectNetwork, 1, 0, 0, false, false, false, 0);
-		}
-		else if(_wifi.statusBits.isSsidConnected &&
-				_wifi.statusBits.tcpConnectionStatus == WIFI_TCP_CONNECTING &&
-				BufferContains(&_shell.swapBuffer, "OK", 2) == 0)
-		{
-			_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "Ready");
-		}
-		else if(_wifi.statusBits.isSsidConnected &&
-				BufferContains(&_shell.swapBuffer, "CLOSED", 6) >= 0)
-		{
-			_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "Closed");
-			//ShellAddTask(ShellConnectTcp, 1, 0, 0, false, false, false, 0);
-			//_wifi.eventTime = _tick;
-		}
-		else if(BufferContains(&_shell.swapBuffer, "ERROR", 5) >= 0)
-		{
-			_shell.result.lastError = SHELL_ERROR_WIFI_COMMAND;
-			_shell.result.values[0] = _tick;
-		}
-		else if(BufferContains(&_shell.swapBuffer, "#", 1) == 0)
-		{
-			ShellParseCommandLine(&_shell.swapBuffer);
-		}
-		_shell.swapBuffer.length = 0;
-	}
-	else if(_shell.terminal->buffers.external.length && !_sram.statusBits.busy)
-	{
-		RingBufferDequeueSRAM(&_shell.terminal->buffers.external, &_shell.swapBuffer);
-		while(_sram.statusBits.busy)
-			continue;
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_ERROR.y, COORD_VALUE_ERROR.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM2A.y, COORD_VALUE_COMM2A.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM2B.y, COORD_VALUE_COMM2B.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM2C.y, COORD_VALUE_COMM2C.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_COMM2D.y, COORD_VALUE_COMM2D.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		ShellParseCommandLine(&_shell.swapBuffer);
-		_shell.swapBuffer.length = 0;
-	}
-
-	if(_shell.result.lastWarning)
-		ShellPrintLastWarning(32, 0);
-
-	if(_shell.result.lastError)
-		ShellPrintLastError(32, 0);
-}
-
-// SHELL MANAGEMENT FUNCTIONS--------------------------------------------------
-
-/**
- * Initializes the shell environment
- * @param serverComm		Pointer to a <code>CommPort</code> structure which is defined for the WIFI module
- * @param terminalComm		Pointer to a <code>CommPort</code> structure which is defined for the debug terminal
- * @param swapBufferSize	The capacity (in bytes) of the shell's swap buffer
- * @param swapBufferData	Pointer to an array allocated for swap buffer data
- */
-void ShellInitialize(CommPort* serverComm, CommPort* terminalComm,
-					 uint16_t swapBufferSize, char* swapBufferData)
-{
-
-	_shell.result.lastWarning = 0;
-	_shell.result.lastError = 0;
-	_shell.task.current = 0;
-	_shell.server = serverComm;
-	_shell.terminal = terminalComm;
-	InitializeBuffer(&_shell.swapBuffer, swapBufferSize, 1, swapBufferData);
-	LinkedList_16Element_Initialize(&_shell.task.list, &_taskListData, sizeof(Task));
-
-	// Print basic layout
-	ShellPrintBasicLayout();
-
-	// Add one-shot tasks
-	ShellAddTask(TaskUpdateRelayStatus, 1, 0, 0, false, false, false, 0);
-
-	// Add persistent tasks
-	ShellAddTask(TaskPrintDateTime, 0, 1000, 0, false, true, true, 1, _shell.terminal);
-	ShellAddTask(TaskPrintTick, 0, 125, 0, false, true, true, 1, _shell.terminal);
-	ShellAddTask(TaskCalculateRMSCurrent, 0, 500, 0, false, true, true, 0);
-	ShellAddTask(TaskUpdateProximityStatus, 0, 2000, 0, false, true, true, 0);
-	ShellAddTask(TaskPrintTemp, 0, 10000, 0, false, true, true, 0);
-}
-
-/**
- * Parses the buffer for any commands it recognizes
- * @param buffer Pointer to a <code>Buffer</code> containing the data to parse
- */
-void ShellParseCommandLine(Buffer* buffer)
-{
-	if(BufferContains(buffer, "WC:", 3) == 0)
-	{
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_CMD.y, COORD_VALUE_CMD.x);
-		CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_CMD.y, COORD_VALUE_CMD.x);
-		CommPutString(_shell.terminal, (uint8_t*) buffer->data);
-		CommPutString(_shell.server, ((uint8_t*) buffer->data) + 3);
-		CommPutNewline(_shell.server);
-	}
-	else if(BufferContains(buffer, "#", 1) == 0)
-	{
-		_shell.swapBuffer = BufferTrimLeft(&_shell.swapBuffer, 1);
-		if(BufferContains(buffer, "tcpStart", 8) == 0)
-		{
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "             ");
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_HOST_STATUS.y, COORD_VALUE_HOST_STATUS.x);
-			CommPutString(_shell.terminal, "Connecting...");
-			ShellAddTask(TaskConnectTcp, 1, 0, 0, false, false, false, 0);
-		}
-		else if(BufferContains(buffer, "SRLS:", 5) == 0)
-		{
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_CMD.y, COORD_VALUE_CMD.x);
-			CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
-			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_CMD.y, COORD_VALUE_CMD.x);
-			CommPutString(_shell.terminal, (uint8_t*) buffer->data);
-
-			if(BufferContains(buffer, "0", 1) == 5)
-				RelayControl(0);
-			else if(BufferContains(buffer, "1", 1) == 5)
-				RelayControl(1);
-		}
-	}
-	else
-		_shell.result.lastError = SHELL_ERROR_COMMAND_NOT_RECOGNIZED;
-}
-
-/**
- * Callback function for handling any ANSI control sequences received on a specified COMM port
- * @param comm Pointer to a <code>CommPort</code>
- * @warning this function currently contains no actions - these must be implemented
- */
-void ShellHandleSequence(CommPort* comm)
-{
-	switch(comm->sequence.terminator)
-	{
-		case ANSI_CUU:
-		{
-
-			break;
-		}
-		case ANSI_CUD:
-		{
-
-			break;
-		}
-		case ANSI_CUF:
-		{
-
-			break;
-		}
-		case ANSI_CUB:
-		{
-
-			break;
-		}
-	}
-	CommResetSequence(comm);
-}
-
-/**
- * Prints the basic layout of the debug environment to the debug terminal
- */
-void ShellPrintBasicLayout(void)
-{
-	// Clear screen
-	CommPutSequence(_shell.terminal, ANSI_EDISP, 1, 2);
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 0);
-
-	// Print version info
-	CommPutString(_shell.terminal, "SmartModule");
-	CommPutNewline(_shell.terminal);
-	CommPutString(_shell.terminal, "HW: Rev.2");
-	CommPutNewline(_shell.terminal);
-	CommPutString(_shell.terminal, "FW: v1.00");
-	CommPutNewline(_shell.terminal);
-
-	// Print borders
-	unsigned char i;
-	for(i = 0; i < 49; i++)
-		CommPutChar(_shell.terminal, '_');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 7, 0);
-	for(i = 0; i < 49; i++)
-		CommPutChar(_shell.terminal, '_');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 1, 13);
-	for(i = 0; i < 7; i++)
-	{
-		CommPutChar(_shell.terminal, '|');
-		CommPutSequence(_shell.terminal, ANSI_CUD, 0);
-		CommPutSequence(_shell.terminal, ANSI_CUB, 0);
-	}
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 1, 50);
-	for(i = 0; i < 7; i++)
-	{
-		CommPutChar(_shell.terminal, '|');
-		CommPutSequence(_shell.terminal, ANSI_CUD, 0);
-		CommPutSequence(_shell.terminal, ANSI_CUB, 0);
-	}
-
-	// Print labels
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_NAME.y, COORD_LABEL_NAME.x);
-	CommPutString(_shell.terminal, "NAME");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_STATUS.y, COORD_LABEL_STATUS.x);
-	CommPutString(_shell.terminal, "STATUS");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_SSID.y, COORD_LABEL_SSID.x);
-	CommPutString(_shell.terminal, "SSID: ");
-	CommPutString(_shell.terminal, network_ssid);
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_HOST.y, COORD_LABEL_HOST.x);
-	CommPutString(_shell.terminal, "HOST: ");
-	CommPutString(_shell.terminal, tcp_server);
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_RELAY.y, COORD_LABEL_RELAY.x);
-	CommPutString(_shell.terminal, "RELAY:");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_PROX.y, COORD_LABEL_PROX.x);
-	CommPutString(_shell.terminal, "PROX:");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_TEMP.y, COORD_LABEL_TEMP.x);
-	CommPutString(_shell.terminal, "TEMP:");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_LOAD.y, COORD_LABEL_LOAD.x);
-	CommPutString(_shell.terminal, "LOAD:");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_UPTIME.y, COORD_LABEL_UPTIME.x);
-	CommPutString(_shell.terminal, "SYS TIME (ms):");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM1A.y, COORD_LABEL_COMM1A.x);
-	CommPutString(_shell.terminal, "COMM1>");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM1B.y, COORD_LABEL_COMM1B.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM1C.y, COORD_LABEL_COMM1C.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM1D.y, COORD_LABEL_COMM1D.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM2A.y, COORD_LABEL_COMM2A.x);
-	CommPutString(_shell.terminal, "COMM2>");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM2B.y, COORD_LABEL_COMM2B.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM2C.y, COORD_LABEL_COMM2C.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_COMM2D.y, COORD_LABEL_COMM2D.x);
-	CommPutChar(_shell.terminal, '>');
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_LABEL_CMD.y, COORD_LABEL_CMD.x);
-	CommPutString(_shell.terminal, "CMD:");
-}
-
-/**
- * Prints the last warning to the debug terminal at the location specified
- * @param row	Terminal row at which the output will be printed
- * @param col	Terminal column at which the output will be printed
- */
-void ShellPrintLastWarning(unsigned char row, unsigned char col)
-{
-	char valueStr[16];
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_ERROR.y, COORD_VALUE_ERROR.x);
-	CommPutString(_shell.terminal, "WARNING: ");
-	switch(_shell.result.lastWarning)
-	{
-		case SHELL_WARNING_DATA_TRUNCATED:
-		{
-			CommPutString(_shell.terminal, "Data truncated (");
-			ltoa(&valueStr, _shell.result.values[0], 10);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, "->");
-			ltoa(&valueStr, _shell.result.values[1], 10);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutChar(_shell.terminal, ')');
-			break;
-		}
-		case SHELL_WARNING_FIFO_BUFFER_OVERWRITE:
-		{
-			ltoa(&valueStr, _shell.result.values[0], 16);
-			CommPutString(_shell.terminal, "The FIFO buffer (0x");
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, ") is full. At least one value has been overwritten.");
-			break;
-		}
-		default:
-		{
-
-			CommPutString(_shell.terminal, "UNDEFINED");
-			break;
-		}
-	}
-	_shell.result.lastWarning = 0;
-}
-
-/**
- * Prints the last error to the debug terminal at the location specified
- * @param row	Terminal row at which the output will be printed
- * @param col	Terminal column at which the output will be printed
- */
-void ShellPrintLastError(unsigned char row, unsigned char col)
-{
-	char valueStr[16];
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_ERROR.y, COORD_VALUE_ERROR.x);
-	CommPutString(_shell.terminal, "ERROR: ");
-	switch(_shell.result.lastError)
-	{
-		case SHELL_ERROR_SRAM_BUSY:
-		{
-			CommPutString(_shell.terminal, "SRAM busy");
-			break;
-		}
-		case SHELL_ERROR_ZERO_LENGTH:
-		{
-			CommPutString(_shell.terminal, "Length = 0");
-			break;
-		}
-		case SHELL_ERROR_ADDRESS_RANGE:
-		{
-			CommPutString(_shell.terminal, "Specified address (0x");
-			ltoa(&valueStr, _shell.result.values[0], 16);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, ") is outside the valid range (0x");
-			ltoa(&valueStr, _shell.result.values[1], 16);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, "-0x");
-			ltoa(&valueStr, _shell.result.values[2], 16);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutChar(_shell.terminal, ')');
-			break;
-		}
-		case SHELL_ERROR_LINE_QUEUE_EMPTY:
-		{
-			CommPutString(_shell.terminal, "Line queue is empty");
-			break;
-		}
-		case SHELL_ERROR_COMMAND_NOT_RECOGNIZED:
-		{
-			CommPutString(_shell.terminal, "Command not recognized: ");
-			CommPutString(_shell.terminal, _shell.swapBuffer.data);
-			break;
-		}
-		case SHELL_ERROR_TASK_TIMEOUT:
-		{
-			ltoa(&valueStr, _shell.result.values[0], 16);
-			CommPutString(_shell.terminal, "The task (0x");
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, ") has timed out after ");
-			ltoa(&valueStr, _shell.result.values[1], 10);
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, "ms");
-			break;
-		}
-		case SHELL_ERROR_NULL_REFERENCE:
-		{
-			CommPutString(_shell.terminal, "NULL reference");
-			break;
-		}
-		case SHELL_ERROR_WIFI_COMMAND:
-		{
-			ultoa(&valueStr, _shell.result.values[0], 10);
-			CommPutString(_shell.terminal, "WiFi module reported an error (system time = ");
-			CommPutString(_shell.terminal, &valueStr);
-			CommPutString(_shell.terminal, "ms)");
-			break;
-		}
-		default:
-		{
-			CommPutString(_shell.terminal, "UNDEFINED");
-			break;
-		}
-	}
-	_shell.result.lastError = 0;
-}
-
-// TASK MANAGEMENT FUNCTIONS---------------------------------------------------
-
-/**
- * The main task scheduler function.
- * This function must be called either directly or indirectly from the main program loop
- * @see UpdateShell
- */
-void TaskScheduler(void)
-{
-	// If no tasks are currently running, check if more have been added to the task list
-	if(_shell.task.current == NULL)
-	{
-		if(_shell.task.list.first == NULL)
-			return;
-		_shell.task.current = _shell.task.list.first;
-	}
-
-	if(CURRENT_TASK->statusBits.busy
-	&& CURRENT_TASK->lastRun != 0
-	&& CURRENT_TASK->timeout > 0
-	&& _tick - CURRENT_TASK->lastRun > CURRENT_TASK->timeout)
-	{
-		_shell.result.values[0] = (uint32_t) CURRENT_TASK->action;
-		_shell.result.values[1] = _tick - CURRENT_TASK->lastRun;
-		_shell.result.lastError = SHELL_ERROR_TASK_TIMEOUT;
-		goto t_comp;
-	}
-
-	if(CURRENT_TASK->statusBits.modeInfinite || CURRENT_TASK->runsRemaining > 0)
-	{
-		// Return if the run interval has not elapsed
-		if(CURRENT_TASK->statusBits.modePeriodic
-		&& CURRENT_TASK->lastRun != 0
-		&& (_tick - CURRENT_TASK->lastRun < CURRENT_TASK->runInterval))
-			goto t_next;
-
-		if(!CURRENT_TASK->statusBits.busy)
-			CURRENT_TASK->lastRun = _tick;
-		if(CURRENT_TASK->action())
-		{
-			CURRENT_TASK->statusBits.busy = false;
-			if(!CURRENT_TASK->statusBits.modeInfinite)
-				CURRENT_TASK->runsRemaining--;
-		}
-		else
-			CURRENT_TASK->statusBits.busy = true;
-	}
-	else goto t_comp;
-
-t_next:{
-		// If the current task is not running exclusively, move to the next task
-		if(!CURRENT_TASK->statusBits.modeExclusive)
-		{
-			if(_shell.task.current->next)
-				_shell.task.current = _shell.task.current->next;
-			else
-
-				if(_shell.task.current != _shell.task.list.first)
-				_shell.task.current = _shell.task.list.first;
-		}
-		return;
-	}
-
-t_comp:{
-		LinkedListNode* nextNode = _shell.task.current->next;
-		LinkedListRemove(&_shell.task.list, _shell.task.current);
-		_shell.task.current = nextNode;
-	}
-}
-
-/**
- * Adds a new task to the task scheduler
- * @param action		The task function (must have no parameters and return <code>bool</code>)
- * @param runCount		Total number of times the task is to run (0 if not applicable)
- * @param runInterval	Interval (in milliseconds) at which the task is executed
- * @param timeout		Length of time before a task is considered to have timed out (fails to return <b>true</b>)
- * @param isExclusive	Whether or not the task has exclusive priority
- * @param isInfinite	Whether or not the task runs infinitely
- * @param isPeriodic	Whether or not the task runs periodically
- * @param paramCount	Number of parameters to be passed to the task function
- * @param ...			List of parameters to be passed to the task function
- * @return				A pointer to the <code>LinkedListNode</code> containing the task information
- */
-LinkedListNode* ShellAddTask(B_Action action,
-							 unsigned int runCount, unsigned long int runInterval, unsigned long int timeout,
-							 bool isExclusive, bool isInfinite, bool isPeriodic,
-							 unsigned char paramCount, ...)
-{
-
-	Task task;
-	task.action = action;
-	task.lastRun = 0;
-	task.runsRemaining = runCount;
-	task.runInterval = runInterval;
-	task.timeout = timeout;
-	task.status = 0;
-	task.statusBits.modeExclusive = isExclusive;
-	task.statusBits.modeInfinite = isInfinite;
-	task.statusBits.modePeriodic = isPeriodic;
-
-	if(paramCount)
-	{
-		unsigned char i;
-		va_list args;
-		va_start(args, paramCount);
-		for(i = 0; i < paramCount; i++)
-		{
-			task.params[i] = va_arg(args, void*);
-		}
-		va_end(args);
-	}
-	LinkedListInsert(&_shell.task.list, _shell.task.list.last, &task, false);
-	return _shell.task.list.last;
-}
-
-// TASKS-----------------------------------------------------------------------
-
-/**
- * Prints the current OS tick value to the terminal
- * @return true if successful, false if failed
- */
-bool TaskPrintTick(void)
-{
-	CommPort* port = (CommPort*) CURRENT_TASK->params[0];
-	CommPutSequence(port, ANSI_CPOS, 2, COORD_VALUE_UPTIME.y, COORD_VALUE_UPTIME.x);
-	char tickStr[12];
-	ltoa(&tickStr, _tick, 10);
-	CommPutString(port, &tickStr);
-	return true;
-}
-
-/**
- * Prints the current date and time to the terminal
- * @return true if successful, false if failed
- */
-bool TaskPrintDateTime(void)
-{
-	DateTime dt;
-	GetDateTime(&dt);
-	dt.date.Year.Tens = 1;	// HARD CODED = FIGURE OUT WHY year is always '00
-	dt.date.Year.Ones = 7;	// HARD CODED = FIGURE OUT WHY year is always '00
-	CommPort* port = (CommPort*) CURRENT_TASK->params[0];
-
-	// Weekday
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_DATE.y, COORD_VALUE_DATE.x);
-	switch(dt.weekday)
-	{
-		case SUNDAY:
-			CommPutString(port, "Sun ");
-			break;
-		case MONDAY:
-			CommPutString(port, "Mon ");
-			break;
-		case TUESDAY:
-			CommPutString(port, "Tue ");
-			break;
-		case WEDNESDAY:
-			CommPutString(port, "Wed ");
-			break;
-		case THURSDAY:
-			CommPutString(port, "Thu ");
-			break;
-		case FRIDAY:
-			CommPutString(port, "Fri ");
-			break;
-		case SATURDAY:
-			CommPutString(port, "Sat ");
-			break;
-	}
-
-	// Date
-	CommPutChar(port, '0' + dt.date.Month.Tens);
-	CommPutChar(port, '0' + dt.date.Month.Ones);
-	CommPutChar(port, '/');
-	CommPutChar(port, '0' + dt.date.Day.Tens);
-	CommPutChar(port, '0' + dt.date.Day.Ones);
-	CommPutChar(port, '/');
-	CommPutChar(port, '0' + dt.date.Year.Tens);
-	CommPutChar(port, '0' + dt.date.Year.Ones);
-
-	// Time
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_TIME.y, COORD_VALUE_TIME.x);
-	CommPutChar(port, '0' + dt.time.Hour.Tens);
-	CommPutChar(port, '0' + dt.time.Hour.Ones);
-	CommPutChar(port, ':');
-	CommPutChar(port, '0' + dt.time.Minute.Tens);
-	CommPutChar(port, '0' + dt.time.Minute.Ones);
-	CommPutChar(port, ':');
-	CommPutChar(port, '0' + dt.time.Second.Tens);
-	CommPutChar(port, '0' + dt.time.Second.Ones);
-	return true;
-}
-
-/**
- * Calculates the RMS current
- * @return true if successful, false if failed
- */
-bool TaskCalculateRMSCurrent(void)
-{
-	float rms = (float) CalculateCurrentRMS();
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_LOAD.y, COORD_VALUE_LOAD.x);
-	CommPutString(_shell.terminal, "            ");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_LOAD.y, COORD_VALUE_LOAD.x);
-	if(rms > 1800.0)
-	{
-		switch(_adc.pinFloatAnimation)
-		{
-			case 0:
-			{
-				CommPutString(_shell.terminal, "Floating");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 1:
-			{
-				CommPutString(_shell.terminal, "fLoating");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 2:
-			{
-				CommPutString(_shell.terminal, "flOating");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 3:
-			{
-				CommPutString(_shell.terminal, "floAting");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 4:
-			{
-				CommPutString(_shell.terminal, "floaTing");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 5:
-			{
-				CommPutString(_shell.terminal, "floatIng");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 6:
-			{
-				CommPutString(_shell.terminal, "floatiNg");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			case 7:
-			{
-				CommPutString(_shell.terminal, "floatinG");
-				_adc.pinFloatAnimation++;
-				break;
-			}
-			default:
-			{
-				CommPutString(_shell.terminal, "floating");
-				_adc.pinFloatAnimation = 0;
-				break;
-			}
-		}
-	}
-	else
-	{
-		int status;
-		unsigned char* rmsStr = ftoa(rms, &status);
-		unsigned char valueStr[6];
-		CommPutString(_shell.terminal, rmsStr);
-		CommPutChar(_shell.terminal, 'W');
-
-		if(_wifi.statusBits.tcpConnectionStatus == WIFI_TCP_READY)
-		{
-			CommPutString(_shell.server, at_cipsend);
-			CommPutChar(_shell.server, '=');
-			itoa(&valueStr, strlen(rmsStr), 10);
-			CommPutString(_shell.server, valueStr);
-			CommPutNewline(_shell.server);
-			Delay10KTCYx(120);	// Delay for 100ms (quick and dirty)
-			CommPutString(_shell.server, rmsStr);
-			CommPutNewline(_shell.server);
-		}
-	}
-	return true;
-}
-
-/**
- * Updates the status of the relay
- * @return true if successful, false if failed
- */
-bool TaskUpdateRelayStatus(void)
-{
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_RELAY.y, COORD_VALUE_RELAY.x);
-	CommPutString(_shell.terminal, "      ");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_RELAY.y, COORD_VALUE_RELAY.x);
-
-	if(_relayState)
-		CommPutString(_shell.terminal, "CLOSED");
-	else
-		CommPutString(_shell.terminal, "OPEN");
-	return true;
-}
-
-/**
- * Updates the status of the proximity sensor
- * @return true if successful, false if failed
- */
-bool TaskUpdateProximityStatus(void)
-{
-	if(!_prox.isTripped)
-		return true;
-
-	unsigned char numStr[6];
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_PROX.y, COORD_VALUE_PROX.x);
-	CommPutString(_shell.terminal, "     ");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_PROX.y, COORD_VALUE_PROX.x);
-	itoa(&numStr, _prox.count, 10);
-	CommPutString(_shell.terminal, numStr);
-	_prox.isTripped = false;
-	return true;
-}
-
-/**
- * Prints the current temperature to the terminal
- * @return true if successful, false if failed
- */
-bool TaskPrintTemp(void)
-{
-	int status;
-	unsigned char* tempStr = ftoa(70.0 + (float) (rand() % 5)*(0.1), &status);
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_TEMP.y, COORD_VALUE_TEMP.x);
-	CommPutString(_shell.terminal, "     ");
-	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, COORD_VALUE_TEMP.y, COORD_VALUE_TEMP.x);
-	tempStr[4] = 0;
-	CommPutString(_shell.terminal, tempStr);
-	CommPutString(_shell.terminal, "F");
-	return true;
-}
-
-/**
- * Initiates a connection of the specified network
- * @return true if successful, false if failed
- */
-bool TaskConnectNetwork(void)
-{
-	CommPutString(_shell.server, at_cwjap_cur);
-	CommPutString(_shell.server, "=\"");
-	CommPutString(_shell.server, network_ssid);
-	if(network_use_password)
-	{
-		CommPutString(_shell.server, "\",\"");
-		CommPutString(_shell.server, network_pass);
-	}
-	CommPutChar(_shell.server, '\"');
-	CommPutNewline(_shell.server);
-	return true;
-}
-
-/**
- * Initiates a TCP client connection to the specified host
- * @return true if successful, false if failed
- */
-bool TaskConnectTcp(void)
-{
-	if(_tick - _wifi.eventTime < 2000)
-		return false;
-
-	unsigned char numStr[6];
-	itoa(&numStr, tcp_port, 10);
-	CommPutString(_shell.server, at_cipstart);
-	CommPutString(_shell.server, "=\"TCP\",\"");
-	CommPutString(_shell.server, tcp_server);
-	CommPutString(_shell.server, "\",");
-	CommPutString(_shell.server, &numStr);
-	CommPutNewline(_shell.server);
-	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CONNECTING;
-	return true;
-}
-
-// BUTTON ACTIONS--------------------------------------------------------------
-
-/**
- * This function executes when the button is pressed
- */
-void ButtonPress(void)
-{
-	RelayControl(_relayState ? 0 : 1);
-}
-
-/**
- * This function executes when the button is held
- */
-void ButtonHold(void)
-{
-	;
-}
-
-/**
- * This function executes when the button is released
- */
-void ButtonRelease(void)
-{
-	;
-}
-
-// LOAD MEASUREMENT FUNCTIONS--------------------------------------------------
-
-/**
- * Initializes all variables necessary for load calculations
- */
-void InitializeLoadMeasurement(void)
-{
-	InitializeRingBuffer(&_adc.samples, ADC_WINDOW_SIZE, 2, &_adcData);
-	_adc.pinFloatAnimation = 0;
-}
-
-/**
- * Calculates the RMS current from the adc sample buffer
- * @return The RMS current
- */
-double CalculateCurrentRMS(void)
-{
-	if(_adc.samples.length != _adc.samples.capacity)
-		return 0.0;
-
-	// Pause ADC sampling
-	PIE5bits.TMR6IE	= 0;
-
-	unsigned int i;
-	double result = 0.0;
-	// Calculate the sum of the squares of each sample
-	for(i = 0; i < ADC_WINDOW_SIZE; i++)
-	{
-		unsigned int sample = 0;
-		RingBufferDequeue(&_adc.samples, &sample);
-		double adjSample = ((sample * 0.000805860806) - 2.474) / 0.04;
-		result += adjSample * adjSample;
-	}
-
-	// Divide the sum by the window size,
-	// then take the square root of this value to obtain the RMS voltage
-	result /= (double) ADC_WINDOW_SIZE;
-	result = sqrt(result);
-	result *= 120.0;
-
-	_adc.samples.head = 0;
-	_adc.samples.tail = 0;
-	_adc.samples.length = 0;
-
-	// Resume ADC sampling
-	PIE5bits.TMR6IE	= 1;
-	return result;
-}
-
-// RELAY CONTROL FUNCTIONS-----------------------------------------------------
-
-/**
- * Sets the relay to the specified state
- * @param state <b>0</b> open the relay, <b>>0</b> to close the relay
- */
-void RelayControl(unsigned char state)
-{
-	if(state)	// Close relay
-	{
-		RELAY_SET = 1;
-		LED = 1;
-	}
-	else		// Open relay
-	{
-		RELAY_RES = 1;
-		LED = 0;
-	}
-	_relayState = state;
-	ShellAddTask(TaskUpdateRelayStatus, 1, 0, 0, false, false, false, 0);
-	T0CONbits.TMR0ON = true;
+/**@file		main.c
+ * @brief		Implementation of the RTOS, task scheduler, and SmartModule operations
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		December 16, 2016
+ * @copyright	GNU Public License
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "main.h"
+#include "system.h"
+#include "button.h"
+#include "serial_comm.h"
+#include "sram.h"
+#include "wifi.h"
+#include "linked_list.h"
+#include "screen.h"
+#include "format.h"
+#include "telemetry.h"
+#include "utility.h"
+
+// GLOBAL VARIABLES------------------------------------------------------------
+volatile uint32_t _tick = 0;	/**< Global timekeeping variable (not related to RTCC)*/
+volatile ButtonInfo _button;	/**< The main SmartModule button */
+volatile Sram _sram;			/**< Main SRAM control structure */
+CommPort _comm1, _comm2;		/**< USART1 and USART2 (wifi and debug terminal) control structures */
+const CommDataRegisters _comm1Regs = {&TXREG1, (TXSTAbits_t*) & TXSTA1, &PIE1, 4, 5};
+const CommDataRegisters _comm2Regs = {&TXREG2, (TXSTAbits_t*) & TXSTA2, &PIE3, 4, 5};
+LAYOUT_POINTS(LAYOUT_COORD)		/**< Fixed terminal layout points and their pre-rendered sequences (see LAYOUT_POINTS) */
+LAYOUT_POINTS(LAYOUT_CPOS)
+LAYOUT_POINTS(LAYOUT_CLEAR)
+PayloadQueue _comm1Payloads;	/**< Data pushed by the TCP server (+IPD payloads received on USART1) */
+WifiInfo _wifi;					/**< Main WIFI control structure */
+const WifiCommand _joinNetworkCommand = {
+	AtJoinNetwork, AtJoinNetworkLine, AtJoinNetworkDone, 20000,
+	WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR | WIFI_RESPONSE_FAIL
+};
+const WifiCommand _connectTcpCommand = {
+	AtConnectTcp, AtConnectTcpLine, AtConnectTcpDone, 10000,
+	WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR
+};
+uint16_t _uplinkSequence;		/**< Sequence number of the next uplink record */
+Shell _shell;					/**< Main SHELL control structure */
+char _serverLine[LINE_BUFFER_SIZE];	/**< Line of a WC: command, kept until TaskSendServerLine has sent it */
+bool _isServerLinePending;		/**< Set from a WC: command until its line has been sent */
+Task _taskListData[SHELL_MAX_TASKS];
+#if SHELL_TASK_STATISTICS
+TaskStatistics _taskStatistics[SHELL_MAX_TASKS];	/**< Scheduler statistics (indexed by task list memory index) */
+#endif
+AdcRmsInfo _adc;				/**< ADC measurement control structure */
+#if ADC_SCAN_COUNT > 1
+const unsigned char _adcChannels[] = {0, ADC_SCAN_CHANNEL1, ADC_SCAN_CHANNEL2};	/**< Analog inputs in scan order (AN0 is the current sensor) */
+#endif
+unsigned char _relayState;		/**< Current state of the relay */
+EnergyMeter _energy;			/**< Energy totals */
+uint16_t _energySequence;		/**< Sequence number of the most recent energy checkpoint */
+ProxDetectInfo _prox;			/**< Proximity detection information structure */
+#if SHELL_DASHBOARD
+Screen _screen;					/**< Dashboard screen model (rendered to the debug terminal) */
+const ScreenField _screenFields[FIELD_COUNT] = {
+	{&COORD_VALUE_SSID_STATUS, &CPOS_VALUE_SSID_STATUS, 13},
+	{&COORD_VALUE_UPTIME, &CPOS_VALUE_UPTIME, 10},
+	{&COORD_VALUE_HOST_STATUS, &CPOS_VALUE_HOST_STATUS, 13},
+	{&COORD_VALUE_DATE, &CPOS_VALUE_DATE, 12},
+	{&COORD_VALUE_RELAY, &CPOS_VALUE_RELAY, 6},
+	{&COORD_VALUE_LOAD, &CPOS_VALUE_LOAD, 12},
+	{&COORD_VALUE_TIME, &CPOS_VALUE_TIME, 8},
+	{&COORD_VALUE_PROX, &CPOS_VALUE_PROX, 5},
+	{&COORD_VALUE_TEMP, &CPOS_VALUE_TEMP, 6},
+	{&COORD_VALUE_COMM1A, &CPOS_VALUE_COMM1A, FIELD_PANE_WIDTH},
+	{&COORD_VALUE_COMM1B, &CPOS_VALUE_COMM1B, FIELD_PANE_WIDTH},
+	{&COORD_VALUE_CMD, &CPOS_VALUE_CMD, FIELD_PANE_WIDTH}
+};
+char _screenCurrent[85 + (3 * FIELD_PANE_WIDTH)];	/**< Screen model cell memory (sum of all field widths) */
+char _screenDesired[85 + (3 * FIELD_PANE_WIDTH)];
+#endif
+
+// PROGRAM ENTRY & MAIN LOOP---------------------------------------------------
+
+/**
+ * Program entry point and main loop
+ */
+void main(void)
+{
+	// Initialize device
+	ConfigureOscillator();
+	ConfigureWDT();
+	ConfigurePorts();
+	ConfigureTimers();
+	ConfigureSPI();
+	ConfigureUSART();
+	ConfigureRTCC();
+	ConfigureADC();
+	ConfigureInterrupts();
+	ConfigureOS();
+
+	// Main program loop
+main_loop:
+	// BUTTON------------------------------------------
+	UpdateButton(&_button);
+
+	// USART-------------------------------------------
+	UpdateCommPort(&_comm1);
+	UpdateCommPort(&_comm2);
+
+	// WIFI--------------------------------------------
+	UpdateWifi();
+
+	// SHELL-------------------------------------------
+	UpdateShell();
+	goto main_loop;
+}
+
+// SHELL UPDATE FUNCTION-------------------------------------------------------
+
+/**
+ * This function performs all related shell operations based on the current state of the RTOS and any received commands.
+ * A call to this function must be placed in the main program loop.
+ * @see main()
+ */
+void UpdateShell(void)
+{
+	// Manage tasks (this is delayed by SHELL_RESET_DELAY upon a device reset)
+	// Until the scheduler starts, the watchdog is cleared unconditionally
+	if(_tick > SHELL_RESET_DELAY)
+		TaskScheduler();
+	else
+		CLRWDT();
+
+	if(_shell.server->buffers.external.length && !_sram.statusBits.busy)
+	{
+		RingBufferDequeueSRAM(&_shell.server->buffers.external, &_shell.swapBuffer);
+		if(!SramWait())
+			return;
+
+		if((BufferContains(&_shell.swapBuffer, "OK", 2) == 0)
+		|| (BufferContains(&_shell.swapBuffer, "ERROR", 2) == 0))
+		{
+			ScreenWrite(&_screen, FIELD_COMM1B, (char*) _shell.swapBuffer.data);
+		}
+		else
+		{
+			ScreenWrite(&_screen, FIELD_COMM1A, (char*) _shell.swapBuffer.data);
+			ScreenWrite(&_screen, FIELD_COMM1B, "");
+		}
+
+		if(WifiHandleResponse(&_shell.swapBuffer))
+		{
+			// The line was a response to the current AT command (see WifiQueueCommand)
+		}
+		else if(BufferContains(&_shell.swapBuffer, "WIFI GOT IP", 11) >= 0)
+		{
+			_wifi.statusBits.isSsidConnected = true;
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Connected");
+
+			// Send command to connect to TCP server
+			ScreenWrite(&_screen, FIELD_HOST_STATUS, "Connecting...");
+			ShellAddTask(TaskConnectTcp, 1, 0, 0, false, false, false, 0);
+		}
+		else if(BufferContains(&_shell.swapBuffer, "WIFI CONNECTED", 14) >= 0)
+		{
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Connecting...");
+		}
+		else if(BufferContains(&_shell.swapBuffer, "WIFI DISCONNECT", 15) >= 0)
+		{
+			_wifi.statusBits.isSsidConnected = false;
+			_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Disconnected");
+			ShellAddTask(TaskConnectNetwork, 1, 0, 0, false, false, false, 0);
+		}
+		else if(_wifi.statusBits.isSsidConnected &&
+				BufferContains(&_shell.swapBuffer, "CLOSED", 6) >= 0)
+		{
+			_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+			ScreenWrite(&_screen, FIELD_HOST_STATUS, "Closed");
+			//ShellAddTask(ShellConnectTcp, 1, 0, 0, false, false, false, 0);
+			//_wifi.eventTime = _tick;
+		}
+		else if(BufferContains(&_shell.swapBuffer, "ERROR", 5) >= 0)
+		{
+			_shell.result.lastError = SHELL_ERROR_WIFI_COMMAND;
+			_shell.result.values[0] = _tick;
+		}
+		else if(BufferContains(&_shell.swapBuffer, "#", 1) == 0)
+		{
+			ShellParseCommandLine(&_shell.swapBuffer);
+		}
+		_shell.swapBuffer.length = 0;
+	}
+	else if(_shell.terminal->buffers.external.length && !_sram.statusBits.busy
+			&& (_shell.isHeadless || CommReserve(_shell.terminal, 5 * LAYOUT_CLEAR_MAX_LENGTH)))
+	{
+		RingBufferDequeueSRAM(&_shell.terminal->buffers.external, &_shell.swapBuffer);
+		if(!SramWait())
+			return;
+		if(!_shell.isHeadless)
+		{
+			CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_ERROR);
+			CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_COMM2A);
+			CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_COMM2B);
+			CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_COMM2C);
+			CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_COMM2D);
+		}
+		ShellParseCommandLine(&_shell.swapBuffer);
+		_shell.swapBuffer.length = 0;
+	}
+	else if(CommPeekPayload(_shell.server) != NULL && !_sram.statusBits.busy)
+	{
+		ShellHandlePayload(CommPeekPayload(_shell.server));
+		CommReleasePayload(_shell.server);
+	}
+
+	// Warnings and errors are printed once the TX buffer is empty (every message fits in the TX buffer)
+	// In headless mode, they are reported in the next status frame instead
+	if(_shell.isHeadless || _shell.terminal->buffers.tx.length)
+		return;
+
+	// One message per pass: each fits in the TX buffer, a warning and an error together do not
+	if(_shell.result.lastWarning)
+		ShellPrintLastWarning(32, 0);
+	else if(_shell.result.lastError)
+		ShellPrintLastError(32, 0);
+}
+
+// SHELL MANAGEMENT FUNCTIONS--------------------------------------------------
+
+/**
+ * Initializes the shell environment
+ * @param serverComm		Pointer to a <code>CommPort</code> structure which is defined for the WIFI module
+ * @param terminalComm		Pointer to a <code>CommPort</code> structure which is defined for the debug terminal
+ * @param swapBufferSize	The capacity (in bytes) of the shell's swap buffer
+ * @param swapBufferData	Pointer to an array allocated for swap buffer data
+ */
+void ShellInitialize(CommPort* serverComm, CommPort* terminalComm,
+					 uint16_t swapBufferSize, char* swapBufferData)
+{
+
+	_shell.result.lastWarning = 0;
+	_shell.result.lastError = 0;
+	_shell.task.current = 0;
+	_shell.watchdog.critical = 0;
+	_shell.watchdog.checkIns = 0;
+	_shell.watchdog.isResetPending = false;
+	_shell.server = serverComm;
+	_shell.terminal = terminalComm;
+	_shell.isHeadless = !SHELL_DASHBOARD;
+	_isServerLinePending = false;
+	InitializeBuffer(&_shell.swapBuffer, swapBufferSize, 1, swapBufferData);
+	LinkedList_16Element_Initialize(&_shell.task.list, &_taskListData, sizeof(Task));
+
+#if SHELL_DASHBOARD
+	// Initialize the screen model (all fields are blank once the basic layout has been printed)
+	ScreenInitialize(&_screen, _shell.terminal, _screenFields, FIELD_COUNT, _screenCurrent, _screenDesired);
+#endif
+
+	// Report a reset caused by the hardware watchdog
+	if(!RCONbits.TO)
+		_shell.result.lastWarning = SHELL_WARNING_WATCHDOG_RESET;
+
+	// Add one-shot tasks (the basic layout is printed exclusively, before anything else is rendered)
+#if SHELL_DASHBOARD
+	ShellAddTask(TaskPrintBasicLayout, 1, 0, 0, true, false, false, 0);
+#endif
+	ShellAddTask(TaskUpdateRelayStatus, 1, 0, 0, false, false, false, 0);
+	ShellAddTask(TaskRestoreEnergy, 1, 0, 0, false, false, false, 0);
+
+	// Add persistent tasks
+#if SHELL_DASHBOARD
+	ShellAddTask(TaskRenderScreen, 0, 50, 0, false, true, true, 0);
+#endif
+	ShellAddTask(TaskSendTelemetry, 0, SHELL_TELEMETRY_INTERVAL, 0, false, true, true, 0);
+	ShellAddTask(TaskPrintDateTime, 0, 1000, 0, false, true, true, 0);
+	ShellSuperviseTask(ShellAddTask(TaskPrintTick, 0, 125, 0, false, true, true, 0),
+					   TASK_POLICY_RESTART, true);
+	ShellSuperviseTask(ShellAddTask(TaskCalculateRMSCurrent, 0, 100, 100, false, true, true, 0),
+					   TASK_POLICY_RESTART, true);
+	ShellAddTask(TaskCheckpointEnergy, 0, ENERGY_CHECKPOINT_INTERVAL, 0, false, true, true, 0);
+#if ADC_HARMONIC_COUNT
+	ShellAddTask(TaskCalculateHarmonics, 0, 10, 0, false, true, true, 0);
+#endif
+#if ADC_CAPTURE_SIZE
+	ShellAddTask(TaskStoreCapture, 0, 100, 0, false, true, true, 0);
+#endif
+	ShellAddTask(TaskUpdateProximityStatus, 0, 2000, 0, false, true, true, 0);
+	ShellAddTask(TaskPrintTemp, 0, 10000, 0, false, true, true, 0);
+}
+
+/**
+ * Parses the buffer for any commands it recognizes
+ * @param buffer Pointer to a <code>Buffer</code> containing the data to parse
+ */
+void ShellParseCommandLine(Buffer* buffer)
+{
+	if(BufferContains(buffer, "WC:", 3) == 0)
+	{
+		// The line may be longer than the TX buffer, and the swap buffer is reused once this returns,
+		// so the line is copied and sent by a task (a line which arrives while one is being sent is dropped)
+		ScreenWrite(&_screen, FIELD_CMD, (char*) buffer->data);
+		if(_isServerLinePending)
+		{
+			_shell.result.lastWarning = SHELL_WARNING_DATA_TRUNCATED;
+			_shell.result.values[0] = buffer->length - 3;
+			_shell.result.values[1] = 0;
+		}
+		else
+		{
+			strncpy(_serverLine, ((char*) buffer->data) + 3, LINE_BUFFER_SIZE - 1);
+			_serverLine[LINE_BUFFER_SIZE - 1] = ASCII_NUL;
+			_isServerLinePending = ShellAddTask(TaskSendServerLine, 1, 0, 0, false, false, false, 0) != NULL;
+		}
+	}
+	else if(BufferContains(buffer, "#", 1) == 0)
+	{
+		_shell.swapBuffer = BufferTrimLeft(&_shell.swapBuffer, 1);
+		if(BufferContains(buffer, "tcpStart", 8) == 0)
+		{
+			ScreenWrite(&_screen, FIELD_HOST_STATUS, "Connecting...");
+			ShellAddTask(TaskConnectTcp, 1, 0, 0, false, false, false, 0);
+		}
+		else if(BufferContains(buffer, "SRLS:", 5) == 0)
+		{
+			ScreenWrite(&_screen, FIELD_CMD, (char*) buffer->data);
+
+			if(BufferContains(buffer, "0", 1) == 5)
+				RelayControl(0);
+			else if(BufferContains(buffer, "1", 1) == 5)
+				RelayControl(1);
+		}
+		else if(BufferContains(buffer, "headless", 8) == 0)
+		{
+			_shell.isHeadless = true;
+		}
+#if SHELL_DASHBOARD
+		else if(BufferContains(buffer, "dashboard", 9) == 0)
+		{
+			// The layout task clears the screen and marks every field for redrawing
+			_shell.isHeadless = false;
+			ShellAddTask(TaskPrintBasicLayout, 1, 0, 0, true, false, false, 0);
+		}
+#endif
+		else if(BufferContains(buffer, "energy", 6) == 0)
+		{
+			ShellAddTask(TaskPrintEnergy, ENERGY_TOTAL_COUNT, 0, 0, false, false, false, 0);
+		}
+#if ADC_SCAN_COUNT > 1
+		else if(BufferContains(buffer, "analog", 6) == 0)
+		{
+			ShellAddTask(TaskPrintAnalogInputs, ADC_SCAN_COUNT - 1, 0, 0, false, false, false, 0);
+		}
+#endif
+#if ADC_HARMONIC_COUNT
+		else if(BufferContains(buffer, "harmonics", 9) == 0)
+		{
+			ShellAddTask(TaskPrintHarmonics, ADC_HARMONIC_COUNT + 1, 0, 0, false, false, false, 0);
+		}
+#endif
+		else if(BufferContains(buffer, "sample", 6) == 0)
+		{
+			// #sample [prescale postscale period cycles size] prints (or changes) the sampling configuration
+			unsigned long int values[5];
+			unsigned char count = 0;
+			char* text = (char*) buffer->data + 6;
+			char* end;
+			while(count < 5)
+			{
+				values[count] = strtoul(text, &end, 10);
+				if(end == text || values[count] > 255)
+					break;
+				text = end;
+				count++;
+			}
+			if(count == 5)
+			{
+				AdcSampling sampling;
+				sampling.prescale = (unsigned char) values[0];
+				sampling.postscale = (unsigned char) values[1];
+				sampling.period = (unsigned char) values[2];
+				sampling.windowCycles = (unsigned char) values[3];
+				sampling.windowSize = (unsigned char) values[4];
+				if(!ConfigureSampling(&sampling))
+					_shell.result.lastError = SHELL_ERROR_INVALID_SAMPLING;
+			}
+			else if(count)
+				_shell.result.lastError = SHELL_ERROR_INVALID_SAMPLING;
+			ShellAddTask(TaskPrintSampling, 1, 0, 0, false, false, false, 0);
+		}
+#if ADC_CAPTURE_SIZE
+		else if(BufferContains(buffer, "capture", 7) == 0)
+		{
+			// #capture [high low] prints the most recent transient capture (or changes the trigger thresholds)
+			char* text = (char*) buffer->data + 7;
+			char* end;
+			long int high = strtol(text, &end, 10);
+			if(end != text)
+			{
+				text = end;
+				long int low = strtol(text, &end, 10);
+				if(end != text && low < high && low >= -4095 && high <= 4095)
+				{
+					PIE1bits.ADIE = false;
+					_adc.capture.high = (int) high;
+					_adc.capture.low = (int) low;
+					PIE1bits.ADIE = true;
+				}
+				else
+					_shell.result.lastError = SHELL_ERROR_INVALID_CAPTURE;
+			}
+			ShellAddTask(TaskPrintCapture, 2 + ADC_CAPTURE_SIZE / 8, 0, 0, false, false, false, 0);
+		}
+#endif
+		else if(BufferContains(buffer, "tx", 2) == 0)
+		{
+			ShellAddTask(TaskPrintCommStatistics, 2, 0, 0, false, false, false, 1, _shell.server);
+			ShellAddTask(TaskPrintCommStatistics, 2, 0, 0, false, false, false, 1, _shell.terminal);
+		}
+#if SHELL_TASK_STATISTICS
+		else if(BufferContains(buffer, "stats", 5) == 0)
+		{
+			ShellAddTask(TaskPrintTaskStatistics, 2 * SHELL_MAX_TASKS, 0, 0, false, false, false, 0);
+		}
+#endif
+	}
+	else
+		_shell.result.lastError = SHELL_ERROR_COMMAND_NOT_RECOGNIZED;
+}
+
+/**
+ * Handles a payload which has been pushed by the TCP server.
+ * A payload which starts with '#' and fits in the swap buffer is parsed as a command line,
+ * any other payload is only reported.
+ * @param file Pointer to a <code>FileDescriptor</code> describing the payload in SRAM
+ */
+void ShellHandlePayload(const FileDescriptor* file)
+{
+	char text[FORMAT_MAX_LENGTH + 7];
+	strcpy(text, "+IPD: ");
+	FormatUnsigned(text + 6, file->length, 0, ' ');
+	ScreenWrite(&_screen, FIELD_COMM1A, text);
+
+	if(file->length >= _shell.swapBuffer.capacity)
+		return;
+
+	SramRead(file->address, file->length, &_shell.swapBuffer);
+	if(!SramWait())
+		return;
+
+	if(BufferContains(&_shell.swapBuffer, "#", 1) == 0)
+	{
+		// Remove the trailing newline (if any), then terminate the command line like a received line
+		char* data = (char*) _shell.swapBuffer.data;
+		while(_shell.swapBuffer.length && (uint8_t) data[_shell.swapBuffer.length - 1] < 0x20)
+			_shell.swapBuffer.length--;
+		data[_shell.swapBuffer.length] = ASCII_NUL;
+		_shell.swapBuffer.length++;
+		ShellParseCommandLine(&_shell.swapBuffer);
+	}
+	_shell.swapBuffer.length = 0;
+}
+
+/**
+ * Encodes a reading as an uplink record (stamped with the device ID, the RTCC time, and the system time)
+ * and adds it to the uplink queue
+ * @param tag		Reading type (<code>TELEMETRY_TAG_LOAD</code>, ...)
+ * @param value		Reading value
+ * @param isUrgent	Determines whether the reading should be sent as soon as possible
+ * @return			true if successful, false if the uplink queue is full
+ */
+bool ShellQueueReading(uint8_t tag, int32_t value, bool isUrgent)
+{
+	TelemetryReading reading;
+	reading.tag = tag;
+	reading.value = value;
+	return ShellQueueReadings(&reading, 1, isUrgent);
+}
+
+/**
+ * Encodes several readings as one uplink record (see ShellQueueReading) and adds it to the uplink queue
+ * @param readings	Pointer to an array of readings
+ * @param count		Number of readings (1 - <code>TELEMETRY_MAX_READINGS</code>)
+ * @param isUrgent	Determines whether the readings should be sent as soon as possible
+ * @return			true if successful, false if the uplink queue is full
+ */
+bool ShellQueueReadings(const TelemetryReading* readings, uint8_t count, bool isUrgent)
+{
+	TelemetryRecord record;
+	uint8_t frame[TELEMETRY_MAX_RECORD_SIZE];
+	DateTime dt;
+	GetDateTime(&dt);
+	memcpy(record.id, _id, TELEMETRY_ID_SIZE);
+	record.sequence = _uplinkSequence;
+	record.time[0] = dt.date.Year.ByteValue;
+	record.time[1] = dt.date.Month.ByteValue;
+	record.time[2] = dt.date.Day.ByteValue;
+	record.time[3] = dt.time.Hour.ByteValue;
+	record.time[4] = dt.time.Minute.ByteValue;
+	record.time[5] = dt.time.Second.ByteValue;
+	record.uptime = _tick;
+	record.readingCount = count;
+	memcpy(record.readings, readings, count * sizeof(TelemetryReading));
+
+	if(!WifiQueueRecord(frame, TelemetryEncodeRecord(&record, frame), isUrgent))
+		return false;
+	_uplinkSequence++;
+	return true;
+}
+
+/**
+ * Callback function for handling any ANSI control sequences received on a specified COMM port
+ * @param comm Pointer to a <code>CommPort</code>
+ * @warning this function currently contains no actions - these must be implemented
+ */
+void ShellHandleSequence(CommPort* comm)
+{
+	switch(comm->sequence.terminator)
+	{
+		case ANSI_CUU:
+		{
+
+			break;
+		}
+		case ANSI_CUD:
+		{
+
+			break;
+		}
+		case ANSI_CUF:
+		{
+
+			break;
+		}
+		case ANSI_CUB:
+		{
+
+			break;
+		}
+	}
+	CommResetSequence(comm);
+}
+
+/**
+ * Prints a label (and an optional value) at a fixed layout position, if the TX buffer has room for all of it
+ * @param position	Pointer to the pre-rendered cursor position of the label
+ * @param label		Label text
+ * @param value		Value text to be printed after the label (may be NULL)
+ * @return			true if the label was printed, false if the TX buffer is full
+ */
+bool ShellPutLabel(const StoredSequence* position, const char* label, const char* value)
+{
+	uint16_t length = position->length + strlen(label);
+	if(value)
+		length += strlen(value);
+	if(!CommReserve(_shell.terminal, length))
+		return false;
+
+	CommPutStoredSequence(_shell.terminal, position);
+	CommPutString(_shell.terminal, label);
+	if(value)
+		CommPutString(_shell.terminal, value);
+	return true;
+}
+
+/**
+ * Prints the last warning to the debug terminal at the location specified
+ * @param row	Terminal row at which the output will be printed
+ * @param col	Terminal column at which the output will be printed
+ */
+void ShellPrintLastWarning(unsigned char row, unsigned char col)
+{
+	CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_ERROR);
+	CommPutString(_shell.terminal, "WARNING: ");
+	switch(_shell.result.lastWarning)
+	{
+		case SHELL_WARNING_DATA_TRUNCATED:
+		{
+			CommPutString(_shell.terminal, "Data truncated (");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[0], 0, ' ');
+			CommPutString(_shell.terminal, "->");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[1], 0, ' ');
+			CommPutChar(_shell.terminal, ')');
+			break;
+		}
+		case SHELL_WARNING_FIFO_BUFFER_OVERWRITE:
+		{
+			CommPutString(_shell.terminal, "FIFO 0x");
+			FormatPutHex(_shell.terminal, _shell.result.values[0], 0);
+			CommPutString(_shell.terminal, " full, value overwritten");
+			break;
+		}
+		case SHELL_WARNING_WATCHDOG_RESET:
+		{
+			CommPutString(_shell.terminal, "The device was reset by the watchdog timer");
+			break;
+		}
+		case SHELL_WARNING_ADC_OVERRUN:
+		{
+			CommPutString(_shell.terminal, "ADC windows discarded (");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[0], 0, ' ');
+			CommPutChar(_shell.terminal, ')');
+			break;
+		}
+		default:
+		{
+
+			CommPutString(_shell.terminal, "UNDEFINED");
+			break;
+		}
+	}
+	_shell.result.lastWarning = 0;
+}
+
+/**
+ * Prints the last error to the debug terminal at the location specified
+ * @param row	Terminal row at which the output will be printed
+ * @param col	Terminal column at which the output will be printed
+ */
+void ShellPrintLastError(unsigned char row, unsigned char col)
+{
+	CommPutStoredSequence(_shell.terminal, &CLEAR_VALUE_ERROR);
+	CommPutString(_shell.terminal, "ERROR: ");
+	switch(_shell.result.lastError)
+	{
+		case SHELL_ERROR_SRAM_BUSY:
+		{
+			CommPutString(_shell.terminal, "SRAM busy");
+			break;
+		}
+		case SHELL_ERROR_ZERO_LENGTH:
+		{
+			CommPutString(_shell.terminal, "Length = 0");
+			break;
+		}
+		case SHELL_ERROR_ADDRESS_RANGE:
+		{
+			CommPutString(_shell.terminal, "Address 0x");
+			FormatPutHex(_shell.terminal, _shell.result.values[0], 0);
+			CommPutString(_shell.terminal, " outside 0x");
+			FormatPutHex(_shell.terminal, _shell.result.values[1], 0);
+			CommPutString(_shell.terminal, "-0x");
+			FormatPutHex(_shell.terminal, _shell.result.values[2], 0);
+			break;
+		}
+		case SHELL_ERROR_LINE_QUEUE_EMPTY:
+		{
+			CommPutString(_shell.terminal, "Line queue is empty");
+			break;
+		}
+		case SHELL_ERROR_COMMAND_NOT_RECOGNIZED:
+		{
+			CommPutString(_shell.terminal, "Unknown command: ");
+			CommPutSubString(_shell.terminal, _shell.swapBuffer.data, 0, 28);
+			break;
+		}
+		case SHELL_ERROR_TASK_TIMEOUT:
+		{
+			CommPutString(_shell.terminal, "Task 0x");
+			FormatPutHex(_shell.terminal, _shell.result.values[0], 0);
+			CommPutString(_shell.terminal, " timed out after ");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[1], 0, ' ');
+			CommPutString(_shell.terminal, "ms");
+			break;
+		}
+		case SHELL_ERROR_NULL_REFERENCE:
+		{
+			CommPutString(_shell.terminal, "NULL reference");
+			break;
+		}
+		case SHELL_ERROR_WIFI_COMMAND:
+		{
+			CommPutString(_shell.terminal, "WiFi module error at ");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[0], 0, ' ');
+			CommPutString(_shell.terminal, "ms");
+			break;
+		}
+		case SHELL_ERROR_WIFI_TIMEOUT:
+		{
+			CommPutString(_shell.terminal, "WiFi command timed out at ");
+			FormatPutUnsigned(_shell.terminal, _shell.result.values[0], 0, ' ');
+			CommPutString(_shell.terminal, "ms");
+			break;
+		}
+		case SHELL_ERROR_INVALID_SAMPLING:
+		{
+			CommPutString(_shell.terminal, "Invalid sampling configuration");
+			break;
+		}
+		case SHELL_ERROR_INVALID_CAPTURE:
+		{
+			CommPutString(_shell.terminal, "Invalid capture thresholds");
+			break;
+		}
+		default:
+		{
+			CommPutString(_shell.terminal, "UNDEFINED");
+			break;
+		}
+	}
+	_shell.result.lastError = 0;
+}
+
+// TASK MANAGEMENT FUNCTIONS---------------------------------------------------
+
+/**
+ * The main task scheduler function.
+ * This function must be called either directly or indirectly from the main program loop
+ * @see UpdateShell
+ */
+void TaskScheduler(void)
+{
+	ShellServiceWatchdog();
+
+	// If no tasks are currently running, check if more have been added to the task list
+	if(_shell.task.current == NULL)
+	{
+		if(_shell.task.list.first == NULL)
+			return;
+		_shell.task.current = _shell.task.list.first;
+	}
+
+	// Supervise busy tasks: a task which has not checked in within its heartbeat budget
+	// is handled according to its supervision policy
+	if(CURRENT_TASK->statusBits.busy
+	&& CURRENT_TASK->timeout > 0
+	&& _tick - CURRENT_TASK->lastCheckIn > CURRENT_TASK->timeout)
+	{
+		_shell.result.values[0] = (uint32_t) CURRENT_TASK->action;
+		_shell.result.values[1] = _tick - CURRENT_TASK->lastCheckIn;
+		_shell.result.lastError = SHELL_ERROR_TASK_TIMEOUT;
+
+		switch(CURRENT_TASK->statusBits.policy)
+		{
+			case TASK_POLICY_RESTART:
+			{
+				if(CURRENT_TASK->restarts < SHELL_TASK_MAX_RESTARTS)
+				{
+					CURRENT_TASK->restarts++;
+					CURRENT_TASK->statusBits.busy = false;
+					goto t_next;
+				}
+				break;
+			}
+			case TASK_POLICY_RESET:
+			{
+				_shell.watchdog.isResetPending = true;
+				goto t_next;
+			}
+			default:
+				break;
+		}
+
+		// The task is given up. Removing a critical task would also remove it from the watchdog check-ins,
+		// so that the watchdog would be cleared without it: a critical task stops the watchdog from being cleared instead
+		if(CURRENT_TASK->statusBits.modeCritical)
+		{
+			_shell.watchdog.isResetPending = true;
+			goto t_next;
+		}
+		goto t_comp;
+	}
+
+	if(CURRENT_TASK->statusBits.modeInfinite || CURRENT_TASK->runsRemaining > 0)
+	{
+		// Return if the run interval has not elapsed (a busy task continues its run without waiting)
+		if(CURRENT_TASK->statusBits.modePeriodic
+		&& !CURRENT_TASK->statusBits.busy
+		&& CURRENT_TASK->lastRun != 0
+		&& (_tick - CURRENT_TASK->lastRun < CURRENT_TASK->runInterval))
+			goto t_next;
+
+		if(!CURRENT_TASK->statusBits.busy)
+		{
+#if SHELL_TASK_STATISTICS
+			ShellRecordTaskStart();
+#endif
+			CURRENT_TASK->lastRun = _tick;
+			CURRENT_TASK->lastCheckIn = _tick;
+		}
+		if(CURRENT_TASK->action())
+		{
+			ShellTaskCheckIn();
+			CURRENT_TASK->restarts = 0;
+			CURRENT_TASK->statusBits.busy = false;
+			if(!CURRENT_TASK->statusBits.modeInfinite)
+				CURRENT_TASK->runsRemaining--;
+		}
+		else
+			CURRENT_TASK->statusBits.busy = true;
+	}
+	else goto t_comp;
+
+t_next:{
+		// If the current task is not running exclusively, move to the next task
+		if(!CURRENT_TASK->statusBits.modeExclusive)
+		{
+			if(_shell.task.current->next)
+				_shell.task.current = _shell.task.current->next;
+			else
+
+				if(_shell.task.current != _shell.task.list.first)
+				_shell.task.current = _shell.task.list.first;
+		}
+		return;
+	}
+
+t_comp:{
+		LinkedListNode* nextNode = _shell.task.current->next;
+		bit_clear(_shell.watchdog.critical, _shell.task.current->memoryIndex);
+		bit_clear(_shell.watchdog.checkIns, _shell.task.current->memoryIndex);
+		LinkedListRemove(&_shell.task.list, _shell.task.current);
+		_shell.task.current = nextNode;
+	}
+}
+
+/**
+ * Adds a new task to the task scheduler
+ * @param action		The task function (must have no parameters and return <code>bool</code>)
+ * @param runCount		Total number of times the task is to run (0 if not applicable)
+ * @param runInterval	Interval (in milliseconds) at which the task is executed
+ * @param timeout		Heartbeat budget: length of time a busy task may go without checking in before it is considered to have timed out
+ * @param isExclusive	Whether or not the task has exclusive priority
+ * @param isInfinite	Whether or not the task runs infinitely
+ * @param isPeriodic	Whether or not the task runs periodically
+ * @param paramCount	Number of parameters to be passed to the task function
+ * @param ...			List of parameters to be passed to the task function
+ * @return				A pointer to the <code>LinkedListNode</code> containing the task information
+ */
+LinkedListNode* ShellAddTask(B_Action action,
+							 unsigned int runCount, unsigned long int runInterval, unsigned long int timeout,
+							 bool isExclusive, bool isInfinite, bool isPeriodic,
+							 unsigned char paramCount, ...)
+{
+
+	Task task;
+	task.action = action;
+	task.lastRun = 0;
+	task.runsRemaining = runCount;
+	task.runInterval = runInterval;
+	task.timeout = timeout;
+	task.lastCheckIn = 0;
+	task.restarts = 0;
+	task.status = 0;
+	task.statusBits.modeExclusive = isExclusive;
+	task.statusBits.modeInfinite = isInfinite;
+	task.statusBits.modePeriodic = isPeriodic;
+
+	if(paramCount)
+	{
+		unsigned char i;
+		va_list args;
+		va_start(args, paramCount);
+		for(i = 0; i < paramCount; i++)
+		{
+			task.params[i] = va_arg(args, void*);
+		}
+		va_end(args);
+	}
+	LinkedListInsert(&_shell.task.list, _shell.task.list.last, &task, false);
+#if SHELL_TASK_STATISTICS
+	if(_shell.task.list.last)
+	{
+		TaskStatistics* stats = &_taskStatistics[_shell.task.list.last->memoryIndex];
+		memset(stats, 0, sizeof(TaskStatistics));
+		stats->queuedAt = _tick;
+	}
+#endif
+	return _shell.task.list.last;
+}
+
+/**
+ * Sets the supervision policy of a task
+ * @param node			Pointer to the <code>LinkedListNode</code> containing the task (as returned by <code>ShellAddTask</code>)
+ * @param policy		Action taken when the task overruns its heartbeat budget (<code>TASK_POLICY_ABORT</code>,
+ *						<code>TASK_POLICY_RESTART</code> or <code>TASK_POLICY_RESET</code>)
+ * @param isCritical	Whether or not the task must check in before the hardware watchdog is cleared
+ */
+void ShellSuperviseTask(LinkedListNode* node, unsigned char policy, bool isCritical)
+{
+	if(node == NULL)
+		return;
+
+	((Task*) node->data)->statusBits.policy = policy;
+	((Task*) node->data)->statusBits.modeCritical = isCritical;
+	bit_clear(_shell.watchdog.checkIns, node->memoryIndex);
+	if(isCritical)
+		bit_set(_shell.watchdog.critical, node->memoryIndex);
+	else
+		bit_clear(_shell.watchdog.critical, node->memoryIndex);
+}
+
+/**
+ * Reports that the currently running task is still making progress.
+ * Long-running tasks which return <b>false</b> should call this function to remain within their heartbeat budget.
+ * A task automatically checks in each time its action returns <b>true</b>.
+ */
+void ShellTaskCheckIn(void)
+{
+	if(_shell.task.current == NULL)
+		return;
+
+	CURRENT_TASK->lastCheckIn = _tick;
+	bit_set(_shell.watchdog.checkIns, _shell.task.current->memoryIndex);
+}
+
+/**
+ * Records the start-time jitter of the current task in its statistics histogram.
+ * Must be called immediately before the task's <code>lastRun</code> timestamp is updated.
+ */
+void ShellRecordTaskStart(void)
+{
+#if SHELL_TASK_STATISTICS
+	TaskStatistics* stats = &_taskStatistics[_shell.task.current->memoryIndex];
+	uint32_t due;
+	if(CURRENT_TASK->lastRun == 0)
+		due = stats->queuedAt;
+	else if(CURRENT_TASK->statusBits.modePeriodic)
+		due = CURRENT_TASK->lastRun + CURRENT_TASK->runInterval;
+	else
+		return;
+
+	uint32_t jitter = _tick > due ? _tick - due : 0;
+	uint8_t bucket = 0;
+	uint32_t range = jitter;
+	while(range && bucket < SHELL_JITTER_BUCKETS - 1)
+	{
+		range >>= 1;
+		bucket++;
+	}
+
+	if(stats->histogram[bucket] < UINT16_MAX)
+		stats->histogram[bucket]++;
+	if(stats->runs < UINT16_MAX)
+		stats->runs++;
+	if(jitter > stats->maxJitter)
+		stats->maxJitter = jitter > UINT16_MAX ? UINT16_MAX : (uint16_t) jitter;
+#endif
+}
+
+/**
+ * Clears the hardware watchdog timer once every critical task has checked in.
+ * If a task has requested a device reset, the watchdog is no longer cleared.
+ * @see TaskScheduler
+ */
+void ShellServiceWatchdog(void)
+{
+	if(_shell.watchdog.isResetPending
+	|| (_shell.watchdog.checkIns & _shell.watchdog.critical) != _shell.watchdog.critical)
+		return;
+
+	CLRWDT();
+	_shell.watchdog.checkIns = 0;
+}
+
+// TASKS-----------------------------------------------------------------------
+#if SHELL_DASHBOARD
+
+/**
+ * Sends all changes made to the dashboard screen model to the terminal
+ * @return true if successful, false if failed
+ */
+bool TaskRenderScreen(void)
+{
+	if(!_shell.isHeadless)
+		ScreenRender(&_screen);
+	return true;
+}
+
+/**
+ * Prints the basic layout of the debug environment to the debug terminal.
+ * The layout is larger than the TX buffer, so it is printed in steps which each fit in the TX buffer.
+ * If the TX buffer is full, the task returns and resumes from the same step on its next run.
+ * This task is also used to return from headless mode.
+ * @return true if the layout has been printed completely, false if the task is still printing
+ */
+bool TaskPrintBasicLayout(void)
+{
+	static unsigned char step = 0;
+	unsigned char i;
+
+	switch(step)
+	{
+		case 0:
+		{
+			// Clear screen and print version info
+			if(!CommReserve(_shell.terminal, 48))
+				return false;
+			CommPutSequence(_shell.terminal, ANSI_EDISP, 1, 2);
+			CommPutSequence(_shell.terminal, ANSI_CPOS, 0);
+			CommPutString(_shell.terminal, "SmartModule");
+			CommPutNewline(_shell.terminal);
+			CommPutString(_shell.terminal, "HW: Rev.2");
+			CommPutNewline(_shell.terminal);
+			CommPutString(_shell.terminal, "FW: v1.00");
+			CommPutNewline(_shell.terminal);
+			step++;
+		}
+		case 1:
+		{
+			// Print borders
+			if(!CommReserve(_shell.terminal, 49))
+				return false;
+			for(i = 0; i < 49; i++)
+				CommPutChar(_shell.terminal, '_');
+			step++;
+		}
+		case 2:
+		{
+			if(!CommReserve(_shell.terminal, 56))
+				return false;
+			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 7, 0);
+			for(i = 0; i < 49; i++)
+				CommPutChar(_shell.terminal, '_');
+			step++;
+		}
+		case 3:
+		{
+			if(!CommReserve(_shell.terminal, 56))
+				return false;
+			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 1, 13);
+			for(i = 0; i < 7; i++)
+			{
+				CommPutChar(_shell.terminal, '|');
+				CommPutSequence(_shell.terminal, ANSI_CUD, 0);
+				CommPutSequence(_shell.terminal, ANSI_CUB, 0);
+			}
+			step++;
+		}
+		case 4:
+		{
+			if(!CommReserve(_shell.terminal, 56))
+				return false;
+			CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 1, 50);
+			for(i = 0; i < 7; i++)
+			{
+				CommPutChar(_shell.terminal, '|');
+				CommPutSequence(_shell.terminal, ANSI_CUD, 0);
+				CommPutSequence(_shell.terminal, ANSI_CUB, 0);
+			}
+			step++;
+		}
+		case 5:
+			if(!ShellPutLabel(&CPOS_LABEL_NAME, "NAME", NULL))
+				return false;
+			step++;
+		case 6:
+			if(!ShellPutLabel(&CPOS_LABEL_STATUS, "STATUS", NULL))
+				return false;
+			step++;
+		case 7:
+			if(!ShellPutLabel(&CPOS_LABEL_SSID, "SSID: ", network_ssid))
+				return false;
+			step++;
+		case 8:
+			if(!ShellPutLabel(&CPOS_LABEL_HOST, "HOST: ", tcp_server))
+				return false;
+			step++;
+		case 9:
+			if(!ShellPutLabel(&CPOS_LABEL_RELAY, "RELAY:", NULL))
+				return false;
+			step++;
+		case 10:
+			if(!ShellPutLabel(&CPOS_LABEL_PROX, "PROX:", NULL))
+				return false;
+			step++;
+		case 11:
+			if(!ShellPutLabel(&CPOS_LABEL_TEMP, "TEMP:", NULL))
+				return false;
+			step++;
+		case 12:
+			if(!ShellPutLabel(&CPOS_LABEL_LOAD, "LOAD:", NULL))
+				return false;
+			step++;
+		case 13:
+			if(!ShellPutLabel(&CPOS_LABEL_UPTIME, "SYS TIME (ms):", NULL))
+				return false;
+			step++;
+		case 14:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM1A, "COMM1>", NULL))
+				return false;
+			step++;
+		case 15:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM1B, ">", NULL))
+				return false;
+			step++;
+		case 16:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM1C, ">", NULL))
+				return false;
+			step++;
+		case 17:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM1D, ">", NULL))
+				return false;
+			step++;
+		case 18:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM2A, "COMM2>", NULL))
+				return false;
+			step++;
+		case 19:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM2B, ">", NULL))
+				return false;
+			step++;
+		case 20:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM2C, ">", NULL))
+				return false;
+			step++;
+		case 21:
+			if(!ShellPutLabel(&CPOS_LABEL_COMM2D, ">", NULL))
+				return false;
+			step++;
+		case 22:
+			if(!ShellPutLabel(&CPOS_LABEL_CMD, "CMD:", NULL))
+				return false;
+			step++;
+	}
+	step = 0;
+
+	// The terminal is now blank apart from the layout, so every field with contents must be redrawn
+	ScreenInvalidate(&_screen);
+	return true;
+}
+#endif
+
+/**
+ * Prints the counters of a <b>CommPort</b> (passed as the first task parameter) to the debug terminal:
+ * the TX counters on the first run, the RX counters on the second (a whole line does not fit in the TX buffer).
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintCommStatistics(void)
+{
+	CommPort* port = (CommPort*) CURRENT_TASK->params[0];
+	unsigned char row = port == _shell.server ? 22 : 23;
+
+	// Second part: the RX counters (at a fixed column, other tasks may have moved the cursor since the first part)
+	if(CURRENT_TASK->runsRemaining == 1)
+	{
+		// The whole TX buffer (it holds four counters of up to 7 digits)
+		if(!CommReserve(_shell.terminal, TX_BUFFER_SIZE))
+			return false;
+
+		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, row, 46);
+		CommPutString(_shell.terminal, " lost=");
+		FormatPutUnsigned(_shell.terminal, port->rxLines.overrun, 0, ' ');
+		CommPutString(_shell.terminal, " oerr=");
+		FormatPutUnsigned(_shell.terminal, port->rxCounters.overrun, 0, ' ');
+		CommPutString(_shell.terminal, " ferr=");
+		FormatPutUnsigned(_shell.terminal, port->rxCounters.framing, 0, ' ');
+		CommPutString(_shell.terminal, " ldrop=");
+		FormatPutUnsigned(_shell.terminal, port->rxCounters.dropped, 0, ' ');
+		return true;
+	}
+
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 46))
+		return false;
+
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, row, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	CommPutString(_shell.terminal, port == _shell.server ? "COMM1" : "COMM2");
+	CommPutString(_shell.terminal, " deferred=");
+	FormatPutUnsigned(_shell.terminal, port->txCounters.deferred, 0, ' ');
+	CommPutString(_shell.terminal, " dropped=");
+	FormatPutUnsigned(_shell.terminal, port->txCounters.dropped, 0, ' ');
+	return true;
+}
+
+#if SHELL_TASK_STATISTICS
+/**
+ * Prints the scheduler statistics of one task list entry per two runs to the debug terminal
+ * (the task is added with two runs per entry, because a whole line does not fit in the TX buffer).
+ * A line contains the task's function address, number of recorded starts, the largest start-time jitter,
+ * and the jitter histogram (buckets: 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+ ms).
+ * The lines of unused entries are cleared.
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintTaskStatistics(void)
+{
+	unsigned char index = 2 * SHELL_MAX_TASKS - CURRENT_TASK->runsRemaining;
+	unsigned char row = 22 + index / 2;
+	LinkedListNode* node = _shell.task.list.first;
+	unsigned char i;
+	for(i = index / 2; node && i; i--)
+		node = node->next;
+
+	// Second part: the histogram (at a fixed column, other tasks may have moved the cursor since the first part)
+	if(index & 1)
+	{
+		if(node == NULL)
+			return true;
+		if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 1 + 6 * SHELL_JITTER_BUCKETS))
+			return false;
+
+		TaskStatistics* stats = &_taskStatistics[node->memoryIndex];
+		CommPutSequence(_shell.terminal, ANSI_CPOS, 2, row, 32);
+		CommPutChar(_shell.terminal, '|');
+		for(i = 0; i < SHELL_JITTER_BUCKETS; i++)
+		{
+			CommPutChar(_shell.terminal, ' ');
+			FormatPutUnsigned(_shell.terminal, stats->histogram[i], 0, ' ');
+		}
+		return true;
+	}
+
+	// First part: the task and its totals
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 30))
+		return false;
+
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, row, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	if(node == NULL)
+		return true;
+
+	TaskStatistics* stats = &_taskStatistics[node->memoryIndex];
+	CommPutString(_shell.terminal, "0x");
+	FormatPutHex(_shell.terminal, (uint32_t) ((Task*) node->data)->action, 0);
+	CommPutString(_shell.terminal, " n=");
+	FormatPutUnsigned(_shell.terminal, stats->runs, 0, ' ');
+	CommPutString(_shell.terminal, " max=");
+	FormatPutUnsigned(_shell.terminal, stats->maxJitter, 0, ' ');
+	CommPutString(_shell.terminal, "ms");
+	return true;
+}
+#endif
+
+/**
+ * Sends a binary status frame to the terminal (in headless mode only).
+ * Warnings and errors are cleared once they have been reported.
+ * @return true if successful, false if the TX buffer is full
+ * @see TelemetryEncodeStatus
+ */
+bool TaskSendTelemetry(void)
+{
+	if(!_shell.isHeadless)
+		return true;
+
+	TelemetryStatus status;
+	uint8_t frame[TELEMETRY_MAX_FRAME_SIZE];
+	status.uptime = _tick;
+	status.load = _adc.load;
+	status.proxCount = _prox.count;
+	status.relay = _relayState ? 1 : 0;
+	status.link = (_wifi.statusBits.isSsidConnected ? TELEMETRY_LINK_SSID : 0)
+			| (_wifi.statusBits.tcpConnectionStatus << TELEMETRY_LINK_TCP_SHIFT);
+	status.warning = _shell.result.lastWarning;
+	status.error = _shell.result.lastError;
+
+	uint8_t length = TelemetryEncodeStatus(&status, frame);
+	if(!CommReserve(_shell.terminal, length))
+		return false;
+	CommWrite(_shell.terminal, (char*) frame, length);
+	_shell.result.lastWarning = 0;
+	_shell.result.lastError = 0;
+	return true;
+}
+
+/**
+ * Restores the energy meter from the most recent valid checkpoint in SRAM.
+ * SRAM keeps its contents through a reset of the microcontroller (for example, by the watchdog),
+ * but not through a loss of power: the checkpoints are then invalid, and the meter starts from zero.
+ * @return true (the meter is left cleared if no checkpoint can be read)
+ */
+bool TaskRestoreEnergy(void)
+{
+	EnergyCheckpoint checkpoint;
+	Buffer destination;
+	unsigned char slot;
+	bool isRestored = false;
+	InitializeBuffer(&destination, sizeof(EnergyCheckpoint), 1, &checkpoint);
+
+	for(slot = 0; slot < 2; slot++)
+	{
+		if(!SramWait())
+			return true;
+		SramRead(SRAM_ADDR_ENERGY + (slot * sizeof(EnergyCheckpoint)), sizeof(EnergyCheckpoint), &destination);
+		if(!SramWait())
+			return true;
+
+		// Keep the newer of the two checkpoints (the sequence number wraps)
+		if(EnergyIsValid(&checkpoint)
+		&& (!isRestored || (int16_t) (checkpoint.sequence - _energySequence) > 0))
+		{
+			_energy = checkpoint.meter;
+			_energySequence = checkpoint.sequence;
+			isRestored = true;
+		}
+	}
+	return true;
+}
+
+/**
+ * Starts a new energy day at midnight, saves the energy meter to SRAM, and queues its totals for the uplink.
+ * Checkpoints alternate between two slots, so that a reset during a write leaves the previous checkpoint intact.
+ * The sequence number only advances once the write has completed, so a failed write is retried in the same slot.
+ * @return true if successful, false if the checkpoint could not be written (SHELL_ERROR_SRAM_BUSY)
+ */
+bool TaskCheckpointEnergy(void)
+{
+	DateTime dt;
+	GetDateTime(&dt);
+	if(EnergySetDay(&_energy, dt.date.Day.ByteValue))
+		ShellQueueReading(TELEMETRY_TAG_ENERGY_DAY, EnergyMilliwattHours(&_energy.totals[ENERGY_YESTERDAY]), false);
+
+	EnergyCheckpoint checkpoint;
+	Buffer source;
+	uint16_t sequence = _energySequence + 1;
+	EnergySeal(&_energy, sequence, &checkpoint);
+	InitializeBuffer(&source, sizeof(EnergyCheckpoint), 1, &checkpoint);
+	source.length = sizeof(EnergyCheckpoint);
+	if(!SramWait())
+		return false;
+	SramWrite(SRAM_ADDR_ENERGY + ((sequence & 1) * sizeof(EnergyCheckpoint)), &source);
+	if(!SramWait())
+		return false;
+	_energySequence = sequence;
+
+	ShellQueueReading(TELEMETRY_TAG_ENERGY, _energy.totals[ENERGY_TOTAL].wattHours, false);
+	return true;
+}
+
+/**
+ * Prints one energy total per run to the debug terminal (the task is added with one run per total)
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintEnergy(void)
+{
+	static const char* labels[ENERGY_TOTAL_COUNT] = {"total", "today", "yesterday", "open", "closed"};
+	unsigned char index = ENERGY_TOTAL_COUNT - CURRENT_TASK->runsRemaining;
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 34))
+		return false;
+
+	const EnergyTotal* total = &_energy.totals[index];
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 24 + index, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	CommPutString(_shell.terminal, "ENERGY ");
+	CommPutString(_shell.terminal, labels[index]);
+	CommPutChar(_shell.terminal, '=');
+	FormatPutUnsigned(_shell.terminal, total->wattHours, 0, ' ');
+	CommPutChar(_shell.terminal, '.');
+	FormatPutUnsigned(_shell.terminal, total->milliwattHours, 3, '0');
+	CommPutString(_shell.terminal, "Wh");
+	return true;
+}
+
+#if ADC_SCAN_COUNT > 1
+/**
+ * Prints the mean and RMS (AC component) of one of the other scanned inputs per run to the debug terminal
+ * (the task is added with one run per input)
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintAnalogInputs(void)
+{
+	unsigned char index = ADC_SCAN_COUNT - 1 - CURRENT_TASK->runsRemaining;
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 34))
+		return false;
+
+	// 4 fractional bits: 4095 * 16 steps = ADC_VREF
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 24 + ENERGY_TOTAL_COUNT + index, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	CommPutString(_shell.terminal, "AN");
+	FormatPutUnsigned(_shell.terminal, _adcChannels[index + 1], 0, ' ');
+	CommPutString(_shell.terminal, " mean=");
+	FormatPutUnsigned(_shell.terminal, ((unsigned long int) _adc.channelMean[index] * ADC_VREF + 32760) / 65520, 0, ' ');
+	CommPutString(_shell.terminal, "mV rms=");
+	FormatPutUnsigned(_shell.terminal, ((unsigned long int) _adc.channelRms[index] * ADC_VREF + 32760) / 65520, 0, ' ');
+	CommPutString(_shell.terminal, "mV");
+	return true;
+}
+#endif
+
+#if ADC_HARMONIC_COUNT
+/**
+ * Prints the fundamental (as a load), one odd harmonic (relative to the fundamental),
+ * or the total harmonic distortion per run to the debug terminal (the task is added with one run per line)
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintHarmonics(void)
+{
+	unsigned char index = ADC_HARMONIC_COUNT + 1 - CURRENT_TASK->runsRemaining;
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 20))
+		return false;
+
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 24 + ENERGY_TOTAL_COUNT + ADC_SCAN_COUNT - 1 + index, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	if(index == 0)
+	{
+		CommPutString(_shell.terminal, "H1=");
+		FormatPutFixed(_shell.terminal, ((unsigned long int) _adc.harmonics[0] * ADC_LOAD_SCALE + 2048) >> 12, 1, 0, ' ');
+		CommPutChar(_shell.terminal, 'W');
+	}
+	else if(index < ADC_HARMONIC_COUNT)
+	{
+		CommPutChar(_shell.terminal, 'H');
+		FormatPutUnsigned(_shell.terminal, 2 * index + 1, 0, ' ');
+		CommPutChar(_shell.terminal, '=');
+		if(index < _adc.harmonicCount && _adc.harmonics[0])
+		{
+			FormatPutFixed(_shell.terminal, (unsigned long int) _adc.harmonics[index] * 1000 / _adc.harmonics[0], 1, 0, ' ');
+			CommPutChar(_shell.terminal, '%');
+		}
+		else
+			CommPutChar(_shell.terminal, '-');
+	}
+	else
+	{
+		CommPutString(_shell.terminal, "THD=");
+		FormatPutFixed(_shell.terminal, _adc.distortion, 1, 0, ' ');
+		CommPutChar(_shell.terminal, '%');
+	}
+	return true;
+}
+#endif
+
+/**
+ * Prints the sampling configuration and the effective sample rate of the current sensor to the debug terminal
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintSampling(void)
+{
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 48))
+		return false;
+
+	PIE1bits.ADIE = false;
+	AdcSampling sampling = *((const AdcSampling*) &_adc.sampling);
+	unsigned long int period = _adc.samplePeriod;
+	PIE1bits.ADIE = true;
+
+	// Below the analog inputs and harmonics
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 24 + ENERGY_TOTAL_COUNT + ADC_SCAN_COUNT - 1
+			+ (ADC_HARMONIC_COUNT ? ADC_HARMONIC_COUNT + 1 : 0), 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	CommPutString(_shell.terminal, "SAMPLE ");
+	FormatPutFixed(_shell.terminal, CalculateSampleRate(period), 2, 0, ' ');
+	CommPutString(_shell.terminal, "Hz ");
+	FormatPutUnsigned(_shell.terminal, sampling.prescale, 0, ' ');
+	CommPutChar(_shell.terminal, '/');
+	FormatPutUnsigned(_shell.terminal, sampling.postscale, 0, ' ');
+	CommPutChar(_shell.terminal, '/');
+	FormatPutUnsigned(_shell.terminal, sampling.period, 0, ' ');
+	CommPutChar(_shell.terminal, ' ');
+	FormatPutUnsigned(_shell.terminal, sampling.windowCycles, 0, ' ');
+	CommPutString(_shell.terminal, "cyc/");
+	FormatPutUnsigned(_shell.terminal, sampling.windowSize, 0, ' ');
+	if(_adc.isPending)
+		CommPutString(_shell.terminal, " pending");
+	return true;
+}
+
+#if ADC_CAPTURE_SIZE
+/**
+ * Stores a complete transient capture in SRAM (oldest sample first), queues it for the uplink,
+ * and arms the transient recorder again once <code>ADC_CAPTURE_HOLDOFF</code> has passed since the trigger.
+ * The ADC interrupt does not touch the ring between the end of a capture and the next arming.
+ * @return true if successful, false if failed
+ */
+bool TaskStoreCapture(void)
+{
+	if(_adc.capture.state == ADC_CAPTURE_STORED)
+	{
+		if(_tick - _adc.capture.time >= ADC_CAPTURE_HOLDOFF)
+		{
+			PIE1bits.ADIE = false;
+			_adc.capture.remaining = ADC_CAPTURE_PRE_TRIGGER;
+			_adc.capture.state = ADC_CAPTURE_FILLING;
+			PIE1bits.ADIE = true;
+		}
+		return true;
+	}
+	if(_adc.capture.state != ADC_CAPTURE_DONE)
+		return true;
+
+	// The oldest sample is the one the next sample would have overwritten, so the ring is written in two parts
+	unsigned char start = _adc.capture.index & (ADC_CAPTURE_SIZE - 1);
+	Buffer source;
+	if(!SramWait())
+		return true;
+	InitializeBuffer(&source, ADC_CAPTURE_SIZE - start, sizeof(int), (void*) &_adc.capture.samples[start]);
+	source.length = ADC_CAPTURE_SIZE - start;
+	SramWrite(SRAM_ADDR_CAPTURE, &source);
+	if(!SramWait())
+		return true;
+	if(start)
+	{
+		InitializeBuffer(&source, start, sizeof(int), (void*) _adc.capture.samples);
+		source.length = start;
+		SramWrite(SRAM_ADDR_CAPTURE + (ADC_CAPTURE_SIZE - start) * sizeof(int), &source);
+		if(!SramWait())
+			return true;
+	}
+
+	unsigned char i;
+	int peak = 0;
+	for(i = 0; i < ADC_CAPTURE_SIZE; i++)
+	{
+		if(abs(_adc.capture.samples[i]) > abs(peak))
+			peak = _adc.capture.samples[i];
+	}
+	_adc.capture.peak = peak;
+	_adc.capture.period = _adc.samplePeriod;
+	_adc.capture.sequence++;
+	_adc.capture.state = ADC_CAPTURE_STORED;
+
+	if(ShellQueueReading(TELEMETRY_TAG_CAPTURE, peak, true))
+		ShellAddTask(TaskUplinkCapture, ADC_CAPTURE_SIZE / 16, 0, 0, false, false, false, 0);
+	return true;
+}
+
+/**
+ * Queues 16 samples of the stored transient capture per run for the uplink, read back from SRAM
+ * (the task is added with one run per record, each record carries 8 readings of two samples)
+ * @return true once the record is queued, false to retry the same record (SRAM busy or uplink queue full)
+ */
+bool TaskUplinkCapture(void)
+{
+	unsigned char index = ADC_CAPTURE_SIZE / 16 - CURRENT_TASK->runsRemaining;
+	int samples[16];
+	TelemetryReading readings[8];
+	Buffer destination;
+	unsigned char i;
+	InitializeBuffer(&destination, 16, sizeof(int), samples);
+
+	if(!SramWait())
+		return false;
+	SramRead(SRAM_ADDR_CAPTURE + index * 16 * sizeof(int), 16, &destination);
+	if(!SramWait())
+		return false;
+
+	for(i = 0; i < 8; i++)
+	{
+		readings[i].tag = TELEMETRY_TAG_CAPTURE_DATA;
+		readings[i].value = (int32_t) (((uint32_t) (index * 8 + i) << 26)
+				| ((uint32_t) (samples[2 * i] & 0x1FFF) << 13)
+				| (uint32_t) (samples[2 * i + 1] & 0x1FFF));
+	}
+	return ShellQueueReadings(readings, 8, true);
+}
+
+/**
+ * Prints the transient recorder state (first run), the stored capture (second run),
+ * and 8 samples of the stored capture per run, read back from SRAM, to the debug terminal
+ * @return true if successful, false if the TX buffer is full
+ */
+bool TaskPrintCapture(void)
+{
+	static const char* states[] = {" filling", " armed", " triggered", " done", " stored"};
+	unsigned char index = 2 + ADC_CAPTURE_SIZE / 8 - CURRENT_TASK->runsRemaining;
+	unsigned char i;
+	int samples[8];
+	if(index >= 2)
+	{
+		Buffer destination;
+		if(_adc.capture.sequence == 0)
+			return true;
+		InitializeBuffer(&destination, 8, sizeof(int), samples);
+		if(!SramWait())
+			return false;
+		SramRead(SRAM_ADDR_CAPTURE + (index - 2) * 8 * sizeof(int), 8, &destination);
+		if(!SramWait())
+			return false;
+	}
+	if(!CommReserve(_shell.terminal, LAYOUT_CLEAR_MAX_LENGTH + 48))
+		return false;
+
+	// Below the sampling configuration
+	CommPutSequence(_shell.terminal, ANSI_CPOS, 2, 25 + ENERGY_TOTAL_COUNT + ADC_SCAN_COUNT - 1
+			+ (ADC_HARMONIC_COUNT ? ADC_HARMONIC_COUNT + 1 : 0) + index, 1);
+	CommPutSequence(_shell.terminal, ANSI_ELINE, 0);
+	if(index == 0)
+	{
+		CommPutString(_shell.terminal, "CAPTURE ");
+		FormatPutSigned(_shell.terminal, _adc.capture.low, 0, ' ');
+		CommPutString(_shell.terminal, "..");
+		FormatPutSigned(_shell.terminal, _adc.capture.high, 0, ' ');
+		CommPutString(_shell.terminal, states[_adc.capture.state]);
+	}
+	else if(_adc.capture.sequence == 0)
+		CommPutString(_shell.terminal, "no capture");
+	else if(index == 1)
+	{
+		CommPutChar(_shell.terminal, '#');
+		FormatPutUnsigned(_shell.terminal, _adc.capture.sequence, 0, ' ');
+		CommPutString(_shell.terminal, " at ");
+		FormatPutUnsigned(_shell.terminal, _adc.capture.time, 0, ' ');
+		CommPutString(_shell.terminal, "ms peak=");
+		FormatPutSigned(_shell.terminal, _adc.capture.peak, 0, ' ');
+		CommPutChar(_shell.terminal, ' ');
+		FormatPutFixed(_shell.terminal, CalculateSampleRate(_adc.capture.period), 2, 0, ' ');
+		CommPutString(_shell.terminal, "Hz");
+	}
+	else
+	{
+		for(i = 0; i < 8; i++)
+			FormatPutSigned(_shell.terminal, samples[i], 6, ' ');
+	}
+	return true;
+}
+#endif
+
+/**
+ * Prints the current OS tick value to the terminal
+ * @return true if successful, false if failed
+ */
+bool TaskPrintTick(void)
+{
+	char tickStr[FORMAT_MAX_LENGTH + 1];
+	FormatUnsigned(tickStr, _tick, 0, ' ');
+	ScreenWrite(&_screen, FIELD_UPTIME, tickStr);
+	return true;
+}
+
+/**
+ * Prints the current date and time to the terminal
+ * @return true if successful, false if failed
+ */
+bool TaskPrintDateTime(void)
+{
+	DateTime dt;
+	GetDateTime(&dt);
+	dt.date.Year.Tens = 1;	// HARD CODED = FIGURE OUT WHY year is always '00
+	dt.date.Year.Ones = 7;	// HARD CODED = FIGURE OUT WHY year is always '00
+	char dateStr[13];
+	char timeStr[9];
+
+	// Weekday
+	switch(dt.weekday)
+	{
+		case SUNDAY:
+			strcpy(dateStr, "Sun ");
+			break;
+		case MONDAY:
+			strcpy(dateStr, "Mon ");
+			break;
+		case TUESDAY:
+			strcpy(dateStr, "Tue ");
+			break;
+		case WEDNESDAY:
+			strcpy(dateStr, "Wed ");
+			break;
+		case THURSDAY:
+			strcpy(dateStr, "Thu ");
+			break;
+		case FRIDAY:
+			strcpy(dateStr, "Fri ");
+			break;
+		case SATURDAY:
+			strcpy(dateStr, "Sat ");
+			break;
+		default:
+			strcpy(dateStr, "    ");
+			break;
+	}
+
+	// Date
+	dateStr[4] = '0' + dt.date.Month.Tens;
+	dateStr[5] = '0' + dt.date.Month.Ones;
+	dateStr[6] = '/';
+	dateStr[7] = '0' + dt.date.Day.Tens;
+	dateStr[8] = '0' + dt.date.Day.Ones;
+	dateStr[9] = '/';
+	dateStr[10] = '0' + dt.date.Year.Tens;
+	dateStr[11] = '0' + dt.date.Year.Ones;
+	dateStr[12] = ASCII_NUL;
+	ScreenWrite(&_screen, FIELD_DATE, dateStr);
+
+	// Time
+	timeStr[0] = '0' + dt.time.Hour.Tens;
+	timeStr[1] = '0' + dt.time.Hour.Ones;
+	timeStr[2] = ':';
+	timeStr[3] = '0' + dt.time.Minute.Tens;
+	timeStr[4] = '0' + dt.time.Minute.Ones;
+	timeStr[5] = ':';
+	timeStr[6] = '0' + dt.time.Second.Tens;
+	timeStr[7] = '0' + dt.time.Second.Ones;
+	timeStr[8] = ASCII_NUL;
+	ScreenWrite(&_screen, FIELD_TIME, timeStr);
+	return true;
+}
+
+/**
+ * Calculates the RMS current of each window handed over by the ADC interrupt,
+ * and raises a warning if windows have been discarded since the last run
+ * @return true if successful, false if failed
+ */
+bool TaskCalculateRMSCurrent(void)
+{
+	if(_adc.overruns != _adc.reportedOverruns)
+	{
+		_adc.reportedOverruns = _adc.overruns;
+		_shell.result.lastWarning = SHELL_WARNING_ADC_OVERRUN;
+		_shell.result.values[0] = _adc.reportedOverruns;
+	}
+	if(!_adc.isReady)
+		return true;
+#if ADC_HARMONIC_COUNT
+	if(_adc.isHarmonicsPending)
+		return true;
+#endif
+
+	unsigned int load = CalculateCurrentRMS();
+	_adc.load = load;
+	if(load > 18000)
+	{
+		switch(_adc.pinFloatAnimation)
+		{
+			case 0:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "Floating");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 1:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "fLoating");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 2:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "flOating");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 3:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floAting");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 4:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floaTing");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 5:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floatIng");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 6:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floatiNg");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			case 7:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floatinG");
+				_adc.pinFloatAnimation++;
+				break;
+			}
+			default:
+			{
+				ScreenWrite(&_screen, FIELD_LOAD, "floating");
+				_adc.pinFloatAnimation = 0;
+				break;
+			}
+		}
+	}
+	else
+	{
+		char loadStr[FORMAT_MAX_LENGTH + 2];
+		unsigned char length = FormatFixed(loadStr, load, 1, 0, ' ');
+		loadStr[length] = 'W';
+		loadStr[length + 1] = ASCII_NUL;
+		ScreenWrite(&_screen, FIELD_LOAD, loadStr);
+
+		ShellQueueReading(TELEMETRY_TAG_LOAD, load, false);
+		EnergyAddWindow(&_energy, load, _adc.duration, _relayState != 0);
+	}
+
+	if(_adc.frequency
+	&& (_adc.frequency > _adc.reportedFrequency ? _adc.frequency - _adc.reportedFrequency
+		: _adc.reportedFrequency - _adc.frequency) >= ADC_FREQUENCY_DEADBAND)
+	{
+		if(ShellQueueReading(TELEMETRY_TAG_LINE_FREQ, _adc.frequency, false))
+			_adc.reportedFrequency = _adc.frequency;
+	}
+	if(!_adc.isPending && _adc.samplePeriod != _adc.reportedSamplePeriod)
+	{
+		if(ShellQueueReading(TELEMETRY_TAG_SAMPLE_RATE, CalculateSampleRate(_adc.samplePeriod), false))
+			_adc.reportedSamplePeriod = _adc.samplePeriod;
+	}
+#if ADC_HARMONIC_COUNT
+	if(_adc.harmonics[0]
+	&& (_adc.distortion > _adc.reportedDistortion ? _adc.distortion - _adc.reportedDistortion
+		: _adc.reportedDistortion - _adc.distortion) >= ADC_DISTORTION_DEADBAND)
+	{
+		// The individual harmonics (relative to the fundamental) make up the load signature
+		if(ShellQueueReading(TELEMETRY_TAG_DISTORTION, _adc.distortion, false))
+		{
+			unsigned char i;
+			_adc.reportedDistortion = _adc.distortion;
+			for(i = 1; i < _adc.harmonicCount; i++)
+				ShellQueueReading(TELEMETRY_TAG_HARMONIC3 + i - 1, (unsigned long int) _adc.harmonics[i] * 1000 / _adc.harmonics[0], false);
+		}
+	}
+#endif
+	return true;
+}
+
+/**
+ * Updates the status of the relay
+ * @return true if successful, false if failed
+ */
+bool TaskUpdateRelayStatus(void)
+{
+	if(_relayState)
+		ScreenWrite(&_screen, FIELD_RELAY, "CLOSED");
+	else
+		ScreenWrite(&_screen, FIELD_RELAY, "OPEN");
+	ShellQueueReading(TELEMETRY_TAG_RELAY, _relayState ? 1 : 0, true);
+	return true;
+}
+
+/**
+ * Updates the status of the proximity sensor
+ * @return true if successful, false if failed
+ */
+bool TaskUpdateProximityStatus(void)
+{
+	if(!_prox.isTripped)
+		return true;
+
+	char numStr[FORMAT_MAX_LENGTH + 1];
+	FormatUnsigned(numStr, _prox.count, 0, ' ');
+	ScreenWrite(&_screen, FIELD_PROX, numStr);
+	_prox.isTripped = false;
+	return true;
+}
+
+/**
+ * Prints the current temperature to the terminal
+ * @return true if successful, false if failed
+ */
+bool TaskPrintTemp(void)
+{
+	char valueStr[FORMAT_MAX_LENGTH + 3];
+	unsigned char length = FormatFixed(valueStr, 700 + (rand() % 5), 1, 0, ' ');	// Tenths of a degree
+	strcpy(valueStr + length, "F");
+	ScreenWrite(&_screen, FIELD_TEMP, valueStr);
+	return true;
+}
+
+/**
+ * Sends the line of a WC: command to the TCP host, a part at a time as the TX buffer makes room
+ * @return true once the whole line has been written, false if it must be continued
+ */
+bool TaskSendServerLine(void)
+{
+	static unsigned int progress = 0;
+	const char* line = _serverLine;
+	if(!CommPutLine(_shell.server, &line, 1, &progress))
+		return false;
+
+	_isServerLinePending = false;
+	return true;
+}
+
+/**
+ * Initiates a connection of the specified network
+ * @return true if successful, false if failed
+ */
+bool TaskConnectNetwork(void)
+{
+	// Wait until the link speed has been negotiated
+	if(_wifi.statusBits.boot != WIFI_BOOT_COMPLETE)
+	{
+		ShellTaskCheckIn();
+		return false;
+	}
+
+	// The command is sent (and its responses are handled) by the AT command engine
+	return WifiQueueCommand(&_joinNetworkCommand);
+}
+
+/**
+ * Initiates a TCP client connection to the specified host
+ * @return true if successful, false if failed
+ */
+bool TaskConnectTcp(void)
+{
+	// After a failed attempt, wait before trying again
+	if(_tick - _wifi.eventTime < WIFI_TCP_RETRY_DELAY
+	|| _wifi.statusBits.boot != WIFI_BOOT_COMPLETE
+	|| !WifiQueueCommand(&_connectTcpCommand))
+	{
+		ShellTaskCheckIn();
+		return false;
+	}
+
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CONNECTING;
+	return true;
+}
+
+// AT COMMAND HANDLERS---------------------------------------------------------
+
+/**
+ * Writes the AT command which connects to the specified network
+ * @return true if successful, false if there is not enough room in the TX buffer
+ */
+bool AtJoinNetwork(void)
+{
+	// An SSID and a password can be longer than the TX buffer together, so the command is sent in parts
+	static unsigned int progress = 0;
+	const char* parts[6];
+	unsigned char count = 0;
+	parts[count++] = at_cwjap_cur;
+	parts[count++] = "=\"";
+	parts[count++] = network_ssid;
+	if(network_use_password)
+	{
+		parts[count++] = "\",\"";
+		parts[count++] = network_pass;
+	}
+	parts[count++] = "\"";
+	return CommPutLine(_shell.server, parts, count, &progress);
+}
+
+/**
+ * Displays the reason reported by the wifi module (+CWJAP:&lt;code&gt;) when it cannot connect to the network
+ * @param line Pointer to a <b>Buffer</b> containing an intermediate response line
+ */
+void AtJoinNetworkLine(void* line)
+{
+	if(BufferContains((Buffer*) line, "+CWJAP:", 7) != 0)
+		return;
+
+	switch(((char*) ((Buffer*) line)->data)[7])
+	{
+		case '1':
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Timeout");
+			break;
+		case '2':
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Bad password");
+			break;
+		case '3':
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "No AP");
+			break;
+		default:
+			ScreenWrite(&_screen, FIELD_SSID_STATUS, "Failed");
+			break;
+	}
+}
+
+/**
+ * Handles the result of the network connection (the connection itself is reported by WIFI GOT IP).
+ * If the connection failed, it is tried again.
+ * @param response The final response
+ */
+void AtJoinNetworkDone(unsigned char response)
+{
+	if(response == WIFI_RESPONSE_OK)
+		return;
+
+	_shell.result.lastError = response == WIFI_RESPONSE_TIMEOUT ? SHELL_ERROR_WIFI_TIMEOUT : SHELL_ERROR_WIFI_COMMAND;
+	_shell.result.values[0] = _tick;
+	ShellAddTask(TaskConnectNetwork, 1, 0, 0, false, false, false, 0);
+}
+
+/**
+ * Writes the AT command which opens a TCP client connection to the specified host
+ * @return true if successful, false if there is not enough room in the TX buffer
+ */
+bool AtConnectTcp(void)
+{
+	// A host name can be longer than the TX buffer, so the command is sent in parts
+	static unsigned int progress = 0;
+	char port[FORMAT_MAX_LENGTH + 1];
+	const char* parts[5];
+	FormatUnsigned(port, tcp_port, 0, ' ');
+	parts[0] = at_cipstart;
+	parts[1] = "=\"TCP\",\"";
+	parts[2] = tcp_server;
+	parts[3] = "\",";
+	parts[4] = port;
+	return CommPutLine(_shell.server, parts, 5, &progress);
+}
+
+/**
+ * Handles ALREADY CONNECTED (which is followed by ERROR, even though the connection is usable)
+ * @param line Pointer to a <b>Buffer</b> containing an intermediate response line
+ */
+void AtConnectTcpLine(void* line)
+{
+	if(BufferContains((Buffer*) line, "ALREADY CONNECTED", 17) == 0)
+		_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+}
+
+/**
+ * Handles the result of the TCP connection.
+ * If the connection failed (and the network is still connected), it is tried again after <code>WIFI_TCP_RETRY_DELAY</code>.
+ * @param response The final response
+ */
+void AtConnectTcpDone(unsigned char response)
+{
+	if(response == WIFI_RESPONSE_OK || _wifi.statusBits.tcpConnectionStatus == WIFI_TCP_READY)
+	{
+		_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_READY;
+		ScreenWrite(&_screen, FIELD_HOST_STATUS, "Ready");
+		return;
+	}
+
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+	ScreenWrite(&_screen, FIELD_HOST_STATUS, "Closed");
+	if(response == WIFI_RESPONSE_TIMEOUT)
+	{
+		_shell.result.lastError = SHELL_ERROR_WIFI_TIMEOUT;
+		_shell.result.values[0] = _tick;
+	}
+	if(_wifi.statusBits.isSsidConnected)
+	{
+		_wifi.eventTime = _tick;
+		ShellAddTask(TaskConnectTcp, 1, 0, 0, false, false, false, 0);
+	}
+}
+
+// BUTTON ACTIONS--------------------------------------------------------------
+
+/**
+ * This function executes when the button is pressed
+ */
+void ButtonPress(void)
+{
+	RelayControl(_relayState ? 0 : 1);
+}
+
+/**
+ * This function executes when the button is held
+ */
+void ButtonHold(void)
+{
+	;
+}
+
+/**
+ * This function executes when the button is released
+ */
+void ButtonRelease(void)
+{
+	;
+}
+
+// LOAD MEASUREMENT FUNCTIONS--------------------------------------------------
+// The window count is a single byte, which also keeps the sum of squares within 32 bits (255 * 4095^2 < 2^32)
+#if ADC_WINDOW_SIZE > 255
+#error "ADC_WINDOW_SIZE must not exceed 255"
+#endif
+#if ADC_WINDOW_CYCLES < 1 || ADC_WINDOW_CYCLES * 12 >= ADC_WINDOW_SIZE
+#error "ADC_WINDOW_SIZE must hold ADC_WINDOW_CYCLES mains cycles at 50Hz (12 samples per cycle)"
+#endif
+// The mean square (AC component) of a window whose mean is within ADC_FLOAT_OFFSET of ADC_DC_OFFSET is below 2^30 (8 fractional bits),
+// so that the sliding sum of up to 4 windows fits in 32 bits
+// Window durations are passed to the energy meter in whole periods of ENERGY_TIME_BASE (see ADC_ENERGY_TICKS)
+#if ADC_CYCLE_CLOCK % (ENERGY_TIME_BASE * 100) != 0
+#error "ENERGY_TIME_BASE must divide the instruction clock (ADC_CYCLE_CLOCK)"
+#endif
+#if ADC_SLIDING_RMS && (ADC_SLIDING_WINDOWS < 1 || ADC_SLIDING_WINDOWS > 4)
+#error "ADC_SLIDING_WINDOWS must be between 1 and 4"
+#endif
+#if ADC_SCAN_COUNT < 1 || ADC_SCAN_COUNT > 3
+#error "ADC_SCAN_COUNT must be between 1 and 3"
+#endif
+#if ADC_SCAN_COUNT > 1 && (ADC_SCAN_CHANNEL1 == 1 || ADC_SCAN_CHANNEL2 == 1)
+#error "AN1 is the proximity detector input and cannot be scanned"
+#endif
+#if ADC_HARMONIC_COUNT < 0 || ADC_HARMONIC_COUNT > 4
+#error "ADC_HARMONIC_COUNT must be between 0 and 4"
+#endif
+// The ring index is a single byte, and the uplink numbers the sample pairs of a capture with 6 bits (see TELEMETRY_TAG_CAPTURE_DATA)
+#if ADC_CAPTURE_SIZE && (ADC_CAPTURE_SIZE < 16 || ADC_CAPTURE_SIZE > 128 || (ADC_CAPTURE_SIZE & (ADC_CAPTURE_SIZE - 1)))
+#error "ADC_CAPTURE_SIZE must be 0, or a power of 2 from 16 to 128"
+#endif
+#if ADC_CAPTURE_SIZE && (ADC_CAPTURE_PRE_TRIGGER < 1 || ADC_CAPTURE_PRE_TRIGGER > ADC_CAPTURE_SIZE - 2)
+#error "ADC_CAPTURE_PRE_TRIGGER must be between 1 and ADC_CAPTURE_SIZE - 2"
+#endif
+
+/**
+ * Initializes all variables necessary for load calculations
+ */
+void InitializeLoadMeasurement(void)
+{
+	unsigned char i;
+	for(i = 0; i < 2; i++)
+	{
+		_adc.windows[i].sum = 0;
+		_adc.windows[i].sumSquares = 0;
+		_adc.windows[i].count = 0;
+		_adc.windows[i].cycles = 0;
+		_adc.windows[i].isSynchronized = false;
+		_adc.windows[i].offset = ADC_DC_OFFSET;
+		_adc.windows[i].period = CalculateSamplePeriod(ADC_TIMER_PRESCALE, ADC_TIMER_POSTSCALE, ADC_TIMER_PERIOD);
+	}
+	_adc.active = 0;
+	_adc.isReady = false;
+	_adc.overruns = 0;
+	_adc.reportedOverruns = 0;
+	_adc.isArmed = false;
+	_adc.previous = 0;
+	_adc.dcOffset = ADC_DC_OFFSET;
+	_adc.dcLevel = (long int) ADC_DC_OFFSET << 8;
+	_adc.frequency = 0;
+	_adc.reportedFrequency = 0;
+	_adc.duration = 0;
+	_adc.durationResidue = 0;
+	_adc.sampling.prescale = ADC_TIMER_PRESCALE;
+	_adc.sampling.postscale = ADC_TIMER_POSTSCALE;
+	_adc.sampling.period = ADC_TIMER_PERIOD;
+	_adc.sampling.windowCycles = ADC_WINDOW_CYCLES;
+	_adc.sampling.windowSize = ADC_WINDOW_SIZE;
+	_adc.samplePeriod = CalculateSamplePeriod(ADC_TIMER_PRESCALE, ADC_TIMER_POSTSCALE, ADC_TIMER_PERIOD);
+	_adc.isPending = false;
+	_adc.reportedSamplePeriod = 0;
+	_adc.channel = 0;
+#if ADC_HARMONIC_COUNT
+	_adc.harmonicCount = 0;
+	_adc.inputShift = 0;
+	_adc.isHarmonicsPending = false;
+	_adc.harmonicFilter = 0;
+	for(i = 0; i < ADC_HARMONIC_COUNT; i++)
+	{
+		_adc.windows[0].goertzel[i].s1 = _adc.windows[0].goertzel[i].s2 = 0;
+		_adc.windows[1].goertzel[i].s1 = _adc.windows[1].goertzel[i].s2 = 0;
+		_adc.coefficients[i] = 0;
+		_adc.harmonics[i] = 0;
+	}
+	_adc.windows[0].harmonicCount = _adc.windows[1].harmonicCount = 0;
+	_adc.windows[0].inputShift = _adc.windows[1].inputShift = 0;
+	_adc.distortion = 0;
+	_adc.reportedDistortion = 0;
+#endif
+#if ADC_SCAN_COUNT > 1
+	for(i = 0; i < ADC_SCAN_COUNT - 1; i++)
+	{
+		_adc.channelMean[i] = 0;
+		_adc.channelRms[i] = 0;
+	}
+#endif
+#if ADC_TRACK_LINE
+	_adc.trackedFrequency = 0;
+#endif
+#if ADC_SLIDING_RMS
+	_adc.historyIndex = 0;
+	_adc.historyCount = 0;
+#endif
+#if ADC_CAPTURE_SIZE
+	_adc.capture.index = 0;
+	_adc.capture.remaining = ADC_CAPTURE_PRE_TRIGGER;
+	_adc.capture.state = ADC_CAPTURE_FILLING;
+	_adc.capture.high = ADC_CAPTURE_HIGH;
+	_adc.capture.low = ADC_CAPTURE_LOW;
+	_adc.capture.time = 0;
+	_adc.capture.sequence = 0;
+	_adc.capture.peak = 0;
+	_adc.capture.period = 0;
+#endif
+	_adc.pinFloatAnimation = 0;
+	_adc.load = 0;
+	EnergyInitialize(&_energy);
+	_energySequence = 0;
+}
+
+/**
+ * Calculates the RMS current from the window handed over by the ADC interrupt.
+ * The DC component (the mean of the window) is removed, and only integer math is used:
+ * the mean square is calculated with 8 fractional bits, and the RMS (with 4 fractional bits) is scaled to tenths of a watt.
+ * The window mean also feeds the DC tracker, whose offset the ADC interrupt subtracts from the samples of the next window.
+ * With ADC_SLIDING_RMS, the mean squares of the last ADC_SLIDING_WINDOWS windows are averaged before the square root is taken.
+ * The ADC interrupt keeps filling the other window meanwhile, so every sample contributes to a measurement
+ * as long as each window is processed before the next one is complete.
+ * The line frequency is measured from the same window (see CalculateLineFrequency),
+ * and with ADC_SCAN_COUNT > 1, the mean and RMS of the other scanned inputs are updated from it as well.
+ * With ADC_HARMONIC_COUNT, the window is then held for its harmonic analysis (see TaskCalculateHarmonics).
+ * @return The RMS load (at 120V) in tenths of a watt, 0 if no window is ready, or 65535 if the input is floating
+ */
+unsigned int CalculateCurrentRMS(void)
+{
+	if(!_adc.isReady)
+		return 0;
+#if ADC_HARMONIC_COUNT
+	if(_adc.isHarmonicsPending)
+		return 0;
+#endif
+
+	// The ADC interrupt leaves the ready window untouched until it is released
+	AdcWindow window = *((const AdcWindow*) &_adc.windows[_adc.active ^ 1]);
+
+	// The energy meter counts whole periods of ENERGY_TIME_BASE, the rest is carried over to the next window
+	unsigned long int ticks = window.count * window.period + _adc.durationResidue;
+	_adc.duration = (unsigned int) (ticks / ADC_ENERGY_TICKS);
+	_adc.durationResidue = ticks % ADC_ENERGY_TICKS;
+
+	_adc.frequency = CalculateLineFrequency(&window);
+#if ADC_TRACK_LINE
+	if(_adc.frequency && !_adc.isPending)
+	{
+		// Crossings of waveforms with flat zero-current regions are noisy, so the frequency is averaged
+		// and PR6 is moved by one step at a time
+		if(_adc.trackedFrequency)
+			_adc.trackedFrequency += ((long int) _adc.frequency - _adc.trackedFrequency) / 16;
+		else
+			_adc.trackedFrequency = _adc.frequency;
+
+		// Use the whole number of samples per cycle closest to the current rate (10 at 60Hz, 12 at 50Hz by default).
+		// The new period takes effect at the start of a window, whose zero crossings are then not used (see ConfigureSampling)
+		AdcSampling sampling = *((const AdcSampling*) &_adc.sampling);
+		unsigned long int clock = ADC_CYCLE_CLOCK / ((unsigned int) sampling.prescale * sampling.postscale * ADC_SCAN_COUNT);
+		unsigned long int rate = (CalculateSampleRate(_adc.samplePeriod) + _adc.trackedFrequency / 2)
+				/ _adc.trackedFrequency * _adc.trackedFrequency;
+		unsigned long int period = (clock + rate / 2) / rate - 1;
+		if(period <= 255 && period != sampling.period)
+		{
+			sampling.period = period > sampling.period ? sampling.period + 1 : sampling.period - 1;
+			ConfigureSampling(&sampling);
+		}
+	}
+#endif
+
+	// A floating input sits far from the zero-current output of the sensor
+	long int level = ((long int) window.offset << 8) + (window.sum * 256) / window.count;
+	if(labs(level - ((long int) ADC_DC_OFFSET << 8)) > (long int) ADC_FLOAT_OFFSET << 8)
+	{
+		_adc.isReady = false;
+		return 65535;
+	}
+
+	// Track the DC level of the sensor, so that bias drift does not shift the zero crossings
+	_adc.dcLevel += (level - _adc.dcLevel) / (1 << ADC_DC_TRACK_SHIFT);
+	int offset = (int) ((_adc.dcLevel + 128) >> 8);
+	if(offset != _adc.dcOffset)
+	{
+		PIE1bits.ADIE = false;
+		_adc.dcOffset = offset;
+		PIE1bits.ADIE = true;
+	}
+
+#if ADC_HARMONIC_COUNT
+	// A synchronized window whose samples were all stored is held until TaskCalculateHarmonics has run its filters,
+	// any other window is released now
+	_adc.isHarmonicsPending = window.isSynchronized && window.harmonicCount && window.count <= ADC_HARMONIC_SAMPLES;
+	_adc.isReady = _adc.isHarmonicsPending;
+	if(_adc.frequency)
+		CalculateGoertzelCoefficients(_adc.frequency);
+#else
+	_adc.isReady = false;
+#endif
+
+#if ADC_SCAN_COUNT > 1
+	unsigned char channel;
+	for(channel = 0; channel < ADC_SCAN_COUNT - 1; channel++)
+	{
+		const AdcChannelSums* sums = &window.channels[channel];
+		_adc.channelMean[channel] = (unsigned int) ((sums->sum * 16) / window.count);
+		_adc.channelRms[channel] = SquareRoot(CalculateMeanSquareAC(sums->sum, sums->sumSquares, window.count));
+	}
+#endif
+
+	unsigned long int load = CalculateMeanSquareAC(window.sum, window.sumSquares, window.count);
+#if ADC_SLIDING_RMS
+	_adc.history[_adc.historyIndex] = load;
+	if(++_adc.historyIndex >= ADC_SLIDING_WINDOWS)
+		_adc.historyIndex = 0;
+	if(_adc.historyCount < ADC_SLIDING_WINDOWS)
+		_adc.historyCount++;
+
+	unsigned char i;
+	for(i = 0, load = 0; i < _adc.historyCount; i++)
+		load += _adc.history[i];
+	load /= _adc.historyCount;
+#endif
+	load = ((unsigned long int) SquareRoot(load) * ADC_LOAD_SCALE + 2048) >> 12;
+	return load < 65535 ? (unsigned int) load : 65535;
+}
+
+/**
+ * Calculates the line frequency from a window that starts and ends at a rising zero crossing.
+ * Each crossing is located between its two samples by linear interpolation,
+ * so the length of the window is known to a fraction of a sample (8 fractional bits).
+ * @param window	Pointer to the window
+ * @return			The line frequency in hundredths of a hertz, or 0 if the window is not synchronized to the line
+ */
+unsigned int CalculateLineFrequency(const AdcWindow* window)
+{
+	if(!window->isSynchronized || window->cycles == 0)
+		return 0;
+
+	// A crossing lies after / (after - before) samples before the sample that follows it
+	long int length = ((long int) window->count << 8)
+			+ ((long int) window->start.after << 8) / (window->start.after - window->start.before)
+			- ((long int) window->end.after << 8) / (window->end.after - window->end.before);
+	if(length <= 0)
+		return 0;
+
+	return (unsigned int) ((window->cycles * CalculateSampleRate(window->period) * 256 + length / 2) / length);
+}
+
+/**
+ * Validates a sampling configuration and hands it to the ADC interrupt, which applies it at the start of the next window,
+ * so that the samples of a window are evenly spaced (except for the first interval, see isrHighPriority)
+ * @param sampling	Pointer to the configuration
+ * @return			true if successful, false if the configuration is invalid
+ */
+bool ConfigureSampling(const AdcSampling* sampling)
+{
+	if((sampling->prescale != 1 && sampling->prescale != 4 && sampling->prescale != 16)
+	|| sampling->postscale < 1 || sampling->postscale > 16 || sampling->windowCycles < 1)
+		return false;
+
+	unsigned long int period = CalculateSamplePeriod(sampling->prescale, sampling->postscale, sampling->period);
+	unsigned long int rate = CalculateSampleRate(period);
+	if(rate < ADC_MIN_SAMPLE_RATE || rate > ADC_MAX_SAMPLE_RATE)
+		return false;
+
+	// A window must hold the configured number of mains cycles at 50Hz,
+	// and must not last longer than the energy meter integrates at once (65535 periods of ENERGY_TIME_BASE)
+	if((unsigned long int) sampling->windowSize * 5000 <= (unsigned long int) sampling->windowCycles * rate
+	|| sampling->windowSize * period > 65535UL * ADC_ENERGY_TICKS)
+		return false;
+
+	PIE1bits.ADIE = false;
+	_adc.pending = *sampling;
+	_adc.pendingPeriod = period;
+	_adc.isPending = true;
+	PIE1bits.ADIE = true;
+	return true;
+}
+
+/**
+ * Calculates the time between two samples of the current sensor
+ * @param prescale	TMR6 clock prescale
+ * @param postscale	TMR6 output postscale
+ * @param period	TMR6 period (PR6)
+ * @return			The sample period in instruction cycles
+ */
+unsigned long int CalculateSamplePeriod(unsigned char prescale, unsigned char postscale, unsigned char period)
+{
+	return (unsigned long int) prescale * postscale * (period + 1) * ADC_SCAN_COUNT;
+}
+
+/**
+ * Calculates the rate at which the current sensor is sampled
+ * @param period	Sample period in instruction cycles (see CalculateSamplePeriod)
+ * @return			The sample rate in hundredths of a hertz
+ */
+unsigned long int CalculateSampleRate(unsigned long int period)
+{
+	return (ADC_CYCLE_CLOCK + period / 2) / period;
+}
+
+#if ADC_HARMONIC_COUNT
+/**
+ * Runs the Goertzel filters over the samples of the window held by CalculateCurrentRMS, one filter per run,
+ * then calculates the harmonics (see CalculateHarmonics) and releases the window to the ADC interrupt.
+ * The ADC interrupt only stores the samples, so the filters do not add to the latency of the RX interrupts
+ * (see WIFI_RX_LATENCY).
+ * @return true
+ */
+bool TaskCalculateHarmonics(void)
+{
+	if(!_adc.isHarmonicsPending)
+		return true;
+
+	// The ADC interrupt leaves the held window and its samples untouched until it is released
+	AdcWindow* window = (AdcWindow*) &_adc.windows[_adc.active ^ 1];
+	if(_adc.harmonicFilter < window->harmonicCount)
+	{
+		const int* samples = (const int*) _adc.samples[_adc.active ^ 1];
+		long int coefficient = window->coefficients[_adc.harmonicFilter];
+		long int s1 = 0, s2 = 0;
+		unsigned char i;
+		for(i = 0; i < window->count; i++)
+		{
+			long int state = (samples[i] >> window->inputShift) + ((coefficient * s1) >> ADC_GOERTZEL_SHIFT) - s2;
+			s2 = s1;
+			s1 = state;
+		}
+		window->goertzel[_adc.harmonicFilter].s1 = s1;
+		window->goertzel[_adc.harmonicFilter].s2 = s2;
+		_adc.harmonicFilter++;
+		return true;
+	}
+
+	CalculateHarmonics(window);
+	_adc.harmonicFilter = 0;
+	_adc.isHarmonicsPending = false;
+	_adc.isReady = false;
+	return true;
+}
+
+/**
+ * Calculates the RMS of the fundamental and the odd harmonics, and the total harmonic distortion,
+ * from the Goertzel filters TaskCalculateHarmonics has run over a window.
+ * Each filter yields one term of the discrete Fourier transform of the window, and since a synchronized window
+ * holds whole mains cycles, the terms fall on the line frequency and its multiples.
+ * Only integer math is used: the filter states are scaled down to 14 bits before they are squared.
+ * @param window	Pointer to the window
+ */
+void CalculateHarmonics(const AdcWindow* window)
+{
+	if(!window->isSynchronized || window->harmonicCount == 0)
+		return;
+
+	unsigned long int harmonicSquares = 0;
+	unsigned char i;
+	for(i = 0; i < ADC_HARMONIC_COUNT; i++)
+	{
+		if(i >= window->harmonicCount)
+		{
+			_adc.harmonics[i] = 0;
+			continue;
+		}
+
+		long int s1 = window->goertzel[i].s1;
+		long int s2 = window->goertzel[i].s2;
+		unsigned char shift = 0;
+		while(labs(s1) >= 16384 || labs(s2) >= 16384)
+		{
+			s1 >>= 1;
+			s2 >>= 1;
+			shift++;
+		}
+
+		// Squared magnitude of the transform term: s1^2 + s2^2 - coefficient * s1 * s2
+		long int power = s1 * s1 + s2 * s2
+				- ((window->coefficients[i] * s1 + (1 << (ADC_GOERTZEL_SHIFT - 1))) >> ADC_GOERTZEL_SHIFT) * s2;
+		if(power < 0)
+			power = 0;
+
+		// Mean square of the harmonic (2 * power / count^2, 8 fractional bits), undoing the input shift as well
+		unsigned long int meanSquare = (((unsigned long int) power / window->count) << 8)
+				+ ((((unsigned long int) power % window->count) << 8) / window->count);
+		meanSquare = (meanSquare / window->count) << (2 * (shift + window->inputShift) + 1);
+		_adc.harmonics[i] = SquareRoot(meanSquare);
+		if(i)
+			harmonicSquares += meanSquare;
+	}
+
+	unsigned long int distortion = _adc.harmonics[0] ? (unsigned long int) SquareRoot(harmonicSquares) * 1000 / _adc.harmonics[0] : 0;
+	_adc.distortion = distortion < 65535 ? (unsigned int) distortion : 65535;
+}
+
+/**
+ * Calculates the Goertzel coefficients (2cos(w), where w is the angle a harmonic advances per sample)
+ * for the fundamental and the odd harmonics of the line frequency, and hands them to the ADC interrupt for the next window.
+ * Harmonics close to or above half the sample rate are left out: they cannot be told apart from lower frequencies,
+ * and the filter state (which grows with 1 / sin(w)) would overflow. The limit is 45% of the sample rate.
+ * The filter state also grows with the length of the window. For long windows at high sample rates,
+ * the samples are shifted right before they are filtered, so that the product of a coefficient and a state fits
+ * in 32 bits for any input the ADC can deliver (see TaskCalculateHarmonics).
+ * @param frequency	Line frequency in hundredths of a hertz
+ */
+void CalculateGoertzelCoefficients(unsigned int frequency)
+{
+	unsigned long int period = _adc.samplePeriod;
+	unsigned long int rate = CalculateSampleRate(period);
+	unsigned char count;
+	for(count = 0; count < ADC_HARMONIC_COUNT && 20UL * (2 * count + 1) * frequency < 9 * rate; count++)
+		;
+	if(count == 0)
+		return;
+
+	// Half the angle of the fundamental (pi * frequency / rate, 14 fractional bits), which is below pi / 2
+	long int angle = (long int) (((unsigned long int) frequency * 51472) / rate);
+
+	// Cosine of the half angle from its Taylor series, then cos(w) = 2cos^2(w / 2) - 1
+	long int square = (angle * angle) >> 14;
+	long int term = 16384;
+	long int cosine = 16384;
+	unsigned char i;
+	for(i = 2; i <= 10; i += 2)
+	{
+		term = -((term * square) >> 14) / (i * (i - 1));
+		cosine += term;
+	}
+	cosine = ((cosine * cosine) >> 13) - 16384;
+
+	// Samples expected in a window (a window which runs longer is not synchronized, and its filters are not used)
+	unsigned long int samples = (unsigned long int) _adc.sampling.windowCycles * rate / frequency + 2;
+	if(samples > _adc.sampling.windowSize)
+		samples = _adc.sampling.windowSize;
+
+	// cos(nw) = 2cos(w)cos((n - 1)w) - cos((n - 2)w) yields the cosines of the harmonics
+	int coefficients[ADC_HARMONIC_COUNT];
+	long int previous = 16384;
+	long int current = cosine;
+	unsigned char n = 1;
+	unsigned char shift = 0;
+	for(i = 0; i < count; i++)
+	{
+		while(n < 2 * i + 1)
+		{
+			long int next = ((cosine * current) >> 13) - previous;
+			previous = current;
+			current = next;
+			n++;
+		}
+		coefficients[i] = (int) ((current + (1 << (12 - ADC_GOERTZEL_SHIFT))) >> (13 - ADC_GOERTZEL_SHIFT));
+
+		// A sample lies at most 3070 steps from the bias (at 0V), which drives the state to about 2 / pi * 3070 * samples / sin(w),
+		// less than 2048 * samples / sin(w). The product with the coefficient then fits in 32 bits
+		// while |cos(w)| * samples <= 2^(19 - ADC_GOERTZEL_SHIFT) * sin(w); otherwise the samples are shifted right
+		unsigned long int sine = SquareRoot((1UL << 28) - (unsigned long int) (current * current));
+		while(((unsigned long int) labs(current) * samples >> shift) > sine << (19 - ADC_GOERTZEL_SHIFT))
+			shift++;
+	}
+
+	// The ADC interrupt copies the coefficients at the start of each window
+	// (they are discarded if the sample rate has changed in the meantime)
+	PIE1bits.ADIE = false;
+	if(period == _adc.samplePeriod)
+	{
+		for(i = 0; i < count; i++)
+			_adc.coefficients[i] = coefficients[i];
+		_adc.harmonicCount = count;
+		_adc.inputShift = shift;
+	}
+	PIE1bits.ADIE = true;
+}
+#endif
+
+/**
+ * Calculates the mean square of the AC component of a set of samples (the mean square less the square of the mean)
+ * @param sum			Sum of the samples
+ * @param sumSquares	Sum of the squares of the samples
+ * @param count			Number of samples
+ * @return				The mean square (steps squared, 8 fractional bits)
+ */
+unsigned long int CalculateMeanSquareAC(long int sum, unsigned long int sumSquares, unsigned char count)
+{
+	// The mean of raw samples (up to 4095 steps) squares to more than a signed long holds
+	unsigned long int mean = (unsigned long int) labs((sum * 16) / count);
+	unsigned long int meanSquare = ((sumSquares / count) << 8) + (((sumSquares % count) << 8) / count);
+	unsigned long int dc = mean * mean;
+	return meanSquare > dc ? meanSquare - dc : 0;
+}
+
+/**
+ * Calculates the square root of an integer (rounded to the nearest integer) without floating point math
+ * @param value	The value
+ * @return		The square root of the value
+ */
+unsigned int SquareRoot(unsigned long int value)
+{
+	unsigned long int root = 0;
+	unsigned long int bit = 0x40000000;
+	while(bit > value)
+		bit >>= 2;
+
+	while(bit)
+	{
+		if(value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+
+	// The remainder exceeds the root when the square root is closer to root + 1
+	if(value > root)
+		root++;
+	return (unsigned int) root;
+}
+
+// RELAY CONTROL FUNCTIONS-----------------------------------------------------
+
+/**
+ * Sets the relay to the specified state
+ * @param state <b>0</b> open the relay, <b>>0</b> to close the relay
+ */
+void RelayControl(unsigned char state)
+{
+	if(state)	// Close relay
+	{
+		RELAY_SET = 1;
+		LED = 1;
+	}
+	else		// Open relay
+	{
+		RELAY_RES = 1;
+		LED = 0;
+	}
+	_relayState = state;
+	ShellAddTask(TaskUpdateRelayStatus, 1, 0, 0, false, false, false, 0);
+	T0CONbits.TMR0ON = true;
 }
\ No newline at end of file
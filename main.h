@@ -1,201 +1,502 @@
-/**@file		main.h
- * @brief		Header file which defines the functionality of the RTOS and scheduler, as well as SmartModule-specific tasks
- * @author		Jonathan Ruisi
- * @version		1.0
- * @date		December 16, 2016
- * @copyright	GNU Public License
- */
-
-#ifndef MAIN_H
-#define MAIN_H
-
-#include "serial_comm.h"
-#include "linked_list.h"
-#include "utility.h"
-
-// DEFINITIONS (SHELL)---------------------------------------------------------
-#define SHELL_MAX_RESULT_VALUES					4		/**< The maximum number of parameters that can accompany a warning or error */
-#define SHELL_MAX_TASK_PARAMS					4		/**< The maximum number of parameters that can be passed to a task */
-#define SHELL_MAX_TASKS							16		/**< The maximum number of tasks that can run at a given time */
-#define SHELL_RESET_DELAY						3000	/**< Amount of time (in milliseconds) after startup before the scheduler is started */
-// Warnings
-#define SHELL_WARNING_DATA_TRUNCATED			1
-#define SHELL_WARNING_FIFO_BUFFER_OVERWRITE		2
-// Errors
-#define SHELL_ERROR_SRAM_BUSY					1
-#define SHELL_ERROR_ZERO_LENGTH					2
-#define SHELL_ERROR_ADDRESS_RANGE				3
-#define SHELL_ERROR_LINE_QUEUE_EMPTY			4
-#define SHELL_ERROR_COMMAND_NOT_RECOGNIZED		5
-#define SHELL_ERROR_TASK_TIMEOUT				6
-#define SHELL_ERROR_NULL_REFERENCE				7
-#define SHELL_ERROR_WIFI_COMMAND				8
-
-// DEFINITIONS (MEASUREMENT)---------------------------------------------------
-#define ADC_DC_OFFSET		3103	//*< ((x steps/4096) * 3.3V = offset in volts) */
-#define ADC_WINDOW_SIZE		128		//*< ADC sample window size */
-#define TIMER0_START_VALUE	0xDB60	//*< 100ms (Higher values = SHORTER timer period) */
-
-// DEFINITIONS (OTHER)---------------------------------------------------------
-#define FIRMWARE_VERSION	1.00	//*< Current firmware version */
-
-// MACROS----------------------------------------------------------------------
-/**@def CURRENT_TASK
- * Shortcut for accessing information about the currently running task
- */
-#define CURRENT_TASK ((Task*) _shell.task.current->data)
-
-// TYPE DEFINITIONS------------------------------------------------------------
-
-/**@struct Task
- * Structure which defines a task
- */
-typedef struct Task
-{
-	B_Action action;					/**< Pointer to the task's function */
-	void* params[4];					/**< Array of pointers to parameters to be passed to the function */
-	unsigned int runsRemaining;			/**< Number of remaining runs */
-	unsigned long int lastRun;			/**< Timestamp indicating when the task last executed */
-	unsigned long int runInterval;		/**< Interval (in ticks) at which the task executes */
-	unsigned long int timeout;			/**< Defines the period at which the task is considered to have timed out */
-
-	union
-	{
-
-		struct
-		{
-			unsigned modeExclusive : 1;	/**< Task is given exclusive priority */
-			unsigned modeInfinite : 1;	/**< Task will run indefinitely */
-			unsigned modePeriodic : 1;	/**< Task runs periodically */
-			unsigned busy : 1;			/**< Task is busy */
-			unsigned : 4;
-		} statusBits;
-		unsigned char status;
-	} ;
-} Task;
-
-/**@struct Shell
- * Structure containing all necessary means of controlling the RTOS
- */
-typedef struct Shell
-{
-
-	struct
-	{
-		unsigned char lastWarning;	/**< The most recent warning to occur */
-		unsigned char lastError;	/**< The most recent error to occur */
-		unsigned long int values[SHELL_MAX_RESULT_VALUES];	/**< Relevant information relating to the error or warning */
-	} result;
-
-	struct
-	{
-		LinkedList_16Element list;	/**< Task list */
-		LinkedListNode* current;	/**< Current task */
-	} task;
-
-	CommPort* server;				/**< Pointer to a <b>CommPort</b> which serves as the TCP host */
-	CommPort* terminal;				/**< Pointer to a <b>CommPort</b> which serves as the debug terminal */
-	Buffer swapBuffer;				/**< All data in and out of the shell passes through this buffer */
-} Shell;
-
-typedef struct AdcRmsInfo
-{
-	RingBuffer samples;
-	unsigned char pinFloatAnimation;
-} AdcRmsInfo;
-
-typedef struct ProxDetectInfo
-{
-	bool isTripped;
-	unsigned int count;
-	unsigned long int lastTripped;
-} ProxDetectInfo;
-
-// CONSTANTS-------------------------------------------------------------------
-static const char* _id	= "SM000001";
-const struct Point COORD_LABEL_UPTIME		= {52, 1};
-const struct Point COORD_LABEL_NAME			= {20, 1};
-const struct Point COORD_LABEL_STATUS		= {37, 1};
-const struct Point COORD_LABEL_SSID			= {14, 2};
-const struct Point COORD_LABEL_HOST			= {14, 3};
-const struct Point COORD_LABEL_RELAY		= {14, 5};
-const struct Point COORD_LABEL_PROX			= {15, 6};
-const struct Point COORD_LABEL_TEMP			= {32, 6};
-const struct Point COORD_LABEL_LOAD			= {32, 5};
-const struct Point COORD_LABEL_COMM1A		= {1, 9};
-const struct Point COORD_LABEL_COMM1B		= {6, 10};
-const struct Point COORD_LABEL_COMM1C		= {6, 11};
-const struct Point COORD_LABEL_COMM1D		= {6, 12};
-const struct Point COORD_LABEL_COMM2A		= {1, 15};
-const struct Point COORD_LABEL_COMM2B		= {6, 16};
-const struct Point COORD_LABEL_COMM2C		= {6, 17};
-const struct Point COORD_LABEL_COMM2D		= {6, 18};
-const struct Point COORD_LABEL_CMD			= {1, 20};
-const struct Point COORD_VALUE_UPTIME		= {52, 2};
-const struct Point COORD_VALUE_DATE			= {0, 5};
-const struct Point COORD_VALUE_TIME			= {5, 6};
-const struct Point COORD_VALUE_SSID_NAME	= {20, 2};
-const struct Point COORD_VALUE_SSID_STATUS	= {37, 2};
-const struct Point COORD_VALUE_HOST_NAME	= {20, 3};
-const struct Point COORD_VALUE_HOST_STATUS	= {37, 3};
-const struct Point COORD_VALUE_RELAY		= {21, 5};
-const struct Point COORD_VALUE_PROX			= {21, 6};
-const struct Point COORD_VALUE_TEMP			= {38, 6};
-const struct Point COORD_VALUE_LOAD			= {38, 5};
-const struct Point COORD_VALUE_ERROR		= {1, 32};
-const struct Point COORD_VALUE_COMM1A		= {8, 9};
-const struct Point COORD_VALUE_COMM1B		= {8, 10};
-const struct Point COORD_VALUE_COMM1C		= {8, 11};
-const struct Point COORD_VALUE_COMM1D		= {8, 12};
-const struct Point COORD_VALUE_COMM2A		= {8, 15};
-const struct Point COORD_VALUE_COMM2B		= {8, 16};
-const struct Point COORD_VALUE_COMM2C		= {8, 17};
-const struct Point COORD_VALUE_COMM2D		= {8, 18};
-const struct Point COORD_VALUE_CMD			= {6, 20};
-
-// GLOBAL VARIABLES------------------------------------------------------------
-extern volatile unsigned long int _tick;
-extern volatile struct ButtonInfo _button;
-extern struct CommPort _comm1, _comm2;
-extern const struct CommDataRegisters _comm1Regs, _comm2Regs;
-extern Shell _shell;
-extern struct AdcRmsInfo _adc;
-extern struct ProxDetectInfo _prox;
-extern unsigned char _relayState;
-
-// FUNCTION PROTOTYPES---------------------------------------------------------
-// Shell Management
-void UpdateShell(void);
-void ShellInitialize(CommPort* serverComm, CommPort* terminalComm,
-					 unsigned int swapBufferSize, char* swapBufferData);
-void ShellParseCommandLine(Buffer* buffer);
-void ShellHandleSequence(CommPort* comm);
-void ShellPrintBasicLayout(void);
-void ShellPrintLastWarning(unsigned char row, unsigned char col);
-void ShellPrintLastError(unsigned char row, unsigned char col);
-// Task Management
-void TaskScheduler(void);
-LinkedListNode* ShellAddTask(B_Action action,
-							 unsigned int runCount, unsigned long int runInterval, unsigned long int timeout,
-							 bool isExclusive, bool isInfinite, bool isPeriodic,
-							 unsigned char paramCount, ...);
-// Tasks
-bool TaskPrintTick(void);
-bool TaskPrintDateTime(void);
-bool TaskCalculateRMSCurrent(void);
-bool TaskUpdateRelayStatus(void);
-bool TaskUpdateProximityStatus(void);
-bool TaskPrintTemp(void);
-bool TaskConnectNetwork(void);
-bool TaskConnectTcp(void);
-// Button Actions
-void ButtonPress(void);
-void ButtonHold(void);
-void ButtonRelease(void);
-// Load Measurement
-void InitializeLoadMeasurement(void);
-double CalculateCurrentRMS(void);
-// Relay Control
-void RelayControl(unsigned char state);
-
+/**@file		main.h
+ * @brief		Header file which defines the functionality of the RTOS and scheduler, as well as SmartModule-specific tasks
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		December 16, 2016
+ * @copyright	GNU Public License
+ */
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#include "serial_comm.h"
+#include "linked_list.h"
+#include "screen.h"
+#include "telemetry.h"
+#include "energy.h"
+#include "utility.h"
+
+// DEFINITIONS (SHELL)---------------------------------------------------------
+#define SHELL_MAX_RESULT_VALUES					4		/**< The maximum number of parameters that can accompany a warning or error */
+#define SHELL_MAX_TASK_PARAMS					4		/**< The maximum number of parameters that can be passed to a task */
+#define SHELL_MAX_TASKS							16		/**< The maximum number of tasks that can run at a given time */
+#define SHELL_RESET_DELAY						3000	/**< Amount of time (in milliseconds) after startup before the scheduler is started */
+#define SHELL_TASK_MAX_RESTARTS					3		/**< The number of times an overrunning task is restarted before it is aborted */
+#ifndef SHELL_TASK_STATISTICS
+#define SHELL_TASK_STATISTICS					0		/**< Set to 1 to collect per-task start-time jitter histograms (#stats prints them) */
+#endif
+#define SHELL_JITTER_BUCKETS					8		/**< Number of histogram buckets: 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+ ms */
+#define SHELL_DASHBOARD							1		/**< Set to 0 to compile out the ANSI dashboard (the device then always runs headless) */
+#define SHELL_TELEMETRY_INTERVAL				1000	/**< Interval (in milliseconds) at which status frames are sent in headless mode */
+// Task supervision policies
+#define TASK_POLICY_ABORT						0		/**< An overrunning task is removed from the task list (a critical task resets the device instead) */
+#define TASK_POLICY_RESTART						1		/**< An overrunning task is restarted (up to SHELL_TASK_MAX_RESTARTS times, then handled as TASK_POLICY_ABORT) */
+#define TASK_POLICY_RESET						2		/**< An overrunning task stops the hardware watchdog from being cleared, resetting the device */
+// Warnings
+#define SHELL_WARNING_DATA_TRUNCATED			1
+#define SHELL_WARNING_FIFO_BUFFER_OVERWRITE		2
+#define SHELL_WARNING_WATCHDOG_RESET			3
+#define SHELL_WARNING_ADC_OVERRUN				4
+// Errors
+#define SHELL_ERROR_SRAM_BUSY					1
+#define SHELL_ERROR_ZERO_LENGTH					2
+#define SHELL_ERROR_ADDRESS_RANGE				3
+#define SHELL_ERROR_LINE_QUEUE_EMPTY			4
+#define SHELL_ERROR_COMMAND_NOT_RECOGNIZED		5
+#define SHELL_ERROR_TASK_TIMEOUT				6
+#define SHELL_ERROR_NULL_REFERENCE				7
+#define SHELL_ERROR_WIFI_COMMAND				8
+#define SHELL_ERROR_WIFI_TIMEOUT				9
+#define SHELL_ERROR_INVALID_SAMPLING			10
+#define SHELL_ERROR_INVALID_CAPTURE				11
+
+// DEFINITIONS (SCREEN)--------------------------------------------------------
+// Dashboard fields (indices into the screen model, ordered by row and column)
+#define FIELD_SSID_STATUS	0
+#define FIELD_UPTIME		1
+#define FIELD_HOST_STATUS	2
+#define FIELD_DATE			3
+#define FIELD_RELAY			4
+#define FIELD_LOAD			5
+#define FIELD_TIME			6
+#define FIELD_PROX			7
+#define FIELD_TEMP			8
+#define FIELD_COMM1A		9
+#define FIELD_COMM1B		10
+#define FIELD_CMD			11
+#define FIELD_COUNT			12
+#define FIELD_PANE_WIDTH	40		/**< Width of the COMM1 and CMD panes */
+
+// DEFINITIONS (MEASUREMENT)---------------------------------------------------
+#define ADC_DC_OFFSET		3070	//*< Nominal zero-current output of the current sensor (2.474V = 3070 steps of 3.3V/4095), where the DC tracker starts */
+#define ADC_DC_TRACK_SHIFT	4		//*< Weight of each window mean in the DC tracker (1/2^n, a time constant of 16 windows) */
+#define ADC_WINDOW_SIZE		160		//*< Default maximum ADC sample window size (used when the input has no zero crossings, e.g. at no load) */
+#define ADC_WINDOW_CYCLES	12		//*< Default number of mains cycles in a sample window (200ms at 60Hz, 240ms at 50Hz) */
+#define ADC_ZC_HYSTERESIS	8		//*< Distance (steps) below zero the input must fall before the next rising zero crossing is detected */
+#define ADC_CYCLE_CLOCK		1200000000UL	//*< Instruction clock (FCY) from which TMR6 is clocked (hundredths of a hertz) */
+#define ADC_TIMER_PRESCALE	16		//*< Default TMR6 prescale (as set by ConfigureTimers) */
+#define ADC_TIMER_POSTSCALE	5		//*< Default TMR6 postscale (as set by ConfigureTimers) */
+#define ADC_MIN_SAMPLE_RATE	24000	//*< Lowest rate (hundredths of a hertz) at which the current sensor may be sampled (4 samples per cycle at 60Hz) */
+#define ADC_MAX_SAMPLE_RATE	120000	//*< Highest rate (hundredths of a hertz) at which the current sensor may be sampled (limited by the ADC interrupt and the Goertzel filter state) */
+#define ADC_ENERGY_TICKS	(ADC_CYCLE_CLOCK / 100 / ENERGY_TIME_BASE)	//*< Instruction cycles per period of ENERGY_TIME_BASE */
+#define ADC_TRACK_LINE		0		//*< Set to 1 to trim PR6 so that a whole number of samples fits in a mains cycle (best for sinusoidal loads: harmonics of distorted loads then alias onto fixed phases) */
+#define ADC_FREQUENCY_DEADBAND	5	//*< Change (hundredths of a hertz) in line frequency at which a new reading is queued for the uplink */
+#define ADC_SCAN_COUNT		1		//*< Number of analog inputs converted in turn (1 - 3): the current sensor (AN0), then ADC_SCAN_CHANNEL1 and ADC_SCAN_CHANNEL2 */
+#define ADC_SCAN_CHANNEL1	2		//*< Second scanned input (AN2 = ANALOG2; AN1 is the proximity detector input) */
+#define ADC_SCAN_CHANNEL2	3		//*< Third scanned input (AN3 = ANALOG3) */
+#define ADC_TIMER_PERIOD	(251 / ADC_SCAN_COUNT - 1)	//*< Default TMR6 period (PR6), so that every scanned input is sampled at about 600Hz */
+#define ADC_HARMONIC_COUNT	3		//*< Number of Goertzel filters (0 - 4) run on the current sensor: the fundamental, then the 3rd, 5th, and 7th harmonic (harmonics above 45% of the sample rate are skipped) */
+#define ADC_HARMONIC_SAMPLES	ADC_WINDOW_SIZE	//*< Samples of each window stored for the Goertzel filters (a window which runs longer is not analyzed) */
+#define ADC_GOERTZEL_SHIFT	10		//*< Fractional bits of the Goertzel coefficients (2cos(w), so the filter state times the coefficient fits in 32 bits) */
+#define ADC_DISTORTION_DEADBAND	10	//*< Change (tenths of a percent) in total harmonic distortion at which new readings are queued for the uplink */
+#define ADC_CAPTURE_SIZE	128		//*< Number of current sensor samples in a transient capture (a power of 2 from 16 to 128, 0 compiles the transient recorder out) */
+#define ADC_CAPTURE_PRE_TRIGGER	32	//*< Number of samples in a capture before the trigger sample */
+#define ADC_CAPTURE_HIGH	1000	//*< Default upper trigger threshold (steps above the DC offset, about 20A) */
+#define ADC_CAPTURE_LOW		-1000	//*< Default lower trigger threshold (steps below the DC offset) */
+#define ADC_CAPTURE_HOLDOFF	5000	//*< Time (in milliseconds) from a trigger until the transient recorder is armed again */
+// Transient recorder states (see AdcCapture)
+#define ADC_CAPTURE_FILLING		0	//*< Recording the pre-trigger history */
+#define ADC_CAPTURE_ARMED		1	//*< Recording, and comparing each sample against the thresholds */
+#define ADC_CAPTURE_TRIGGERED	2	//*< Recording the samples after the trigger */
+#define ADC_CAPTURE_DONE		3	//*< The capture is complete (waiting to be stored in SRAM) */
+#define ADC_CAPTURE_STORED		4	//*< The capture has been stored in SRAM (waiting for ADC_CAPTURE_HOLDOFF) */
+#define ENERGY_CHECKPOINT_INTERVAL	60000	//*< Interval (in milliseconds) at which the energy meter is saved to SRAM and its totals are queued for the uplink */
+#define ADC_SLIDING_RMS		0		//*< Set to 1 to report the RMS of the last ADC_SLIDING_WINDOWS windows (still updated after every window) */
+#define ADC_SLIDING_WINDOWS	4		//*< Number of windows covered by the sliding RMS */
+#define ADC_FLOAT_OFFSET	248		//*< Distance (steps) of the window mean from ADC_DC_OFFSET at which the input is considered to be floating (0.2V) */
+#define ADC_VREF			3300	//*< ADC reference voltage (mV) */
+#define ADC_SENSITIVITY		40		//*< Current sensor output (mV per amp) */
+#define ADC_LINE_VOLTAGE	120		//*< Line voltage (V) at which the load is calculated */
+#define ADC_LOAD_SCALE		((ADC_VREF * ADC_LINE_VOLTAGE * 2560UL + (4095UL * ADC_SENSITIVITY) / 2) \
+							/ (4095UL * ADC_SENSITIVITY))	//*< Load (tenths of a watt) per 1/16 RMS step, in 1/4096 units (6189) */
+#define TIMER0_START_VALUE	0xDB60	//*< 100ms (Higher values = SHORTER timer period) */
+
+// DEFINITIONS (OTHER)---------------------------------------------------------
+#define FIRMWARE_VERSION	1.00	//*< Current firmware version */
+
+// MACROS----------------------------------------------------------------------
+/**@def CURRENT_TASK
+ * Shortcut for accessing information about the currently running task
+ */
+#define CURRENT_TASK ((Task*) _shell.task.current->data)
+
+#if !SHELL_DASHBOARD
+/**@def ScreenWrite
+ * Without the dashboard, writes to the screen model are discarded
+ */
+#define ScreenWrite(screen, field, str)
+#endif
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct Task
+ * Structure which defines a task
+ */
+typedef struct Task
+{
+	B_Action action;					/**< Pointer to the task's function */
+	void* params[4];					/**< Array of pointers to parameters to be passed to the function */
+	unsigned int runsRemaining;			/**< Number of remaining runs */
+	unsigned long int lastRun;			/**< Timestamp indicating when the task last executed */
+	unsigned long int runInterval;		/**< Interval (in ticks) at which the task executes */
+	unsigned long int timeout;			/**< Heartbeat budget: the period a busy task may go without checking in before it is considered to have timed out */
+	unsigned long int lastCheckIn;		/**< Timestamp indicating when the task last checked in */
+	unsigned char restarts;				/**< Number of times the task has been restarted since it last completed */
+
+	union
+	{
+
+		struct
+		{
+			unsigned modeExclusive : 1;	/**< Task is given exclusive priority */
+			unsigned modeInfinite : 1;	/**< Task will run indefinitely */
+			unsigned modePeriodic : 1;	/**< Task runs periodically */
+			unsigned busy : 1;			/**< Task is busy */
+			unsigned modeCritical : 1;	/**< Task must check in before the hardware watchdog is cleared */
+			unsigned policy : 2;		/**< Action taken when the task overruns its heartbeat budget */
+			unsigned : 1;
+		} statusBits;
+		unsigned char status;
+	} ;
+} Task;
+
+/**@struct Shell
+ * Structure containing all necessary means of controlling the RTOS
+ */
+typedef struct Shell
+{
+
+	struct
+	{
+		unsigned char lastWarning;	/**< The most recent warning to occur */
+		unsigned char lastError;	/**< The most recent error to occur */
+		unsigned long int values[SHELL_MAX_RESULT_VALUES];	/**< Relevant information relating to the error or warning */
+	} result;
+
+	struct
+	{
+		LinkedList_16Element list;	/**< Task list */
+		LinkedListNode* current;	/**< Current task */
+	} task;
+
+	struct
+	{
+		unsigned int critical;		/**< Bitmap of critical tasks (indexed by task list memory index) */
+		unsigned int checkIns;		/**< Bitmap of tasks which have checked in since the watchdog was last cleared */
+		bool isResetPending;		/**< Set when a task has requested a device reset (the watchdog is no longer cleared) */
+	} watchdog;
+
+	CommPort* server;				/**< Pointer to a <b>CommPort</b> which serves as the TCP host */
+	CommPort* terminal;				/**< Pointer to a <b>CommPort</b> which serves as the debug terminal */
+	bool isHeadless;				/**< Binary status frames are sent to the terminal instead of the ANSI dashboard */
+	Buffer swapBuffer;				/**< All data in and out of the shell passes through this buffer */
+} Shell;
+
+/**@struct TaskStatistics
+ * Scheduler statistics for one task list entry.
+ * Start-time jitter is the delay between the time a task was due (its last run plus its run interval,
+ * or the time it was added for its first run) and the time the scheduler actually started it.
+ */
+typedef struct TaskStatistics
+{
+	unsigned long int queuedAt;						/**< Timestamp indicating when the task was added */
+	unsigned int runs;								/**< Number of recorded starts */
+	unsigned int maxJitter;							/**< Largest recorded start-time jitter (in ticks) */
+	unsigned int histogram[SHELL_JITTER_BUCKETS];	/**< Start-time jitter histogram (log2 buckets) */
+} TaskStatistics;
+
+/**@struct AdcCrossing
+ * The two samples on either side of a rising zero crossing (relative to the DC offset of the window)
+ */
+typedef struct AdcCrossing
+{
+	int before;						/**< Last sample below zero */
+	int after;						/**< First sample at or above zero (the first sample of the next window) */
+} AdcCrossing;
+
+/**@struct AdcChannelSums
+ * Sums accumulated for one of the other scanned inputs (raw samples)
+ */
+typedef struct AdcChannelSums
+{
+	long int sum;					/**< Sum of the samples */
+	unsigned long int sumSquares;	/**< Sum of the squares of the samples */
+} AdcChannelSums;
+
+/**@struct AdcGoertzel
+ * State of a Goertzel filter (the two most recent outputs)
+ */
+typedef struct AdcGoertzel
+{
+	long int s1;					/**< Most recent output */
+	long int s2;					/**< Output before s1 */
+} AdcGoertzel;
+
+/**@struct AdcSampling
+ * Sampling configuration (see ConfigureSampling)
+ */
+typedef struct AdcSampling
+{
+	unsigned char prescale;			/**< TMR6 clock prescale (1, 4, or 16) */
+	unsigned char postscale;		/**< TMR6 output postscale (1 - 16) */
+	unsigned char period;			/**< TMR6 period (PR6): each input is sampled every prescale * postscale * (period + 1) * ADC_SCAN_COUNT instruction cycles */
+	unsigned char windowCycles;		/**< Number of mains cycles in a sample window */
+	unsigned char windowSize;		/**< Maximum number of samples in a window */
+} AdcSampling;
+
+#if ADC_CAPTURE_SIZE
+/**@struct AdcCapture
+ * Transient recorder. The ADC interrupt keeps the most recent current sensor samples in a ring,
+ * and stops once a sample outside the thresholds has been followed by the rest of the capture (see TaskStoreCapture).
+ */
+typedef struct AdcCapture
+{
+	int samples[ADC_CAPTURE_SIZE];	/**< Ring of samples (relative to the DC offset of their window) */
+	unsigned char index;			/**< Number of samples recorded (wraps, the next sample is stored at index & (ADC_CAPTURE_SIZE - 1)) */
+	unsigned char remaining;		/**< Samples until the pre-trigger history is full, or until the capture is complete */
+	unsigned char state;			/**< Recorder state (ADC_CAPTURE_FILLING, ADC_CAPTURE_ARMED, ...) */
+	int high;						/**< Upper trigger threshold (steps relative to the DC offset) */
+	int low;						/**< Lower trigger threshold (steps relative to the DC offset) */
+	unsigned long int time;			/**< System time of the trigger (milliseconds) */
+	unsigned int sequence;			/**< Number of captures stored in SRAM */
+	int peak;						/**< Sample of the largest magnitude in the stored capture */
+	unsigned long int period;		/**< Time between two samples of the stored capture (instruction cycles) */
+} AdcCapture;
+#endif
+
+/**@struct AdcWindow
+ * Sums accumulated by the ADC interrupt over one sample window.
+ * A window runs from one rising zero crossing of the input to another, AdcSampling.windowCycles mains cycles later,
+ * so that no partial cycles are included at its edges.
+ */
+typedef struct AdcWindow
+{
+	long int sum;					/**< Sum of the samples (relative to offset) */
+	unsigned long int sumSquares;	/**< Sum of the squares of the samples (relative to offset) */
+	unsigned char count;			/**< Number of samples accumulated (the window is cut off at AdcSampling.windowSize) */
+	unsigned char cycles;			/**< Number of rising zero crossings in the window */
+	bool isSynchronized;			/**< The window starts and ends at a zero crossing (it covers exactly <code>cycles</code> mains cycles) */
+	AdcCrossing start;				/**< Zero crossing at which the window starts */
+	AdcCrossing end;				/**< Zero crossing at which the window ends */
+	int offset;						/**< DC offset (steps) subtracted from the samples of this window */
+	unsigned long int period;		/**< Time between two samples of this window (instruction cycles) */
+#if ADC_SCAN_COUNT > 1
+	AdcChannelSums channels[ADC_SCAN_COUNT - 1];	/**< Sums of the other scanned inputs over the same samples */
+#endif
+#if ADC_HARMONIC_COUNT
+	unsigned char harmonicCount;	/**< Number of Goertzel filters run over this window (harmonics below half the sample rate) */
+	int coefficients[ADC_HARMONIC_COUNT];		/**< Goertzel coefficients used for this window (ADC_GOERTZEL_SHIFT fractional bits) */
+	AdcGoertzel goertzel[ADC_HARMONIC_COUNT];	/**< Goertzel filter states (see TaskCalculateHarmonics) */
+	unsigned char inputShift;		/**< Right shift of the samples fed to the Goertzel filters (see CalculateGoertzelCoefficients) */
+#endif
+} AdcWindow;
+
+typedef struct AdcRmsInfo
+{
+	volatile AdcWindow windows[2];			/**< Sample windows (the ADC interrupt fills one while the other is processed) */
+	volatile unsigned char active;			/**< Index of the window being filled by the ADC interrupt */
+	volatile bool isReady;					/**< The other window is complete and waiting to be processed */
+	volatile unsigned char overruns;		/**< Number of windows discarded because the previous window had not been processed yet (wraps at 255) */
+	unsigned char reportedOverruns;			/**< Value of overruns when the last warning was raised */
+	volatile bool isArmed;					/**< The input has fallen below -ADC_ZC_HYSTERESIS since the last rising zero crossing */
+	volatile int previous;					/**< Previous sample (relative to the DC offset of its window) */
+	volatile int dcOffset;					/**< DC offset (steps) applied from the next window on */
+	long int dcLevel;						/**< Tracked DC level of the input (steps, 8 fractional bits) */
+	unsigned int frequency;					/**< Most recent line frequency (hundredths of a hertz, 0 if unknown) */
+	unsigned int reportedFrequency;			/**< Line frequency most recently queued for the uplink */
+	unsigned int duration;					/**< Length of the most recent window (periods of ENERGY_TIME_BASE) */
+	unsigned long int durationResidue;		/**< Length of the windows not yet passed on in duration (instruction cycles) */
+	volatile AdcSampling sampling;			/**< Sampling configuration in effect */
+	volatile unsigned long int samplePeriod;	/**< Time between two samples of the current sensor (instruction cycles) */
+	AdcSampling pending;					/**< Sampling configuration to be applied by the ADC interrupt at the start of the next window */
+	unsigned long int pendingPeriod;		/**< samplePeriod of the pending configuration */
+	volatile bool isPending;				/**< A sampling configuration is waiting to be applied */
+	unsigned long int reportedSamplePeriod;	/**< Value of samplePeriod when the sample rate was last queued for the uplink */
+	volatile unsigned char channel;			/**< Index of the scanned input being converted (0 = current sensor) */
+#if ADC_SCAN_COUNT > 1
+	unsigned int channelMean[ADC_SCAN_COUNT - 1];	/**< Mean of each of the other scanned inputs (steps, 4 fractional bits) */
+	unsigned int channelRms[ADC_SCAN_COUNT - 1];	/**< RMS of the AC component of each of the other scanned inputs (steps, 4 fractional bits) */
+#endif
+#if ADC_HARMONIC_COUNT
+	volatile unsigned char harmonicCount;	/**< Number of Goertzel filters applied from the next window on (0 until the line frequency is known) */
+	volatile int coefficients[ADC_HARMONIC_COUNT];	/**< Goertzel coefficients applied from the next window on */
+	volatile unsigned char inputShift;		/**< Right shift of the samples fed to the Goertzel filters from the next window on */
+	volatile int samples[2][ADC_HARMONIC_SAMPLES];	/**< Current sensor samples of each window (relative to its offset), stored by the ADC interrupt */
+	volatile bool isHarmonicsPending;		/**< The ready window is held until TaskCalculateHarmonics has run its filters */
+	unsigned char harmonicFilter;			/**< Next filter run by TaskCalculateHarmonics */
+	unsigned int harmonics[ADC_HARMONIC_COUNT];		/**< RMS of the fundamental and each odd harmonic (steps, 4 fractional bits) */
+	unsigned int distortion;				/**< Total harmonic distortion of the analyzed harmonics (tenths of a percent) */
+	unsigned int reportedDistortion;		/**< Total harmonic distortion most recently queued for the uplink */
+#endif
+#if ADC_CAPTURE_SIZE
+	volatile AdcCapture capture;			/**< Transient recorder */
+#endif
+#if ADC_TRACK_LINE
+	unsigned int trackedFrequency;			/**< Averaged line frequency (hundredths of a hertz) to which PR6 is trimmed */
+#endif
+#if ADC_SLIDING_RMS
+	unsigned long int history[ADC_SLIDING_WINDOWS];	/**< Mean square (AC component, 8 fractional bits) of the most recent windows */
+	unsigned char historyIndex;				/**< Index at which the next mean square is stored */
+	unsigned char historyCount;				/**< Number of valid entries in history */
+#endif
+	unsigned char pinFloatAnimation;
+	unsigned int load;				/**< Most recent RMS load (tenths of a watt) */
+} AdcRmsInfo;
+
+typedef struct ProxDetectInfo
+{
+	bool isTripped;
+	unsigned int count;
+	unsigned long int lastTripped;
+} ProxDetectInfo;
+
+// CONSTANTS-------------------------------------------------------------------
+static const char* _id	= "SM000001";
+
+/**@def LAYOUT_POINTS(POINT)
+ * List of all fixed terminal layout points as POINT(name, column, row).
+ * Each point is expanded into a <b>Point</b> (COORD_name) and two pre-rendered sequences stored in program memory:
+ * a cursor position (CPOS_name) and a cursor position followed by an erase line (CLEAR_name).
+ */
+#define LAYOUT_POINTS(POINT) \
+	POINT(LABEL_UPTIME, 52, 1) \
+	POINT(LABEL_NAME, 20, 1) \
+	POINT(LABEL_STATUS, 37, 1) \
+	POINT(LABEL_SSID, 14, 2) \
+	POINT(LABEL_HOST, 14, 3) \
+	POINT(LABEL_RELAY, 14, 5) \
+	POINT(LABEL_PROX, 15, 6) \
+	POINT(LABEL_TEMP, 32, 6) \
+	POINT(LABEL_LOAD, 32, 5) \
+	POINT(LABEL_COMM1A, 1, 9) \
+	POINT(LABEL_COMM1B, 6, 10) \
+	POINT(LABEL_COMM1C, 6, 11) \
+	POINT(LABEL_COMM1D, 6, 12) \
+	POINT(LABEL_COMM2A, 1, 15) \
+	POINT(LABEL_COMM2B, 6, 16) \
+	POINT(LABEL_COMM2C, 6, 17) \
+	POINT(LABEL_COMM2D, 6, 18) \
+	POINT(LABEL_CMD, 1, 20) \
+	POINT(VALUE_UPTIME, 52, 2) \
+	POINT(VALUE_DATE, 0, 5) \
+	POINT(VALUE_TIME, 5, 6) \
+	POINT(VALUE_SSID_NAME, 20, 2) \
+	POINT(VALUE_SSID_STATUS, 37, 2) \
+	POINT(VALUE_HOST_NAME, 20, 3) \
+	POINT(VALUE_HOST_STATUS, 37, 3) \
+	POINT(VALUE_RELAY, 21, 5) \
+	POINT(VALUE_PROX, 21, 6) \
+	POINT(VALUE_TEMP, 38, 6) \
+	POINT(VALUE_LOAD, 38, 5) \
+	POINT(VALUE_ERROR, 1, 32) \
+	POINT(VALUE_COMM1A, 8, 9) \
+	POINT(VALUE_COMM1B, 8, 10) \
+	POINT(VALUE_COMM1C, 8, 11) \
+	POINT(VALUE_COMM1D, 8, 12) \
+	POINT(VALUE_COMM2A, 8, 15) \
+	POINT(VALUE_COMM2B, 8, 16) \
+	POINT(VALUE_COMM2C, 8, 17) \
+	POINT(VALUE_COMM2D, 8, 18) \
+	POINT(VALUE_CMD, 6, 20)
+
+#define LAYOUT_CLEAR_MAX_LENGTH		11	/**< Length of the longest CLEAR_name sequence (ESC[rr;ccH ESC[K) */
+#define LAYOUT_SEQUENCE_CPOS(x, y)	"\033[" #y ";" #x "H"
+#define LAYOUT_SEQUENCE_CLEAR(x, y)	"\033[" #y ";" #x "H\033[K"
+#define LAYOUT_COORD(name, x, y)	const struct Point COORD_##name = {x, y};
+#define LAYOUT_CPOS(name, x, y)		const StoredSequence CPOS_##name = {LAYOUT_SEQUENCE_CPOS(x, y), sizeof(LAYOUT_SEQUENCE_CPOS(x, y)) - 1};
+#define LAYOUT_CLEAR(name, x, y)	const StoredSequence CLEAR_##name = {LAYOUT_SEQUENCE_CLEAR(x, y), sizeof(LAYOUT_SEQUENCE_CLEAR(x, y)) - 1};
+#define LAYOUT_EXTERN(name, x, y)	extern const struct Point COORD_##name; extern const StoredSequence CPOS_##name, CLEAR_##name;
+
+// The points and sequences are defined once, in main.c
+LAYOUT_POINTS(LAYOUT_EXTERN)
+
+// GLOBAL VARIABLES------------------------------------------------------------
+extern volatile unsigned long int _tick;
+extern volatile struct ButtonInfo _button;
+extern struct CommPort _comm1, _comm2;
+extern const struct CommDataRegisters _comm1Regs, _comm2Regs;
+extern struct PayloadQueue _comm1Payloads;
+extern Shell _shell;
+extern Screen _screen;
+extern struct AdcRmsInfo _adc;
+extern struct ProxDetectInfo _prox;
+extern unsigned char _relayState;
+extern EnergyMeter _energy;
+#if ADC_SCAN_COUNT > 1
+extern const unsigned char _adcChannels[];
+#endif
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+// Shell Management
+void UpdateShell(void);
+void ShellInitialize(CommPort* serverComm, CommPort* terminalComm,
+					 unsigned int swapBufferSize, char* swapBufferData);
+void ShellParseCommandLine(Buffer* buffer);
+void ShellHandleSequence(CommPort* comm);
+void ShellHandlePayload(const FileDescriptor* file);
+bool ShellQueueReading(uint8_t tag, int32_t value, bool isUrgent);
+bool ShellQueueReadings(const TelemetryReading* readings, uint8_t count, bool isUrgent);
+bool ShellPutLabel(const StoredSequence* position, const char* label, const char* value);
+void ShellPrintLastWarning(unsigned char row, unsigned char col);
+void ShellPrintLastError(unsigned char row, unsigned char col);
+// Task Management
+void TaskScheduler(void);
+LinkedListNode* ShellAddTask(B_Action action,
+							 unsigned int runCount, unsigned long int runInterval, unsigned long int timeout,
+							 bool isExclusive, bool isInfinite, bool isPeriodic,
+							 unsigned char paramCount, ...);
+void ShellSuperviseTask(LinkedListNode* node, unsigned char policy, bool isCritical);
+void ShellTaskCheckIn(void);
+void ShellServiceWatchdog(void);
+void ShellRecordTaskStart(void);
+// Tasks
+bool TaskPrintTick(void);
+bool TaskPrintDateTime(void);
+bool TaskCalculateRMSCurrent(void);
+bool TaskUpdateRelayStatus(void);
+bool TaskUpdateProximityStatus(void);
+bool TaskPrintTemp(void);
+bool TaskSendServerLine(void);
+bool TaskConnectNetwork(void);
+bool TaskConnectTcp(void);
+bool TaskRenderScreen(void);
+bool TaskPrintBasicLayout(void);
+bool TaskPrintCommStatistics(void);
+bool TaskPrintTaskStatistics(void);
+bool TaskSendTelemetry(void);
+bool TaskRestoreEnergy(void);
+bool TaskCheckpointEnergy(void);
+bool TaskPrintEnergy(void);
+bool TaskPrintAnalogInputs(void);
+bool TaskPrintHarmonics(void);
+bool TaskCalculateHarmonics(void);
+bool TaskPrintSampling(void);
+bool TaskStoreCapture(void);
+bool TaskUplinkCapture(void);
+bool TaskPrintCapture(void);
+// AT Command Handlers
+bool AtJoinNetwork(void);
+void AtJoinNetworkLine(void* line);
+void AtJoinNetworkDone(unsigned char response);
+bool AtConnectTcp(void);
+void AtConnectTcpLine(void* line);
+void AtConnectTcpDone(unsigned char response);
+// Button Actions
+void ButtonPress(void);
+void ButtonHold(void);
+void ButtonRelease(void);
+// Load Measurement
+void InitializeLoadMeasurement(void);
+unsigned int CalculateCurrentRMS(void);
+unsigned int CalculateLineFrequency(const AdcWindow* window);
+unsigned long int CalculateMeanSquareAC(long int sum, unsigned long int sumSquares, unsigned char count);
+bool ConfigureSampling(const AdcSampling* sampling);
+unsigned long int CalculateSamplePeriod(unsigned char prescale, unsigned char postscale, unsigned char period);
+unsigned long int CalculateSampleRate(unsigned long int period);
+void CalculateHarmonics(const AdcWindow* window);
+void CalculateGoertzelCoefficients(unsigned int frequency);
+unsigned int SquareRoot(unsigned long int value);
+// Relay Control
+void RelayControl(unsigned char state);
+
 #endif
\ No newline at end of file
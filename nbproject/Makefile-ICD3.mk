@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c linked_list.c buffer.c system.c
+SOURCEFILES_QUOTED_IF_SPACED=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c linked_list.c buffer.c system.c screen.c format.c telemetry.c energy.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/system.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/config.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/interrupt.p1.d ${OBJECTDIR}/button.p1.d ${OBJECTDIR}/sram.p1.d ${OBJECTDIR}/serial_comm.p1.d ${OBJECTDIR}/wifi.p1.d ${OBJECTDIR}/linked_list.p1.d ${OBJECTDIR}/buffer.p1.d ${OBJECTDIR}/system.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/system.p1 ${OBJECTDIR}/screen.p1 ${OBJECTDIR}/format.p1 ${OBJECTDIR}/telemetry.p1 ${OBJECTDIR}/energy.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/config.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/interrupt.p1.d ${OBJECTDIR}/button.p1.d ${OBJECTDIR}/sram.p1.d ${OBJECTDIR}/serial_comm.p1.d ${OBJECTDIR}/wifi.p1.d ${OBJECTDIR}/linked_list.p1.d ${OBJECTDIR}/buffer.p1.d ${OBJECTDIR}/system.p1.d ${OBJECTDIR}/screen.p1.d ${OBJECTDIR}/format.p1.d ${OBJECTDIR}/telemetry.p1.d ${OBJECTDIR}/energy.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/system.p1
+OBJECTFILES=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/system.p1 ${OBJECTDIR}/screen.p1 ${OBJECTDIR}/format.p1 ${OBJECTDIR}/telemetry.p1 ${OBJECTDIR}/energy.p1
 
 # Source Files
-SOURCEFILES=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c linked_list.c buffer.c system.c
+SOURCEFILES=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c linked_list.c buffer.c system.c screen.c format.c telemetry.c energy.c
 
 
 CFLAGS=
@@ -173,6 +173,38 @@ ${OBJECTDIR}/system.p1: system.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/system.d ${OBJECTDIR}/system.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/system.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/telemetry.p1: telemetry.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/telemetry.p1.d 
+	@${RM} ${OBJECTDIR}/telemetry.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  -D__DEBUG=1 --debugger=icd3  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/telemetry.p1  telemetry.c 
+	@-${MV} ${OBJECTDIR}/telemetry.d ${OBJECTDIR}/telemetry.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/telemetry.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/energy.p1: energy.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/energy.p1.d 
+	@${RM} ${OBJECTDIR}/energy.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  -D__DEBUG=1 --debugger=icd3  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/energy.p1  energy.c 
+	@-${MV} ${OBJECTDIR}/energy.d ${OBJECTDIR}/energy.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/energy.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/format.p1: format.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/format.p1.d 
+	@${RM} ${OBJECTDIR}/format.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  -D__DEBUG=1 --debugger=icd3  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/format.p1  format.c 
+	@-${MV} ${OBJECTDIR}/format.d ${OBJECTDIR}/format.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/format.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/screen.p1: screen.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/screen.p1.d 
+	@${RM} ${OBJECTDIR}/screen.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  -D__DEBUG=1 --debugger=icd3  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/screen.p1  screen.c 
+	@-${MV} ${OBJECTDIR}/screen.d ${OBJECTDIR}/screen.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/screen.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 else
 ${OBJECTDIR}/config.p1: config.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
@@ -254,6 +286,38 @@ ${OBJECTDIR}/system.p1: system.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/system.d ${OBJECTDIR}/system.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/system.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/telemetry.p1: telemetry.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/telemetry.p1.d 
+	@${RM} ${OBJECTDIR}/telemetry.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/telemetry.p1  telemetry.c 
+	@-${MV} ${OBJECTDIR}/telemetry.d ${OBJECTDIR}/telemetry.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/telemetry.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/energy.p1: energy.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/energy.p1.d 
+	@${RM} ${OBJECTDIR}/energy.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/energy.p1  energy.c 
+	@-${MV} ${OBJECTDIR}/energy.d ${OBJECTDIR}/energy.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/energy.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/format.p1: format.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/format.p1.d 
+	@${RM} ${OBJECTDIR}/format.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/format.p1  format.c 
+	@-${MV} ${OBJECTDIR}/format.d ${OBJECTDIR}/format.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/format.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/screen.p1: screen.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/screen.p1.d 
+	@${RM} ${OBJECTDIR}/screen.p1 
+	${MP_CC} --pass1 $(MP_EXTRA_CC_PRE) --chip=$(MP_PROCESSOR_OPTION) -Q -G  --double=32 --float=24 --emi=byteselect --opt=none --addrqual=require -P -N255 --warn=0 --asmlist -DXPRJ_ICD3=$(CND_CONF)  --summary=default,+psect,-class,+mem,-hex,+file --output=default,-inhx032 --runtime=default,+clear,+init,-keep,-no_startup,-download,-config,+clib,+plib $(COMPARISON_BUILD)  --output=-mcof,+elf:multilocs --stack=compiled:auto:auto:auto "--errformat=%f:%l: error: (%n) %s" "--warnformat=%f:%l: warning: (%n) %s" "--msgformat=%f:%l: advisory: (%n) %s" --MSGDISABLE=350    -o${OBJECTDIR}/screen.p1  screen.c 
+	@-${MV} ${OBJECTDIR}/screen.d ${OBJECTDIR}/screen.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/screen.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c shell.c linked_list.c buffer.c smartmodule.c
+SOURCEFILES_QUOTED_IF_SPACED=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c shell.c linked_list.c buffer.c smartmodule.c screen.c format.c telemetry.c energy.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/shell.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/smartmodule.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/config.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/interrupt.p1.d ${OBJECTDIR}/button.p1.d ${OBJECTDIR}/sram.p1.d ${OBJECTDIR}/serial_comm.p1.d ${OBJECTDIR}/wifi.p1.d ${OBJECTDIR}/shell.p1.d ${OBJECTDIR}/linked_list.p1.d ${OBJECTDIR}/buffer.p1.d ${OBJECTDIR}/smartmodule.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/shell.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/smartmodule.p1 ${OBJECTDIR}/screen.p1 ${OBJECTDIR}/format.p1 ${OBJECTDIR}/telemetry.p1 ${OBJECTDIR}/energy.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/config.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/interrupt.p1.d ${OBJECTDIR}/button.p1.d ${OBJECTDIR}/sram.p1.d ${OBJECTDIR}/serial_comm.p1.d ${OBJECTDIR}/wifi.p1.d ${OBJECTDIR}/shell.p1.d ${OBJECTDIR}/linked_list.p1.d ${OBJECTDIR}/buffer.p1.d ${OBJECTDIR}/smartmodule.p1.d ${OBJECTDIR}/screen.p1.d ${OBJECTDIR}/format.p1.d ${OBJECTDIR}/telemetry.p1.d ${OBJECTDIR}/energy.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/shell.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/smartmodule.p1
+OBJECTFILES=${OBJECTDIR}/config.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/interrupt.p1 ${OBJECTDIR}/button.p1 ${OBJECTDIR}/sram.p1 ${OBJECTDIR}/serial_comm.p1 ${OBJECTDIR}/wifi.p1 ${OBJECTDIR}/shell.p1 ${OBJECTDIR}/linked_list.p1 ${OBJECTDIR}/buffer.p1 ${OBJECTDIR}/smartmodule.p1 ${OBJECTDIR}/screen.p1 ${OBJECTDIR}/format.p1 ${OBJECTDIR}/telemetry.p1 ${OBJECTDIR}/energy.p1
 
 # Source Files
-SOURCEFILES=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c shell.c linked_list.c buffer.c smartmodule.c
+SOURCEFILES=config.c main.c interrupt.c button.c sram.c serial_comm.c wifi.c shell.c linked_list.c buffer.c smartmodule.c screen.c format.c telemetry.c energy.c
 
 
 CFLAGS=
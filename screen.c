@@ -0,0 +1,183 @@
+/**@file		screen.c
+ * @brief		Implementation of the terminal screen model and dirty-cell renderer
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "screen.h"
+#include "serial_comm.h"
+#include "utility.h"
+
+// INITIALIZATION FUNCTIONS----------------------------------------------------
+
+/**
+ * Initializes a newly created <b>Screen</b>.
+ * All cells are assumed to be blank on the terminal (the layout must have been printed on a cleared screen).
+ * @param screen		Pointer to the <b>Screen</b> to be initialized
+ * @param comm			Pointer to the <b>CommPort</b> to which the terminal is connected
+ * @param fields		Pointer to an array of field definitions
+ * @param fieldCount	Number of fields (must not exceed <code>SCREEN_MAX_FIELDS</code>)
+ * @param currentData	Pointer to cell storage (must be at least the sum of all field widths in size)
+ * @param desiredData	Pointer to cell storage (must be at least the sum of all field widths in size)
+ */
+void ScreenInitialize(Screen* screen, CommPort* comm,
+					  const ScreenField* fields, unsigned char fieldCount,
+					  char* currentData, char* desiredData)
+{
+	if(screen == NULL || fields == NULL || fieldCount > SCREEN_MAX_FIELDS)
+		return;
+
+	screen->comm = comm;
+	screen->fields = fields;
+	screen->fieldCount = fieldCount;
+	screen->current = currentData;
+	screen->desired = desiredData;
+	screen->dirty = 0;
+	screen->cursor.isKnown = false;
+
+	uint16_t i, cellCount = 0;
+	for(i = 0; i < fieldCount; i++)
+		cellCount += fields[i].width;
+	for(i = 0; i < cellCount; i++)
+	{
+		currentData[i] = ' ';
+		desiredData[i] = ' ';
+	}
+}
+
+// MODEL FUNCTIONS-------------------------------------------------------------
+
+/**
+ * Sets the desired contents of a field.
+ * The string is truncated to the width of the field, and the remainder of the field is filled with spaces.
+ * Nothing is sent to the terminal until the screen is rendered.
+ * @param screen	Pointer to the target <b>Screen</b>
+ * @param field		Index of the target field
+ * @param str		Null-terminated string to be displayed in the field
+ * @see ScreenRender
+ */
+void ScreenWrite(Screen* screen, unsigned char field, const char* str)
+{
+	if(screen == NULL || str == NULL || field >= screen->fieldCount)
+		return;
+
+	uint16_t offset = 0;
+	uint8_t i;
+	for(i = 0; i < field; i++)
+		offset += screen->fields[i].width;
+
+	char* desired = screen->desired + offset;
+	char* current = screen->current + offset;
+	bool isChanged = false;
+	for(i = 0; i < screen->fields[field].width; i++)
+	{
+		char ch = *str ? *str++ : ' ';
+		desired[i] = ch;
+		if(ch != current[i])
+			isChanged = true;
+	}
+
+	if(isChanged)
+		bit_set(screen->dirty, field);
+}
+
+/**
+ * Marks the terminal as blank (for example, after the screen has been cleared and the layout reprinted).
+ * Every field with visible contents is redrawn on the next render.
+ * @param screen Pointer to the target <b>Screen</b>
+ */
+void ScreenInvalidate(Screen* screen)
+{
+	if(screen == NULL)
+		return;
+
+	uint16_t offset = 0;
+	uint8_t f, i;
+	for(f = 0; f < screen->fieldCount; offset += screen->fields[f].width, f++)
+	{
+		for(i = 0; i < screen->fields[f].width; i++)
+		{
+			screen->current[offset + i] = ' ';
+			if(screen->desired[offset + i] != ' ')
+				bit_set(screen->dirty, f);
+		}
+	}
+	screen->cursor.isKnown = false;
+}
+
+// RENDERING FUNCTIONS---------------------------------------------------------
+
+/**
+ * Sends every changed cell of every dirty field to the terminal.
+ * Runs of unchanged cells are skipped with a cursor move, unless reprinting them is shorter.
+ * The terminal cursor position is assumed to be unknown when rendering starts,
+ * since other code may print to the terminal between calls.
+ * Rendering never waits for the TX buffer: when it is full, the remaining cells are rendered on a later call.
+ * @param screen Pointer to the <b>Screen</b> to be rendered
+ */
+void ScreenRender(Screen* screen)
+{
+	if(screen == NULL || screen->dirty == 0)
+		return;
+
+	screen->cursor.isKnown = false;
+	uint16_t offset = 0;
+	uint8_t f;
+	for(f = 0; f < screen->fieldCount; offset += screen->fields[f].width, f++)
+	{
+		if(!bit_test(screen->dirty, f))
+			continue;
+
+		const ScreenField* field = &screen->fields[f];
+		uint8_t row = field->position->y ? field->position->y : 1;
+		uint8_t col = field->position->x ? field->position->x : 1;
+		char* desired = screen->desired + offset;
+		char* current = screen->current + offset;
+
+		uint8_t i;
+		for(i = 0; i < field->width; i++, col++)
+		{
+			if(desired[i] == current[i])
+				continue;
+
+			// Stop if the TX buffer is full (the field stays dirty and rendering resumes on the next call)
+			if(!CommReserve(screen->comm, SCREEN_CELL_RESERVE))
+				return;
+
+			// Position the cursor: reprint a short run of unchanged cells, otherwise move
+			if(screen->cursor.isKnown
+			&& screen->cursor.row == row
+			&& screen->cursor.col <= col
+			&& col - screen->cursor.col < SCREEN_MAX_SKIP
+			&& col - screen->cursor.col <= i)
+			{
+				while(screen->cursor.col < col)
+				{
+					CommPutChar(screen->comm, current[i - (col - screen->cursor.col)]);
+					screen->cursor.col++;
+				}
+			}
+			else
+			{
+				if(i == 0 && field->cursor != NULL)
+					CommPutStoredSequence(screen->comm, field->cursor);
+				else
+					CommPutSequence(screen->comm, ANSI_CPOS, 2, row, col);
+				screen->cursor.row = row;
+				screen->cursor.col = col;
+				screen->cursor.isKnown = true;
+			}
+
+			CommPutChar(screen->comm, desired[i]);
+			current[i] = desired[i];
+			screen->cursor.col++;
+		}
+		bit_clear(screen->dirty, f);
+	}
+}
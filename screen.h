@@ -0,0 +1,66 @@
+/**@file		screen.h
+ * @brief		Header file defining a screen model (shadow framebuffer) for ANSI terminal layouts.
+ *				Values are written into the model, and a renderer emits only the cells which have changed.
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stdbool.h>
+#include "serial_comm.h"
+#include "utility.h"
+
+// DEFINITIONS-----------------------------------------------------------------
+#define SCREEN_MAX_FIELDS	16	/**< The maximum number of fields in a screen (one bit of <code>Screen.dirty</code> per field) */
+#define SCREEN_MAX_SKIP		5	/**< Unchanged cells shorter than this are reprinted rather than skipped with a cursor move */
+#define SCREEN_CELL_RESERVE	11	/**< TX buffer space needed to emit one changed cell (the longer of a cursor move and a reprinted run, plus the cell) */
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct ScreenField
+ * Defines one rectangular (single row) region of the terminal layout
+ * @see Point
+ * @see StoredSequence
+ */
+typedef struct ScreenField
+{
+	const Point* position;			/**< Terminal position of the first cell (x = column, y = row) */
+	const StoredSequence* cursor;	/**< Pre-rendered cursor position sequence for the first cell (optional, may be NULL) */
+	unsigned char width;			/**< Number of cells in the field */
+} ScreenField;
+
+/**@struct Screen
+ * Structure containing the current (displayed) and desired contents of every field of a terminal layout.
+ * Cell memory for each field is allocated sequentially, in the order in which fields are defined.
+ * @see ScreenField
+ */
+typedef struct Screen
+{
+	const ScreenField* fields;	/**< Pointer to an array of field definitions */
+	unsigned char fieldCount;	/**< Number of fields */
+	char* current;				/**< Cells as currently displayed on the terminal */
+	char* desired;				/**< Cells as they should be displayed on the terminal */
+	unsigned int dirty;			/**< Bitmap of fields whose desired contents differ from their current contents */
+	CommPort* comm;				/**< The <b>CommPort</b> to which the terminal is connected */
+
+	struct
+	{
+		unsigned char row;		/**< Row at which the next character will be printed */
+		unsigned char col;		/**< Column at which the next character will be printed */
+		bool isKnown;			/**< Indicates that the position of the terminal cursor is known */
+	} cursor;
+} Screen;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+void ScreenInitialize(Screen* screen, CommPort* comm,
+					  const ScreenField* fields, unsigned char fieldCount,
+					  char* currentData, char* desiredData);
+void ScreenWrite(Screen* screen, unsigned char field, const char* str);
+void ScreenInvalidate(Screen* screen);
+void ScreenRender(Screen* screen);
+
+#endif
@@ -1,321 +1,953 @@
-/* Project:	SmartModule
- * File:	serial_comm.c
- * Author:	Jonathan Ruisi
- * Created:	February 14, 2017, 2:22 AM
- */
-
-#include <xc.h>
-#include <stdbool.h>
-#include <stdint.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-#include "main.h"
-#include "system.h"
-#include "serial_comm.h"
-#include "sram.h"
-#include "utility.h"
-
-// COMM PORT FUNCTIONS---------------------------------------------------------
-
-void CommPortInitialize(CommPort* comm,
-						unsigned int txBufferSize, unsigned int rxBufferSize, unsigned int lineBufferSize,
-						char* txData, char* rxData, char* lineData,
-						const unsigned short long int* lineQueueBaseAddress, unsigned int lineQueueSize,
-						NewlineFlags txNewline, NewlineFlags rxNewline,
-						const CommDataRegisters* registers,
-						bool enableFlowControl, bool enableEcho,
-						unsigned char echoRow, unsigned char echoColumn)
-{
-	comm->status = enableFlowControl ? 0x3 : 0x0;	// Enable TX and RX flow control
-	comm->mode = enableEcho ? 0x7 : 0x0;			// Enable character, newline, and sequence echo
-	comm->modeBits.useExternalBuffer = true;
-	comm->cursor.x = echoColumn;
-	comm->cursor.y = echoRow;
-	comm->newline.tx = txNewline;
-	comm->newline.rx = rxNewline;
-	comm->newline.inProgress = 0;
-	comm->sequence.status = 0;
-	comm->sequence.paramCount = 0;
-	comm->sequence.terminator = 0;
-	comm->buffers.external.data = (uint24_t*) lineQueueBaseAddress;
-	comm->buffers.external.elementSize = lineBufferSize;
-	comm->registers = registers;
-	InitializeRingBuffer(&comm->buffers.tx, txBufferSize, 1, txData);
-	InitializeRingBuffer(&comm->buffers.rx, rxBufferSize, 1, rxData);
-	InitializeBuffer(&comm->buffers.line, lineBufferSize, 1, lineData);
-	InitializeRingBufferSRAM(&comm->buffers.external, lineQueueSize, lineBufferSize, lineQueueBaseAddress);
-}
-
-void UpdateCommPort(CommPort* comm)
-{
-	// Manage RX flow control (This block of code sends XON, whereas XOFF is sent in the ISR for USART RX)
-	if(comm->statusBits.isRxFlowControl
-	&& comm->statusBits.isRxPaused
-	&& comm->buffers.rx.length <= XON_THRESHOLD)
-	{
-		while(!(*comm->registers->pTxSta).TRMT)
-			continue;
-		*comm->registers->pTxReg = ASCII_XON;
-		comm->statusBits.isRxPaused = false;
-	}
-
-	// Only continue if all events have been handled
-	if(comm->statusBits.hasSequence
-	|| comm->buffers.external.length == comm->buffers.external.capacity
-	|| (!comm->modeBits.useExternalBuffer && comm->statusBits.hasLine))
-		return;
-
-	// Only continue if the RX buffer is not empty
-	if(comm->buffers.rx.length == 0)
-		return;
-
-	// Retrieve the next character from the RX buffer
-	char ch;
-	RingBufferDequeue(&comm->buffers.rx, &ch);
-
-	// If an escape sequence has been initiated,
-	// retrieve parameters until terminating character is received
-	if(comm->sequence.statusBits.csiCharCount == 1)
-	{
-		if(ch == '[')
-			comm->sequence.statusBits.csiCharCount++;
-		else
-			CommResetSequence(comm);
-	}
-	else if(comm->sequence.statusBits.csiCharCount == 2)
-	{
-		// Check for terminating character (any alphabetical character)
-		// Check for parameters (0-9 and : ; < = > ?)
-		if((ch >= 0x41 && ch <= 0x5A) || (ch >= 0x61 && ch <= 0x7A))
-		{
-			comm->sequence.terminator = ch;
-			comm->sequence.statusBits.sequenceId = ch;
-			comm->statusBits.hasSequence = true;
-
-			// If enabled, echo the sequence
-			if(comm->modeBits.echoSequence)
-			{
-				CommPutChar(comm, ASCII_ESC);
-				CommPutChar(comm, '[');
-				uint8_t i;
-				for(i = 0; i < comm->sequence.paramCount; i++)
-				{
-					CommPutChar(comm, comm->sequence.params[i]);
-				}
-				CommPutChar(comm, comm->sequence.terminator);
-			}
-		}
-		else if(comm->sequence.paramCount < SEQ_MAX_PARAMS
-				&& (ch >= 0x30 && ch <= 0x3F)
-				&& !comm->sequence.terminator)
-		{
-			comm->sequence.params[comm->sequence.paramCount] = ch;
-			comm->sequence.paramCount++;
-		}
-		else
-		{
-			CommResetSequence(comm);
-		}
-	}
-
-	// If a control character was received, process it, otherwise add character to the line
-	if(ch < 0x20 && !comm->modeBits.isBinaryMode && !comm->sequence.status)
-	{
-		switch(ch)
-		{
-			case ASCII_BS:
-			{
-				if(comm->buffers.line.length)
-					comm->buffers.line.length--;
-				break;
-			}
-			case ASCII_LF:
-			{
-				comm->newline.inProgress |= NEWLINE_LF;
-				break;
-			}
-			case ASCII_CR:
-			{
-				comm->newline.inProgress |= NEWLINE_CR;
-				break;
-			}
-			case ASCII_ESC:
-			{
-				comm->sequence.statusBits.csiCharCount++;
-				break;
-			}
-		}
-	}
-	else if(!comm->sequence.status)
-	{
-		// Since a printable character was received, invalidate a partial newline
-		comm->newline.inProgress = 0;
-
-		// Add character to the line
-		((char*) comm->buffers.line.data)[comm->buffers.line.length] = ch;
-		comm->buffers.line.length++;
-
-		// Echo received character (if enabled)
-		// Backspace characters will be echoed if the line buffer is not empty
-		// (printable characters will be echoed iff received outside of an escape sequence)
-		if(comm->modeBits.echoRx)
-		{
-			while(comm->buffers.tx.length || !(*comm->registers->pTxSta).TRMT)
-				continue;
-			CommPutSequence(comm, ANSI_SCPOS, 0);
-			CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x + comm->buffers.line.length - 1);
-			CommPutChar(comm, ch);
-			CommPutSequence(comm, ANSI_RCPOS, 0);
-		}
-	}
-
-	// If the line buffer is full, flush the line to external RAM (or set hasLine flag if not using external RAM)
-	if(comm->buffers.line.length == comm->buffers.line.capacity)
-	{
-		if(!comm->modeBits.isBinaryMode)
-		{
-			((char*) comm->buffers.line.data)[comm->buffers.line.capacity - 1] = ASCII_NUL;
-
-			if(comm->modeBits.echoNewline)
-			{
-				while(comm->buffers.tx.length || !(*comm->registers->pTxSta).TRMT)
-					continue;
-				comm->cursor.y++;
-				CommPutSequence(comm, ANSI_SCPOS, 0);
-				CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x);
-				CommPutNewline(comm);
-				CommPutSequence(comm, ANSI_RCPOS, 0);
-			}
-		}
-
-		if(comm->modeBits.useExternalBuffer)
-			CommFlushLineBuffer(comm);
-		else
-			comm->statusBits.hasLine = true;
-	}
-
-	// If a newline has been received, flush the line to external RAM (or set hasLine flag if not using external RAM)
-	if(comm->newline.inProgress == comm->newline.rx)
-	{
-		((char*) comm->buffers.line.data)[comm->buffers.line.length] = ASCII_NUL;
-		comm->buffers.line.length++;
-		comm->newline.inProgress = 0;
-		if(comm->modeBits.useExternalBuffer)
-			CommFlushLineBuffer(comm);
-		else
-			comm->statusBits.hasLine = true;
-
-		// If enabled, echo the newline sequence
-		if(comm->modeBits.echoNewline)
-		{
-			while(comm->buffers.tx.length || !(*comm->registers->pTxSta).TRMT)
-				continue;
-			comm->cursor.y++;
-			CommPutSequence(comm, ANSI_SCPOS, 0);
-			CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x);
-			CommPutNewline(comm);
-			CommPutSequence(comm, ANSI_RCPOS, 0);
-		}
-	}
-}
-
-void CommFlushLineBuffer(CommPort* comm)
-{
-	while(_sram.statusBits.busy)
-		continue;
-	RingBufferEnqueueSRAM(&comm->buffers.external, &comm->buffers.line);
-	comm->buffers.line.length = 0;
-}
-
-void CommResetSequence(CommPort* comm)
-{
-	comm->statusBits.hasSequence = false;
-	comm->sequence.status = 0;
-	comm->sequence.paramCount = 0;
-	comm->sequence.terminator = 0;
-}
-
-void CommPutChar(CommPort* comm, char data)
-{
-	while(comm->buffers.tx.length == comm->buffers.tx.capacity)
-		continue;
-	RingBufferEnqueue(&comm->buffers.tx, (char*) data);
-	bit_set(*comm->registers->pPie, comm->registers->txieBit);
-}
-
-void CommPutString(CommPort* comm, const char* str)
-{
-	uint16_t length;
-	for(length = 0; str[length] != ASCII_NUL; length++)
-		CommPutChar(comm, str[length]);
-}
-
-void CommPutSubString(CommPort* comm, const char* str, unsigned int startIndex, unsigned int length)
-{
-	uint16_t i;
-	for(i = 0; str[i + startIndex] != ASCII_NUL && i < length; i++)
-		CommPutChar(comm, str[i + startIndex]);
-}
-
-void CommPutNewline(CommPort* comm)
-{
-	if(comm->newline.tx & NEWLINE_CR)
-		CommPutChar(comm, ASCII_CR);
-
-	if(comm->newline.tx & NEWLINE_LF)
-		CommPutChar(comm, ASCII_LF);
-}
-
-void CommPutSequence(CommPort* comm, unsigned char terminator, unsigned char paramCount, ...)
-{
-	va_list args;
-	unsigned char i;
-	CommPutChar(comm, ASCII_ESC);
-	CommPutChar(comm, '[');
-
-	if(paramCount)
-	{
-		va_start(args, paramCount);
-		for(i = 0; i < paramCount; i++)
-		{
-			unsigned char param = va_arg(args, unsigned char);
-			if(param < 10)
-				CommPutChar(comm, 0x30 + param);
-			else
-			{
-				char numStr[8];
-				itoa(&numStr, param, 10);
-				CommPutString(comm, &numStr);
-			}
-
-			if(i < paramCount - 1)
-				CommPutChar(comm, ';');
-		}
-		va_end(args);
-	}
-	CommPutChar(comm, terminator);
-}
-
-void CommEchoSequence(CommPort* comm)
-{
-	unsigned char i;
-	CommPutChar(comm, ASCII_ESC);
-	CommPutChar(comm, '[');
-
-	for(i = 0; i < comm->sequence.paramCount; i++)
-	{
-		if(comm->sequence.params[i] < 10)
-			CommPutChar(comm, 0x30 + comm->sequence.params[i]);
-		else
-		{
-			char numStr[8];
-			itoa(&numStr, comm->sequence.params[i], 10);
-			CommPutString(comm, &numStr);
-		}
-
-		if(i < comm->sequence.paramCount - 1)
-			CommPutChar(comm, ';');
-	}
-	CommPutChar(comm, comm->sequence.terminator);
+/* Project:	SmartModule
+ * File:	serial_comm.c
+ * Author:	Jonathan Ruisi
+ * Created:	February 14, 2017, 2:22 AM
+ */
+
+#include <xc.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "format.h"
+#include "system.h"
+#include "serial_comm.h"
+#include "sram.h"
+#include "utility.h"
+
+// RECEIVER STATE MACHINE------------------------------------------------------
+// Parser states (the first three are stored in sequence.statusBits.state, RX_STATE_BINARY is selected by isBinaryMode)
+#define RX_STATE_TEXT		0	/**< Characters are added to the line */
+#define RX_STATE_ESCAPE		1	/**< ESC has been received */
+#define RX_STATE_CSI		2	/**< ESC [ has been received, parameters are being collected */
+#define RX_STATE_BINARY		3	/**< Every character is added to the line */
+#define RX_STATE_COUNT		4
+// Character classes
+#define RX_CLASS_TEXT		0	/**< Printable character with no meaning in a control sequence */
+#define RX_CLASS_PARAM		1	/**< Control sequence parameter (0-9 : ; < = > ?) */
+#define RX_CLASS_FINAL		2	/**< Control sequence terminator (A-Z a-z) */
+#define RX_CLASS_BRACKET	3	/**< Control sequence introducer ([) */
+#define RX_CLASS_CR			4	/**< Carriage return */
+#define RX_CLASS_LF			5	/**< Line feed */
+#define RX_CLASS_BS			6	/**< Backspace */
+#define RX_CLASS_ESC		7	/**< Escape */
+#define RX_CLASS_CONTROL	8	/**< Any other control character */
+#define RX_CLASS_COUNT		9
+// Actions
+#define RX_ACTION_APPEND	0	/**< Add the character to the line */
+#define RX_ACTION_IGNORE	1	/**< Discard the character */
+#define RX_ACTION_BS		2	/**< Remove the last character from the line */
+#define RX_ACTION_CR		3	/**< Record a carriage return as part of a newline */
+#define RX_ACTION_LF		4	/**< Record a line feed as part of a newline */
+#define RX_ACTION_ESCAPE	5	/**< Start a control sequence */
+#define RX_ACTION_CSI		6	/**< Start collecting control sequence parameters */
+#define RX_ACTION_PARAM		7	/**< Add a parameter to the control sequence */
+#define RX_ACTION_FINAL		8	/**< Complete the control sequence */
+#define RX_ACTION_ABORT		9	/**< Discard the control sequence, then process the character as text */
+
+/** Character class of each 7-bit character (characters above 0x7F are text) */
+static const unsigned char _rxClass[128] = {
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	// 0x00
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,
+	RX_CLASS_BS,		RX_CLASS_CONTROL,	RX_CLASS_LF,		RX_CLASS_CONTROL,	// 0x08
+	RX_CLASS_CONTROL,	RX_CLASS_CR,		RX_CLASS_CONTROL,	RX_CLASS_CONTROL,
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	// 0x10
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_ESC,		// 0x18
+	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,	RX_CLASS_CONTROL,
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		// 0x20
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		// 0x28
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,
+	RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		// 0x30
+	RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,
+	RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		// 0x38
+	RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,		RX_CLASS_PARAM,
+	RX_CLASS_TEXT,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x40
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x48
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x50
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_BRACKET,	// 0x58
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,
+	RX_CLASS_TEXT,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x60
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x68
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		// 0x70
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,
+	RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_FINAL,		RX_CLASS_TEXT,		// 0x78
+	RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT,		RX_CLASS_TEXT
+};
+
+/** Action taken for each combination of parser state and character class */
+static const unsigned char _rxAction[RX_STATE_COUNT][RX_CLASS_COUNT] = {
+	// TEXT				PARAM				FINAL				BRACKET				CR					LF					BS					ESC					CONTROL
+	{RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_CR,		RX_ACTION_LF,		RX_ACTION_BS,		RX_ACTION_ESCAPE,	RX_ACTION_IGNORE},	// RX_STATE_TEXT
+	{RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_CSI,		RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ESCAPE,	RX_ACTION_ABORT},	// RX_STATE_ESCAPE
+	{RX_ACTION_ABORT,	RX_ACTION_PARAM,	RX_ACTION_FINAL,	RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ABORT,	RX_ACTION_ESCAPE,	RX_ACTION_ABORT},	// RX_STATE_CSI
+	{RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND,	RX_ACTION_APPEND}	// RX_STATE_BINARY
+};
+
+static bool CommQueueLine(CommPort* comm);
+static void CommEchoNewline(CommPort* comm);
+static bool CommBeginPayload(CommPort* comm);
+static void CommStorePayload(CommPort* comm);
+
+// COMM PORT FUNCTIONS---------------------------------------------------------
+
+void CommPortInitialize(CommPort* comm,
+						unsigned int txBufferSize, unsigned int rxBufferSize, unsigned int lineBufferSize,
+						char* txData, char* rxData, char* lineData,
+						const unsigned short long int* lineQueueBaseAddress, unsigned int lineQueueSize,
+						NewlineFlags txNewline, NewlineFlags rxNewline,
+						const CommDataRegisters* registers,
+						bool enableFlowControl, bool enableEcho,
+						unsigned char echoRow, unsigned char echoColumn)
+{
+	comm->status = enableFlowControl ? 0x3 : 0x0;	// Enable TX and RX flow control
+	comm->mode = enableEcho ? 0x7 : 0x0;			// Enable character, newline, and sequence echo
+	comm->modeBits.useExternalBuffer = true;
+	comm->cursor.x = echoColumn;
+	comm->cursor.y = echoRow;
+	comm->newline.tx = txNewline;
+	comm->newline.rx = rxNewline;
+	comm->newline.inProgress = 0;
+	comm->sequence.status = 0;
+	comm->sequence.paramCount = 0;
+	comm->sequence.terminator = 0;
+	comm->buffers.external.data = (uint24_t*) lineQueueBaseAddress;
+	comm->buffers.external.elementSize = lineBufferSize;
+	comm->registers = registers;
+	comm->urgent.length = 0;
+	comm->urgent.head = 0;
+	comm->urgent.tail = 0;
+	comm->txCounters.deferred = 0;
+	comm->txCounters.dropped = 0;
+	comm->rxCounters.overrun = 0;
+	comm->rxCounters.framing = 0;
+	comm->rxCounters.dropped = 0;
+	comm->rxLines.count = 0;
+	comm->rxLines.head = 0;
+	comm->rxLines.tail = 0;
+	comm->rxLines.inProgress = 0;
+	comm->rxLines.isOverflow = false;
+	comm->rxLines.ipdMatch = 0;
+	comm->rxLines.payload = 0;
+	comm->rxLines.isLineStart = true;
+	comm->rxLines.isPrompt = false;
+	comm->rxLines.overrun = 0;
+	comm->payloads = NULL;
+	InitializeRingBuffer(&comm->buffers.tx, txBufferSize, 1, txData);
+	InitializeRingBuffer(&comm->buffers.rx, rxBufferSize, 1, rxData);
+	InitializeBuffer(&comm->buffers.line, lineBufferSize, 1, lineData);
+	InitializeRingBufferSRAM(&comm->buffers.external, lineQueueSize, lineBufferSize, lineQueueBaseAddress);
+}
+
+/**
+ * Processes received characters: characters are collected into lines, ANSI control sequences are parsed,
+ * and both are echoed (if enabled).
+ * Every character waiting in the RX buffer is processed (up to <code>RX_BUDGET</code> characters per call),
+ * unless a received line or control sequence must be handled first, or the TX buffer cannot hold the echo.
+ * Without character echo, only complete lines (as indexed by the RX interrupt) are processed,
+ * so a port with no complete line returns immediately.
+ * A call to this function must be placed in the main program loop.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+void UpdateCommPort(CommPort* comm)
+{
+	// Manage RX flow control (This block of code queues XON, whereas XOFF is queued in the ISR for USART RX)
+	if(comm->statusBits.isRxFlowControl
+	&& comm->statusBits.isRxPaused
+	&& comm->buffers.rx.length <= XON_THRESHOLD
+	&& CommPutUrgent(comm, ASCII_XON))
+		comm->statusBits.isRxPaused = false;
+
+	// Only continue if all events have been handled
+	if(comm->statusBits.hasSequence
+	|| comm->buffers.external.length == comm->buffers.external.capacity
+	|| (!comm->modeBits.useExternalBuffer && comm->statusBits.hasLine))
+		return;
+
+	// Only continue if the RX buffer is not empty
+	volatile RingBuffer* rx = &comm->buffers.rx;
+	uint16_t available = rx->length;
+	if(available == 0)
+		return;
+
+	// Without character echo, only continue if a complete line has been received
+	// (or the RX buffer is filling up with a line that is too long to be framed)
+	uint8_t lineCount = comm->rxLines.count;
+	if(!comm->modeBits.echoRx
+	&& !comm->modeBits.isBinaryMode
+	&& !comm->rxLines.isOverflow
+	&& available < rx->capacity - RX_BUDGET)
+	{
+		if(lineCount == 0)
+			return;
+
+		// Process up to the end of the newest complete line
+		uint8_t newest = comm->rxLines.tail + lineCount - 1;
+		if(newest >= RX_LINE_SLOTS)
+			newest -= RX_LINE_SLOTS;
+		uint16_t end = comm->rxLines.end[newest];
+		available = end > rx->tail ? end - rx->tail : end + rx->capacity - rx->tail;
+	}
+	if(available > RX_BUDGET)
+		available = RX_BUDGET;
+
+	// The echo mode is fixed for the duration of the call (binary mode only changes at the boundaries of a payload)
+	Buffer* line = &comm->buffers.line;
+	char* lineData = (char*) line->data;
+	PayloadQueue* payloads = comm->payloads;
+	bool isBinary = comm->modeBits.isBinaryMode;
+	bool isEchoing = comm->modeBits.echoRx || comm->modeBits.echoNewline || comm->modeBits.echoSequence;
+	bool echoRx = comm->modeBits.echoRx;
+	bool echoNewline = comm->modeBits.echoNewline;
+	bool echoSequence = comm->modeBits.echoSequence;
+
+	// Characters are read directly from the RX buffer and released in a single update once processing stops
+	uint16_t tail = rx->tail;
+	uint16_t count = 0;
+	uint8_t lineTail = comm->rxLines.tail;
+	uint8_t linesPassed = 0;
+	bool isBlocked = false;
+	while(count < available && !isBlocked)
+	{
+		// Only continue if the echo of the next character can be sent without waiting
+		// (the character stays in the RX buffer until then)
+		if(isEchoing && !CommReserve(comm, ECHO_RESERVE))
+			break;
+
+		// Only continue once the line buffer is no longer being written to SRAM
+		if(_sram.statusBits.busy && _sram.targetBuffer == line)
+			break;
+
+		char ch = ((char*) rx->data)[tail];
+		if(++tail == rx->capacity)
+			tail = 0;
+		count++;
+
+		// Retire the index of each complete line as its newline is passed
+		if(linesPassed < lineCount && tail == comm->rxLines.end[lineTail])
+		{
+			linesPassed++;
+			if(++lineTail == RX_LINE_SLOTS)
+				lineTail = 0;
+		}
+
+		uint8_t charClass = (uint8_t) ch & 0x80 ? RX_CLASS_TEXT : _rxClass[(uint8_t) ch];
+		uint8_t action = _rxAction[isBinary ? RX_STATE_BINARY : comm->sequence.statusBits.state][charClass];
+		if(action == RX_ACTION_PARAM && comm->sequence.paramCount == SEQ_MAX_PARAMS)
+			action = RX_ACTION_ABORT;
+		if(action == RX_ACTION_ABORT)
+		{
+			CommResetSequence(comm);
+			action = _rxAction[RX_STATE_TEXT][charClass];
+		}
+
+		switch(action)
+		{
+			case RX_ACTION_APPEND:
+			{
+				// Since a printable character was received, invalidate a partial newline
+				comm->newline.inProgress = 0;
+				lineData[line->length] = ch;
+				line->length++;
+
+				// Payload characters are stored in SRAM, one line buffer at a time
+				if(payloads != NULL && payloads->remaining)
+				{
+					payloads->remaining--;
+					if(payloads->remaining == 0 || line->length == line->capacity)
+					{
+						CommStorePayload(comm);
+						isBinary = comm->modeBits.isBinaryMode;
+					}
+					break;
+				}
+
+				// Echo received character (if enabled)
+				if(echoRx)
+				{
+					CommPutSequence(comm, ANSI_SCPOS, 0);
+					CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x + line->length - 1);
+					CommPutChar(comm, ch);
+					CommPutSequence(comm, ANSI_RCPOS, 0);
+				}
+
+				// An +IPD header switches the port to binary mode for the length of its payload
+				if(ch == ':' && payloads != NULL && CommBeginPayload(comm))
+				{
+					isBinary = true;
+					break;
+				}
+
+				// If the line buffer is full, pass the line on
+				if(line->length == line->capacity)
+				{
+					if(!isBinary)
+					{
+						lineData[line->capacity - 1] = ASCII_NUL;
+						if(echoNewline)
+							CommEchoNewline(comm);
+					}
+					isBlocked = CommQueueLine(comm);
+				}
+				break;
+			}
+			case RX_ACTION_BS:
+			{
+				if(line->length)
+					line->length--;
+				break;
+			}
+			case RX_ACTION_CR:
+			case RX_ACTION_LF:
+			{
+				// If a newline has been received, pass the line on
+				comm->newline.inProgress |= action == RX_ACTION_CR ? NEWLINE_CR : NEWLINE_LF;
+				if(comm->newline.inProgress == comm->newline.rx)
+				{
+					lineData[line->length] = ASCII_NUL;
+					line->length++;
+					comm->newline.inProgress = 0;
+					isBlocked = CommQueueLine(comm);
+					if(echoNewline)
+						CommEchoNewline(comm);
+				}
+				break;
+			}
+			case RX_ACTION_ESCAPE:
+			{
+				CommResetSequence(comm);
+				comm->sequence.statusBits.state = RX_STATE_ESCAPE;
+				break;
+			}
+			case RX_ACTION_CSI:
+			{
+				comm->sequence.statusBits.state = RX_STATE_CSI;
+				break;
+			}
+			case RX_ACTION_PARAM:
+			{
+				comm->sequence.params[comm->sequence.paramCount] = ch;
+				comm->sequence.paramCount++;
+				break;
+			}
+			case RX_ACTION_FINAL:
+			{
+				comm->sequence.terminator = ch;
+				comm->sequence.statusBits.sequenceId = ch;
+				comm->statusBits.hasSequence = true;
+				isBlocked = true;
+
+				// If enabled, echo the sequence
+				if(echoSequence)
+				{
+					CommPutChar(comm, ASCII_ESC);
+					CommPutChar(comm, '[');
+					uint8_t i;
+					for(i = 0; i < comm->sequence.paramCount; i++)
+					{
+						CommPutChar(comm, comm->sequence.params[i]);
+					}
+					CommPutChar(comm, comm->sequence.terminator);
+				}
+				break;
+			}
+		}
+	}
+
+	// Release the processed characters and line indices (the RX interrupt is masked while the counts are updated)
+	comm->rxLines.tail = lineTail;
+	bit_clear(*comm->registers->pPie, comm->registers->rcieBit);
+	rx->tail = tail;
+	rx->length -= count;
+	comm->rxLines.count -= linesPassed;
+	if(rx->length == 0)
+		comm->rxLines.isOverflow = false;
+	bit_set(*comm->registers->pPie, comm->registers->rcieBit);
+}
+
+/**
+ * Adds a received character to the RX buffer and indexes complete lines.
+ * A line is complete once the newline defined by <code>newline.rx</code> has been received.
+ * If the RX buffer is full, the character is discarded (characters that are already buffered are never overwritten).
+ * This function must only be called from the USART RX interrupt.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param data	The received character
+ */
+void _CommReceive(CommPort* comm, char data)
+{
+	volatile RingBuffer* rx = &comm->buffers.rx;
+	if(rx->length == rx->capacity)
+	{
+		comm->rxLines.overrun++;
+		return;
+	}
+
+	((char*) rx->data)[rx->head] = data;
+	if(++rx->head == rx->capacity)
+		rx->head = 0;
+	rx->length++;
+
+	// Payload characters are not framed
+	if(comm->rxLines.payload)
+	{
+		comm->rxLines.payload--;
+		return;
+	}
+
+	// Track the newline (a printable character invalidates a partial newline, other control characters are ignored)
+	if(data == ASCII_CR)
+		comm->rxLines.inProgress |= NEWLINE_CR;
+	else if(data == ASCII_LF)
+		comm->rxLines.inProgress |= NEWLINE_LF;
+	else if((uint8_t) data >= 0x20)
+		comm->rxLines.inProgress = 0;
+
+	// Track +IPD headers ("+IPD,<length>:" or "+IPD,<link>,<length>:")
+	// A header is indexed like a complete line, and the payload which follows it is not framed
+	// The AT+CIPSEND prompt is not followed by a newline, so it is flagged here
+	if(comm->payloads != NULL)
+	{
+		if(data == SEND_PROMPT && comm->rxLines.isLineStart)
+			comm->rxLines.isPrompt = true;
+		comm->rxLines.isLineStart = data == ASCII_LF;
+
+		if(comm->rxLines.ipdMatch < IPD_PREFIX_LENGTH)
+		{
+			if(data == IPD_PREFIX[comm->rxLines.ipdMatch])
+				comm->rxLines.ipdMatch++;
+			else
+				comm->rxLines.ipdMatch = data == IPD_PREFIX[0];
+			comm->rxLines.ipdLength = 0;
+		}
+		else if(data >= '0' && data <= '9')
+			comm->rxLines.ipdLength = (comm->rxLines.ipdLength * 10) + (data - '0');
+		else if(data == ',')
+			comm->rxLines.ipdLength = 0;
+		else
+		{
+			comm->rxLines.ipdMatch = 0;
+			if(data == ':')
+			{
+				comm->rxLines.payload = comm->rxLines.ipdLength;
+				comm->rxLines.inProgress = comm->newline.rx;
+			}
+		}
+	}
+
+	if(comm->rxLines.inProgress != comm->newline.rx)
+		return;
+
+	comm->rxLines.inProgress = 0;
+	if(comm->rxLines.count == RX_LINE_SLOTS)
+	{
+		comm->rxLines.isOverflow = true;
+		return;
+	}
+	comm->rxLines.end[comm->rxLines.head] = rx->head;
+	if(++comm->rxLines.head == RX_LINE_SLOTS)
+		comm->rxLines.head = 0;
+	comm->rxLines.count++;
+}
+
+/**
+ * Sends the next character: the urgent TX lane is always served first, then the TX buffer (unless paused by flow control).
+ * When there is nothing to send, the TX interrupt is disabled.
+ * This function must only be called from the USART TX interrupt.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+void _CommTransmit(CommPort* comm)
+{
+	if(comm->urgent.length)
+	{
+		*comm->registers->pTxReg = comm->urgent.data[comm->urgent.tail];
+		if(++comm->urgent.tail == URGENT_BUFFER_SIZE)
+			comm->urgent.tail = 0;
+		comm->urgent.length--;
+	}
+	else if(comm->buffers.tx.length && !comm->statusBits.isTxPaused)
+		RingBufferDequeue(&comm->buffers.tx, comm->registers->pTxReg);
+	else
+		bit_clear(*comm->registers->pPie, comm->registers->txieBit);
+}
+
+/**
+ * Adds a character to the urgent TX lane and enables the TX interrupt.
+ * This function must only be called from an interrupt (see <b>CommPutUrgent</b>).
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param data	Character to be sent
+ * @return		true if the character was accepted, false if the urgent TX lane is full
+ */
+bool _CommPutUrgent(CommPort* comm, char data)
+{
+	if(comm->urgent.length == URGENT_BUFFER_SIZE)
+		return false;
+
+	comm->urgent.data[comm->urgent.head] = data;
+	if(++comm->urgent.head == URGENT_BUFFER_SIZE)
+		comm->urgent.head = 0;
+	comm->urgent.length++;
+	bit_set(*comm->registers->pPie, comm->registers->txieBit);
+	return true;
+}
+
+/**
+ * Passes a completed line on, either to the line queue in external RAM or to the consumer of <b>hasLine</b>
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @return		true if no more characters can be processed until the line has been handled
+ */
+static bool CommQueueLine(CommPort* comm)
+{
+	if(comm->modeBits.useExternalBuffer)
+	{
+		CommFlushLineBuffer(comm);
+		return comm->buffers.external.length == comm->buffers.external.capacity;
+	}
+	comm->statusBits.hasLine = true;
+	return true;
+}
+
+/**
+ * Starts receiving an +IPD payload if the line ends with a complete +IPD header.
+ * Space for the whole payload is allocated in the <b>PayloadQueue</b>, and the port is switched to binary mode
+ * until the payload has been received. If there is no room, the payload is received but discarded.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @return		true if a payload follows
+ */
+static bool CommBeginPayload(CommPort* comm)
+{
+	Buffer* line = &comm->buffers.line;
+	int16_t header = BufferContains(line, IPD_PREFIX, IPD_PREFIX_LENGTH);
+	if(header < 0)
+		return false;
+
+	// Parse the payload length (the last field of the header)
+	char* data = (char*) line->data;
+	uint16_t i, length = 0;
+	for(i = header + IPD_PREFIX_LENGTH; i < line->length - 1; i++)
+	{
+		if(data[i] >= '0' && data[i] <= '9')
+			length = (length * 10) + (data[i] - '0');
+		else if(data[i] == ',')
+			length = 0;
+		else
+			return false;
+	}
+	line->length = 0;
+	if(length == 0)
+		return false;
+
+	// Allocate contiguous space after the newest payload, or at the start of the region
+	PayloadQueue* queue = comm->payloads;
+	uint24_t end = queue->baseAddress + queue->size;
+	uint24_t oldest = queue->files[queue->tail].address;
+	uint24_t address = queue->count ? queue->nextAddress : queue->baseAddress;
+	queue->isDiscarding = false;
+	if(queue->count == PAYLOAD_SLOTS || length > queue->size)
+		queue->isDiscarding = true;
+	else if(queue->count == 0 || address > oldest)
+	{
+		if(address + length > end)
+		{
+			address = queue->baseAddress;
+			if(queue->count && address + length > oldest)
+				queue->isDiscarding = true;
+		}
+	}
+	else if(address + length > oldest)
+		queue->isDiscarding = true;
+
+	if(queue->isDiscarding)
+		queue->dropped++;
+	queue->current.address = address;
+	queue->current.length = 0;
+	queue->remaining = length;
+	comm->modeBits.isBinaryMode = true;
+	return true;
+}
+
+/**
+ * Writes the contents of the line buffer to the current payload in SRAM.
+ * Once the whole payload has been received, it is added to the <b>PayloadQueue</b> and the port leaves binary mode.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+static void CommStorePayload(CommPort* comm)
+{
+	PayloadQueue* queue = comm->payloads;
+	Buffer* line = &comm->buffers.line;
+	if(!queue->isDiscarding)
+	{
+		if(SramWait())
+		{
+			SramWrite(queue->current.address + queue->current.length, line);
+			queue->current.length += line->length;
+		}
+		else
+		{
+			queue->isDiscarding = true;
+			queue->dropped++;
+		}
+	}
+	line->length = 0;
+
+	if(queue->remaining)
+		return;
+
+	comm->modeBits.isBinaryMode = false;
+	if(queue->isDiscarding)
+		return;
+	queue->files[queue->head] = queue->current;
+	queue->nextAddress = queue->current.address + queue->current.length;
+	if(++queue->head == PAYLOAD_SLOTS)
+		queue->head = 0;
+	queue->count++;
+}
+
+/**
+ * Echoes a received newline below the previous one
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+static void CommEchoNewline(CommPort* comm)
+{
+	comm->cursor.y++;
+	CommPutSequence(comm, ANSI_SCPOS, 0);
+	CommPutSequence(comm, ANSI_CPOS, 2, comm->cursor.y, comm->cursor.x);
+	CommPutNewline(comm);
+	CommPutSequence(comm, ANSI_RCPOS, 0);
+}
+
+/**
+ * Enables the reception of ESP8266 +IPD payloads on a port.
+ * Payloads are streamed into a region of external SRAM instead of being assembled into lines.
+ * @param comm			Pointer to the target <b>CommPort</b>
+ * @param queue			Pointer to the <b>PayloadQueue</b> to be initialized
+ * @param baseAddress	SRAM address of the region
+ * @param size			Size (bytes) of the region (this limits the size of a payload)
+ */
+void CommPayloadQueueInitialize(CommPort* comm, PayloadQueue* queue,
+								unsigned short long int baseAddress, unsigned short long int size)
+{
+	queue->count = 0;
+	queue->head = 0;
+	queue->tail = 0;
+	queue->baseAddress = baseAddress;
+	queue->size = size;
+	queue->nextAddress = baseAddress;
+	queue->current.address = baseAddress;
+	queue->current.length = 0;
+	queue->remaining = 0;
+	queue->isDiscarding = false;
+	queue->dropped = 0;
+	comm->payloads = queue;
+}
+
+/**
+ * Gets the oldest payload which has been received completely.
+ * The payload remains in SRAM until it is released.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @return		Pointer to a <b>FileDescriptor</b> describing the payload, or NULL if there is none
+ * @see CommReleasePayload
+ */
+const FileDescriptor* CommPeekPayload(CommPort* comm)
+{
+	if(comm->payloads == NULL || comm->payloads->count == 0)
+		return NULL;
+	return &comm->payloads->files[comm->payloads->tail];
+}
+
+/**
+ * Releases the oldest payload (its space in SRAM may then be reused)
+ * @param comm Pointer to the target <b>CommPort</b>
+ * @see CommPeekPayload
+ */
+void CommReleasePayload(CommPort* comm)
+{
+	if(comm->payloads == NULL || comm->payloads->count == 0)
+		return;
+	if(++comm->payloads->tail == PAYLOAD_SLOTS)
+		comm->payloads->tail = 0;
+	comm->payloads->count--;
+}
+
+/**
+ * Abandons a partially received payload (for example, when the device on the other end has been reset).
+ * Complete payloads are kept.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+void CommResetPayload(CommPort* comm)
+{
+	if(comm->payloads == NULL)
+		return;
+
+	bit_clear(*comm->registers->pPie, comm->registers->rcieBit);
+	comm->rxLines.payload = 0;
+	comm->rxLines.ipdMatch = 0;
+	bit_set(*comm->registers->pPie, comm->registers->rcieBit);
+	comm->payloads->remaining = 0;
+	comm->modeBits.isBinaryMode = false;
+	comm->buffers.line.length = 0;
+}
+
+/**
+ * Passes the line buffer on to the line queue in external RAM, and empties it.
+ * If the SRAM does not become ready, the line is dropped (and counted in <b>rxCounters.dropped</b>):
+ * the line buffer is empty afterwards in either case, so the characters which follow start a new line.
+ * @param comm Pointer to the target <b>CommPort</b>
+ */
+void CommFlushLineBuffer(CommPort* comm)
+{
+	if(!SramWait() || !RingBufferEnqueueSRAM(&comm->buffers.external, &comm->buffers.line))
+		comm->rxCounters.dropped++;
+	comm->buffers.line.length = 0;
+}
+
+void CommResetSequence(CommPort* comm)
+{
+	comm->statusBits.hasSequence = false;
+	comm->sequence.status = 0;
+	comm->sequence.paramCount = 0;
+	comm->sequence.terminator = 0;
+}
+
+/**
+ * Checks whether the TX buffer has room for the specified number of characters, without waiting.
+ * If it does, the characters may be written after the head of the TX buffer and published with <b>CommCommit</b>
+ * (or sent with any of the CommPut functions, which will not drop them).
+ * If it does not, the caller is expected to return and try again later.
+ * A request larger than the TX buffer succeeds once the TX buffer is empty (the excess will be dropped).
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param count	Number of characters
+ * @return		true if the characters fit, false if the output has been deferred
+ * @see CommCommit
+ */
+bool CommReserve(CommPort* comm, unsigned int count)
+{
+	if(count > comm->buffers.tx.capacity)
+		count = comm->buffers.tx.capacity;
+
+	if(comm->buffers.tx.capacity - comm->buffers.tx.length >= count)
+		return true;
+
+	comm->txCounters.deferred += count;
+	return false;
+}
+
+/**
+ * Publishes characters which have been written after the head of the TX buffer to the TX interrupt
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param count	Number of characters written (previously reserved with <b>CommReserve</b>)
+ * @see CommReserve
+ */
+void CommCommit(CommPort* comm, unsigned int count)
+{
+	volatile RingBuffer* tx = &comm->buffers.tx;
+	uint16_t head = tx->head + count;
+	if(head >= tx->capacity)
+		head -= tx->capacity;
+
+	bit_clear(*comm->registers->pPie, comm->registers->txieBit);
+	tx->head = head;
+	tx->length += count;
+	bit_set(*comm->registers->pPie, comm->registers->txieBit);
+}
+
+/**
+ * Copies as many characters as currently fit into the TX buffer, without waiting.
+ * The accepted characters are published to the TX interrupt with a single length update.
+ * @param comm		Pointer to the target <b>CommPort</b>
+ * @param data		Pointer to the characters to be sent
+ * @param length	Number of characters to be sent
+ * @return			Number of characters accepted
+ */
+unsigned int CommWrite(CommPort* comm, const char* data, unsigned int length)
+{
+	volatile RingBuffer* tx = &comm->buffers.tx;
+	uint16_t count = tx->capacity - tx->length;
+	if(count > length)
+		count = length;
+	if(count == 0)
+		return 0;
+
+	// Only the TX interrupt moves the tail, so the free region after the head can be filled directly
+	uint16_t head = tx->head;
+	uint16_t i;
+	for(i = 0; i < count; i++)
+	{
+		((char*) tx->data)[head] = data[i];
+		if(++head == tx->capacity)
+			head = 0;
+	}
+
+	CommCommit(comm, count);
+	return count;
+}
+
+/**
+ * Adds a character to the TX buffer, without waiting.
+ * If the TX buffer is full, the character is dropped.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param data	Character to be sent
+ * @return		true if the character was accepted, false if it was dropped
+ */
+bool CommPutChar(CommPort* comm, char data)
+{
+	if(comm->buffers.tx.length == comm->buffers.tx.capacity)
+	{
+		comm->txCounters.dropped++;
+		return false;
+	}
+
+	bit_clear(*comm->registers->pPie, comm->registers->txieBit);
+	RingBufferEnqueue(&comm->buffers.tx, (char*) data);
+	bit_set(*comm->registers->pPie, comm->registers->txieBit);
+	return true;
+}
+
+/**
+ * Sends a character ahead of everything waiting in the TX buffer, without waiting.
+ * Characters in the urgent TX lane are sent even while TX is paused by flow control,
+ * so this is intended for flow control characters and short replies which must not queue behind bulk output.
+ * @param comm	Pointer to the target <b>CommPort</b>
+ * @param data	Character to be sent
+ * @return		true if the character was accepted, false if the urgent TX lane is full
+ */
+bool CommPutUrgent(CommPort* comm, char data)
+{
+	// The RX interrupt may also add characters (XOFF), so both interrupts of the port are masked
+	bit_clear(*comm->registers->pPie, comm->registers->rcieBit);
+	bit_clear(*comm->registers->pPie, comm->registers->txieBit);
+	bool isAccepted = _CommPutUrgent(comm, data);
+	bit_set(*comm->registers->pPie, comm->registers->txieBit);
+	bit_set(*comm->registers->pPie, comm->registers->rcieBit);
+	return isAccepted;
+}
+
+void CommPutString(CommPort* comm, const char* str)
+{
+	uint16_t length = strlen(str);
+	comm->txCounters.dropped += length - CommWrite(comm, str, length);
+}
+
+void CommPutSubString(CommPort* comm, const char* str, unsigned int startIndex, unsigned int length)
+{
+	uint16_t i;
+	for(i = 0; str[i + startIndex] != ASCII_NUL && i < length; i++)
+		continue;
+	comm->txCounters.dropped += i - CommWrite(comm, str + startIndex, i);
+}
+
+void CommPutNewline(CommPort* comm)
+{
+	if(comm->newline.tx & NEWLINE_CR)
+		CommPutChar(comm, ASCII_CR);
+
+	if(comm->newline.tx & NEWLINE_LF)
+		CommPutChar(comm, ASCII_LF);
+}
+
+/**
+ * Sends a line made up of several strings, which may be longer than the TX buffer, without waiting.
+ * As much as fits is sent on each call. The caller calls again with the same strings until the whole line has been sent.
+ * @param comm		Pointer to the target <b>CommPort</b>
+ * @param parts		Strings which make up the line (a newline is sent after the last one)
+ * @param count		Number of strings
+ * @param progress	Number of characters sent by the previous calls (0 to start a line, reset to 0 once it has been sent)
+ * @return			true once the whole line has been sent, false if the caller must call again
+ */
+bool CommPutLine(CommPort* comm, const char* const* parts, unsigned char count, unsigned int* progress)
+{
+	uint16_t skip = *progress;
+	uint8_t i;
+	for(i = 0; i < count; i++)
+	{
+		uint16_t length = strlen(parts[i]);
+		if(skip >= length)
+		{
+			skip -= length;
+			continue;
+		}
+
+		uint16_t sent = CommWrite(comm, parts[i] + skip, length - skip);
+		*progress += sent;
+		if(sent < length - skip)
+			return false;
+		skip = 0;
+	}
+
+	if(comm->buffers.tx.capacity - comm->buffers.tx.length < 2)
+		return false;
+	CommPutNewline(comm);
+	*progress = 0;
+	return true;
+}
+
+void CommPutSequence(CommPort* comm, unsigned char terminator, unsigned char paramCount, ...)
+{
+	va_list args;
+	unsigned char i;
+	CommPutChar(comm, ASCII_ESC);
+	CommPutChar(comm, '[');
+
+	if(paramCount)
+	{
+		va_start(args, paramCount);
+		for(i = 0; i < paramCount; i++)
+		{
+			unsigned char param = (unsigned char) va_arg(args, int);	// Variadic char arguments are promoted to int
+			if(param < 10)
+				CommPutChar(comm, 0x30 + param);
+			else
+				FormatPutUnsigned(comm, param, 0, ' ');
+
+			if(i < paramCount - 1)
+				CommPutChar(comm, ';');
+		}
+		va_end(args);
+	}
+	CommPutChar(comm, terminator);
+}
+
+/**
+ * Sends a pre-rendered control sequence with a single bulk copy into the TX buffer, without waiting.
+ * A sequence is never sent partially: if it does not fit, all of it is dropped.
+ * @param comm		Pointer to the target <b>CommPort</b>
+ * @param sequence	Pointer to the sequence to be sent
+ * @return			true if the sequence was accepted, false if it was dropped
+ * @see StoredSequence
+ */
+bool CommPutStoredSequence(CommPort* comm, const StoredSequence* sequence)
+{
+	if(comm->buffers.tx.capacity - comm->buffers.tx.length < sequence->length)
+	{
+		comm->txCounters.dropped += sequence->length;
+		return false;
+	}
+	CommWrite(comm, sequence->data, sequence->length);
+	return true;
+}
+
+void CommEchoSequence(CommPort* comm)
+{
+	unsigned char i;
+	CommPutChar(comm, ASCII_ESC);
+	CommPutChar(comm, '[');
+
+	for(i = 0; i < comm->sequence.paramCount; i++)
+	{
+		if(comm->sequence.params[i] < 10)
+			CommPutChar(comm, 0x30 + comm->sequence.params[i]);
+		else
+			FormatPutUnsigned(comm, comm->sequence.params[i], 0, ' ');
+
+		if(i < comm->sequence.paramCount - 1)
+			CommPutChar(comm, ';');
+	}
+	CommPutChar(comm, comm->sequence.terminator);
 }
\ No newline at end of file
@@ -1,170 +1,272 @@
-/**@file		serial_comm.h
- * @brief		Header file which creates an abstraction layer for any USART module on an enhanced mid-range PIC microcontroller
- * @author		Jonathan Ruisi
- * @version		1.0
- * @date		February 14, 2017
- * @copyright	GNU Public License
- */
-
-#ifndef SERIAL_COMM_H
-#define SERIAL_COMM_H
-
-#include "utility.h"
-#include "buffer.h"
-#include "linked_list.h"
-
-// MACROS (Calculates SPBRG values for USART baud rate generator)--------------
-/**@def CALCULATE_BRG(rate)
- * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
- * BRG16 = 0, BRGH = 0
- */
-#define CALCULATE_BRG(rate)		((FOSC/rate)/64)-1
-
-/**@def CALCULATE_BRG(rate)
- * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
- * BRG16 = 0, BRGH = 1
- */
-#define CALCULATE_BRG_H(rate)	((FOSC/rate)/16)-1	// BRG16 = 0, BRGH = 1
-
-/**@def CALCULATE_BRG(rate)
- * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
- * BRG16 = 1, BRGH = 0
- */
-#define CALCULATE_BRG_16(rate)	((FOSC/rate)/16)-1	// BRG16 = 1, BRGH = 0
-
-/**@def CALCULATE_BRG(rate)
- * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
- * BRG16 = 1, BRGH = 1
- */
-#define CALCULATE_BRG_16H(rate)	((FOSC/rate)/4)-1	// BRG16 = 1, BRGH = 1
-
-// DEFINITIONS-----------------------------------------------------------------
-#define XOFF_THRESHOLD	(3 * RX_BUFFER_SIZE) / 4	/**< Software flow control: Determines how full the RX buffer must be before an XOFF character is transmitted, pausing transmission */
-#define XON_THRESHOLD	RX_BUFFER_SIZE / 4			/**< Software flow control: Determines how full the RX buffer must be before an XON character is transmitted, resuming transmission */
-#define SEQ_MAX_PARAMS	8							/**< Sets the maximum parameters that can be present in an ANSI control sequence */
-
-// ENUMERATED TYPES------------------------------------------------------------
-
-/**@enum NewlineFlags
- * Defines the contents of a newline
- */
-typedef enum
-{
-	NEWLINE_CR		= 1,	/**< Carriage return only */
-	NEWLINE_LF		= 2,	/**< Line feed only */
-	NEWLINE_CRLF	= 3		/**< Carriage return and line feed */
-} NewlineFlags;
-
-// TYPE DEFINITIONS------------------------------------------------------------
-
-/**@struct CommDataRegisters
- * Structure which provides hardware-specific mappings to USART registers.
- * This allows the abstraction layer to work with any enhanced mid-range PIC microcontroller.
- */
-typedef struct CommDataRegisters
-{
-	unsigned char volatile* const pTxReg;
-	TXSTAbits_t volatile* const pTxSta;
-	unsigned char volatile* const pPie;
-	unsigned char const txieBit;
-} CommDataRegisters;
-
-/**@struct CommPort
- * Structure which contains all necessary elements for control and communication with a USART module
- * @see NewlineFlags
- * @see CommDataRegisters
- * @see RingBuffer
- * @see Buffer
- * @see Point
- */
-typedef struct CommPort
-{
-
-	union
-	{
-
-		struct
-		{
-			unsigned isTxFlowControl : 1;	/**< Enables/disables TX software flow control */
-			unsigned isRxFlowControl : 1;	/**< Enables/disables RX software flow control */
-			unsigned isTxPaused : 1;		/**< Indicates that TX has been paused by software flow control */
-			unsigned isRxPaused : 1;		/**< Indicates that RX has been paused by software flow control */
-			unsigned hasLine : 1;			/**< Indicates that a new line has been received */
-			unsigned hasSequence : 1;		/**< Indicates that an ANSI control sequence has been received */
-			unsigned : 2;
-		} statusBits;
-		unsigned char status;
-	} ;
-
-	union
-	{
-
-		struct
-		{
-			unsigned echoRx : 1;			/**< Determines whether or not received characters are echoed */
-			unsigned echoNewline : 1;		/**< Determines whether or not received newlines are echoed */
-			unsigned echoSequence : 1;		/**< Determines whether or not received ANSI control sequences are echoed */
-			unsigned useExternalBuffer : 1;	/**< Determines whether or not to use an external SRAM buffer to store received lines */
-			unsigned ignoreRx : 1;			/**< Temporarily disables RX */
-			unsigned isBinaryMode : 1;		/**< If set, all received data is treated as binary (all newlines and control sequences are ignored) */
-			unsigned : 2;
-		} modeBits;
-		unsigned char mode;
-	} ;
-
-	struct
-	{
-		NewlineFlags rx;					/**< Defines the newline character(s) for RX */
-		NewlineFlags tx;					/**< Defines the newline character(s) for TX */
-		NewlineFlags inProgress;			/**< Internal use, DO NOT MODIFY */
-	} newline;
-
-	struct
-	{
-
-		union
-		{
-
-			struct
-			{
-				unsigned csiCharCount : 2;		/**< Internal use, DO NOT MODIFY */
-				unsigned sequenceId : 6;		/**< Internal use, DO NOT MODIFY */
-			} statusBits;
-			unsigned char status;				/**< Internal use, DO NOT MODIFY */
-		} ;
-		unsigned char paramCount;				/**< The number of parameters in the parameter list for an ANSI control sequence */
-		unsigned char params[SEQ_MAX_PARAMS];	/**< A list of parameters for an ANSI control sequence */
-		unsigned char terminator;				/**< Defines the terminating character of an ANSI control sequence */
-	} sequence;
-
-	struct
-	{
-		volatile RingBuffer tx;					/**< TX FIFO buffer */
-		volatile RingBuffer rx;					/**< RX FIFO buffer */
-		Buffer line;							/**< Line buffer */
-		RingBuffer external;					/**< FIFO buffer mapped to external SRAM */
-	} buffers;
-
-	Point cursor;								/**< Current location of the terminal cursor */
-	const CommDataRegisters* registers;			/**< Pointer to a <b>CommDataRegisters</b> structure */
-} CommPort;
-
-// FUNCTION PROTOTYPES---------------------------------------------------------
-void CommPortInitialize(CommPort* comm,
-						unsigned int txBufferSize, unsigned int rxBufferSize, unsigned int lineBufferSize,
-						char* txData, char* rxData, char* lineData,
-						const unsigned short long int* lineQueueBaseAddress, unsigned int lineQueueSize,
-						NewlineFlags txNewline, NewlineFlags rxNewline,
-						const CommDataRegisters* registers,
-						bool enableFlowControl, bool enableEcho,
-						unsigned char echoRow, unsigned char echoColumn);
-void UpdateCommPort(CommPort* comm);
-void CommFlushLineBuffer(CommPort* comm);
-void CommResetSequence(CommPort* comm);
-void CommPutChar(CommPort* comm, char data);
-void CommPutString(CommPort* comm, const char* str);
-void CommPutSubString(CommPort* comm, const char* str, unsigned int startIndex, unsigned int length);
-void CommPutNewline(CommPort* comm);
-void CommPutSequence(CommPort* comm, unsigned char terminator, unsigned char paramCount, ...);
-
+/**@file		serial_comm.h
+ * @brief		Header file which creates an abstraction layer for any USART module on an enhanced mid-range PIC microcontroller
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		February 14, 2017
+ * @copyright	GNU Public License
+ */
+
+#ifndef SERIAL_COMM_H
+#define SERIAL_COMM_H
+
+#include "utility.h"
+#include "buffer.h"
+#include "linked_list.h"
+
+// MACROS (Calculates SPBRG values for USART baud rate generator)--------------
+/**@def CALCULATE_BRG(rate)
+ * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
+ * BRG16 = 0, BRGH = 0
+ */
+#define CALCULATE_BRG(rate)		((FOSC/rate)/64)-1
+
+/**@def CALCULATE_BRG(rate)
+ * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
+ * BRG16 = 0, BRGH = 1
+ */
+#define CALCULATE_BRG_H(rate)	((FOSC/rate)/16)-1	// BRG16 = 0, BRGH = 1
+
+/**@def CALCULATE_BRG(rate)
+ * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
+ * BRG16 = 1, BRGH = 0
+ */
+#define CALCULATE_BRG_16(rate)	((FOSC/rate)/16)-1	// BRG16 = 1, BRGH = 0
+
+/**@def CALCULATE_BRG(rate)
+ * Calculates the BRG value to be loaded into (SPBRGHx:SPBRGx) based on the desired baud rate (\a rate).
+ * BRG16 = 1, BRGH = 1
+ */
+#define CALCULATE_BRG_16H(rate)	((FOSC/rate)/4)-1	// BRG16 = 1, BRGH = 1
+
+/**@def BAUD_ERROR_16H(rate)
+ * Calculates the error (in tenths of a percent, rounded down) of the baud rate generated from <code>CALCULATE_BRG_16H(rate)</code>.
+ * This can be evaluated by the preprocessor, so that baud rates can be checked against <code>BAUD_MAX_ERROR</code> at compile time.
+ */
+#define BAUD_ACTUAL_16H(rate)	(FOSC/(4*(CALCULATE_BRG_16H(rate)+1)))
+#define BAUD_ERROR_16H(rate)	(BAUD_ACTUAL_16H(rate) > (rate) \
+								? ((BAUD_ACTUAL_16H(rate) - (rate)) * 1000) / (rate) \
+								: (((rate) - BAUD_ACTUAL_16H(rate)) * 1000) / (rate))
+
+// DEFINITIONS-----------------------------------------------------------------
+#define BAUD_MAX_ERROR	15							/**< The maximum acceptable baud rate error (tenths of a percent) */
+#define XOFF_THRESHOLD	(3 * RX_BUFFER_SIZE) / 4	/**< Software flow control: Determines how full the RX buffer must be before an XOFF character is transmitted, pausing transmission */
+#define XON_THRESHOLD	RX_BUFFER_SIZE / 4			/**< Software flow control: Determines how full the RX buffer must be before an XON character is transmitted, resuming transmission */
+#define URGENT_BUFFER_SIZE	4						/**< The maximum number of characters waiting in the urgent TX lane (flow control and urgent replies) */
+#define SEQ_MAX_PARAMS	8							/**< Sets the maximum parameters that can be present in an ANSI control sequence */
+#define ECHO_RESERVE	32							/**< TX buffer space needed to echo the effects of one received character (two newline echoes, worst case) */
+#define RX_BUDGET		64							/**< The maximum number of received characters processed by one call to UpdateCommPort */
+#define RX_LINE_SLOTS	8							/**< The maximum number of complete lines that the RX interrupt can index in the RX buffer */
+#define PAYLOAD_SLOTS	4							/**< The maximum number of received +IPD payloads waiting to be handled */
+#define IPD_PREFIX		"+IPD,"						/**< Start of the header which precedes data received by the ESP8266 */
+#define IPD_PREFIX_LENGTH	5
+#define SEND_PROMPT		'>'							/**< Prompt which the ESP8266 sends (at the start of a line) when it is ready for AT+CIPSEND data */
+
+// ENUMERATED TYPES------------------------------------------------------------
+
+/**@enum NewlineFlags
+ * Defines the contents of a newline
+ */
+typedef enum
+{
+	NEWLINE_CR		= 1,	/**< Carriage return only */
+	NEWLINE_LF		= 2,	/**< Line feed only */
+	NEWLINE_CRLF	= 3		/**< Carriage return and line feed */
+} NewlineFlags;
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct PayloadQueue
+ * Structure which describes a region of external SRAM in which ESP8266 +IPD payloads are stored as they are received.
+ * Each payload is stored contiguously, and is described by a <b>FileDescriptor</b> once it is complete.
+ * @see FileDescriptor
+ */
+typedef struct PayloadQueue
+{
+	FileDescriptor files[PAYLOAD_SLOTS];	/**< Complete payloads (oldest first) */
+	unsigned char count;					/**< Number of complete payloads */
+	unsigned char head;						/**< Internal use, DO NOT MODIFY */
+	unsigned char tail;						/**< Internal use, DO NOT MODIFY */
+	unsigned short long int baseAddress;	/**< SRAM address of the region */
+	unsigned short long int size;			/**< Size (bytes) of the region */
+	unsigned short long int nextAddress;	/**< Internal use, DO NOT MODIFY */
+	FileDescriptor current;					/**< The payload which is being received */
+	unsigned int remaining;					/**< Number of payload bytes still to be received */
+	bool isDiscarding;						/**< Indicates that the current payload is being discarded (there was no room to store it) */
+	unsigned long int dropped;				/**< Number of payloads which were discarded */
+} PayloadQueue;
+
+/**@struct CommDataRegisters
+ * Structure which provides hardware-specific mappings to USART registers.
+ * This allows the abstraction layer to work with any enhanced mid-range PIC microcontroller.
+ */
+typedef struct CommDataRegisters
+{
+	unsigned char volatile* const pTxReg;
+	TXSTAbits_t volatile* const pTxSta;
+	unsigned char volatile* const pPie;
+	unsigned char const txieBit;
+	unsigned char const rcieBit;
+} CommDataRegisters;
+
+/**@struct CommPort
+ * Structure which contains all necessary elements for control and communication with a USART module
+ * @see NewlineFlags
+ * @see CommDataRegisters
+ * @see RingBuffer
+ * @see Buffer
+ * @see Point
+ */
+typedef struct CommPort
+{
+
+	union
+	{
+
+		struct
+		{
+			unsigned isTxFlowControl : 1;	/**< Enables/disables TX software flow control */
+			unsigned isRxFlowControl : 1;	/**< Enables/disables RX software flow control */
+			unsigned isTxPaused : 1;		/**< Indicates that TX has been paused by software flow control */
+			unsigned isRxPaused : 1;		/**< Indicates that RX has been paused by software flow control */
+			unsigned hasLine : 1;			/**< Indicates that a new line has been received */
+			unsigned hasSequence : 1;		/**< Indicates that an ANSI control sequence has been received */
+			unsigned : 2;
+		} statusBits;
+		unsigned char status;
+	} ;
+
+	union
+	{
+
+		struct
+		{
+			unsigned echoRx : 1;			/**< Determines whether or not received characters are echoed */
+			unsigned echoNewline : 1;		/**< Determines whether or not received newlines are echoed */
+			unsigned echoSequence : 1;		/**< Determines whether or not received ANSI control sequences are echoed */
+			unsigned useExternalBuffer : 1;	/**< Determines whether or not to use an external SRAM buffer to store received lines */
+			unsigned ignoreRx : 1;			/**< Temporarily disables RX */
+			unsigned isBinaryMode : 1;		/**< If set, all received data is treated as binary (all newlines and control sequences are ignored) */
+			unsigned : 2;
+		} modeBits;
+		unsigned char mode;
+	} ;
+
+	struct
+	{
+		NewlineFlags rx;					/**< Defines the newline character(s) for RX */
+		NewlineFlags tx;					/**< Defines the newline character(s) for TX */
+		NewlineFlags inProgress;			/**< Internal use, DO NOT MODIFY */
+	} newline;
+
+	struct
+	{
+
+		union
+		{
+
+			struct
+			{
+				unsigned state : 2;				/**< Internal use, DO NOT MODIFY */
+				unsigned sequenceId : 6;		/**< Internal use, DO NOT MODIFY */
+			} statusBits;
+			unsigned char status;				/**< Internal use, DO NOT MODIFY */
+		} ;
+		unsigned char paramCount;				/**< The number of parameters in the parameter list for an ANSI control sequence */
+		unsigned char params[SEQ_MAX_PARAMS];	/**< A list of parameters for an ANSI control sequence */
+		unsigned char terminator;				/**< Defines the terminating character of an ANSI control sequence */
+	} sequence;
+
+	struct
+	{
+		volatile RingBuffer tx;					/**< TX FIFO buffer */
+		volatile RingBuffer rx;					/**< RX FIFO buffer */
+		Buffer line;							/**< Line buffer */
+		RingBuffer external;					/**< FIFO buffer mapped to external SRAM */
+	} buffers;
+
+	struct
+	{
+		volatile char data[URGENT_BUFFER_SIZE];	/**< Characters which are sent ahead of the TX buffer */
+		volatile unsigned char length;			/**< Number of characters waiting */
+		volatile unsigned char head;			/**< Internal use, DO NOT MODIFY */
+		volatile unsigned char tail;			/**< Internal use, DO NOT MODIFY */
+	} urgent;
+
+	struct
+	{
+		unsigned long int deferred;				/**< Characters whose output was postponed because the TX buffer was full (counted once per attempt) */
+		unsigned long int dropped;				/**< Characters which were discarded because the TX buffer was full */
+	} txCounters;
+
+	struct
+	{
+		volatile unsigned long int overrun;		/**< Times the USART receiver overran (the characters received while its FIFO was full were lost) */
+		volatile unsigned long int framing;		/**< Characters which were discarded because they were received with a framing error */
+		unsigned long int dropped;				/**< Lines which were discarded because they could not be written to the line queue in external RAM */
+	} rxCounters;
+
+	struct
+	{
+		volatile unsigned int end[RX_LINE_SLOTS];	/**< RX buffer index following the newline of each complete line (written by the RX interrupt) */
+		volatile unsigned char count;				/**< Number of complete lines in the RX buffer */
+		volatile unsigned char head;				/**< Internal use, DO NOT MODIFY */
+		unsigned char tail;							/**< Internal use, DO NOT MODIFY */
+		volatile NewlineFlags inProgress;			/**< Internal use, DO NOT MODIFY */
+		volatile bool isOverflow;					/**< Indicates that a complete line could not be indexed (the RX buffer is then processed without framing until it is empty) */
+		unsigned char ipdMatch;						/**< Internal use, DO NOT MODIFY */
+		unsigned int ipdLength;						/**< Internal use, DO NOT MODIFY */
+		volatile unsigned int payload;				/**< Number of +IPD payload characters still to be received (these are not framed) */
+		volatile bool isLineStart;					/**< Internal use, DO NOT MODIFY */
+		volatile bool isPrompt;						/**< Indicates that <code>SEND_PROMPT</code> has been received (set by the RX interrupt, cleared by the consumer) */
+		volatile unsigned long int overrun;			/**< Characters which were discarded because the RX buffer was full */
+	} rxLines;
+
+	PayloadQueue* payloads;						/**< Pointer to a <b>PayloadQueue</b> (NULL if +IPD frames are not expected on this port) */
+	Point cursor;								/**< Current location of the terminal cursor */
+	const CommDataRegisters* registers;			/**< Pointer to a <b>CommDataRegisters</b> structure */
+} CommPort;
+
+/**@struct StoredSequence
+ * A pre-rendered ANSI control sequence (including ESC and CSI), stored in program memory.
+ * Used for sequences whose parameters are known at compile time.
+ * @see CommPutStoredSequence
+ */
+typedef struct StoredSequence
+{
+	const char* data;		/**< Sequence characters (not null-terminated in the output) */
+	unsigned char length;	/**< Number of characters in the sequence */
+} StoredSequence;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+void CommPortInitialize(CommPort* comm,
+						unsigned int txBufferSize, unsigned int rxBufferSize, unsigned int lineBufferSize,
+						char* txData, char* rxData, char* lineData,
+						const unsigned short long int* lineQueueBaseAddress, unsigned int lineQueueSize,
+						NewlineFlags txNewline, NewlineFlags rxNewline,
+						const CommDataRegisters* registers,
+						bool enableFlowControl, bool enableEcho,
+						unsigned char echoRow, unsigned char echoColumn);
+void UpdateCommPort(CommPort* comm);
+void _CommReceive(CommPort* comm, char data);
+void _CommTransmit(CommPort* comm);
+bool _CommPutUrgent(CommPort* comm, char data);
+void CommPayloadQueueInitialize(CommPort* comm, PayloadQueue* queue,
+								unsigned short long int baseAddress, unsigned short long int size);
+const FileDescriptor* CommPeekPayload(CommPort* comm);
+void CommReleasePayload(CommPort* comm);
+void CommResetPayload(CommPort* comm);
+void CommFlushLineBuffer(CommPort* comm);
+void CommResetSequence(CommPort* comm);
+bool CommReserve(CommPort* comm, unsigned int count);
+void CommCommit(CommPort* comm, unsigned int count);
+unsigned int CommWrite(CommPort* comm, const char* data, unsigned int length);
+bool CommPutChar(CommPort* comm, char data);
+bool CommPutUrgent(CommPort* comm, char data);
+void CommPutString(CommPort* comm, const char* str);
+void CommPutSubString(CommPort* comm, const char* str, unsigned int startIndex, unsigned int length);
+void CommPutNewline(CommPort* comm);
+bool CommPutLine(CommPort* comm, const char* const* parts, unsigned char count, unsigned int* progress);
+void CommPutSequence(CommPort* comm, unsigned char terminator, unsigned char paramCount, ...);
+bool CommPutStoredSequence(CommPort* comm, const StoredSequence* sequence);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,369 @@
+/**@file		telemetry.c
+ * @brief		Implementation of the binary status frame encoder and decoder
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "telemetry.h"
+
+// CONSTANTS-------------------------------------------------------------------
+static const uint16_t _crc16Table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+// A record body of up to 254 bytes is encoded with a single COBS code byte (see TELEMETRY_MAX_RECORD_SIZE)
+#if TELEMETRY_MAX_BODY_SIZE > 254
+#error "TELEMETRY_MAX_BODY_SIZE is too large for TELEMETRY_MAX_RECORD_SIZE"
+#endif
+
+static uint8_t* TelemetryPutField(uint8_t* p, uint8_t tag, uint32_t value, uint8_t length);
+static uint32_t TelemetryGetField(const uint8_t* p, uint8_t length, bool isSigned);
+
+// CRC FUNCTIONS---------------------------------------------------------------
+
+/**
+ * Updates a CRC-16/CCITT-FALSE checksum (polynomial 0x1021, MSB first) using a lookup table
+ * @param crc		Current checksum (0xFFFF to start a new checksum)
+ * @param data		Pointer to the data
+ * @param length	Number of bytes
+ * @return			Updated checksum
+ */
+uint16_t TelemetryCrc16(uint16_t crc, const uint8_t* data, uint16_t length)
+{
+	while(length--)
+		crc = (uint16_t) (crc << 8) ^ _crc16Table[(uint8_t) (crc >> 8) ^ *data++];
+	return crc;
+}
+
+// FRAME FUNCTIONS-------------------------------------------------------------
+
+/**
+ * Encodes a status frame
+ * @param status	Pointer to the status to be encoded
+ * @param frame		Destination (must hold at least <code>TELEMETRY_MAX_FRAME_SIZE</code> bytes)
+ * @return			Size of the frame (bytes)
+ */
+uint8_t TelemetryEncodeStatus(const TelemetryStatus* status, uint8_t* frame)
+{
+	uint8_t* p = frame;
+	*p++ = TELEMETRY_SYNC;
+	*p++ = TELEMETRY_STATUS_SIZE;
+	*p++ = TELEMETRY_TYPE_STATUS;
+	*p++ = (uint8_t) status->uptime;
+	*p++ = (uint8_t) (status->uptime >> 8);
+	*p++ = (uint8_t) (status->uptime >> 16);
+	*p++ = (uint8_t) (status->uptime >> 24);
+	*p++ = (uint8_t) status->load;
+	*p++ = (uint8_t) (status->load >> 8);
+	*p++ = (uint8_t) status->proxCount;
+	*p++ = (uint8_t) (status->proxCount >> 8);
+	*p++ = status->relay;
+	*p++ = status->link;
+	*p++ = status->warning;
+	*p++ = status->error;
+
+	uint16_t crc = TelemetryCrc16(0xFFFF, frame + 1, TELEMETRY_STATUS_SIZE + 1);
+	*p++ = (uint8_t) crc;
+	*p++ = (uint8_t) (crc >> 8);
+	return (uint8_t) (p - frame);
+}
+
+/**
+ * Decodes a status frame from the start of a receive buffer.
+ * A receiver calls this function with the bytes it has collected:
+ * if the result is 0, it waits for more bytes; if the result is negative, it discards the first byte and retries;
+ * otherwise, it discards the number of bytes returned (one complete frame).
+ * @param data		Pointer to the received bytes
+ * @param length	Number of received bytes
+ * @param status	Pointer to a destination for the decoded status
+ * @return			Size of the frame if a valid status frame was decoded,
+ *					0 if more bytes are needed, or -1 if the data does not start with a valid status frame
+ */
+int16_t TelemetryDecodeStatus(const uint8_t* data, uint16_t length, TelemetryStatus* status)
+{
+	if(length < 1)
+		return 0;
+	if(data[0] != TELEMETRY_SYNC)
+		return -1;
+	if(length < TELEMETRY_HEADER_SIZE)
+		return 0;
+	if(data[1] != TELEMETRY_STATUS_SIZE)
+		return -1;
+
+	uint16_t frameSize = TELEMETRY_HEADER_SIZE + TELEMETRY_STATUS_SIZE + TELEMETRY_CRC_SIZE;
+	if(length < frameSize)
+		return 0;
+
+	uint16_t crc = TelemetryCrc16(0xFFFF, data + 1, TELEMETRY_STATUS_SIZE + 1);
+	if(data[frameSize - 2] != (uint8_t) crc
+	|| data[frameSize - 1] != (uint8_t) (crc >> 8)
+	|| data[2] != TELEMETRY_TYPE_STATUS)
+		return -1;
+
+	const uint8_t* p = data + 3;
+	status->uptime = (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+	status->load = (uint16_t) (p[4] | (p[5] << 8));
+	status->proxCount = (uint16_t) (p[6] | (p[7] << 8));
+	status->relay = p[8];
+	status->link = p[9];
+	status->warning = p[10];
+	status->error = p[11];
+	return (int16_t) frameSize;
+}
+
+// RECORD FUNCTIONS------------------------------------------------------------
+
+/**
+ * Encodes data with Consistent Overhead Byte Stuffing, so that the result contains no zero bytes.
+ * The result is one byte longer than the data, plus one byte for every 254 bytes of data.
+ * @param data		Pointer to the data
+ * @param length	Number of bytes
+ * @param dest		Destination (must not overlap the data)
+ * @return			Size of the encoded data (bytes)
+ */
+uint16_t TelemetryCobsEncode(const uint8_t* data, uint16_t length, uint8_t* dest)
+{
+	uint8_t* code = dest;
+	uint8_t* p = dest + 1;
+	uint8_t run = 1;
+	while(length--)
+	{
+		uint8_t byte = *data++;
+		if(byte != 0)
+		{
+			*p++ = byte;
+			if(++run < 0xFF)
+				continue;
+		}
+		*code = run;
+		code = p++;
+		run = 1;
+	}
+	*code = run;
+	return (uint16_t) (p - dest);
+}
+
+/**
+ * Decodes data encoded with <b>TelemetryCobsEncode</b> (without the delimiter)
+ * @param data		Pointer to the encoded data
+ * @param length	Number of bytes
+ * @param dest		Destination (must hold at least <code>length</code> bytes, and must not overlap the data)
+ * @return			Size of the decoded data (bytes), or -1 if the encoding is invalid
+ */
+int16_t TelemetryCobsDecode(const uint8_t* data, uint16_t length, uint8_t* dest)
+{
+	uint8_t* p = dest;
+	while(length)
+	{
+		uint8_t code = *data++;
+		length--;
+		if(code == 0 || code - 1 > length)
+			return -1;
+
+		uint8_t i;
+		for(i = 1; i < code; i++)
+		{
+			if(*data == 0)
+				return -1;
+			*p++ = *data++;
+		}
+		length -= code - 1;
+		if(code != 0xFF && length)
+			*p++ = 0;
+	}
+	return (int16_t) (p - dest);
+}
+
+/**
+ * Encodes an uplink record.
+ * Each reading is stored in the fewest bytes (1, 2, or 4) that hold its value.
+ * Readings beyond <code>TELEMETRY_MAX_READINGS</code> are not encoded.
+ * @param record	Pointer to the record to be encoded
+ * @param frame		Destination (must hold at least <code>TELEMETRY_MAX_RECORD_SIZE</code> bytes)
+ * @return			Size of the encoded record, including the delimiter (bytes)
+ */
+uint8_t TelemetryEncodeRecord(const TelemetryRecord* record, uint8_t* frame)
+{
+	uint8_t body[TELEMETRY_MAX_BODY_SIZE];
+	uint8_t* p = body;
+	uint8_t i;
+
+	*p++ = TELEMETRY_TAG_ID;
+	*p++ = TELEMETRY_ID_SIZE;
+	for(i = 0; i < TELEMETRY_ID_SIZE; i++)
+		*p++ = (uint8_t) record->id[i];
+	p = TelemetryPutField(p, TELEMETRY_TAG_SEQUENCE, record->sequence, 2);
+	*p++ = TELEMETRY_TAG_TIME;
+	*p++ = TELEMETRY_TIME_SIZE;
+	for(i = 0; i < TELEMETRY_TIME_SIZE; i++)
+		*p++ = record->time[i];
+	p = TelemetryPutField(p, TELEMETRY_TAG_UPTIME, record->uptime, 4);
+
+	for(i = 0; i < record->readingCount && i < TELEMETRY_MAX_READINGS; i++)
+	{
+		int32_t value = record->readings[i].value;
+		uint8_t length = 4;
+		if(value >= -128 && value <= 127)
+			length = 1;
+		else if(value >= -32768L && value <= 32767L)
+			length = 2;
+		p = TelemetryPutField(p, record->readings[i].tag, (uint32_t) value, length);
+	}
+
+	uint16_t crc = TelemetryCrc16(0xFFFF, body, (uint16_t) (p - body));
+	*p++ = (uint8_t) crc;
+	*p++ = (uint8_t) (crc >> 8);
+
+	uint8_t length = (uint8_t) TelemetryCobsEncode(body, (uint16_t) (p - body), frame);
+	frame[length++] = TELEMETRY_DELIMITER;
+	return length;
+}
+
+/**
+ * Decodes an uplink record from the start of a receive buffer.
+ * A receiver calls this function with the bytes it has collected:
+ * if the result is 0, it waits for more bytes; if the result is negative, it discards that many bytes (up to the next delimiter);
+ * otherwise, it discards the number of bytes returned (one complete record).
+ * @param data		Pointer to the received bytes
+ * @param length	Number of received bytes
+ * @param record	Pointer to a destination for the decoded record
+ * @return			Size of the record (including the delimiter) if a valid record was decoded,
+ *					0 if more bytes are needed, or the negated number of bytes to discard if the data does not start with a valid record
+ */
+int16_t TelemetryDecodeRecord(const uint8_t* data, uint16_t length, TelemetryRecord* record)
+{
+	uint16_t end;
+	for(end = 0; end < length && data[end] != TELEMETRY_DELIMITER; end++)
+	{
+		if(end == TELEMETRY_MAX_RECORD_SIZE)
+			return -(int16_t) end;
+	}
+	if(end == length)
+		return 0;
+
+	int16_t frameSize = (int16_t) (end + 1);
+	uint8_t body[TELEMETRY_MAX_RECORD_SIZE];
+	int16_t bodySize = end < TELEMETRY_MAX_RECORD_SIZE ? TelemetryCobsDecode(data, end, body) : -1;
+	if(bodySize < TELEMETRY_CRC_SIZE)
+		return -frameSize;
+
+	bodySize -= TELEMETRY_CRC_SIZE;
+	uint16_t crc = TelemetryCrc16(0xFFFF, body, (uint16_t) bodySize);
+	if(body[bodySize] != (uint8_t) crc || body[bodySize + 1] != (uint8_t) (crc >> 8))
+		return -frameSize;
+
+	uint8_t i;
+	for(i = 0; i < TELEMETRY_ID_SIZE; i++)
+		record->id[i] = ' ';
+	for(i = 0; i < TELEMETRY_TIME_SIZE; i++)
+		record->time[i] = 0;
+	record->sequence = 0;
+	record->uptime = 0;
+	record->readingCount = 0;
+
+	int16_t offset = 0;
+	while(offset < bodySize)
+	{
+		if(offset + 2 > bodySize || offset + 2 + body[offset + 1] > bodySize)
+			return -frameSize;
+
+		uint8_t tag = body[offset];
+		uint8_t fieldSize = body[offset + 1];
+		const uint8_t* value = body + offset + 2;
+		offset += 2 + fieldSize;
+
+		if(tag == TELEMETRY_TAG_ID)
+		{
+			for(i = 0; i < TELEMETRY_ID_SIZE && i < fieldSize; i++)
+				record->id[i] = (char) value[i];
+		}
+		else if(tag == TELEMETRY_TAG_TIME && fieldSize == TELEMETRY_TIME_SIZE)
+		{
+			for(i = 0; i < TELEMETRY_TIME_SIZE; i++)
+				record->time[i] = value[i];
+		}
+		else if(tag == TELEMETRY_TAG_SEQUENCE && fieldSize == 2)
+			record->sequence = (uint16_t) TelemetryGetField(value, fieldSize, false);
+		else if(tag == TELEMETRY_TAG_UPTIME && fieldSize == 4)
+			record->uptime = TelemetryGetField(value, fieldSize, false);
+		else if(tag >= TELEMETRY_TAG_LOAD
+			 && (fieldSize == 1 || fieldSize == 2 || fieldSize == 4)
+			 && record->readingCount < TELEMETRY_MAX_READINGS)
+		{
+			record->readings[record->readingCount].tag = tag;
+			record->readings[record->readingCount].value = (int32_t) TelemetryGetField(value, fieldSize, true);
+			record->readingCount++;
+		}
+	}
+	return frameSize;
+}
+
+/**
+ * Writes a field with a little-endian integer value
+ * @param p			Destination
+ * @param tag		Field tag
+ * @param value		Field value
+ * @param length	Number of value bytes (1 to 4)
+ * @return			Pointer to the byte following the field
+ */
+static uint8_t* TelemetryPutField(uint8_t* p, uint8_t tag, uint32_t value, uint8_t length)
+{
+	*p++ = tag;
+	*p++ = length;
+	while(length--)
+	{
+		*p++ = (uint8_t) value;
+		value >>= 8;
+	}
+	return p;
+}
+
+/**
+ * Reads a little-endian integer field value
+ * @param p			Pointer to the value
+ * @param length	Number of value bytes (1 to 4)
+ * @param isSigned	Determines whether the value is sign-extended
+ * @return			Field value
+ */
+static uint32_t TelemetryGetField(const uint8_t* p, uint8_t length, bool isSigned)
+{
+	uint32_t value = (isSigned && (p[length - 1] & 0x80)) ? 0xFFFFFFFF : 0;
+	while(length--)
+		value = (value << 8) | p[length];
+	return value;
+}
@@ -0,0 +1,111 @@
+/**@file		telemetry.h
+ * @brief		Header file defining compact binary status frames, which replace the ANSI dashboard in headless mode,
+ *				and COBS-framed uplink records, which carry readings to the TCP server.
+ *				This module has no hardware dependencies, so the same encoder and decoder can be built for a host.
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		October 19, 2026
+ * @copyright	GNU Public License
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINITIONS-----------------------------------------------------------------
+// Frame layout: SYNC | LENGTH | TYPE | PAYLOAD... | CRC (low byte) | CRC (high byte)
+// LENGTH counts the TYPE and PAYLOAD bytes, the CRC covers LENGTH, TYPE, and PAYLOAD.
+// Multi-byte payload values are little-endian.
+#define TELEMETRY_SYNC				0xA5	/**< First byte of every frame */
+#define TELEMETRY_HEADER_SIZE		2		/**< SYNC and LENGTH */
+#define TELEMETRY_CRC_SIZE			2		/**< CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) */
+#define TELEMETRY_MAX_FRAME_SIZE	32		/**< Size of the largest frame */
+// Frame types
+#define TELEMETRY_TYPE_STATUS		1		/**< Device status (see TelemetryStatus) */
+#define TELEMETRY_STATUS_SIZE		13		/**< TYPE and PAYLOAD bytes of a status frame */
+// Link state bits
+#define TELEMETRY_LINK_SSID			0x01	/**< The wifi module is connected to a network */
+#define TELEMETRY_LINK_TCP_MASK		0x06	/**< TCP connection status (WIFI_TCP_CLOSED, WIFI_TCP_CONNECTING, WIFI_TCP_READY) */
+#define TELEMETRY_LINK_TCP_SHIFT	1
+
+// Uplink record layout: COBS(FIELD... | CRC (low byte) | CRC (high byte)) | DELIMITER
+// Each FIELD is TAG | LENGTH | VALUE, the CRC (CRC-16/CCITT-FALSE) covers all fields.
+// Fields with unknown tags are skipped by the decoder, so new tags can be added without breaking older servers.
+#define TELEMETRY_DELIMITER			0x00	/**< Last byte of every uplink record (COBS removes this value from the rest of the record) */
+#define TELEMETRY_ID_SIZE			8		/**< Length of the device ID (characters) */
+#define TELEMETRY_TIME_SIZE			6		/**< RTCC timestamp: year, month, day, hour, minute, second (BCD) */
+#define TELEMETRY_MAX_READINGS		8		/**< The maximum number of readings in one uplink record */
+#define TELEMETRY_MAX_BODY_SIZE		(2 + TELEMETRY_ID_SIZE + 4 + 2 + TELEMETRY_TIME_SIZE + 6 \
+									+ 6 * TELEMETRY_MAX_READINGS + TELEMETRY_CRC_SIZE)	/**< Size of the largest record before COBS encoding */
+#define TELEMETRY_MAX_RECORD_SIZE	(TELEMETRY_MAX_BODY_SIZE + 2)						/**< Size of the largest encoded record (one COBS code byte and the delimiter) */
+// Record tags
+#define TELEMETRY_TAG_ID			0x01	/**< Device ID (TELEMETRY_ID_SIZE characters) */
+#define TELEMETRY_TAG_SEQUENCE		0x02	/**< Record sequence number (16 bits), so that the server can discard duplicates and detect gaps */
+#define TELEMETRY_TAG_TIME			0x03	/**< RTCC timestamp (TELEMETRY_TIME_SIZE bytes) */
+#define TELEMETRY_TAG_UPTIME		0x04	/**< System time (milliseconds, 32 bits) */
+// Reading tags (signed values, 1, 2, or 4 bytes)
+#define TELEMETRY_TAG_LOAD			0x10	/**< RMS load (tenths of a watt) */
+#define TELEMETRY_TAG_PROX_COUNT	0x11	/**< Number of proximity detections */
+#define TELEMETRY_TAG_RELAY			0x12	/**< Relay state (0 = open, 1 = closed) */
+#define TELEMETRY_TAG_LINE_FREQ		0x13	/**< Line frequency (hundredths of a hertz) */
+#define TELEMETRY_TAG_ENERGY		0x14	/**< Energy since the meter was cleared (watt-hours) */
+#define TELEMETRY_TAG_ENERGY_DAY	0x15	/**< Energy used on the previous day (milliwatt-hours) */
+#define TELEMETRY_TAG_DISTORTION	0x16	/**< Total harmonic distortion of the load current (tenths of a percent) */
+#define TELEMETRY_TAG_HARMONIC3		0x17	/**< 3rd harmonic of the load current (tenths of a percent of the fundamental) */
+#define TELEMETRY_TAG_HARMONIC5		0x18	/**< 5th harmonic of the load current (tenths of a percent of the fundamental) */
+#define TELEMETRY_TAG_HARMONIC7		0x19	/**< 7th harmonic of the load current (tenths of a percent of the fundamental) */
+#define TELEMETRY_TAG_SAMPLE_RATE	0x1A	/**< Rate at which the current sensor is sampled (hundredths of a hertz) */
+#define TELEMETRY_TAG_CAPTURE		0x1B	/**< Transient capture: sample of the largest magnitude (ADC steps from the DC offset), followed by its samples */
+#define TELEMETRY_TAG_CAPTURE_DATA	0x1C	/**< Two samples of the most recent transient capture: pair index (bits 31-26), then each sample (13-bit two's complement, bits 25-13 and 12-0) */
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct TelemetryStatus
+ * Contents of a status frame
+ */
+typedef struct TelemetryStatus
+{
+	uint32_t uptime;		/**< System time (milliseconds) */
+	uint16_t load;			/**< RMS load (tenths of a watt) */
+	uint16_t proxCount;		/**< Number of proximity detections */
+	uint8_t relay;			/**< Relay state (0 = open, 1 = closed) */
+	uint8_t link;			/**< Link state bits */
+	uint8_t warning;		/**< Most recent warning code (0 = none) */
+	uint8_t error;			/**< Most recent error code (0 = none) */
+} TelemetryStatus;
+
+/**@struct TelemetryReading
+ * A single typed reading
+ */
+typedef struct TelemetryReading
+{
+	uint8_t tag;			/**< Reading type (TELEMETRY_TAG_LOAD, TELEMETRY_TAG_PROX_COUNT, ...) */
+	int32_t value;			/**< Reading value (the unit depends on the type) */
+} TelemetryReading;
+
+/**@struct TelemetryRecord
+ * Contents of an uplink record
+ * @see TelemetryReading
+ */
+typedef struct TelemetryRecord
+{
+	char id[TELEMETRY_ID_SIZE];							/**< Device ID (not null-terminated) */
+	uint16_t sequence;									/**< Record sequence number */
+	uint8_t time[TELEMETRY_TIME_SIZE];					/**< RTCC timestamp */
+	uint32_t uptime;									/**< System time (milliseconds) */
+	uint8_t readingCount;								/**< Number of readings */
+	TelemetryReading readings[TELEMETRY_MAX_READINGS];	/**< Readings */
+} TelemetryRecord;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+uint16_t TelemetryCrc16(uint16_t crc, const uint8_t* data, uint16_t length);
+uint8_t TelemetryEncodeStatus(const TelemetryStatus* status, uint8_t* frame);
+int16_t TelemetryDecodeStatus(const uint8_t* data, uint16_t length, TelemetryStatus* status);
+uint16_t TelemetryCobsEncode(const uint8_t* data, uint16_t length, uint8_t* dest);
+int16_t TelemetryCobsDecode(const uint8_t* data, uint16_t length, uint8_t* dest);
+uint8_t TelemetryEncodeRecord(const TelemetryRecord* record, uint8_t* frame);
+int16_t TelemetryDecodeRecord(const uint8_t* data, uint16_t length, TelemetryRecord* record);
+
+#endif
@@ -1,80 +1,801 @@
-/* Project:	SmartModule
- * File:	wifi.c
- * Author:	Jonathan Ruisi
- * Created:	February 14, 2017, 7:55 AM
- */
-
-#include <xc.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include "wifi.h"
-#include "main.h"
-#include "system.h"
-#include "serial_comm.h"
-#include "utility.h"
-
-// FUNCTIONS-------------------------------------------------------------------
-
-void UpdateWifi(void)
-{
-	if((_wifi.statusBits.boot == WIFI_BOOT_POWER_ON_RESET_HOLD) && (_tick - _wifi.eventTime > 2000))
-	{
-		_wifi.statusBits.resetMode = WIFI_RESET_RELEASE;
-		WifiReset();
-	}
-	else if(_wifi.statusBits.boot >= WIFI_BOOT_RESET_RELEASE && _wifi.statusBits.boot < WIFI_BOOT_COMPLETE)
-		WifiHandleBoot();
-}
-
-void WifiReset(void)
-{
-	WIFI_RST = 0;
-	_wifi.statusBits.isSsidConnected = false;
-	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
-	if(_wifi.statusBits.resetMode == WIFI_RESET_HOLD || _wifi.statusBits.resetMode == WIFI_RESET_RESTART)
-	{
-		RCSTA1bits.SPEN	= false;
-		SPBRGH1	= GET_BYTE(CALCULATE_BRG_16H(76800), 1);
-		SPBRG1	= GET_BYTE(CALCULATE_BRG_16H(76800), 0);
-		_wifi.statusBits.boot = WIFI_BOOT_RESET_HOLD;
-		return;
-	}
-
-	RCSTA1bits.SPEN	= true;
-	_comm1.modeBits.ignoreRx = true;
-	_comm1.modeBits.useExternalBuffer = false;
-	_wifi.statusBits.boot = WIFI_BOOT_RESET_RELEASE;
-	_wifi.eventTime = _tick;
-	WIFI_RST = 1;
-}
-
-void WifiHandleBoot(void)
-{
-	if(_wifi.statusBits.boot == WIFI_BOOT_RESET_RELEASE && (_tick - _wifi.eventTime > 100))
-	{
-		_wifi.statusBits.boot = WIFI_BOOT_SELFCHECK;
-		_wifi.eventTime = _tick;
-	}
-	else if(_wifi.statusBits.boot == WIFI_BOOT_SELFCHECK)
-	{
-		RCSTA1bits.SPEN	= false;
-		SPBRGH1	= GET_BYTE(CALCULATE_BRG_16H(115200), 1);
-		SPBRG1	= GET_BYTE(CALCULATE_BRG_16H(115200), 0);
-		RCSTA1bits.SPEN	= true;
-		_comm1.modeBits.ignoreRx = false;
-		_wifi.statusBits.boot = WIFI_BOOT_INITIALIZING;
-		_wifi.eventTime = _tick;
-	}
-	else if(_wifi.statusBits.boot == WIFI_BOOT_INITIALIZING && _comm1.statusBits.hasLine)
-	{
-		if(BufferContains(&_comm1.buffers.line, "ready", 5) >= 0)
-		{
-			_wifi.statusBits.boot = WIFI_BOOT_COMPLETE;
-			CommPutString(&_comm1, "ATE0");
-			CommPutNewline(&_comm1);
-			_comm1.modeBits.useExternalBuffer = true;
-		}
-		_comm1.buffers.line.length = 0;
-		_comm1.statusBits.hasLine = false;
-	}
+/* Project:	SmartModule
+ * File:	wifi.c
+ * Author:	Jonathan Ruisi
+ * Created:	February 14, 2017, 7:55 AM
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "wifi.h"
+#include "main.h"
+#include "system.h"
+#include "serial_comm.h"
+#include "format.h"
+#include "sram.h"
+#include "utility.h"
+
+// LINK SPEEDS-----------------------------------------------------------------
+// Every link speed must be generated accurately from FOSC (BRG16 = 1, BRGH = 1)
+#if BAUD_ERROR_16H(WIFI_BAUD_BOOT) > BAUD_MAX_ERROR
+#error "WIFI_BAUD_BOOT cannot be generated accurately from FOSC"
+#endif
+#if BAUD_ERROR_16H(WIFI_LINK_RATE0) > BAUD_MAX_ERROR
+#error "WIFI_LINK_RATE0 cannot be generated accurately from FOSC"
+#endif
+#if BAUD_ERROR_16H(WIFI_LINK_RATE1) > BAUD_MAX_ERROR
+#error "WIFI_LINK_RATE1 cannot be generated accurately from FOSC"
+#endif
+#if BAUD_ERROR_16H(WIFI_LINK_RATE2) > BAUD_MAX_ERROR
+#error "WIFI_LINK_RATE2 cannot be generated accurately from FOSC"
+#endif
+#if BAUD_ERROR_16H(WIFI_LINK_RATE3) > BAUD_MAX_ERROR
+#error "WIFI_LINK_RATE3 cannot be generated accurately from FOSC"
+#endif
+// Every negotiated link speed must leave the RX interrupt enough time to empty the USART FIFO
+#if (WIFI_LINK_RATES > 1 && WIFI_RX_DEADLINE(WIFI_LINK_RATE1) < WIFI_RX_LATENCY) \
+ || (WIFI_LINK_RATES > 2 && WIFI_RX_DEADLINE(WIFI_LINK_RATE2) < WIFI_RX_LATENCY) \
+ || (WIFI_LINK_RATES > 3 && WIFI_RX_DEADLINE(WIFI_LINK_RATE3) < WIFI_RX_LATENCY)
+#error "WIFI_LINK_RATES includes a link speed at which USART1 overruns during the worst-case interrupt latency"
+#endif
+
+static const unsigned long int _linkRates[] = {
+	WIFI_LINK_RATE0, WIFI_LINK_RATE1, WIFI_LINK_RATE2, WIFI_LINK_RATE3
+};
+static const unsigned int _linkBrg[] = {
+	CALCULATE_BRG_16H(WIFI_LINK_RATE0), CALCULATE_BRG_16H(WIFI_LINK_RATE1),
+	CALCULATE_BRG_16H(WIFI_LINK_RATE2), CALCULATE_BRG_16H(WIFI_LINK_RATE3)
+};
+
+static void WifiSetBrg(unsigned int brg);
+static void WifiStartCommand(const WifiCommand* command);
+static void WifiCompleteCommand(unsigned char response);
+static unsigned char WifiParseResponse(Buffer* line);
+static bool WifiCloseBatch(void);
+static unsigned short long int WifiBatchAddress(unsigned char batch);
+static bool WifiWriteMode(void);
+static bool WifiWriteStream(void);
+static bool WifiWriteBatch(void);
+static void WifiModeDone(unsigned char response);
+static void WifiStreamDone(unsigned char response);
+static void WifiBatchDone(unsigned char response);
+
+// UPLINK COMMANDS-------------------------------------------------------------
+static const WifiCommand _modeCommand = {
+	WifiWriteMode, NULL, WifiModeDone, WIFI_COMMAND_TIMEOUT, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR
+};
+static const WifiCommand _streamCommand = {
+	WifiWriteStream, NULL, WifiStreamDone, WIFI_COMMAND_TIMEOUT, WIFI_RESPONSE_OK | WIFI_RESPONSE_ERROR
+};
+// The OK which precedes the prompt is an intermediate line: the command completes once the batch has been sent
+static const WifiCommand _batchCommand = {
+	WifiWriteBatch, NULL, WifiBatchDone, 2 * WIFI_UPLINK_TIMEOUT,
+	WIFI_RESPONSE_SEND_OK | WIFI_RESPONSE_SEND_FAIL | WIFI_RESPONSE_ERROR
+};
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void UpdateWifi(void)
+{
+	if((_wifi.statusBits.boot == WIFI_BOOT_POWER_ON_RESET_HOLD) && (_tick - _wifi.eventTime > 2000))
+	{
+		_wifi.statusBits.resetMode = WIFI_RESET_RELEASE;
+		WifiReset();
+	}
+	else if(_wifi.statusBits.boot == WIFI_BOOT_NEGOTIATING)
+		WifiNegotiateLink();
+	else if(_wifi.statusBits.boot == WIFI_BOOT_COMPLETE)
+	{
+		WifiUpdateCommands();
+		WifiUpdateUplink();
+	}
+	else if(_wifi.statusBits.boot >= WIFI_BOOT_RESET_RELEASE && _wifi.statusBits.boot < WIFI_BOOT_COMPLETE)
+		WifiHandleBoot();
+}
+
+void WifiReset(void)
+{
+	WIFI_RST = 0;
+	_wifi.statusBits.isSsidConnected = false;
+	_wifi.statusBits.tcpConnectionStatus = WIFI_TCP_CLOSED;
+	if(_wifi.statusBits.resetMode == WIFI_RESET_HOLD || _wifi.statusBits.resetMode == WIFI_RESET_RESTART)
+	{
+		RCSTA1bits.SPEN	= false;
+		SPBRGH1	= GET_BYTE(CALCULATE_BRG_16H(WIFI_BAUD_BOOT), 1);
+		SPBRG1	= GET_BYTE(CALCULATE_BRG_16H(WIFI_BAUD_BOOT), 0);
+		_wifi.statusBits.boot = WIFI_BOOT_RESET_HOLD;
+		return;
+	}
+
+	RCSTA1bits.SPEN	= true;
+	_comm1.modeBits.ignoreRx = true;
+	CommResetPayload(&_comm1);
+	_comm1.modeBits.useExternalBuffer = false;
+	_wifi.link.rate = 0;
+	_wifi.command.head = 0;
+	_wifi.command.count = 0;
+	_wifi.command.current = NULL;
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+	_wifi.uplink.isPassthrough = false;
+	_wifi.uplink.isPassthroughFailed = false;
+	_wifi.statusBits.boot = WIFI_BOOT_RESET_RELEASE;
+	_wifi.eventTime = _tick;
+	WIFI_RST = 1;
+}
+
+void WifiHandleBoot(void)
+{
+	if(_wifi.statusBits.boot == WIFI_BOOT_RESET_RELEASE && (_tick - _wifi.eventTime > 100))
+	{
+		_wifi.statusBits.boot = WIFI_BOOT_SELFCHECK;
+		_wifi.eventTime = _tick;
+	}
+	else if(_wifi.statusBits.boot == WIFI_BOOT_SELFCHECK)
+	{
+		WifiSetBrg(_linkBrg[0]);
+		_comm1.modeBits.ignoreRx = false;
+		_wifi.statusBits.boot = WIFI_BOOT_INITIALIZING;
+		_wifi.eventTime = _tick;
+	}
+	else if(_wifi.statusBits.boot == WIFI_BOOT_INITIALIZING && (_tick - _wifi.eventTime > WIFI_BOOT_TIMEOUT))
+	{
+		// The module never reported "ready"
+		WifiRestart();
+	}
+	else if(_wifi.statusBits.boot == WIFI_BOOT_INITIALIZING && _comm1.statusBits.hasLine)
+	{
+		if(BufferContains(&_comm1.buffers.line, "ready", 5) >= 0)
+		{
+			_wifi.statusBits.boot = WIFI_BOOT_NEGOTIATING;
+			_wifi.link.step = WIFI_LINK_ECHO_OFF;
+			_wifi.link.eventTime = _tick;
+			CommPutString(&_comm1, "ATE0");
+			CommPutNewline(&_comm1);
+		}
+		_comm1.buffers.line.length = 0;
+		_comm1.statusBits.hasLine = false;
+	}
+}
+
+/**
+ * Steps the link to the ESP8266 up through the link speeds, up to <code>_wifi.link.limit</code>.
+ * Each speed is requested with AT+UART_CUR (at the current speed), then verified with an AT round trip at the new speed.
+ * If the ESP8266 rejects a speed, negotiation stops at the current speed.
+ * If a speed cannot be verified, the ESP8266 is restarted (it then returns to <code>WIFI_LINK_RATE0</code>)
+ * and the last verified speed becomes the limit.
+ * Responses are consumed here, any other line is passed on to the shell.
+ */
+void WifiNegotiateLink(void)
+{
+	bool isOk = false, isError = false;
+	if(_comm1.statusBits.hasLine)
+	{
+		isOk = BufferContains(&_comm1.buffers.line, "OK", 2) == 0;
+		isError = BufferContains(&_comm1.buffers.line, "ERROR", 5) == 0;
+		if(!isOk && !isError && _comm1.buffers.line.length > 1)
+			CommFlushLineBuffer(&_comm1);
+		_comm1.buffers.line.length = 0;
+		_comm1.statusBits.hasLine = false;
+	}
+	bool isTimeout = _tick - _wifi.link.eventTime > WIFI_LINK_TIMEOUT;
+
+	switch(_wifi.link.step)
+	{
+		case WIFI_LINK_ECHO_OFF:
+		{
+			if(isOk || isError || isTimeout)
+				_wifi.link.step = WIFI_LINK_REQUEST;
+			break;
+		}
+		case WIFI_LINK_REQUEST:
+		{
+			if(_wifi.link.rate >= _wifi.link.limit)
+			{
+				_wifi.statusBits.boot = WIFI_BOOT_COMPLETE;
+				_comm1.modeBits.useExternalBuffer = true;
+				break;
+			}
+			if(!CommReserve(&_comm1, strlen(at_uart_cur) + 20))
+				break;
+
+			CommPutString(&_comm1, at_uart_cur);
+			CommPutChar(&_comm1, '=');
+			FormatPutUnsigned(&_comm1, _linkRates[_wifi.link.rate + 1], 0, ' ');
+			CommPutString(&_comm1, ",8,1,0,0");
+			CommPutNewline(&_comm1);
+			_wifi.link.step = WIFI_LINK_SWITCH;
+			_wifi.link.eventTime = _tick;
+			break;
+		}
+		case WIFI_LINK_SWITCH:
+		{
+			// The ESP8266 answers at the current speed, then switches
+			if(isOk)
+			{
+				WifiSetBrg(_linkBrg[_wifi.link.rate + 1]);
+				_wifi.link.step = WIFI_LINK_SETTLING;
+				_wifi.link.eventTime = _tick;
+			}
+			else if(isError)
+			{
+				_wifi.link.limit = _wifi.link.rate;
+				_wifi.link.step = WIFI_LINK_REQUEST;
+			}
+			else if(isTimeout)
+			{
+				_wifi.link.limit = _wifi.link.rate;
+				WifiRestart();
+			}
+			break;
+		}
+		case WIFI_LINK_SETTLING:
+		{
+			if(_tick - _wifi.link.eventTime < WIFI_LINK_SETTLE
+			|| !CommReserve(&_comm1, strlen(at_test) + 2))
+				break;
+
+			CommPutString(&_comm1, at_test);
+			CommPutNewline(&_comm1);
+			_wifi.link.step = WIFI_LINK_VERIFY;
+			_wifi.link.eventTime = _tick;
+			break;
+		}
+		case WIFI_LINK_VERIFY:
+		{
+			if(isOk)
+			{
+				_wifi.link.rate++;
+				_wifi.link.step = WIFI_LINK_REQUEST;
+			}
+			else if(isTimeout)
+			{
+				_wifi.link.limit = _wifi.link.rate;
+				WifiRestart();
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * Holds the ESP8266 in reset, then restarts the power-on sequence
+ */
+void WifiRestart(void)
+{
+	_wifi.statusBits.resetMode = WIFI_RESET_RESTART;
+	WifiReset();
+	_comm1.buffers.line.length = 0;
+	_comm1.statusBits.hasLine = false;
+	_wifi.statusBits.boot = WIFI_BOOT_POWER_ON_RESET_HOLD;
+	_wifi.eventTime = _tick;
+}
+
+// AT COMMAND FUNCTIONS--------------------------------------------------------
+
+/**
+ * Adds an AT command to the command queue.
+ * Queued commands are sent one at a time, in order, each as soon as the final response to the previous one has arrived.
+ * Lines received while a command is waiting for its final response are passed to its <b>line</b> handler,
+ * and the final response (or <code>WIFI_RESPONSE_TIMEOUT</code>) is passed to its <b>done</b> handler.
+ * While commands are queued, the uplink leaves passthrough mode and no batch is started.
+ * Commands are discarded when the ESP8266 is reset.
+ * @param command	Pointer to the command (which must remain valid until it has completed)
+ * @return			true if the command was queued, false if the command queue is full
+ */
+bool WifiQueueCommand(const WifiCommand* command)
+{
+	if(command == NULL || _wifi.command.count == WIFI_COMMAND_QUEUE_SIZE)
+		return false;
+
+	_wifi.command.queue[(_wifi.command.head + _wifi.command.count) % WIFI_COMMAND_QUEUE_SIZE] = command;
+	_wifi.command.count++;
+	return true;
+}
+
+/**
+ * Sends the next queued AT command once the current one has completed (and once the uplink is idle),
+ * and times out the current command.
+ * This function is called by <b>UpdateWifi</b> once the wifi boot process is complete.
+ */
+void WifiUpdateCommands(void)
+{
+	if(_wifi.command.current == NULL)
+	{
+		if(_wifi.command.count == 0 || _wifi.uplink.step != WIFI_UPLINK_IDLE)
+			return;
+
+		const WifiCommand* command = _wifi.command.queue[_wifi.command.head];
+		if(++_wifi.command.head == WIFI_COMMAND_QUEUE_SIZE)
+			_wifi.command.head = 0;
+		_wifi.command.count--;
+		WifiStartCommand(command);
+		return;
+	}
+
+	if(_wifi.command.isSent)
+	{
+		if(_tick - _wifi.command.eventTime > _wifi.command.current->timeout)
+			WifiCompleteCommand(WIFI_RESPONSE_TIMEOUT);
+	}
+	else if(_wifi.command.retries == 0 || _tick - _wifi.command.eventTime > WIFI_COMMAND_BUSY_DELAY)
+	{
+		if(_wifi.command.current->write())
+		{
+			_wifi.command.isSent = true;
+			_wifi.command.eventTime = _tick;
+		}
+	}
+}
+
+/**
+ * Routes a line received from the ESP8266 to the current AT command.
+ * A final response which the command expects completes it, and the next queued command is sent immediately.
+ * "busy" causes the command to be sent again after <code>WIFI_COMMAND_BUSY_DELAY</code>.
+ * Any other line is passed to the <b>line</b> handler of the command, and is also left for the caller (it may be unsolicited).
+ * @param line	Pointer to a <b>Buffer</b> containing the line
+ * @return		true if the line was a response to the current command (and has been consumed), otherwise false
+ */
+bool WifiHandleResponse(Buffer* line)
+{
+	if(_wifi.command.current == NULL || !_wifi.command.isSent)
+		return false;
+
+	unsigned char response = WifiParseResponse(line);
+	if(response & _wifi.command.current->responses)
+	{
+		WifiCompleteCommand(response);
+		WifiUpdateCommands();
+		return true;
+	}
+	if(response == WIFI_RESPONSE_BUSY)
+	{
+		if(++_wifi.command.retries > WIFI_COMMAND_MAX_RETRIES)
+			WifiCompleteCommand(WIFI_RESPONSE_BUSY);
+		else
+		{
+			_wifi.command.isSent = false;
+			_wifi.command.eventTime = _tick;
+		}
+		return true;
+	}
+
+	if(_wifi.command.current->line != NULL)
+		_wifi.command.current->line(line);
+	return false;
+}
+
+// UPLINK FUNCTIONS------------------------------------------------------------
+
+/**
+ * Initializes the uplink queue (any queued records are discarded)
+ */
+void WifiUplinkInitialize(void)
+{
+	uint8_t i;
+	for(i = 0; i < WIFI_UPLINK_SLOTS; i++)
+		_wifi.uplink.length[i] = 0;
+	_wifi.uplink.head = 0;
+	_wifi.uplink.tail = 0;
+	_wifi.uplink.closed = 0;
+	_wifi.uplink.isUrgent = false;
+	_wifi.uplink.isPassthrough = false;
+	_wifi.uplink.isPassthroughFailed = false;
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+	_wifi.uplink.offset = 0;
+	_wifi.uplink.records = 0;
+	_wifi.uplink.batches = 0;
+	_wifi.uplink.dropped = 0;
+	InitializeBuffer(&_wifi.uplink.chunk, WIFI_UPLINK_CHUNK_SIZE, 1, _wifi.uplink.chunkData);
+}
+
+/**
+ * Adds a record to the uplink queue in external SRAM.
+ * Records are collected into batches of up to <code>WIFI_UPLINK_BATCH_SIZE</code> bytes (a record is never split between batches).
+ * A batch is sent once it is full, once its oldest record is <code>WIFI_UPLINK_MAX_AGE</code> old,
+ * or as soon as possible if it contains an urgent record.
+ * @param record	Pointer to the record
+ * @param length	Size of the record (bytes)
+ * @param isUrgent	Determines whether the record should be sent as soon as possible
+ * @return			true if the record was queued, false if it was dropped (the uplink queue is full, or SRAM is not responding)
+ */
+bool WifiQueueRecord(const unsigned char* record, unsigned char length, bool isUrgent)
+{
+	// Close the batch being filled if the record does not fit
+	if(_wifi.uplink.length[_wifi.uplink.head] + length > WIFI_UPLINK_BATCH_SIZE
+	&& !WifiCloseBatch())
+	{
+		_wifi.uplink.dropped++;
+		return false;
+	}
+
+	Buffer source;
+	InitializeBuffer(&source, length, 1, (void*) record);
+	source.length = length;
+	if(!SramWait())
+	{
+		_wifi.uplink.dropped++;
+		return false;
+	}
+	SramWrite(WifiBatchAddress(_wifi.uplink.head) + _wifi.uplink.length[_wifi.uplink.head], &source);
+	if(!SramWait())
+	{
+		_wifi.uplink.dropped++;
+		return false;
+	}
+
+	if(_wifi.uplink.length[_wifi.uplink.head] == 0)
+		_wifi.uplink.firstTime = _tick;
+	_wifi.uplink.length[_wifi.uplink.head] += length;
+	if(isUrgent)
+		_wifi.uplink.isUrgent = true;
+	_wifi.uplink.records++;
+	return true;
+}
+
+/**
+ * Sends the uplink queue, without waiting.
+ * In passthrough mode (once the TCP connection is up, AT+CIPMODE=1 and AT+CIPSEND start passthrough),
+ * records are copied from SRAM to the TX buffer as they are queued, with no further commands or prompts.
+ * Otherwise, each batch is sent with AT+CIPSEND (with the size of the batch): the batch is copied once the prompt has been received,
+ * and the batch is sent again if the prompt does not arrive in time, or if the ESP8266 does not report SEND OK.
+ * Uplink commands are sent through the AT command engine. While other commands are queued,
+ * passthrough is left (with +++) and no batch is started.
+ * This function is called by <b>UpdateWifi</b> once the wifi boot process is complete.
+ * @see WifiQueueRecord
+ * @see WifiQueueCommand
+ */
+void WifiUpdateUplink(void)
+{
+	switch(_wifi.uplink.step)
+	{
+		case WIFI_UPLINK_IDLE:
+		{
+			if(_wifi.statusBits.tcpConnectionStatus != WIFI_TCP_READY
+			|| _wifi.command.current != NULL
+			|| _wifi.command.count)
+				break;
+
+#if WIFI_PASSTHROUGH
+			if(!_wifi.uplink.isPassthroughFailed)
+			{
+				WifiStartCommand(&_modeCommand);
+				_wifi.uplink.step = WIFI_UPLINK_MODE;
+				break;
+			}
+#endif
+
+			// Close the batch being filled if it is due
+			if(_wifi.uplink.closed == 0
+			&& _wifi.uplink.length[_wifi.uplink.head]
+			&& (_wifi.uplink.isUrgent || _tick - _wifi.uplink.firstTime > WIFI_UPLINK_MAX_AGE))
+				WifiCloseBatch();
+			if(_wifi.uplink.closed == 0)
+				break;
+
+			_comm1.rxLines.isPrompt = false;
+			WifiStartCommand(&_batchCommand);
+			_wifi.uplink.offset = 0;
+			_wifi.uplink.chunk.length = 0;
+			_wifi.uplink.step = WIFI_UPLINK_PROMPT;
+			_wifi.uplink.eventTime = _tick;
+			break;
+		}
+		case WIFI_UPLINK_PROMPT:
+		{
+			if(_comm1.rxLines.isPrompt)
+			{
+				_comm1.rxLines.isPrompt = false;
+				_wifi.uplink.step = _wifi.uplink.isPassthrough ? WIFI_UPLINK_STREAM : WIFI_UPLINK_DATA;
+			}
+			else if(_tick - _wifi.uplink.eventTime > WIFI_UPLINK_TIMEOUT)
+			{
+				_wifi.uplink.isPassthrough = false;
+				_wifi.uplink.step = WIFI_UPLINK_IDLE;
+			}
+			break;
+		}
+		case WIFI_UPLINK_STREAM:
+		{
+			// The SRAM interrupt sets the length of the chunk once it has been read
+			if(_sram.statusBits.busy)
+				break;
+
+			// Leave passthrough when commands are waiting, or when the connection has been lost
+			// A chunk which has been read but not sent is read again later (the offset only moves once it has been sent)
+			if(_wifi.command.count || _wifi.statusBits.tcpConnectionStatus != WIFI_TCP_READY)
+			{
+				_wifi.uplink.chunk.length = 0;
+				_wifi.uplink.step = WIFI_UPLINK_GUARD;
+				_wifi.uplink.eventTime = _tick;
+				break;
+			}
+
+			if(_wifi.uplink.chunk.length == 0)
+			{
+				uint16_t remaining = _wifi.uplink.length[_wifi.uplink.tail] - _wifi.uplink.offset;
+				if(remaining)
+				{
+					SramRead(WifiBatchAddress(_wifi.uplink.tail) + _wifi.uplink.offset,
+							remaining < WIFI_UPLINK_CHUNK_SIZE ? remaining : WIFI_UPLINK_CHUNK_SIZE,
+							&_wifi.uplink.chunk);
+				}
+				else if(_wifi.uplink.closed)
+				{
+					// The oldest batch has been streamed completely, and it will not grow any further
+					if(++_wifi.uplink.tail == WIFI_UPLINK_SLOTS)
+						_wifi.uplink.tail = 0;
+					_wifi.uplink.closed--;
+					_wifi.uplink.offset = 0;
+					_wifi.uplink.batches++;
+				}
+				break;
+			}
+			if(!CommReserve(&_comm1, _wifi.uplink.chunk.length))
+				break;
+
+			CommWrite(&_comm1, _wifi.uplink.chunkData, _wifi.uplink.chunk.length);
+			_wifi.uplink.offset += _wifi.uplink.chunk.length;
+			_wifi.uplink.chunk.length = 0;
+			break;
+		}
+		case WIFI_UPLINK_GUARD:
+		{
+			// The guard time starts once the TX buffer is empty
+			if(_comm1.buffers.tx.length)
+				_wifi.uplink.eventTime = _tick;
+			if(_tick - _wifi.uplink.eventTime <= WIFI_ESCAPE_GUARD
+			|| !CommReserve(&_comm1, 3))
+				break;
+
+			CommPutString(&_comm1, "+++");
+			_wifi.uplink.step = WIFI_UPLINK_ESCAPE;
+			_wifi.uplink.eventTime = _tick;
+			break;
+		}
+		case WIFI_UPLINK_ESCAPE:
+		{
+			if(_comm1.buffers.tx.length)
+				_wifi.uplink.eventTime = _tick;
+			if(_tick - _wifi.uplink.eventTime <= WIFI_ESCAPE_GUARD)
+				break;
+
+			_wifi.uplink.isPassthrough = false;
+			_wifi.uplink.step = WIFI_UPLINK_IDLE;
+			break;
+		}
+		case WIFI_UPLINK_DATA:
+		{
+			// The SRAM interrupt sets the length of the chunk once it has been read
+			if(_sram.statusBits.busy)
+				break;
+
+			if(_wifi.uplink.chunk.length == 0)
+			{
+				uint16_t remaining = _wifi.uplink.length[_wifi.uplink.tail] - _wifi.uplink.offset;
+				SramRead(WifiBatchAddress(_wifi.uplink.tail) + _wifi.uplink.offset,
+						remaining < WIFI_UPLINK_CHUNK_SIZE ? remaining : WIFI_UPLINK_CHUNK_SIZE,
+						&_wifi.uplink.chunk);
+				break;
+			}
+			if(!CommReserve(&_comm1, _wifi.uplink.chunk.length))
+				break;
+
+			CommWrite(&_comm1, _wifi.uplink.chunkData, _wifi.uplink.chunk.length);
+			_wifi.uplink.offset += _wifi.uplink.chunk.length;
+			_wifi.uplink.chunk.length = 0;
+			if(_wifi.uplink.offset == _wifi.uplink.length[_wifi.uplink.tail])
+			{
+				_wifi.uplink.step = WIFI_UPLINK_CONFIRM;
+				_wifi.uplink.eventTime = _tick;
+			}
+			break;
+		}
+		case WIFI_UPLINK_CONFIRM:
+		{
+			// SEND OK is handled by WifiBatchDone
+			if(_tick - _wifi.uplink.eventTime > WIFI_UPLINK_TIMEOUT)
+				_wifi.uplink.step = WIFI_UPLINK_IDLE;
+			break;
+		}
+	}
+}
+
+// INTERNAL FUNCTIONS----------------------------------------------------------
+
+/**
+ * Closes the batch being filled, so that it can be sent
+ * @return true if successful, false if every other batch is waiting to be sent
+ */
+static bool WifiCloseBatch(void)
+{
+	if(_wifi.uplink.closed == WIFI_UPLINK_SLOTS - 1)
+		return false;
+
+	if(++_wifi.uplink.head == WIFI_UPLINK_SLOTS)
+		_wifi.uplink.head = 0;
+	_wifi.uplink.length[_wifi.uplink.head] = 0;
+	_wifi.uplink.closed++;
+	_wifi.uplink.isUrgent = false;
+	return true;
+}
+
+/**
+ * Calculates the SRAM address of a batch
+ * @param batch	Index of the batch
+ * @return		SRAM address of the first byte of the batch
+ */
+static unsigned short long int WifiBatchAddress(unsigned char batch)
+{
+	return SRAM_ADDR_UPLINK_QUEUE + ((unsigned short long int) batch * WIFI_UPLINK_BATCH_SIZE);
+}
+
+/**
+ * Makes an AT command the current command, and sends it if there is room in the TX buffer
+ * (otherwise it is sent by <b>WifiUpdateCommands</b>). There must be no current command.
+ * @param command Pointer to the command
+ */
+static void WifiStartCommand(const WifiCommand* command)
+{
+	_wifi.command.current = command;
+	_wifi.command.isSent = false;
+	_wifi.command.retries = 0;
+	if(command->write())
+	{
+		_wifi.command.isSent = true;
+		_wifi.command.eventTime = _tick;
+	}
+}
+
+/**
+ * Completes the current AT command, and passes the final response to its <b>done</b> handler
+ * (which may start another command)
+ * @param response The final response (WIFI_RESPONSE_OK, ..., WIFI_RESPONSE_TIMEOUT)
+ */
+static void WifiCompleteCommand(unsigned char response)
+{
+	const WifiCommand* command = _wifi.command.current;
+	_wifi.command.current = NULL;
+	if(command->done != NULL)
+		command->done(response);
+}
+
+/**
+ * Identifies a final response line
+ * @param line	Pointer to a <b>Buffer</b> containing the line
+ * @return		The final response (WIFI_RESPONSE_OK, ...), or WIFI_RESPONSE_NONE
+ */
+static unsigned char WifiParseResponse(Buffer* line)
+{
+	if(BufferContains(line, "OK", 2) == 0)
+		return WIFI_RESPONSE_OK;
+	if(BufferContains(line, "ERROR", 5) == 0)
+		return WIFI_RESPONSE_ERROR;
+	if(BufferContains(line, "FAIL", 4) == 0)
+		return WIFI_RESPONSE_FAIL;
+	if(BufferContains(line, "SEND OK", 7) == 0)
+		return WIFI_RESPONSE_SEND_OK;
+	if(BufferContains(line, "SEND FAIL", 9) == 0)
+		return WIFI_RESPONSE_SEND_FAIL;
+	if(BufferContains(line, "busy", 4) == 0)
+		return WIFI_RESPONSE_BUSY;
+	return WIFI_RESPONSE_NONE;
+}
+
+/**
+ * Writes AT+CIPMODE=1 (passthrough mode)
+ * @return true if successful, false if there is not enough room in the TX buffer
+ */
+static bool WifiWriteMode(void)
+{
+	if(!CommReserve(&_comm1, strlen(at_cipmode) + 4))
+		return false;
+
+	CommPutString(&_comm1, at_cipmode);
+	CommPutString(&_comm1, "=1");
+	CommPutNewline(&_comm1);
+	return true;
+}
+
+/**
+ * Writes AT+CIPSEND (without a length, which starts passthrough)
+ * @return true if successful, false if there is not enough room in the TX buffer
+ */
+static bool WifiWriteStream(void)
+{
+	if(!CommReserve(&_comm1, strlen(at_cipsend) + 2))
+		return false;
+
+	CommPutString(&_comm1, at_cipsend);
+	CommPutNewline(&_comm1);
+	return true;
+}
+
+/**
+ * Writes AT+CIPSEND with the size of the oldest batch
+ * @return true if successful, false if there is not enough room in the TX buffer
+ */
+static bool WifiWriteBatch(void)
+{
+	if(!CommReserve(&_comm1, strlen(at_cipsend) + 7))
+		return false;
+
+	CommPutString(&_comm1, at_cipsend);
+	CommPutChar(&_comm1, '=');
+	FormatPutUnsigned(&_comm1, _wifi.uplink.length[_wifi.uplink.tail], 0, ' ');
+	CommPutNewline(&_comm1);
+	return true;
+}
+
+/**
+ * Handles the result of AT+CIPMODE=1: passthrough is started with AT+CIPSEND,
+ * or, if passthrough mode is rejected, batches are sent with AT+CIPSEND from then on (until the ESP8266 is reset)
+ * @param response The final response
+ */
+static void WifiModeDone(unsigned char response)
+{
+	if(_wifi.uplink.step != WIFI_UPLINK_MODE)
+		return;
+
+	if(response == WIFI_RESPONSE_OK)
+	{
+		// The batch being streamed (and the offset within it) is kept from any previous passthrough session
+		_comm1.rxLines.isPrompt = false;
+		WifiStartCommand(&_streamCommand);
+		_wifi.uplink.chunk.length = 0;
+		_wifi.uplink.isPassthrough = true;
+		_wifi.uplink.step = WIFI_UPLINK_PROMPT;
+		_wifi.uplink.eventTime = _tick;
+		return;
+	}
+	if(response == WIFI_RESPONSE_ERROR)
+		_wifi.uplink.isPassthroughFailed = true;
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+}
+
+/**
+ * Handles the result of AT+CIPSEND (passthrough): the prompt follows OK, otherwise passthrough is tried again later
+ * @param response The final response
+ */
+static void WifiStreamDone(unsigned char response)
+{
+	if(response == WIFI_RESPONSE_OK || _wifi.uplink.step != WIFI_UPLINK_PROMPT)
+		return;
+
+	_wifi.uplink.isPassthrough = false;
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+}
+
+/**
+ * Handles the result of AT+CIPSEND (batch).
+ * A batch which has been sent is removed from the uplink queue, otherwise it is sent again.
+ * Results received while the batch is being copied to the TX buffer are ignored (the ESP8266 is still collecting data).
+ * @param response The final response
+ */
+static void WifiBatchDone(unsigned char response)
+{
+	if(_wifi.uplink.step == WIFI_UPLINK_IDLE || _wifi.uplink.step == WIFI_UPLINK_DATA)
+		return;
+
+	if(response == WIFI_RESPONSE_SEND_OK && _wifi.uplink.step == WIFI_UPLINK_CONFIRM)
+	{
+		if(++_wifi.uplink.tail == WIFI_UPLINK_SLOTS)
+			_wifi.uplink.tail = 0;
+		_wifi.uplink.closed--;
+		_wifi.uplink.offset = 0;
+		_wifi.uplink.batches++;
+	}
+	_wifi.uplink.step = WIFI_UPLINK_IDLE;
+}
+
+/**
+ * Changes the baud rate of USART1 (the receiver and transmitter are reset)
+ * @param brg Value for (SPBRGH1:SPBRG1) with BRG16 = 1 and BRGH = 1
+ */
+static void WifiSetBrg(unsigned int brg)
+{
+	RCSTA1bits.SPEN	= false;
+	SPBRGH1	= GET_BYTE(brg, 1);
+	SPBRG1	= GET_BYTE(brg, 0);
+	RCSTA1bits.SPEN	= true;
 }
\ No newline at end of file
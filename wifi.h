@@ -1,135 +1,263 @@
-/**@file		wifi.h
- * @brief		Header file for implementation of the ESP8266 wifi module
- * @author		Jonathan Ruisi
- * @version		1.0
- * @date		February 14, 2017
- * @warning		This code has only been tested with <b>Version 1</b> of the ESP8266
- * @copyright	GNU Public License
- */
-
-#ifndef WIFI_H
-#define WIFI_H
-
-// DEFINITIONS-----------------------------------------------------------------
-// Boot states
-#define WIFI_BOOT_POWER_ON_RESET_HOLD	0	/**< Flag indicating the wifi is being held in reset until powerup has completed */
-#define WIFI_BOOT_RESET_HOLD			1	/**< Flag indicating the wifi is being held in reset indefinitely */
-#define WIFI_BOOT_RESET_RELEASE			2	/**< Flag indicating the wifi has been released from reset and has started its boot procedure */
-#define WIFI_BOOT_SELFCHECK				3	/**< Flag indicating the wifi is currently booting and is running self-check */
-#define WIFI_BOOT_INITIALIZING			4	/**< Flag indicating the wifi is currently booting and is initializing */
-#define WIFI_BOOT_COMPLETE				5	/**< Flag indicating the wifi boot process is complete */
-// Reset modes
-#define WIFI_RESET_HOLD		0				/**< Reset of indefinite length */
-#define WIFI_RESET_RELEASE	1				/**< Release the wifi from reset */
-#define WIFI_RESET_RESTART	2				/**< Reset while system restarts */
-// TCP status
-#define WIFI_TCP_CLOSED		0				/**< TCP connection status: CLOSED */
-#define WIFI_TCP_CONNECTING	1				/**< TCP connection status: CONNECTING */
-#define WIFI_TCP_READY		2				/**< TCP connection status: CONNECTED */
-
-// TYPE DEFINITIONS------------------------------------------------------------
-
-/**@struct WifiInfo
- * Structure containing status information and event timing for the ESP8266
- */
-typedef struct
-{
-
-	union
-	{
-
-		struct
-		{
-			unsigned boot : 3;					/**< Current boot status */
-			unsigned resetMode : 2;				/**< Current reset mode */
-			unsigned isSsidConnected : 1;		/**< Flag indicating whether or not the wifi is connected to a network */
-			unsigned tcpConnectionStatus : 2;	/**< Flag indicating whether or not the wifi has established itself as a TCP client */
-		} statusBits;
-		unsigned char status;
-	} ;
-	unsigned long int eventTime;				/**< Timestamp of the last event */
-} WifiInfo;
-
-// CONSTANTS (NETWORK INFO)----------------------------------------------------
-static const char* network_ssid			= "JASPERNET";		/**< The SSID to connect to on startup */
-static const bool network_use_password	= true;				/**< Flag indicating if the SSID requires a password */
-static const char* network_pass			= "";				/**< The password for the SSID */
-static const char* tcp_server			= "JRUISI-LAPTOP";	/**< The TCP host */
-static const unsigned int tcp_port		= 11000;			/**< The TCP port */
-
-// CONSTANTS (ESP-8266 AT COMMANDS)--------------------------------------------
-// BASIC COMMANDS
-static const char* at_test				= "AT";					/**< Test AT startup */
-static const char* at_echo				= "ATE";				/**< AT command echo */
-static const char* at_rst				= "AT+RST";				/**< Restart module */
-static const char* at_gmr				= "AT+GMR";				/**< View version info */
-static const char* at_gslp				= "AT+GSLP";			/**< Enter deep-sleep mode */
-static const char* at_restore			= "AT+RESTORE";			/**< Factory reset */
-static const char* at_uart_cur			= "AT+UART_CUR";		/**< UART current configuration */
-static const char* at_uart_def			= "AT+UART_DEF";		/**< UART default configuration, save to flash */
-static const char* at_sleep				= "AT+SLEEP";			/**< Sleep mode */
-static const char* at_wakeupgpio		= "AT+WAKEUPGPIO";		/**< Set a GPIO to wake ESP8266 up from light-sleep mode */
-static const char* at_rfpower			= "AT+RFPOWER";			/**< Set maximum value of RF TX power */
-static const char* at_rfvdd				= "AT+RFVDD";			/**< Set RF TX power according to VDD33 */
-// WIFI COMMANDS
-static const char* at_cwmode_cur		= "AT+CWMODE_CUR";		/**< Wifi mode */
-static const char* at_cwmode_def		= "AT+CWMODE_DEF";		/**< Wifi mode (saved to flash) */
-static const char* at_cwjap_cur			= "AT+CWJAP_CUR";		/**< Connect to AP */
-static const char* at_cwjap_def			= "AT+CWJAP_DEP";		/**< Connect to AP */
-static const char* at_cwlapopt			= "AT+CWLAPOPT";		/**< Set the configuration of command AT+CWLAP */
-static const char* at_cwlap				= "AT+CWLAP";			/**< List available APs */
-static const char* at_cwqap				= "AT+CWQAP";			/**< Disconnect from AP */
-static const char* at_cwsap_cur			= "AT+CWSAP_CUR";		/**< Configure ESP8266 soft-AP */
-static const char* at_cwsap_def			= "AT+CWSAP_DEF";		/**< Configure ESP8266 soft-AP */
-static const char* at_cwlif				= "AT+CWLIF";			/**< Get station IP which is connected to ESP8266 softAP */
-static const char* at_cwdhcp_cur		= "AT+CWDHCP_CUR";		/**< Enable/disable DHCP */
-static const char* at_cwdhcp_def		= "AT+CWDHCP_DEF";		/**< Enable/disable DHCP */
-static const char* at_cwdhcps_cur		= "AT+CWDHCPS_CUR";		/**< Set IP range of DHCP server */
-static const char* at_cwdhcps_def		= "AT+CWDHCPS_DEF";		/**< Set IP range of DHCP server */
-static const char* at_cwautoconn		= "AT+CWAUTOCONN";		/**< Connect to AP automatically on power-up */
-static const char* at_cipstamac_cur		= "AT+CIPSTAMAC_CUR";	/**< Set MAC address of ESP8266 station */
-static const char* at_cipstamac_def		= "AT+CIPSTAMAC_DEF";	/**< Set MAC address of ESP8266 station */
-static const char* at_cipapmac_cur		= "AT+CIPAPMAC_CUR";	/**< Set MAC address of ESP8266 soft-AP */
-static const char* at_cipapmac_def		= "AT+CIPAPMAC_DEF";	/**< Set MAC address of ESP8266 soft-AP */
-static const char* at_cipsta_cur		= "AT+CIPSTA_CUR";		/**< Set IP address of ESP8266 station */
-static const char* at_cipsta_def		= "AT+CIPSTA_DEF";		/**< Set IP address of ESP8266 station */
-static const char* at_cipap_cur			= "AT+CIPAP_CUR";		/**< Set IP address of ESP8266 soft-AP */
-static const char* at_cipap_def			= "AT+CIPAP_DEF";		/**< Set IP address of ESP8266 soft-AP */
-static const char* at_cwstartsmart		= "AT+CWSTARTSMART";	/**< Start SmartConfig */
-static const char* at_cwstopsmart		= "AT+CWSTOPSMART";		/**< Stop SmartConfig */
-static const char* at_cwstartdiscover	= "AT+CWSTARTDISCOVER";	/**< Start the mode that the ESP8266 can be found by WeChat */
-static const char* at_cwstopdiscover	= "AT+CWSTOPDISCOVER";	/**< Stop the mode that the ESP8266 can be found by WeChat */
-static const char* at_wps				= "AT+WPS";				/**< Set WPS function */
-static const char* at_mdns				= "AT+MDNS";			/**< Set MDNS function */
-// TCP/IP COMMANDS
-static const char* at_cipstatus			= "AT+CIPSTATUS";		/**< Get connection status */
-static const char* at_cipdomain			= "AT+CIPDOMAIN";		/**< DNS function */
-static const char* at_cipstart			= "AT+CIPSTART";		/**< Establish TCP connection, UDP transmission, or SSL connection */
-static const char* at_cipsslsize		= "AT+CIPSSLSIZE";		/**< Set the size of SSL buffer */
-static const char* at_cipsend			= "AT+CIPSEND";			/**< Send data */
-static const char* at_cipsendex			= "AT+CIPSENDEX";		/**< Send data (if <length> or "\0" is met, data will be sent) */
-static const char* at_cipsendbuf		= "AT+CIPSENDBUF";		/**< Write data into TCP send buffer */
-static const char* at_cipbufreset		= "AT+CIPBUFRESET";		/**< Reset segment ID count */
-static const char* at_cipbufstatus		= "AT+CIPBUFSTATUS";	/**< Check status of TCP send buffer */
-static const char* at_cipcheckseq		= "AT+CIPCHECKSEQ";		/**< Check if a specific segment is sent or not */
-static const char* at_cipclose			= "AT+CIPCLOSE";		/**< Close TCP/UDP/SSL connection */
-static const char* at_cifsr				= "AT+CIFSR";			/**< Get local IP address */
-static const char* at_cipmux			= "AT+CIPMUX";			/**< Set multiple connections mode */
-static const char* at_cipserver			= "AT+CIPSERVER";		/**< Configure as server */
-static const char* at_cipmode			= "AT+CIPMODE";			/**< Set transmission mode */
-static const char* at_savetranslink		= "AT+SAVETRANSLINK";	/**< Save transparent transmission link to flash */
-static const char* at_cipsto			= "AT+CIPSTO";			/**< Set timeout when ESP8266 runs as TCP server */
-static const char* at_ciupdate			= "AT+CIUPDATE";		/**< Upgrade firmware through network (DON'T USE THIS!) */
-static const char* at_ping				= "AT+PING";			/**< Ping function */
-static const char* at_cipdinfo			= "AT+CIPDINFO";		/**< Show remote IP and remote port */
-
-// GLOBAL VARIABLES------------------------------------------------------------
-extern WifiInfo _wifi;
-
-// FUNCTION PROTOTYPES---------------------------------------------------------
-// ESP8266 Control
-void WifiReset(void);
-void WifiHandleBoot(void);
-void UpdateWifi(void);
-
+/**@file		wifi.h
+ * @brief		Header file for implementation of the ESP8266 wifi module
+ * @author		Jonathan Ruisi
+ * @version		1.0
+ * @date		February 14, 2017
+ * @warning		This code has only been tested with <b>Version 1</b> of the ESP8266
+ * @copyright	GNU Public License
+ */
+
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "buffer.h"
+#include "utility.h"
+
+// DEFINITIONS-----------------------------------------------------------------
+// Boot states
+#define WIFI_BOOT_POWER_ON_RESET_HOLD	0	/**< Flag indicating the wifi is being held in reset until powerup has completed */
+#define WIFI_BOOT_RESET_HOLD			1	/**< Flag indicating the wifi is being held in reset indefinitely */
+#define WIFI_BOOT_RESET_RELEASE			2	/**< Flag indicating the wifi has been released from reset and has started its boot procedure */
+#define WIFI_BOOT_SELFCHECK				3	/**< Flag indicating the wifi is currently booting and is running self-check */
+#define WIFI_BOOT_INITIALIZING			4	/**< Flag indicating the wifi is currently booting and is initializing */
+#define WIFI_BOOT_NEGOTIATING			5	/**< Flag indicating the wifi has booted and the link speed is being negotiated */
+#define WIFI_BOOT_COMPLETE				6	/**< Flag indicating the wifi boot process is complete */
+#define WIFI_BOOT_TIMEOUT				5000	/**< Time (in milliseconds) allowed for the wifi to report "ready" before it is restarted */
+// Link speeds (the ESP8266 boots at WIFI_BAUD_BOOT, then runs at WIFI_LINK_RATE0 until a faster rate has been negotiated)
+#define WIFI_BAUD_BOOT		76800			/**< Baud rate of the ESP8266 boot messages */
+#define WIFI_LINK_RATE0		115200			/**< Default baud rate of the ESP8266 AT interface */
+#define WIFI_LINK_RATE1		230400
+#define WIFI_LINK_RATE2		460800
+#define WIFI_LINK_RATE3		921600
+#define WIFI_LINK_RATES		2				/**< Number of link speeds that may be negotiated (capped by WIFI_RX_LATENCY) */
+/**
+ * Worst-case time (in instruction cycles) before the RX interrupt reads RCREG1, estimated from the code paths.
+ * The high-priority ISR runs first: at the end of a sample window it hands the window over, applies a pending
+ * sampling change, restarts the sums and the capture (about 600 cycles), and stores the sample for the Goertzel
+ * filters (about 20 cycles; the filters run in TaskCalculateHarmonics).
+ * The SRAM and TX1 handlers ahead of RX1 in the low-priority ISR add about 150 cycles.
+ */
+#define WIFI_RX_LATENCY		770
+/**
+ * Time (in instruction cycles) the USART1 receiver can wait at a link speed (\a rate) before it overruns:
+ * the FIFO holds 2 characters of 10 bits. A link speed may only be negotiated if this is at least WIFI_RX_LATENCY.
+ * 115200: 2083, 230400: 1041, 460800: 520, 921600: 260.
+ */
+#define WIFI_RX_DEADLINE(rate)	(20 * (FCY) / (rate))
+#define WIFI_LINK_TIMEOUT	250				/**< Time (in milliseconds) allowed for a response during link negotiation */
+#define WIFI_LINK_SETTLE	5				/**< Time (in milliseconds) allowed for both ends to switch to a new link speed */
+// Link negotiation steps
+#define WIFI_LINK_ECHO_OFF	0				/**< Waiting for the response to ATE0 */
+#define WIFI_LINK_REQUEST	1				/**< Requesting the next link speed with AT+UART_CUR */
+#define WIFI_LINK_SWITCH	2				/**< Waiting for the ESP8266 to accept the next link speed */
+#define WIFI_LINK_SETTLING	3				/**< Waiting for both ends to switch to the next link speed */
+#define WIFI_LINK_VERIFY	4				/**< Waiting for the response to AT at the next link speed */
+// Reset modes
+#define WIFI_RESET_HOLD		0				/**< Reset of indefinite length */
+#define WIFI_RESET_RELEASE	1				/**< Release the wifi from reset */
+#define WIFI_RESET_RESTART	2				/**< Reset while system restarts */
+// TCP status
+#define WIFI_TCP_CLOSED		0				/**< TCP connection status: CLOSED */
+#define WIFI_TCP_CONNECTING	1				/**< TCP connection status: CONNECTING */
+#define WIFI_TCP_READY		2				/**< TCP connection status: CONNECTED */
+#define WIFI_TCP_RETRY_DELAY	2000		/**< Time (in milliseconds) between failed TCP connection attempts */
+// AT command engine (commands are queued, then sent one at a time, each as soon as the previous one has completed)
+#define WIFI_COMMAND_QUEUE_SIZE		4		/**< Number of AT commands which may be waiting to be sent */
+#define WIFI_COMMAND_TIMEOUT		1000	/**< Time (in milliseconds) allowed for the final response to a short command */
+#define WIFI_COMMAND_BUSY_DELAY		100		/**< Time (in milliseconds) before a command rejected with "busy" is sent again */
+#define WIFI_COMMAND_MAX_RETRIES	5		/**< Number of times a command rejected with "busy" is sent again */
+// AT command final responses (bits)
+#define WIFI_RESPONSE_NONE			0x00	/**< The line is not a final response */
+#define WIFI_RESPONSE_OK			0x01	/**< OK */
+#define WIFI_RESPONSE_ERROR			0x02	/**< ERROR */
+#define WIFI_RESPONSE_FAIL			0x04	/**< FAIL */
+#define WIFI_RESPONSE_SEND_OK		0x08	/**< SEND OK */
+#define WIFI_RESPONSE_SEND_FAIL		0x10	/**< SEND FAIL */
+#define WIFI_RESPONSE_BUSY			0x40	/**< busy p... or busy s... (the command was ignored, and is sent again) */
+#define WIFI_RESPONSE_TIMEOUT		0x80	/**< No final response was received in time */
+// Uplink queue (records are collected into batches in external SRAM, then streamed in passthrough mode,
+// or sent with a single AT+CIPSEND per batch if passthrough is disabled or not supported)
+#define WIFI_PASSTHROUGH		1			/**< Set to 0 to send every batch with AT+CIPSEND instead of using passthrough mode (AT+CIPMODE=1) */
+#define WIFI_ESCAPE_GUARD		1000		/**< Time (in milliseconds) without data before and after +++, which leaves passthrough mode */
+#define WIFI_UPLINK_SLOTS		4			/**< Number of batches in the uplink queue */
+#define WIFI_UPLINK_BATCH_SIZE	2048		/**< The maximum size (in bytes) of a batch (the largest AT+CIPSEND) */
+#define WIFI_UPLINK_MAX_AGE		5000		/**< Time (in milliseconds) after which a partial batch is sent */
+#define WIFI_UPLINK_TIMEOUT		5000		/**< Time (in milliseconds) allowed for the AT+CIPSEND prompt, and for SEND OK after the batch */
+#define WIFI_UPLINK_CHUNK_SIZE	32			/**< Number of bytes copied from SRAM to the TX buffer at a time */
+// Uplink steps
+#define WIFI_UPLINK_IDLE		0			/**< No batch is being sent */
+#define WIFI_UPLINK_PROMPT		1			/**< Waiting for the AT+CIPSEND prompt */
+#define WIFI_UPLINK_DATA		2			/**< Sending the oldest batch */
+#define WIFI_UPLINK_CONFIRM		3			/**< Waiting for SEND OK */
+#define WIFI_UPLINK_MODE		4			/**< Waiting for the response to AT+CIPMODE=1 */
+#define WIFI_UPLINK_STREAM		5			/**< Passthrough: records are sent as they are queued */
+#define WIFI_UPLINK_GUARD		6			/**< Leaving passthrough: waiting out the guard time before +++ */
+#define WIFI_UPLINK_ESCAPE		7			/**< Leaving passthrough: waiting out the guard time after +++ */
+
+// TYPE DEFINITIONS------------------------------------------------------------
+
+/**@struct WifiCommand
+ * Structure which defines an AT command and the handling of its responses (see WifiQueueCommand)
+ */
+typedef struct WifiCommand
+{
+	B_Action write;							/**< Writes the command into the TX buffer (returns false if there is not enough room, and is called again later) */
+	Action_pV line;							/**< Handles each intermediate response line (a <b>Buffer</b>), or NULL */
+	Action_U8 done;							/**< Handles the final response (WIFI_RESPONSE_OK, ..., WIFI_RESPONSE_TIMEOUT), or NULL */
+	unsigned int timeout;					/**< Time (in milliseconds) allowed for the final response */
+	unsigned char responses;				/**< Final responses which complete the command (all others are intermediate lines) */
+} WifiCommand;
+
+/**@struct WifiInfo
+ * Structure containing status information and event timing for the ESP8266
+ */
+typedef struct
+{
+
+	union
+	{
+
+		struct
+		{
+			unsigned boot : 3;					/**< Current boot status */
+			unsigned resetMode : 2;				/**< Current reset mode */
+			unsigned isSsidConnected : 1;		/**< Flag indicating whether or not the wifi is connected to a network */
+			unsigned tcpConnectionStatus : 2;	/**< Flag indicating whether or not the wifi has established itself as a TCP client */
+		} statusBits;
+		unsigned char status;
+	} ;
+	unsigned long int eventTime;				/**< Timestamp of the last event */
+
+	struct
+	{
+		unsigned char rate;						/**< Index of the current (verified) link speed */
+		unsigned char limit;					/**< Index of the fastest link speed that may be negotiated */
+		unsigned char step;						/**< Current link negotiation step */
+		unsigned long int eventTime;			/**< Timestamp of the last negotiation step */
+	} link;
+
+	struct
+	{
+		const WifiCommand* queue[WIFI_COMMAND_QUEUE_SIZE];	/**< Commands waiting to be sent (oldest first, starting at head) */
+		unsigned char head;						/**< Index of the oldest queued command */
+		unsigned char count;					/**< Number of queued commands */
+		const WifiCommand* current;				/**< Command being sent, or waiting for its final response (NULL if none) */
+		bool isSent;							/**< Indicates that the current command has been written to the TX buffer */
+		unsigned char retries;					/**< Number of times the current command has been rejected with "busy" */
+		unsigned long int eventTime;			/**< Timestamp at which the current command was sent (or rejected) */
+	} command;
+
+	struct
+	{
+		unsigned int length[WIFI_UPLINK_SLOTS];	/**< Size (in bytes) of each batch */
+		unsigned char head;						/**< Index of the batch being filled */
+		unsigned char tail;						/**< Index of the oldest batch */
+		unsigned char closed;					/**< Number of batches which are ready to be sent (starting at the tail) */
+		bool isUrgent;							/**< Indicates that the batch being filled must be sent as soon as possible */
+		bool isPassthrough;						/**< Indicates that the ESP8266 is (or is entering) passthrough mode */
+		bool isPassthroughFailed;				/**< Indicates that the ESP8266 rejected AT+CIPMODE=1 (batches are sent with AT+CIPSEND) */
+		unsigned long int firstTime;			/**< Timestamp of the oldest record in the batch being filled */
+		unsigned char step;						/**< Current uplink step */
+		unsigned int offset;					/**< Number of bytes of the oldest batch which have been sent */
+		unsigned long int eventTime;			/**< Timestamp of the last uplink step */
+		Buffer chunk;							/**< Bytes being copied from SRAM to the TX buffer */
+		char chunkData[WIFI_UPLINK_CHUNK_SIZE];
+		unsigned long int records;				/**< Number of records queued */
+		unsigned long int batches;				/**< Number of batches sent */
+		unsigned long int dropped;				/**< Number of records discarded because the uplink queue was full */
+	} uplink;
+} WifiInfo;
+
+// CONSTANTS (NETWORK INFO)----------------------------------------------------
+static const char* network_ssid			= "JASPERNET";		/**< The SSID to connect to on startup */
+static const bool network_use_password	= true;				/**< Flag indicating if the SSID requires a password */
+static const char* network_pass			= "";				/**< The password for the SSID */
+static const char* tcp_server			= "JRUISI-LAPTOP";	/**< The TCP host */
+static const unsigned int tcp_port		= 11000;			/**< The TCP port */
+
+// CONSTANTS (ESP-8266 AT COMMANDS)--------------------------------------------
+// BASIC COMMANDS
+static const char* at_test				= "AT";					/**< Test AT startup */
+static const char* at_echo				= "ATE";				/**< AT command echo */
+static const char* at_rst				= "AT+RST";				/**< Restart module */
+static const char* at_gmr				= "AT+GMR";				/**< View version info */
+static const char* at_gslp				= "AT+GSLP";			/**< Enter deep-sleep mode */
+static const char* at_restore			= "AT+RESTORE";			/**< Factory reset */
+static const char* at_uart_cur			= "AT+UART_CUR";		/**< UART current configuration */
+static const char* at_uart_def			= "AT+UART_DEF";		/**< UART default configuration, save to flash */
+static const char* at_sleep				= "AT+SLEEP";			/**< Sleep mode */
+static const char* at_wakeupgpio		= "AT+WAKEUPGPIO";		/**< Set a GPIO to wake ESP8266 up from light-sleep mode */
+static const char* at_rfpower			= "AT+RFPOWER";			/**< Set maximum value of RF TX power */
+static const char* at_rfvdd				= "AT+RFVDD";			/**< Set RF TX power according to VDD33 */
+// WIFI COMMANDS
+static const char* at_cwmode_cur		= "AT+CWMODE_CUR";		/**< Wifi mode */
+static const char* at_cwmode_def		= "AT+CWMODE_DEF";		/**< Wifi mode (saved to flash) */
+static const char* at_cwjap_cur			= "AT+CWJAP_CUR";		/**< Connect to AP */
+static const char* at_cwjap_def			= "AT+CWJAP_DEP";		/**< Connect to AP */
+static const char* at_cwlapopt			= "AT+CWLAPOPT";		/**< Set the configuration of command AT+CWLAP */
+static const char* at_cwlap				= "AT+CWLAP";			/**< List available APs */
+static const char* at_cwqap				= "AT+CWQAP";			/**< Disconnect from AP */
+static const char* at_cwsap_cur			= "AT+CWSAP_CUR";		/**< Configure ESP8266 soft-AP */
+static const char* at_cwsap_def			= "AT+CWSAP_DEF";		/**< Configure ESP8266 soft-AP */
+static const char* at_cwlif				= "AT+CWLIF";			/**< Get station IP which is connected to ESP8266 softAP */
+static const char* at_cwdhcp_cur		= "AT+CWDHCP_CUR";		/**< Enable/disable DHCP */
+static const char* at_cwdhcp_def		= "AT+CWDHCP_DEF";		/**< Enable/disable DHCP */
+static const char* at_cwdhcps_cur		= "AT+CWDHCPS_CUR";		/**< Set IP range of DHCP server */
+static const char* at_cwdhcps_def		= "AT+CWDHCPS_DEF";		/**< Set IP range of DHCP server */
+static const char* at_cwautoconn		= "AT+CWAUTOCONN";		/**< Connect to AP automatically on power-up */
+static const char* at_cipstamac_cur		= "AT+CIPSTAMAC_CUR";	/**< Set MAC address of ESP8266 station */
+static const char* at_cipstamac_def		= "AT+CIPSTAMAC_DEF";	/**< Set MAC address of ESP8266 station */
+static const char* at_cipapmac_cur		= "AT+CIPAPMAC_CUR";	/**< Set MAC address of ESP8266 soft-AP */
+static const char* at_cipapmac_def		= "AT+CIPAPMAC_DEF";	/**< Set MAC address of ESP8266 soft-AP */
+static const char* at_cipsta_cur		= "AT+CIPSTA_CUR";		/**< Set IP address of ESP8266 station */
+static const char* at_cipsta_def		= "AT+CIPSTA_DEF";		/**< Set IP address of ESP8266 station */
+static const char* at_cipap_cur			= "AT+CIPAP_CUR";		/**< Set IP address of ESP8266 soft-AP */
+static const char* at_cipap_def			= "AT+CIPAP_DEF";		/**< Set IP address of ESP8266 soft-AP */
+static const char* at_cwstartsmart		= "AT+CWSTARTSMART";	/**< Start SmartConfig */
+static const char* at_cwstopsmart		= "AT+CWSTOPSMART";		/**< Stop SmartConfig */
+static const char* at_cwstartdiscover	= "AT+CWSTARTDISCOVER";	/**< Start the mode that the ESP8266 can be found by WeChat */
+static const char* at_cwstopdiscover	= "AT+CWSTOPDISCOVER";	/**< Stop the mode that the ESP8266 can be found by WeChat */
+static const char* at_wps				= "AT+WPS";				/**< Set WPS function */
+static const char* at_mdns				= "AT+MDNS";			/**< Set MDNS function */
+// TCP/IP COMMANDS
+static const char* at_cipstatus			= "AT+CIPSTATUS";		/**< Get connection status */
+static const char* at_cipdomain			= "AT+CIPDOMAIN";		/**< DNS function */
+static const char* at_cipstart			= "AT+CIPSTART";		/**< Establish TCP connection, UDP transmission, or SSL connection */
+static const char* at_cipsslsize		= "AT+CIPSSLSIZE";		/**< Set the size of SSL buffer */
+static const char* at_cipsend			= "AT+CIPSEND";			/**< Send data */
+static const char* at_cipsendex			= "AT+CIPSENDEX";		/**< Send data (if <length> or "\0" is met, data will be sent) */
+static const char* at_cipsendbuf		= "AT+CIPSENDBUF";		/**< Write data into TCP send buffer */
+static const char* at_cipbufreset		= "AT+CIPBUFRESET";		/**< Reset segment ID count */
+static const char* at_cipbufstatus		= "AT+CIPBUFSTATUS";	/**< Check status of TCP send buffer */
+static const char* at_cipcheckseq		= "AT+CIPCHECKSEQ";		/**< Check if a specific segment is sent or not */
+static const char* at_cipclose			= "AT+CIPCLOSE";		/**< Close TCP/UDP/SSL connection */
+static const char* at_cifsr				= "AT+CIFSR";			/**< Get local IP address */
+static const char* at_cipmux			= "AT+CIPMUX";			/**< Set multiple connections mode */
+static const char* at_cipserver			= "AT+CIPSERVER";		/**< Configure as server */
+static const char* at_cipmode			= "AT+CIPMODE";			/**< Set transmission mode */
+static const char* at_savetranslink		= "AT+SAVETRANSLINK";	/**< Save transparent transmission link to flash */
+static const char* at_cipsto			= "AT+CIPSTO";			/**< Set timeout when ESP8266 runs as TCP server */
+static const char* at_ciupdate			= "AT+CIUPDATE";		/**< Upgrade firmware through network (DON'T USE THIS!) */
+static const char* at_ping				= "AT+PING";			/**< Ping function */
+static const char* at_cipdinfo			= "AT+CIPDINFO";		/**< Show remote IP and remote port */
+
+// GLOBAL VARIABLES------------------------------------------------------------
+extern WifiInfo _wifi;
+
+// FUNCTION PROTOTYPES---------------------------------------------------------
+// ESP8266 Control
+void WifiReset(void);
+void WifiHandleBoot(void);
+void WifiNegotiateLink(void);
+void WifiRestart(void);
+void UpdateWifi(void);
+// AT Commands
+bool WifiQueueCommand(const WifiCommand* command);
+void WifiUpdateCommands(void);
+bool WifiHandleResponse(Buffer* line);
+// Uplink
+void WifiUplinkInitialize(void);
+bool WifiQueueRecord(const unsigned char* record, unsigned char length, bool isUrgent);
+void WifiUpdateUplink(void);
+
 #endif
\ No newline at end of file